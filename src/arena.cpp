@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include "arena.h"
+
+/*******************************************************************************
+ * @brief set up an arena
+ * @param arena: the arena
+ * @param name: for the counters
+ * @param base: start of the region, ARENA_ALIGN aligned
+ * @param size: its size in bytes
+ * ****************************************************************************/
+void arena_init(Arena *arena, const char *name, void *base, uint32_t size){
+    *arena = {};
+    arena->base = (uint8_t *)base;
+    arena->size = size;
+    arena->name = name;
+}
+
+/*******************************************************************************
+ * @brief allocate a block at the top
+ * @param size: bytes
+ * @param align: power of two
+ * @return the block, NULL if it does not fit
+ * ****************************************************************************/
+void *arena_alloc(Arena *arena, uint32_t size, uint32_t align){
+    uint32_t start = (arena->used + align - 1) & ~(align - 1);
+    if (start < arena->used || start > arena->size || size > arena->size - start){
+        arena->failed++;
+        return NULL;
+    }
+    arena->last = start;
+    arena->used = start + size;
+    arena->allocs++;
+    if (arena->used > arena->peak){
+        arena->peak = arena->used;
+    }
+    if (arena->used > arena->high_water){
+        arena->high_water = arena->used;
+    }
+    return arena->base + start;
+}
+
+/*******************************************************************************
+ * @brief give a block back if it is the newest
+ * @param block: from arena_alloc()
+ * ****************************************************************************/
+void arena_free(Arena *arena, void *block){
+    if (block == arena->base + arena->last && arena->last <= arena->used){
+        arena->used = arena->last;
+    }
+}
+
+bool arena_owns(const Arena *arena, const void *block){
+    return (const uint8_t *)block >= arena->base && (const uint8_t *)block < arena->base + arena->size;
+}
+
+/*******************************************************************************
+ * @brief note the top of the arena
+ * @return the mark to reset to
+ * ****************************************************************************/
+ArenaMark arena_mark(Arena *arena){
+    ArenaMark mark = {arena->used, arena->peak};
+    arena->peak = arena->used;
+    return mark;
+}
+
+/*******************************************************************************
+ * @brief drop every block allocated since a mark
+ * @param mark: from arena_mark(), the marks after it already reset
+ * @return the most bytes held above the mark meanwhile
+ * ****************************************************************************/
+uint32_t arena_reset(Arena *arena, ArenaMark mark){
+    uint32_t most = arena->peak - mark.used;
+    arena->used = mark.used;
+    arena->last = mark.used;
+    if (mark.peak > arena->peak){
+        arena->peak = mark.peak;
+    }
+    arena->resets++;
+    return most;
+}
+
+/*******************************************************************************
+ * @brief print the counters
+ * ****************************************************************************/
+void arena_print_stats(const Arena *arena){
+    printf("Arena %s: %lu of %lu bytes used, high water %lu, %lu allocations, %lu did not fit, %lu resets\n",
+           arena->name, (unsigned long)arena->used, (unsigned long)arena->size, (unsigned long)arena->high_water,
+           (unsigned long)arena->allocs, (unsigned long)arena->failed, (unsigned long)arena->resets);
+}
@@ -0,0 +1,117 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <new>
+
+// Bump allocator over a fixed region, for the large buffers of one
+// operation: the recordings of an attempt, a DTW matrix.
+//
+// Allocating moves the top of the arena up. Blocks are not freed one by
+// one: arena_mark() notes the top and arena_reset() drops everything
+// allocated since, in O(1). Freeing the newest block does give it back, so
+// a vector growing at the top reuses its space. Each mark also tracks the
+// most the arena held while it was open, so every operation can report its
+// own high-water mark.
+//
+// Not locked: an arena belongs to one thread. Kept free of mbed.
+
+#define ARENA_ALIGN 8
+
+typedef struct
+{
+    uint8_t *base;
+    uint32_t size;
+    uint32_t used;       // the next block starts at base + used
+    uint32_t last;       // offset of the newest block, for arena_free()
+    uint32_t peak;       // most used since the innermost open mark
+    uint32_t high_water; // most used ever
+    uint32_t allocs;
+    uint32_t failed;     // allocations that did not fit
+    uint32_t resets;
+    const char *name;
+} Arena;
+
+// The top of an arena, to go back to
+typedef struct
+{
+    uint32_t used;
+    uint32_t peak;       // of the enclosing mark
+} ArenaMark;
+
+// Set up an arena over size bytes at base
+void arena_init(Arena *arena, const char *name, void *base, uint32_t size);
+
+// Allocate a block; NULL if it does not fit
+void *arena_alloc(Arena *arena, uint32_t size, uint32_t align = ARENA_ALIGN);
+
+// Give a block back; only the newest one really is, the others wait for a
+// reset
+void arena_free(Arena *arena, void *block);
+
+// True if a block is in the arena
+bool arena_owns(const Arena *arena, const void *block);
+
+// Note the top, and start tracking the peak from there
+ArenaMark arena_mark(Arena *arena);
+
+// Drop everything allocated since a mark; returns the most bytes the arena
+// held above it meanwhile
+uint32_t arena_reset(Arena *arena, ArenaMark mark);
+
+// Print the counters
+void arena_print_stats(const Arena *arena);
+
+// Everything allocated while it exists is dropped when it goes
+class ArenaScope
+{
+public:
+    explicit ArenaScope(Arena *arena) : arena(arena), mark(arena_mark(arena)) {}
+    ~ArenaScope() { arena_reset(arena, mark); }
+    ArenaScope(const ArenaScope &) = delete;
+    ArenaScope &operator=(const ArenaScope &) = delete;
+
+private:
+    Arena *arena;
+    ArenaMark mark;
+};
+
+// Allocator for standard containers. When the arena is full, blocks come
+// from the heap instead.
+template <class T>
+struct ArenaAllocator
+{
+    typedef T value_type;
+    Arena *arena;
+
+    explicit ArenaAllocator(Arena *arena) : arena(arena) {}
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+    T *allocate(size_t n){
+        void *block = arena_alloc(arena, n * sizeof(T), alignof(T) > ARENA_ALIGN ? alignof(T) : ARENA_ALIGN);
+        return (T *)(block ? block : ::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *block, size_t){
+        if (arena_owns(arena, block)){
+            arena_free(arena, block);
+        }
+        else{
+            ::operator delete(block);
+        }
+    }
+};
+
+template <class T, class U>
+bool operator==(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b){
+    return a.arena == b.arena;
+}
+
+template <class T, class U>
+bool operator!=(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b){
+    return a.arena != b.arena;
+}
+
+#endif
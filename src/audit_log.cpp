@@ -0,0 +1,220 @@
+#include "mbed.h"
+#include "audit_log.h"
+#include "settings.h"
+#include "sdram_map.h"
+#include "drivers/stm32f429i_discovery_eeprom.h"
+
+#define AUDIT_WAKE_FLAG 1
+
+#define RECORD_PAGES (sizeof(AuditRecord) / EEPROM_PAGESIZE)
+
+static_assert(sizeof(AuditRecord) % EEPROM_PAGESIZE == 0, "records must be whole EEPROM pages");
+static_assert(AUDIT_EEPROM_ADDR >= SETTINGS_EEPROM_ADDR + SETTINGS_KEYS * SETTINGS_SLOT_SIZE &&
+                  AUDIT_EEPROM_ADDR % EEPROM_PAGESIZE == 0 && AUDIT_EEPROM_ADDR + AUDIT_EEPROM_SIZE <= EEPROM_MAX_SIZE,
+              "the slots must fit the EEPROM after the settings");
+
+static Thread worker_thread(AUDIT_WORKER_PRIORITY, AUDIT_WORKER_STACK);
+static EventFlags worker_flags;
+static Mutex ring_mutex;
+
+// Record n is ring[n % AUDIT_RING_RECORDS]. The app adds at appended, the
+// writer takes from written; both under ring_mutex, held for a copy. Only
+// the writer moves written.
+static AuditRecord *const ring = (AuditRecord *)SDRAM_AUDIT_ADDR;
+static uint32_t appended = 0;
+static uint32_t written = 0;
+static Kernel::Clock::time_point waiting_since; // when the oldest waiting record was added
+
+static AuditLogStats stats;
+
+/*******************************************************************************
+ * @brief copy the oldest waiting record out of the ring, skipping those the
+ *        EEPROM has no room left for; ring locked
+ * @param copy: the record
+ * @return false if none is waiting
+ * ****************************************************************************/
+static bool take_record(AuditRecord *copy){
+    if (appended - written > AUDIT_EEPROM_SLOTS){
+        stats.skipped += appended - written - AUDIT_EEPROM_SLOTS;
+        written = appended - AUDIT_EEPROM_SLOTS;
+    }
+    if (written == appended){
+        return false;
+    }
+    *copy = ring[written % AUDIT_RING_RECORDS];
+    return true;
+}
+
+/*******************************************************************************
+ * @brief write waiting records back in batches, a page at a time within the
+ *        budget, then sleep until more come
+ * ****************************************************************************/
+static void worker(){
+    static AuditRecord record; // DMA source
+    Kernel::Clock::time_point period_end = Kernel::Clock::now() + AUDIT_BUDGET_PERIOD;
+    uint32_t budget_left = AUDIT_BUDGET_PAGES;
+
+    while (1){
+        worker_flags.wait_any(AUDIT_WAKE_FLAG);
+
+        // Wait for a batch, or for the oldest record to have waited long
+        // enough
+        while (1){
+            ring_mutex.lock();
+            uint32_t waiting = appended - written;
+            Kernel::Clock::time_point due = waiting_since + AUDIT_FLUSH_DELAY;
+            ring_mutex.unlock();
+            if (waiting >= AUDIT_BATCH || Kernel::Clock::now() >= due){
+                break;
+            }
+            worker_flags.wait_any_until(AUDIT_WAKE_FLAG, due);
+        }
+        stats.batches++;
+
+        // Everything waiting, those added meanwhile included
+        while (1){
+            ring_mutex.lock();
+            bool taken = take_record(&record);
+            ring_mutex.unlock();
+            if (!taken){
+                break;
+            }
+
+            uint32_t address = AUDIT_EEPROM_ADDR + (record.sequence % AUDIT_EEPROM_SLOTS) * sizeof(AuditRecord);
+            uint32_t page = 0;
+            while (page < RECORD_PAGES){
+                if (Kernel::Clock::now() >= period_end){
+                    period_end = Kernel::Clock::now() + AUDIT_BUDGET_PERIOD;
+                    budget_left = AUDIT_BUDGET_PAGES;
+                }
+                if (budget_left == 0){
+                    stats.throttled++;
+                    ThisThread::sleep_until(period_end);
+                    continue;
+                }
+
+                // The write cycle is waited out in the driver, bus held
+                uint8_t length = EEPROM_PAGESIZE;
+                uint32_t offset = page * EEPROM_PAGESIZE;
+                uint32_t start = us_ticker_read();
+                settings_lock_bus();
+                bool ok = BSP_EEPROM_WritePage((uint8_t *)&record + offset, address + offset, &length) == EEPROM_OK;
+                settings_unlock_bus();
+                stats.max_write_us = max(stats.max_write_us, us_ticker_read() - start);
+                budget_left--;
+
+                if (ok){
+                    stats.pages_written++;
+                    page++;
+                }
+                else{
+                    stats.failed++;
+                    ThisThread::sleep_for(AUDIT_RETRY);
+                }
+            }
+
+            ring_mutex.lock();
+            written++;
+            stats.written++;
+            ring_mutex.unlock();
+        }
+    }
+}
+
+/*******************************************************************************
+ * @brief start the writer, and print the log if asked to
+ * @param eeprom: settings_init() found the EEPROM
+ * @return false if there is no EEPROM
+ * ****************************************************************************/
+bool audit_log_init(bool eeprom){
+    if (!eeprom){
+        printf("Audit: no EEPROM, attempts are kept until the next reset\n");
+        return false;
+    }
+    if (AUDIT_DUMP){
+        audit_log_dump();
+    }
+    worker_thread.start(callback(worker));
+    return true;
+}
+
+/*******************************************************************************
+ * @brief seal a record and add it to the ring
+ * @param record: the attempt, its CRC is set here
+ * ****************************************************************************/
+void audit_log_append(AuditRecord *record){
+    uint32_t start = us_ticker_read();
+    audit_record_seal(record);
+
+    ring_mutex.lock();
+    if (appended == written){
+        waiting_since = Kernel::Clock::now();
+    }
+    ring[appended % AUDIT_RING_RECORDS] = *record;
+    appended++;
+    stats.appended++;
+    ring_mutex.unlock();
+
+    worker_flags.set(AUDIT_WAKE_FLAG);
+    stats.max_append_us = max(stats.max_append_us, us_ticker_read() - start);
+}
+
+/*******************************************************************************
+ * @brief print the log as dump lines: the EEPROM's slots, then the records
+ *        of this boot not written back yet
+ * ****************************************************************************/
+void audit_log_dump(){
+    static AuditRecord record; // DMA destination
+    char line[AUDIT_LINE_SIZE];
+    uint32_t found = 0;
+
+    printf("# audit log, %u slots\n", (unsigned)AUDIT_EEPROM_SLOTS);
+    for (uint32_t slot = 0; slot < AUDIT_EEPROM_SLOTS; slot++){
+        uint16_t length = sizeof(record);
+        settings_lock_bus();
+        bool ok = BSP_EEPROM_ReadBuffer((uint8_t *)&record, AUDIT_EEPROM_ADDR + slot * sizeof(record), &length) ==
+                  EEPROM_OK;
+        settings_unlock_bus();
+        if (ok && audit_record_valid(&record)){
+            audit_record_format(&record, line);
+            printf("%s\n", line);
+            found++;
+        }
+    }
+
+    ring_mutex.lock();
+    uint32_t first = max(written, appended - min(appended, (uint32_t)AUDIT_RING_RECORDS));
+    for (uint32_t n = first; n != appended; n++){
+        audit_record_format(&ring[n % AUDIT_RING_RECORDS], line);
+        printf("%s\n", line);
+        found++;
+    }
+    ring_mutex.unlock();
+    printf("# audit log, %lu records\n", (unsigned long)found);
+}
+
+/*******************************************************************************
+ * @brief get the counters
+ * @return a copy of the counters
+ * ****************************************************************************/
+AuditLogStats audit_log_stats(){
+    ring_mutex.lock();
+    AuditLogStats copy = stats;
+    copy.waiting = appended - written;
+    ring_mutex.unlock();
+    return copy;
+}
+
+/*******************************************************************************
+ * @brief print the counters
+ * ****************************************************************************/
+void audit_log_print_stats(){
+    AuditLogStats s = audit_log_stats();
+    printf("Audit: %lu attempts logged, %lu written back in %lu batches, %lu waiting, %lu skipped, "
+           "append %lu us at most\n",
+           (unsigned long)s.appended, (unsigned long)s.written, (unsigned long)s.batches, (unsigned long)s.waiting,
+           (unsigned long)s.skipped, (unsigned long)s.max_append_us);
+    printf("Audit: %lu pages written, %lu failed, throttled %lu times, longest write %lu us\n",
+           (unsigned long)s.pages_written, (unsigned long)s.failed, (unsigned long)s.throttled,
+           (unsigned long)s.max_write_us);
+}
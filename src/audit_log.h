@@ -0,0 +1,99 @@
+#ifndef AUDIT_LOG_H
+#define AUDIT_LOG_H
+
+#include "mbed.h"
+#include "audit_record.h"
+
+// A log of every unlock attempt, an AuditRecord each, kept over a reset in
+// the I2C EEPROM after the settings slots.
+//
+// audit_log_append() copies the record into a ring in SDRAM (sdram_map.h)
+// and returns; it never waits on I2C, so the unlock path pays a CRC and a
+// 40-byte copy. A thread below every other one writes the ring to the
+// EEPROM in batches, as the settings are (settings.h):
+//   - it starts once AUDIT_BATCH records are waiting, or AUDIT_FLUSH_DELAY
+//     after the oldest of them;
+//   - a record is sizeof(AuditRecord) / EEPROM_PAGESIZE page writes, one per
+//     I2C3 hold, and at most AUDIT_BUDGET_PAGES are spent per
+//     AUDIT_BUDGET_PERIOD.
+// The EEPROM holds the last AUDIT_EEPROM_SLOTS attempts, attempt n in slot
+// n % AUDIT_EEPROM_SLOTS, so the slots are written in turn and nothing has
+// to be found at boot. The ring holds the last AUDIT_RING_RECORDS of this
+// boot; records not yet written back when the board resets are lost.
+//
+// Throughput: a page write is a write cycle of about 5 ms with the touch
+// controller kept off the bus, so a record costs about 50 ms of I2C3. The
+// budget allows 40 records a minute, 2 s of bus a minute. The fastest
+// attempts, about a second each in the fast flow, come 60 a minute; the
+// ring takes the difference, and only after some 10 minutes of them back
+// to back does the writer fall AUDIT_EEPROM_SLOTS behind. It then skips to
+// the newest ones, the others would be overwritten in the EEPROM anyway.
+//
+// Wear, per 1,000 attempts: 10,000 page writes over the 1,920 pages of the
+// slots, about 5 writes per page against the EEPROM's million cycles, so
+// the log lasts some 190 million attempts. The same log in a 128 KB flash
+// sector would be 40 KB, a third of an erase per 1,000 attempts against
+// 10,000 cycles, but every erase stalls the bank the key is matched from
+// for a second or two and wipes the whole log with one sector, and bank 2
+// has no spare pair of sectors to take turns.
+//
+// Set AUDIT_DUMP to print the log at boot as "a <hex>" lines, which
+// tools/audit_dump decodes; audit_log_dump() prints it at any time.
+
+// Where the slots start in the EEPROM: after the settings, to its end
+#define AUDIT_EEPROM_ADDR 0x0200
+#define AUDIT_EEPROM_SIZE 0x1E00
+#define AUDIT_EEPROM_SLOTS (AUDIT_EEPROM_SIZE / sizeof(AuditRecord)) // 192
+
+// Records in the SDRAM ring
+#define AUDIT_RING_RECORDS (SDRAM_AUDIT_SIZE / sizeof(AuditRecord)) // 1638
+
+// Write-back pacing
+#define AUDIT_BATCH 8
+#define AUDIT_FLUSH_DELAY 30s
+#define AUDIT_BUDGET_PAGES 400
+#define AUDIT_BUDGET_PERIOD 60s
+#define AUDIT_RETRY 1s // after a failed page write
+
+#define AUDIT_WORKER_PRIORITY osPriorityLow
+#define AUDIT_WORKER_STACK 1024
+
+// Set to 1 to print the log for tools/audit_dump
+#ifndef AUDIT_DUMP
+#define AUDIT_DUMP 0
+#endif
+
+typedef struct
+{
+    uint32_t appended;
+    uint32_t written;        // records written back
+    uint32_t waiting;        // records in the ring not written back yet
+    uint32_t batches;        // times the writer woke to write
+    uint32_t skipped;        // records the writer fell too far behind to write
+    uint32_t pages_written;
+    uint32_t failed;         // page writes the EEPROM refused, retried
+    uint32_t throttled;      // times the budget ran out and the writes waited
+    uint32_t max_append_us;  // longest audit_log_append(), on the unlock path
+    uint32_t max_write_us;   // longest page write, I2C3 held meanwhile
+} AuditLogStats;
+
+// Start the writer; after settings_init(), whose EEPROM it shares, with
+// what it returned. Returns false if there is no EEPROM: records then stay
+// in the ring.
+bool audit_log_init(bool eeprom);
+
+// Seal a record and add it to the ring; the writer takes it from there. Not
+// from an interrupt.
+void audit_log_append(AuditRecord *record);
+
+// Print every valid record in the EEPROM as a dump line, then the ones still
+// waiting in the ring. Holds I2C3 one record at a time.
+void audit_log_dump();
+
+// Get the counters
+AuditLogStats audit_log_stats();
+
+// Print the counters
+void audit_log_print_stats();
+
+#endif
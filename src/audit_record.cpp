@@ -0,0 +1,71 @@
+#include <stddef.h>
+#include <string.h>
+#include "audit_record.h"
+#include "crc32.h"
+
+static const char hex_digits[] = "0123456789abcdef";
+
+static int hex_value(char c){
+    if (c >= '0' && c <= '9'){
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f'){
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F'){
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+void audit_record_seal(AuditRecord *record){
+    record->crc = crc32(0, record, offsetof(AuditRecord, crc));
+}
+
+bool audit_record_valid(const AuditRecord *record){
+    return record->crc == crc32(0, record, offsetof(AuditRecord, crc));
+}
+
+/*******************************************************************************
+ * @brief print a record as a dump line
+ * @param record: the record
+ * @param line: AUDIT_LINE_SIZE bytes, "a " and the bytes in hex
+ * ****************************************************************************/
+void audit_record_format(const AuditRecord *record, char *line){
+    const uint8_t *bytes = (const uint8_t *)record;
+    *line++ = 'a';
+    *line++ = ' ';
+    for (uint32_t i = 0; i < sizeof(AuditRecord); i++){
+        *line++ = hex_digits[bytes[i] >> 4];
+        *line++ = hex_digits[bytes[i] & 15];
+    }
+    *line = 0;
+}
+
+/*******************************************************************************
+ * @brief read a dump line back
+ * @param line: as from audit_record_format(), a line end may follow
+ * @param record: the bytes
+ * @return false if the line is not a dump line
+ * ****************************************************************************/
+bool audit_record_parse(const char *line, AuditRecord *record){
+    if (line[0] != 'a' || line[1] != ' '){
+        return false;
+    }
+    line += 2;
+    uint8_t bytes[sizeof(AuditRecord)];
+    for (uint32_t i = 0; i < sizeof(AuditRecord); i++){
+        int high = hex_value(line[2 * i]);
+        int low = high < 0 ? -1 : hex_value(line[2 * i + 1]);
+        if (low < 0){
+            return false;
+        }
+        bytes[i] = high << 4 | low;
+    }
+    char end = line[2 * sizeof(AuditRecord)];
+    if (end != 0 && end != '\n' && end != '\r' && end != ' '){
+        return false;
+    }
+    memcpy(record, bytes, sizeof(bytes));
+    return true;
+}
@@ -0,0 +1,53 @@
+#ifndef AUDIT_RECORD_H
+#define AUDIT_RECORD_H
+
+#include <stdint.h>
+
+// One unlock attempt as src/audit_log.h keeps it, in RAM and in the EEPROM
+// alike, and as it is printed for tools/audit_dump: the scores the verdict
+// was taken on, how long the attempt took and when it was.
+//
+// There is no clock of the day on the board, so an attempt is placed by the
+// boot it was in and the time since that boot. The record ends in a CRC-32
+// of the fields before it; a slot never written, or cut short by a reset,
+// fails it. Kept free of mbed for the host tool; the layout is that of a
+// little-endian 32-bit float target, the board and the host alike.
+
+// Verdicts
+#define AUDIT_DENIED 0
+#define AUDIT_GRANTED 1
+#define AUDIT_ERROR 2  // the key could not be matched
+#define AUDIT_NO_KEY 3 // no key saved yet
+
+// A dump line: "a ", two hex digits a byte, the terminator
+#define AUDIT_LINE_SIZE (2 + 2 * sizeof(AuditRecord) + 1)
+
+typedef struct
+{
+    uint32_t sequence;     // attempt number over all boots
+    uint32_t boot;         // boot number the attempt was in
+    uint32_t uptime_ms;    // since that boot, at the verdict
+    uint32_t duration_us;  // click to verdict
+    float correlation[3];  // of each axis
+    float dtw;             // DTW distance, infinity if not computed
+    uint16_t samples;      // of the unlocking record
+    uint8_t verdict;       // AUDIT_*
+    uint8_t flow;          // APP_FLOW_* of src/main.cpp
+    uint32_t crc;          // of everything before it
+} AuditRecord;
+
+static_assert(sizeof(AuditRecord) == 40, "the record layout is shared with the EEPROM and tools/audit_dump");
+
+// Set the CRC after filling the fields
+void audit_record_seal(AuditRecord *record);
+
+// Check the CRC
+bool audit_record_valid(const AuditRecord *record);
+
+// Print a record as a dump line into line, AUDIT_LINE_SIZE bytes
+void audit_record_format(const AuditRecord *record, char *line);
+
+// Read a dump line back; false if it is not one. The CRC is not checked.
+bool audit_record_parse(const char *line, AuditRecord *record);
+
+#endif
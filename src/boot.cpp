@@ -0,0 +1,116 @@
+#include "mbed.h"
+#include <atomic>
+#include "boot.h"
+#include "ui.h"
+
+#define BOOT_FRAME_FLAG 1
+#define BOOT_GYRO_FLAG 2
+
+static BootStage stages[BOOT_MAX_STAGES];
+static std::atomic<uint32_t> stage_count(0);
+
+// Above the main thread so its short SPI bursts are not held up by drawing
+static Thread boot_thread(osPriorityAboveNormal, 2048);
+static EventFlags boot_flags;
+
+static Gyroscope_Init_Parameters *boot_gyro_params;
+static Gyroscope_RawData *boot_gyro_data;
+
+/*******************************************************************************
+ * @brief SPI5 side of the boot: gyroscope and panel power-up
+ *
+ * The gyroscope is turned on first so its settling runs under the panel's
+ * delays, and the panel's sleep out runs while the main thread fills the
+ * frame buffers. Calibration only starts once the panel is done with the bus.
+ * ****************************************************************************/
+static void boot_spi_thread(){
+    PowerOnGyroscope(boot_gyro_params, boot_gyro_data);
+    boot_stage("gyro on");
+
+    BSP_LCD_PanelPowerOn();
+    Kernel::Clock::time_point awake = Kernel::Clock::now() + chrono::milliseconds(LCD_SLEEP_OUT_DELAY);
+    boot_stage("panel sleep out");
+
+    // Never show a half-drawn screen
+    boot_flags.wait_all(BOOT_FRAME_FLAG);
+    ThisThread::sleep_until(awake);
+    BSP_LCD_DisplayOn();
+    boot_stage("display on");
+
+    GyroscopeCalibration(boot_gyro_data);
+    boot_stage("gyro calibrated");
+    boot_flags.set(BOOT_GYRO_FLAG);
+
+    boot_print_stats();
+}
+
+/*******************************************************************************
+ * @brief bring up the display path, the panel and gyroscope in the background
+ * @param gyro_params: gyroscope configuration
+ * @param gyro_data: where the gyroscope samples are read to
+ * ****************************************************************************/
+void boot_init(Gyroscope_Init_Parameters *gyro_params, Gyroscope_RawData *gyro_data){
+    boot_stage("main");
+
+    boot_gyro_params = gyro_params;
+    boot_gyro_data = gyro_data;
+    boot_thread.start(callback(boot_spi_thread));
+
+    BSP_LCD_InitLTDC();
+    boot_stage("ltdc");
+
+    // Sleeps through the SDRAM power-up delay, the boot thread runs meanwhile
+    BSP_SDRAM_Init();
+    boot_stage("sdram");
+
+    lcd.InitLayers();
+    boot_stage("layers");
+}
+
+/*******************************************************************************
+ * @brief let the boot thread turn the panel on
+ * ****************************************************************************/
+void boot_show_frame(){
+    boot_flags.set(BOOT_FRAME_FLAG);
+}
+
+/*******************************************************************************
+ * @brief timestamp a boot stage
+ * @param name: stage name, kept by pointer
+ * ****************************************************************************/
+void boot_stage(const char *name){
+    uint32_t now = us_ticker_read();
+    uint32_t index = stage_count.fetch_add(1, std::memory_order_relaxed);
+    if (index < BOOT_MAX_STAGES){
+        stages[index].name = name;
+        stages[index].us = now;
+    }
+}
+
+/*******************************************************************************
+ * @brief check whether the gyroscope is calibrated
+ * @return true once boot_spi_thread() has calibrated it
+ * ****************************************************************************/
+bool boot_gyro_ready(){
+    return boot_flags.get() & BOOT_GYRO_FLAG;
+}
+
+/*******************************************************************************
+ * @brief wait for the gyroscope calibration
+ * ****************************************************************************/
+void boot_wait_gyro(){
+    boot_flags.wait_all(BOOT_GYRO_FLAG, osWaitForever, false);
+}
+
+/*******************************************************************************
+ * @brief print each stage with its time since reset and since the one before
+ * ****************************************************************************/
+void boot_print_stats(){
+    uint32_t count = min(stage_count.load(), (uint32_t)BOOT_MAX_STAGES);
+    uint32_t previous = 0;
+    for (uint32_t i = 0; i < count; i++){
+        printf("Boot: %-16s %8lu us (+%lu us)\n", stages[i].name, (unsigned long)stages[i].us,
+               (unsigned long)(stages[i].us - previous));
+        previous = stages[i].us;
+    }
+}
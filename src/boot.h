@@ -0,0 +1,39 @@
+#ifndef BOOT_H
+#define BOOT_H
+
+#include "mbed.h"
+#include "gyro.h"
+
+// Most stages kept for the boot profile, later ones are counted but dropped
+#define BOOT_MAX_STAGES 12
+
+typedef struct
+{
+    const char *name;
+    uint32_t us; // us ticker, which starts with the HAL right after reset
+} BootStage;
+
+// Bring up the LTDC and the SDRAM and set up both layers. Meanwhile a boot
+// thread, the only user of the SPI5 bus the gyroscope and the panel share,
+// powers the gyroscope on and sends the panel its configuration. Returns as
+// soon as the frame buffers can be drawn; the panel stays dark until
+// boot_show_frame().
+void boot_init(Gyroscope_Init_Parameters *gyro_params, Gyroscope_RawData *gyro_data);
+
+// The first frame is drawn: the boot thread turns the panel on once it is out
+// of sleep, then calibrates the gyroscope and prints the boot profile
+void boot_show_frame();
+
+// Timestamp a boot stage, safe from any thread
+void boot_stage(const char *name);
+
+// Gyroscope calibrated and sampling
+bool boot_gyro_ready();
+
+// Block until the gyroscope is calibrated
+void boot_wait_gyro();
+
+// Print the stages in the order they were reached
+void boot_print_stats();
+
+#endif
@@ -0,0 +1,223 @@
+/* Generated by tools/image_pack.py from boot.ppm, do not edit */
+#include "packed_image.h"
+
+static const uint8_t BootScreen_Data[] = {
+    0x59, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xE4, 0x7A, 0xFD, 0xFD, 0xF6, 0x36, 0xFA, 0x19, 0xFD, 0xFD, 0xF6,
+    0x36, 0xFA, 0x19, 0x56, 0xC5, 0x19, 0xC2, 0x31, 0xC4, 0x19, 0xC4, 0x31, 0xC4, 0x19, 0xC1, 0x31,
+    0xC4, 0x19, 0xC0, 0x31, 0xC3, 0x19, 0x31, 0xC3, 0x19, 0xC2, 0x31, 0xC3, 0x19, 0xC2, 0x31, 0xC5,
+    0x19, 0xC3, 0x31, 0xC5, 0x19, 0xC7, 0x31, 0xC2, 0x19, 0x31, 0xC2, 0x19, 0xC0, 0x31, 0xC1, 0x19,
+    0xC0, 0x31, 0xC2, 0x19, 0xC0, 0x31, 0xC4, 0x19, 0xC5, 0x31, 0xC3, 0x19, 0xC4, 0x31, 0xC3, 0x19,
+    0x31, 0x19, 0xC0, 0x31, 0xC2, 0x19, 0x31, 0xC2, 0x19, 0xC0, 0x31, 0xC6, 0x19, 0xC0, 0x31, 0xC5,
+    0x19, 0xC2, 0x36, 0xFA, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC2,
+    0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0,
+    0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0,
+    0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0,
+    0x19, 0xC7, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0,
+    0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC6, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0,
+    0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0,
+    0x19, 0xC2, 0x31, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC1, 0x36, 0xFA, 0x19,
+    0xC0, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0x19, 0xC0, 0x31, 0x19, 0xC3, 0x31,
+    0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC1, 0x31,
+    0xC0, 0x19, 0xC0, 0x31, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0,
+    0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0,
+    0x19, 0xC6, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC1, 0x19, 0xC0, 0x31, 0xC0,
+    0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC5, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC0, 0x31, 0xC0,
+    0x19, 0xC4, 0x31, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19,
+    0xC2, 0x31, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC1, 0x36, 0xFA, 0x19, 0xC0,
+    0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC2,
+    0x31, 0xC1, 0x19, 0xC4, 0x31, 0xC1, 0x19, 0xC5, 0x31, 0xC0, 0x19, 0x31, 0xC1, 0x19, 0x31, 0xC0,
+    0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0,
+    0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC6, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0,
+    0x19, 0xC2, 0x31, 0xC2, 0x19, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC5, 0x31, 0xC0, 0x19,
+    0xC3, 0x31, 0xC0, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC8, 0x31, 0xC0, 0x19, 0x31, 0xC0, 0x19, 0xC4,
+    0x31, 0xC0, 0x19, 0xC0, 0x31, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC1, 0x36,
+    0xFA, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC0, 0x31,
+    0xC0, 0x19, 0xC3, 0x31, 0xC3, 0x19, 0xC2, 0x31, 0xC3, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0x31, 0xC1,
+    0x19, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC3, 0x19,
+    0xC5, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC6, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19,
+    0xC2, 0x31, 0xC0, 0x19, 0x31, 0x19, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC5, 0x31, 0xC0,
+    0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC8, 0x31, 0xC2, 0x19, 0xC5, 0x31, 0xC3,
+    0x19, 0xC3, 0x31, 0xC3, 0x19, 0xC3, 0x36, 0xFA, 0x19, 0xC0, 0x31, 0xC4, 0x19, 0xC3, 0x31, 0xC4,
+    0x19, 0xC6, 0x31, 0xC1, 0x19, 0xC4, 0x31, 0xC1, 0x19, 0xC2, 0x31, 0x19, 0x31, 0x19, 0x31, 0x19,
+    0x31, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC0, 0x31,
+    0xC0, 0x19, 0xC4, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC6, 0x31, 0xC0, 0x19, 0xC1, 0x31,
+    0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0x31, 0xC2, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0x19,
+    0xC0, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC8, 0x31, 0xC3, 0x19,
+    0xC4, 0x31, 0xC0, 0x19, 0xC0, 0x31, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC2,
+    0x36, 0xFA, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC6, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC1,
+    0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC2,
+    0x31, 0xC1, 0x19, 0x31, 0xC1, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC1, 0x31,
+    0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC6, 0x31,
+    0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC0, 0x31, 0xC1, 0x19, 0xC3, 0x31,
+    0xC0, 0x19, 0xC2, 0x31, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC0, 0x31, 0xC0,
+    0x19, 0xC4, 0x31, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19,
+    0xC2, 0x31, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC1, 0x36, 0xFA, 0x19, 0xC0,
+    0x31, 0xC0, 0x19, 0xC6, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC1,
+    0x31, 0xC0, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC1, 0x19, 0x31,
+    0xC1, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC1, 0x31,
+    0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC7, 0x31, 0xC0, 0x19, 0xC1, 0x31,
+    0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC2, 0x31,
+    0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0x19,
+    0xC2, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0x19, 0xC1,
+    0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC1, 0x36, 0xFA, 0x19, 0x31, 0xC4, 0x19, 0xC2, 0x31,
+    0xC2, 0x19, 0xC0, 0x31, 0xC2, 0x19, 0xC0, 0x31, 0xC4, 0x19, 0xC1, 0x31, 0xC4, 0x19, 0xC3, 0x31,
+    0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC4, 0x31, 0xC3, 0x19, 0xC2, 0x31, 0xC3, 0x19, 0xC0, 0x31,
+    0xC1, 0x19, 0xC0, 0x31, 0xC5, 0x19, 0xC9, 0x31, 0xC3, 0x19, 0xC2, 0x31, 0xC2, 0x19, 0xC0, 0x31,
+    0xC0, 0x19, 0xC1, 0x31, 0xC7, 0x19, 0xC2, 0x31, 0xC3, 0x19, 0xC4, 0x31, 0xC3, 0x19, 0xC2, 0x31,
+    0xC2, 0x19, 0xC0, 0x31, 0xC1, 0x19, 0xC0, 0x31, 0xC6, 0x19, 0xC0, 0x31, 0xC3, 0x19, 0xC0, 0x31,
+    0xC1, 0x19, 0x36, 0xFA, 0x19, 0xFD, 0xFD, 0xF6, 0x36, 0xFA, 0x19, 0xFD, 0xFD, 0xF6, 0x36, 0xFA,
+    0x19, 0xFD, 0xFD, 0xF6, 0x36, 0xFA, 0x19, 0xFD, 0xFD, 0xF6, 0x36, 0xFA, 0x19, 0xFD, 0xFD, 0xF6,
+    0x36, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xC8, 0xA0, 0x33, 0xFE, 0x0E, 0x70, 0xA0, 0x22, 0x00, 0xFD,
+    0xE7, 0x10, 0x0C, 0x04, 0x36, 0xFD, 0xFD, 0xC3, 0xA0, 0x55, 0x10, 0x00, 0xFD, 0xED, 0x10, 0x18,
+    0x36, 0xFD, 0xFD, 0xC0, 0xFE, 0x14, 0xA0, 0xFE, 0x02, 0x10, 0x00, 0xFD, 0xEF, 0x14, 0x08, 0x36,
+    0xFD, 0xFC, 0x08, 0x00, 0xFD, 0xF3, 0x08, 0x36, 0xFD, 0xFA, 0x18, 0x14, 0x00, 0xFD, 0xF3, 0x14,
+    0x18, 0x36, 0xFD, 0xF9, 0x10, 0x00, 0xFD, 0xF5, 0x10, 0x36, 0xFD, 0xF8, 0x04, 0x00, 0xFD, 0xF7,
+    0x36, 0xFD, 0xF8, 0x0C, 0x00, 0xFD, 0xF7, 0x36, 0xFD, 0xF8, 0x10, 0x00, 0xFD, 0xF7, 0x36, 0xFD,
+    0xF8, 0x00, 0xFD, 0xF8, 0x36, 0xFD, 0xF8, 0x00, 0xFD, 0xF8, 0x36, 0xFD, 0xF8, 0x00, 0xFD, 0xF8,
+    0x36, 0xFD, 0xF8, 0x00, 0xFD, 0xF8, 0x36, 0xFD, 0xF8, 0x00, 0xFD, 0xF8, 0x36, 0xFD, 0xF8, 0x00,
+    0xFD, 0xF8, 0x36, 0xFD, 0xF8, 0x00, 0xFD, 0xF8, 0x36, 0xFD, 0xF8, 0x00, 0xFD, 0xF8, 0x36, 0xFD,
+    0xF8, 0x00, 0xD8, 0x19, 0xFD, 0xC3, 0x00, 0xD9, 0x36, 0xFD, 0xF8, 0x00, 0xD8, 0x19, 0xFD, 0xC3,
+    0x00, 0xD9, 0x36, 0xFD, 0xF8, 0x00, 0xD8, 0x19, 0x31, 0xC5, 0x19, 0xC3, 0x31, 0xC6, 0x19, 0xC2,
+    0x31, 0xC3, 0x19, 0x31, 0x19, 0xC2, 0x31, 0xC3, 0x19, 0xC2, 0x31, 0xC5, 0x19, 0xC3, 0x31, 0xC5,
+    0x19, 0xC1, 0x00, 0xD9, 0x36, 0xFD, 0xF8, 0x00, 0xD8, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC1, 0x31,
+    0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0,
+    0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0,
+    0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC0, 0x00, 0xD9, 0x36, 0xFD, 0xF8, 0x00,
+    0xD8, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC2, 0x31,
+    0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC4, 0x31, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19,
+    0xC1, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19,
+    0x00, 0xD9, 0x36, 0xFD, 0xF8, 0x00, 0xD8, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19,
+    0xC3, 0x31, 0xC0, 0x19, 0xC0, 0x31, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC7, 0x31, 0xC0, 0x19, 0xC3,
+    0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC2,
+    0x31, 0xC0, 0x19, 0x00, 0xD9, 0x36, 0xFD, 0xF8, 0x00, 0xD8, 0x19, 0xC0, 0x31, 0xC3, 0x19, 0xC5,
+    0x31, 0xC3, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC7, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC1,
+    0x31, 0xC3, 0x19, 0xC5, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0x00, 0xD9, 0x36, 0xFD, 0xF8,
+    0x00, 0xD8, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC4, 0x31, 0xC0, 0x19, 0xC0,
+    0x31, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC7, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC1, 0x31,
+    0xC0, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC4, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0x00, 0xD9,
+    0x36, 0xFD, 0xF8, 0x00, 0xD8, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC3, 0x31,
+    0xC0, 0x19, 0xC2, 0x31, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC4, 0x31, 0x19, 0xC0, 0x31, 0xC0, 0x19,
+    0xC3, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19,
+    0xC2, 0x31, 0xC0, 0x19, 0x00, 0xD9, 0x36, 0xFD, 0xF8, 0x00, 0xD8, 0x19, 0xC0, 0x31, 0xC0, 0x19,
+    0xC1, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC2,
+    0x31, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC1, 0x31,
+    0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC0, 0x00, 0xD9, 0x36, 0xFD, 0xF8,
+    0x00, 0xD8, 0x19, 0x31, 0xC3, 0x19, 0xC0, 0x31, 0xC1, 0x19, 0xC0, 0x31, 0xC6, 0x19, 0xC2, 0x31,
+    0xC3, 0x19, 0xC4, 0x31, 0xC3, 0x19, 0xC2, 0x31, 0xC3, 0x19, 0xC0, 0x31, 0xC1, 0x19, 0xC0, 0x31,
+    0xC5, 0x19, 0xC1, 0x00, 0xD9, 0x36, 0xFD, 0xF8, 0x00, 0xD8, 0x19, 0xFD, 0xC3, 0x00, 0xD9, 0x36,
+    0xFD, 0xF8, 0x00, 0xD8, 0x19, 0xFD, 0xC3, 0x00, 0xD9, 0x36, 0xFD, 0xF8, 0x00, 0xD8, 0x19, 0xFD,
+    0xC3, 0x00, 0xD9, 0x36, 0xFD, 0xF8, 0x00, 0xD8, 0x19, 0xFD, 0xC3, 0x00, 0xD9, 0x36, 0xFD, 0xF8,
+    0x00, 0xD8, 0x19, 0xFD, 0xC3, 0x00, 0xD9, 0x36, 0xFD, 0xF8, 0x00, 0xFD, 0xF8, 0x36, 0xFD, 0xF8,
+    0x00, 0xFD, 0xF8, 0x36, 0xFD, 0xF8, 0x00, 0xFD, 0xF8, 0x36, 0xFD, 0xF8, 0x00, 0xFD, 0xF8, 0x36,
+    0xFD, 0xF8, 0x00, 0xFD, 0xF8, 0x36, 0xFD, 0xF8, 0x00, 0xFD, 0xF8, 0x36, 0xFD, 0xF8, 0x00, 0xFD,
+    0xF8, 0x36, 0xFD, 0xF8, 0x00, 0xFD, 0xF8, 0x36, 0xFD, 0xF8, 0x00, 0xFD, 0xF8, 0x36, 0xFD, 0xF8,
+    0x10, 0x00, 0xFD, 0xF7, 0x36, 0xFD, 0xF8, 0x0C, 0x00, 0xFD, 0xF7, 0x36, 0xFD, 0xF8, 0x04, 0x00,
+    0xFD, 0xF7, 0x36, 0xFD, 0xF9, 0x10, 0x00, 0xFD, 0xF5, 0x10, 0x36, 0xFD, 0xF9, 0x18, 0x14, 0x00,
+    0xFD, 0xF3, 0x14, 0x18, 0x36, 0xFD, 0xFA, 0x08, 0x00, 0xFD, 0xF3, 0x08, 0x36, 0xFD, 0xFC, 0x08,
+    0x14, 0x00, 0xFD, 0xEF, 0x14, 0x08, 0x36, 0xFD, 0xFD, 0xC0, 0x18, 0x10, 0x00, 0xFD, 0xED, 0x10,
+    0x18, 0x36, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xE5, 0xFE, 0x7F, 0xF9, 0xFE, 0x7F, 0xFC, 0xFE, 0xFF, 0xFD, 0x31,
+    0xFD, 0xE7, 0x21, 0x25, 0x2D, 0x36, 0xFD, 0xFD, 0xC3, 0xA7, 0x11, 0x21, 0x31, 0xFD, 0xED, 0x21,
+    0x19, 0x36, 0xFD, 0xFD, 0xC0, 0xFE, 0xFF, 0xFA, 0xFE, 0x7F, 0xFF, 0x31, 0xFD, 0xEF, 0x1D, 0x29,
+    0x36, 0xFD, 0xFC, 0x29, 0x31, 0xFD, 0xF3, 0x29, 0x36, 0xFD, 0xFA, 0x19, 0x1D, 0x31, 0xFD, 0xF3,
+    0x1D, 0x19, 0x36, 0xFD, 0xF9, 0x21, 0x31, 0xFD, 0xF5, 0x21, 0x36, 0xFD, 0xF8, 0x2D, 0x31, 0xFD,
+    0xF7, 0x36, 0xFD, 0xF8, 0x25, 0x31, 0xFD, 0xF7, 0x36, 0xFD, 0xF8, 0x21, 0x31, 0xFD, 0xF7, 0x36,
+    0xFD, 0xF8, 0x31, 0xFD, 0xF8, 0x36, 0xFD, 0xF8, 0x31, 0xFD, 0xF8, 0x36, 0xFD, 0xF8, 0x31, 0xFD,
+    0xF8, 0x36, 0xFD, 0xF8, 0x31, 0xFD, 0xF8, 0x36, 0xFD, 0xF8, 0x31, 0xFD, 0xF8, 0x36, 0xFD, 0xF8,
+    0x31, 0xFD, 0xF8, 0x36, 0xFD, 0xF8, 0x31, 0xFD, 0xF8, 0x36, 0xFD, 0xF8, 0x31, 0xFD, 0xF8, 0x36,
+    0xFD, 0xF8, 0x31, 0xD9, 0x7E, 0xFD, 0xC2, 0x31, 0xD9, 0x36, 0xFD, 0xF8, 0x31, 0xD9, 0x19, 0xFD,
+    0xC2, 0x31, 0xD9, 0x36, 0xFD, 0xF8, 0x31, 0xD9, 0x19, 0x31, 0xC2, 0x19, 0x31, 0xC2, 0x19, 0xC0,
+    0x31, 0xC1, 0x19, 0xC0, 0x31, 0xC2, 0x19, 0xC0, 0x31, 0xC4, 0x19, 0xC5, 0x31, 0xC3, 0x19, 0xC4,
+    0x31, 0xC3, 0x19, 0x31, 0x19, 0xC0, 0x31, 0xC2, 0x19, 0x31, 0xC2, 0x19, 0x31, 0xD9, 0x36, 0xFD,
+    0xF8, 0x31, 0xD9, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19,
+    0xC1, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC6, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19,
+    0xC2, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19,
+    0xC0, 0x31, 0xD9, 0x36, 0xFD, 0xF8, 0x31, 0xD9, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0,
+    0x19, 0xC2, 0x31, 0xC1, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC5, 0x31, 0xC0,
+    0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC4, 0x31, 0x19, 0xC1, 0x31, 0xC0, 0x19,
+    0xC0, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xD9, 0x36, 0xFD, 0xF8, 0x31, 0xD9, 0x19, 0xC0, 0x31, 0xC0,
+    0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC2, 0x19, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19,
+    0xC5, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC8, 0x31, 0xC0, 0x19,
+    0x31, 0xC0, 0x19, 0xC2, 0x31, 0xD9, 0x36, 0xFD, 0xF8, 0x31, 0xD9, 0x19, 0xC0, 0x31, 0xC0, 0x19,
+    0xC1, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0x31, 0x19, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0,
+    0x19, 0xC5, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC8, 0x31, 0xC2,
+    0x19, 0xC3, 0x31, 0xD9, 0x36, 0xFD, 0xF8, 0x31, 0xD9, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC1, 0x31,
+    0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0x31, 0xC2, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0x19,
+    0xC0, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC8, 0x31, 0xC3, 0x19,
+    0xC2, 0x31, 0xD9, 0x36, 0xFD, 0xF8, 0x31, 0xD9, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0,
+    0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC0, 0x31, 0xC1, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0x19,
+    0xC0, 0x31, 0xC0, 0x19, 0xC3, 0x31, 0xC0, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC4, 0x31, 0x19, 0xC1,
+    0x31, 0xC0, 0x19, 0xC0, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xD9, 0x36, 0xFD, 0xF8, 0x31, 0xD9, 0x19,
+    0xC0, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19,
+    0xC3, 0x31, 0xC0, 0x19, 0xC2, 0x31, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC2,
+    0x31, 0xC0, 0x19, 0xC2, 0x31, 0x19, 0xC2, 0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC0, 0x19, 0xC0, 0x31,
+    0xD9, 0x36, 0xFD, 0xF8, 0x31, 0xD9, 0x19, 0xC1, 0x31, 0xC3, 0x19, 0xC2, 0x31, 0xC2, 0x19, 0xC0,
+    0x31, 0xC0, 0x19, 0xC1, 0x31, 0xC7, 0x19, 0xC2, 0x31, 0xC3, 0x19, 0xC4, 0x31, 0xC3, 0x19, 0xC2,
+    0x31, 0xC2, 0x19, 0xC0, 0x31, 0xC1, 0x19, 0x31, 0xD9, 0x36, 0xFD, 0xF8, 0x31, 0xD9, 0x19, 0xFD,
+    0xC2, 0x31, 0xD9, 0x36, 0xFD, 0xF8, 0x31, 0xD9, 0x19, 0xFD, 0xC2, 0x31, 0xD9, 0x36, 0xFD, 0xF8,
+    0x31, 0xD9, 0x19, 0xFD, 0xC2, 0x31, 0xD9, 0x36, 0xFD, 0xF8, 0x31, 0xD9, 0x19, 0xFD, 0xC2, 0x31,
+    0xD9, 0x36, 0xFD, 0xF8, 0x31, 0xD9, 0x19, 0xFD, 0xC2, 0x31, 0xD9, 0x36, 0xFD, 0xF8, 0x31, 0xFD,
+    0xF8, 0x36, 0xFD, 0xF8, 0x31, 0xFD, 0xF8, 0x36, 0xFD, 0xF8, 0x31, 0xFD, 0xF8, 0x36, 0xFD, 0xF8,
+    0x31, 0xFD, 0xF8, 0x36, 0xFD, 0xF8, 0x31, 0xFD, 0xF8, 0x36, 0xFD, 0xF8, 0x31, 0xFD, 0xF8, 0x36,
+    0xFD, 0xF8, 0x31, 0xFD, 0xF8, 0x36, 0xFD, 0xF8, 0x31, 0xFD, 0xF8, 0x36, 0xFD, 0xF8, 0x31, 0xFD,
+    0xF8, 0x36, 0xFD, 0xF8, 0x21, 0x31, 0xFD, 0xF7, 0x36, 0xFD, 0xF8, 0x25, 0x31, 0xFD, 0xF7, 0x36,
+    0xFD, 0xF8, 0x2D, 0x31, 0xFD, 0xF7, 0x36, 0xFD, 0xF9, 0x21, 0x31, 0xFD, 0xF5, 0x21, 0x36, 0xFD,
+    0xF9, 0xA7, 0x11, 0x1D, 0x31, 0xFD, 0xF3, 0x1D, 0x19, 0x36, 0xFD, 0xFA, 0x29, 0x31, 0xFD, 0xF3,
+    0x29, 0x36, 0xFD, 0xFC, 0x29, 0x1D, 0x31, 0xFD, 0xEF, 0x1D, 0x29, 0x36, 0xFD, 0xFD, 0xC0, 0x19,
+    0x21, 0x31, 0xFD, 0xED, 0x21, 0x19, 0x36, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD, 0xFD,
+    0xFD, 0xFD, 0xFD, 0xFD, 0xD7,
+};
+
+const PackedImage BootScreen = {
+    240, // width
+    320, // height
+    3365, // bytes
+    BootScreen_Data,
+};
@@ -0,0 +1,55 @@
+#ifndef CCM_MAP_H
+#define CCM_MAP_H
+
+#include "mbed.h"
+
+// Layout of the 64 KB core coupled memory at CCMDATARAM_BASE
+//
+//   0x0000  app thread stack: app_queue, the state machine, sampling and
+//           matching (main.cpp, 4 KB)
+//   0x1000  plot sample ring (trace_plot.cpp, 1 KB)
+//   0x1400  match scratch: DTW rows, correlation sums, decoded key block
+//           (main.cpp, 4 KB)
+//   0x2400  free
+//
+// The CPU reaches CCM over its data bus alone, with no wait state and
+// without meeting the DMA2D, the LTDC or the FMC on the bus matrix, so the
+// kernels keep their speed while the display is being refreshed. The other
+// side of it: no DMA stream, the DMA2D or the LTDC can reach it, and no code
+// runs from it. Only put here what the CPU alone reads and writes; a DMA
+// source or destination in CCM fails the transfer.
+//
+// mbed's linker script leaves CCM out of the memory map, so nothing else is
+// placed there and the regions are laid out by hand here instead of in a
+// linker section. They are not zeroed at reset.
+
+// Set to 0 to keep the buffers in ordinary SRAM, e.g. to measure the
+// difference
+#ifndef CCM_PLACEMENT
+#define CCM_PLACEMENT 1
+#endif
+
+#define CCM_SIZE 0x10000 // 64 KB
+
+#define CCM_APP_STACK_ADDR CCMDATARAM_BASE
+#define CCM_APP_STACK_SIZE 0x1000 // 4 KB
+
+#define CCM_PLOT_RING_ADDR (CCM_APP_STACK_ADDR + CCM_APP_STACK_SIZE)
+#define CCM_PLOT_RING_SIZE 0x400 // 1 KB
+
+#define CCM_MATCH_ADDR (CCM_PLOT_RING_ADDR + CCM_PLOT_RING_SIZE)
+#define CCM_MATCH_SIZE 0x1000 // 4 KB
+
+#define CCM_FREE_ADDR (CCM_MATCH_ADDR + CCM_MATCH_SIZE)
+
+// Define name as a type laid over a region, or an ordinary static without
+// CCM_PLACEMENT
+#if CCM_PLACEMENT
+#define CCM_OVERLAY(type, name, addr, size)                                    \
+    static_assert(sizeof(type) <= (size), #name " does not fit its CCM region"); \
+    static type &name = *(type *)(addr)
+#else
+#define CCM_OVERLAY(type, name, addr, size) static type name
+#endif
+
+#endif
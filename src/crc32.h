@@ -0,0 +1,10 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stdint.h>
+
+// CRC-32 (IEEE, as zlib) of a buffer. Start with crc = 0 and pass the
+// previous result to continue over several buffers.
+uint32_t crc32(uint32_t crc, const void *data, uint32_t length);
+
+#endif
@@ -0,0 +1,241 @@
+#include "mbed.h"
+#include "dma_copy.h"
+#include "ccm_map.h"
+#include "drivers/stm32f429i_discovery_sdram.h"
+
+#define DMA_COPY_DONE_FLAG 1
+
+// Another waiter may take the flag first; then this is the longest a waiter
+// oversleeps
+#define DMA_COPY_POLL 1ms
+
+typedef struct
+{
+    uint8_t *dst;
+    const uint8_t *src;
+    uint32_t size;        // bytes left
+    DmaCopyDone done;
+    void *context;
+} DmaCopyJob;
+
+// The copy of ticket t is jobs[(t - 1) % DMA_COPY_QUEUE]. Threads add at
+// queued, under producer_mutex; the interrupt takes from finished.
+static DmaCopyJob jobs[DMA_COPY_QUEUE];
+static volatile uint32_t queued = 0;   // last ticket handed out
+static volatile uint32_t finished = 0; // last ticket done
+static volatile bool running = false;  // a transfer is under way
+static uint32_t chunk;                 // bytes of the transfer under way
+static uint32_t busy_since;
+
+static Mutex producer_mutex;
+static EventFlags done_flags;
+
+static DmaCopyStats stats;
+
+static bool in_sdram(const void *address){
+    return (uintptr_t)address >= SDRAM_DEVICE_ADDR && (uintptr_t)address < SDRAM_DEVICE_ADDR + SDRAM_DEVICE_SIZE;
+}
+
+static bool in_ccm(const void *address, uint32_t size){
+    return (uintptr_t)address < CCMDATARAM_BASE + CCM_SIZE && (uintptr_t)address + size > CCMDATARAM_BASE;
+}
+
+/*******************************************************************************
+ * @brief end the copy at the head of the queue and run its callback;
+ *        interrupt or critical section
+ * @param ok: false if a transfer failed
+ * ****************************************************************************/
+static void finish(bool ok){
+    DmaCopyJob *job = &jobs[finished % DMA_COPY_QUEUE];
+    DmaCopyDone done = job->done;
+    void *context = job->context;
+    if (!ok){
+        stats.failed++;
+    }
+    finished = finished + 1;
+    done_flags.set(DMA_COPY_DONE_FLAG);
+    if (done){
+        done(context, ok);
+    }
+}
+
+/*******************************************************************************
+ * @brief start the next transfer of the copy at the head of the queue, if
+ *        any; interrupt or critical section
+ * ****************************************************************************/
+static void start_next(){
+    while (finished != queued){
+        DmaCopyJob *job = &jobs[finished % DMA_COPY_QUEUE];
+        uint32_t words = min(job->size / 4, (uint32_t)DMA_COPY_CHUNK);
+        if (!running){
+            running = true;
+            busy_since = us_ticker_read();
+        }
+        chunk = words * 4;
+        stats.transfers++;
+        uint8_t result = in_sdram(job->src)
+                             ? BSP_SDRAM_ReadData_DMA((uintptr_t)job->src, (uint32_t *)job->dst, words)
+                             : BSP_SDRAM_WriteData_DMA((uintptr_t)job->dst, (uint32_t *)job->src, words);
+        if (result == SDRAM_OK){
+            return;
+        }
+        finish(false);
+    }
+    if (running){
+        running = false;
+        stats.busy_us += us_ticker_read() - busy_since;
+    }
+}
+
+/*******************************************************************************
+ * @brief a transfer is done: on to the next chunk or copy. Overrides the
+ *        HAL's weak callback, from the DMA interrupt
+ * ****************************************************************************/
+extern "C" void HAL_SDRAM_DMA_XferCpltCallback(DMA_HandleTypeDef *hdma){
+    DmaCopyJob *job = &jobs[finished % DMA_COPY_QUEUE];
+    job->dst += chunk;
+    job->src += chunk;
+    job->size -= chunk;
+    stats.dma_bytes += chunk;
+    if (job->size == 0){
+        finish(true);
+    }
+    start_next();
+}
+
+/*******************************************************************************
+ * @brief a transfer failed: drop the rest of its copy
+ * ****************************************************************************/
+extern "C" void HAL_SDRAM_DMA_XferErrorCallback(DMA_HandleTypeDef *hdma){
+    finish(false);
+    start_next();
+}
+
+/*******************************************************************************
+ * @brief hook the stream's interrupt; BSP_SDRAM_Init() has set up the stream
+ *        and enabled the interrupt, but left the vector to the application
+ * ****************************************************************************/
+void dma_copy_init(){
+    NVIC_SetVector(SDRAM_DMAx_IRQn, (uint32_t)BSP_SDRAM_DMA_IRQHandler);
+}
+
+/*******************************************************************************
+ * @brief queue a copy, or make it at once if the DMA is not worth it
+ * @param dst: destination
+ * @param src: source
+ * @param size: bytes
+ * @param done: called when it is made, from the interrupt; may be NULL
+ * @param context: for done
+ * @return the ticket to wait on
+ * ****************************************************************************/
+uint32_t dma_copy(void *dst, const void *src, uint32_t size, DmaCopyDone done, void *context){
+    producer_mutex.lock();
+    stats.copies++;
+    if (size < DMA_COPY_MIN || (((uintptr_t)dst | (uintptr_t)src | size) & 3) || in_ccm(dst, size) ||
+        in_ccm(src, size)){
+        stats.cpu_copies++;
+        uint32_t ticket = queued;
+        producer_mutex.unlock();
+        memcpy(dst, src, size);
+        if (done){
+            done(context, true);
+        }
+        return ticket;
+    }
+
+    while (queued - finished >= DMA_COPY_QUEUE){
+        stats.full++;
+        done_flags.wait_any_for(DMA_COPY_DONE_FLAG, DMA_COPY_POLL);
+    }
+    jobs[queued % DMA_COPY_QUEUE] = {(uint8_t *)dst, (const uint8_t *)src, size, done, context};
+
+    core_util_critical_section_enter();
+    uint32_t ticket = queued = queued + 1;
+    stats.queue_peak = max(stats.queue_peak, queued - finished);
+    if (!running){
+        start_next();
+    }
+    core_util_critical_section_exit();
+    producer_mutex.unlock();
+    return ticket;
+}
+
+bool dma_copy_done(uint32_t ticket){
+    return (int32_t)(finished - ticket) >= 0;
+}
+
+/*******************************************************************************
+ * @brief sleep until a copy is made
+ * @param ticket: from dma_copy()
+ * ****************************************************************************/
+void dma_copy_wait(uint32_t ticket){
+    while (!dma_copy_done(ticket)){
+        done_flags.wait_any_for(DMA_COPY_DONE_FLAG, DMA_COPY_POLL);
+    }
+}
+
+/*******************************************************************************
+ * @brief time memcpy() against the DMA both ways between SRAM and SDRAM,
+ *        and how long a DMA copy keeps the CPU
+ * @param sdram: DMA_COPY_BENCH_SIZE free bytes in SDRAM, word aligned
+ * ****************************************************************************/
+void dma_copy_benchmark(void *sdram){
+#if DMA_COPY_BENCHMARK
+    static uint32_t sram[DMA_COPY_BENCH_SIZE / 4];
+    const int runs = 20;
+    const struct
+    {
+        const char *name;
+        void *dst;
+        const void *src;
+    } moves[] = {{"SDRAM to SRAM", sram, sdram}, {"SRAM to SDRAM", sdram, sram}};
+
+    for (const auto &move : moves){
+        uint32_t start = us_ticker_read();
+        for (int i = 0; i < runs; i++){
+            memcpy(move.dst, move.src, DMA_COPY_BENCH_SIZE);
+        }
+        uint32_t cpu_us = max(us_ticker_read() - start, (uint32_t)1);
+
+        // Queued one at a time, as the app does
+        uint32_t queue_us = 0;
+        start = us_ticker_read();
+        for (int i = 0; i < runs; i++){
+            uint32_t queue_start = us_ticker_read();
+            uint32_t ticket = dma_copy(move.dst, move.src, DMA_COPY_BENCH_SIZE);
+            queue_us += us_ticker_read() - queue_start;
+            dma_copy_wait(ticket);
+        }
+        uint32_t dma_us = max(us_ticker_read() - start, (uint32_t)1);
+
+        uint64_t bytes = (uint64_t)DMA_COPY_BENCH_SIZE * runs;
+        printf("DMA copy: %s, %u bytes: memcpy %lu KB/s, DMA %lu KB/s, the CPU busy %lu of %lu us per DMA copy\n",
+               move.name, DMA_COPY_BENCH_SIZE, (unsigned long)(bytes * 1000000 / cpu_us / 1024),
+               (unsigned long)(bytes * 1000000 / dma_us / 1024), (unsigned long)(queue_us / runs),
+               (unsigned long)(dma_us / runs));
+    }
+#endif
+}
+
+/*******************************************************************************
+ * @brief get the counters
+ * @return a copy of the counters
+ * ****************************************************************************/
+DmaCopyStats dma_copy_stats(){
+    core_util_critical_section_enter();
+    DmaCopyStats copy = stats;
+    core_util_critical_section_exit();
+    return copy;
+}
+
+/*******************************************************************************
+ * @brief print the counters
+ * ****************************************************************************/
+void dma_copy_print_stats(){
+    DmaCopyStats s = dma_copy_stats();
+    printf("DMA copy: %lu copies, %lu by the CPU, %lu transfers, %lu failed, %lu waited for the queue, "
+           "queue peak %lu, %lu KB by DMA at %lu KB/s while busy\n",
+           (unsigned long)s.copies, (unsigned long)s.cpu_copies, (unsigned long)s.transfers, (unsigned long)s.failed,
+           (unsigned long)s.full, (unsigned long)s.queue_peak, (unsigned long)(s.dma_bytes / 1024),
+           (unsigned long)(s.busy_us ? s.dma_bytes * 1000000 / s.busy_us / 1024 : 0));
+}
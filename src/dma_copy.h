@@ -0,0 +1,77 @@
+#ifndef DMA_COPY_H
+#define DMA_COPY_H
+
+#include "mbed.h"
+
+// Copies made by DMA2 stream 0, the memory-to-memory stream the BSP sets up
+// for the SDRAM, while the CPU gets on with something else.
+//
+// dma_copy() queues a copy and returns at once with a ticket; copies run one
+// after the other in the order queued. Each can have a callback, run from
+// the DMA interrupt when it is done: keep it short and do not block in it.
+// dma_copy_wait() sleeps until a ticket is done. Transfers go through
+// BSP_SDRAM_ReadData_DMA() when the source is in SDRAM and
+// BSP_SDRAM_WriteData_DMA() otherwise, a DMA_COPY_CHUNK at most each.
+//
+// Copies shorter than DMA_COPY_MIN, or not word aligned, are made by the
+// CPU at once, the DMA setup costing more; so are copies with an end in CCM,
+// which DMA2 cannot reach (ccm_map.h). Nothing may touch the destination, or
+// write the source, until the copy is done.
+
+// Shorter copies are made by the CPU
+#define DMA_COPY_MIN 256
+
+// Copies queued at a time
+#define DMA_COPY_QUEUE 8
+
+// Words per transfer, the stream's NDTR is 16 bits
+#define DMA_COPY_CHUNK 0xFFFF
+
+// Print a CPU memcpy vs DMA comparison from dma_copy_benchmark()
+#ifndef DMA_COPY_BENCHMARK
+#define DMA_COPY_BENCHMARK 0
+#endif
+#define DMA_COPY_BENCH_SIZE 16384 // bytes per copy
+
+// Callback of a finished copy; ok is false if the transfer failed
+typedef void (*DmaCopyDone)(void *context, bool ok);
+
+typedef struct
+{
+    uint32_t copies;      // queued, CPU copies included
+    uint32_t cpu_copies;  // too short or unaligned for the DMA
+    uint32_t transfers;   // DMA transfers, a copy takes one per chunk
+    uint32_t failed;      // copies a transfer error cut short
+    uint32_t full;        // copies that waited for room in the queue
+    uint32_t queue_peak;  // most copies waiting or running
+    uint64_t dma_bytes;
+    uint64_t busy_us;     // time the stream was busy
+} DmaCopyStats;
+
+// Hook the stream's interrupt; after BSP_SDRAM_Init()
+void dma_copy_init();
+
+// Queue a copy of size bytes; done, if not NULL, is called with context
+// once it is made. Returns a ticket to wait on. Waits only if
+// DMA_COPY_QUEUE copies are queued already. Copies the CPU makes are done on
+// return, their ticket is that of the copy queued last. Not from an
+// interrupt.
+uint32_t dma_copy(void *dst, const void *src, uint32_t size, DmaCopyDone done = NULL, void *context = NULL);
+
+// True once the copy of a ticket, and every one queued before it, is done
+bool dma_copy_done(uint32_t ticket);
+
+// Sleep until the copy of a ticket is done; not from an interrupt
+void dma_copy_wait(uint32_t ticket);
+
+// Time DMA_COPY_BENCH_SIZE byte copies between SRAM and a word aligned
+// buffer in SDRAM with the CPU and the DMA, and print them
+void dma_copy_benchmark(void *sdram);
+
+// Get the counters
+DmaCopyStats dma_copy_stats();
+
+// Print the counters
+void dma_copy_print_stats();
+
+#endif
@@ -23,20 +23,18 @@
 #define CONVERTED_FRAME_BUFFER                   (LCD_FRAME_BUFFER+0x260000)
 
 // Constructor
-LCD_DISCO_F429ZI::LCD_DISCO_F429ZI()
+LCD_DISCO_F429ZI::LCD_DISCO_F429ZI() : LCD_DISCO_F429ZI(true)
 {
-  BSP_LCD_Init();  
-  BSP_LCD_LayerDefaultInit(1, LCD_FRAME_BUFFER_LAYER1);
-  BSP_LCD_SelectLayer(1);
-  BSP_LCD_Clear(LCD_COLOR_WHITE);
-  BSP_LCD_SetFont(&Font16);
-  BSP_LCD_SetColorKeying(1, LCD_COLOR_WHITE);
-  BSP_LCD_SetLayerVisible(1, DISABLE);
-  BSP_LCD_LayerDefaultInit(0, LCD_FRAME_BUFFER_LAYER0);
-  BSP_LCD_SelectLayer(0);
-  BSP_LCD_SetFont(&Font16);
-  BSP_LCD_DisplayOn();
-  BSP_LCD_Clear(LCD_COLOR_WHITE);  
+}
+
+LCD_DISCO_F429ZI::LCD_DISCO_F429ZI(bool init)
+{
+  if(init)
+  {
+    BSP_LCD_Init();
+    InitLayers();
+    BSP_LCD_DisplayOn();
+  }
 }
 
 // Destructor
@@ -54,6 +52,24 @@ uint8_t LCD_DISCO_F429ZI::Init(void)
   return BSP_LCD_Init();
 }
 
+void LCD_DISCO_F429ZI::InitLayers(void)
+{
+  BSP_LCD_LayerDefaultInit(1, LCD_FRAME_BUFFER_LAYER1);
+  BSP_LCD_SelectLayer(1);
+  BSP_LCD_Clear(LCD_COLOR_WHITE);
+#if LCD_BSP_FONTS
+  BSP_LCD_SetFont(&Font16);
+#endif
+  BSP_LCD_SetColorKeying(1, LCD_COLOR_WHITE);
+  BSP_LCD_SetLayerVisible(1, DISABLE);
+  BSP_LCD_LayerDefaultInit(0, LCD_FRAME_BUFFER_LAYER0);
+  BSP_LCD_SelectLayer(0);
+#if LCD_BSP_FONTS
+  BSP_LCD_SetFont(&Font16);
+#endif
+  BSP_LCD_Clear(LCD_COLOR_WHITE);  
+}
+
 uint32_t LCD_DISCO_F429ZI::GetXSize(void)
 {
   return BSP_LCD_GetXSize();
@@ -89,6 +105,11 @@ void LCD_DISCO_F429ZI::SetLayerAddress(uint32_t LayerIndex, uint32_t Address)
   BSP_LCD_SetLayerAddress(LayerIndex, Address);
 }
 
+uint32_t LCD_DISCO_F429ZI::GetLayerAddress(uint32_t LayerIndex)
+{
+  return BSP_LCD_GetLayerAddress(LayerIndex);
+}
+
 void LCD_DISCO_F429ZI::SetLayerWindow(uint16_t LayerIndex, uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Height)
 {
   BSP_LCD_SetLayerWindow(LayerIndex, Xpos, Ypos, Width, Height);
@@ -204,6 +225,31 @@ void LCD_DISCO_F429ZI::DrawBitmap(uint32_t X, uint32_t Y, uint8_t *pBmp)
   BSP_LCD_DrawBitmap(X, Y, pBmp);
 }
 
+void LCD_DISCO_F429ZI::DrawImage(uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Height, uint32_t *pSrc)
+{
+  BSP_LCD_DrawImage(Xpos, Ypos, Width, Height, pSrc);
+}
+
+void LCD_DISCO_F429ZI::DrawAlphaMask(uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Height, const uint8_t *pMask, uint32_t Color)
+{
+  BSP_LCD_DrawAlphaMask(Xpos, Ypos, Width, Height, pMask, Color);
+}
+
+void LCD_DISCO_F429ZI::DrawRGB565(uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Height, const uint16_t *pSrc)
+{
+  BSP_LCD_DrawRGB565(Xpos, Ypos, Width, Height, pSrc);
+}
+
+void LCD_DISCO_F429ZI::WaitDMA2D(void)
+{
+  BSP_LCD_WaitDMA2D();
+}
+
+void LCD_DISCO_F429ZI::ScrollLeft(uint32_t LayerIndex, uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Height, uint16_t Pixels)
+{
+  BSP_LCD_ScrollLeft(LayerIndex, Xpos, Ypos, Width, Height, Pixels);
+}
+
 void LCD_DISCO_F429ZI::FillRect(uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Height)
 {
   BSP_LCD_FillRect(Xpos, Ypos, Width, Height);
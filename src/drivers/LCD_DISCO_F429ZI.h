@@ -52,6 +52,10 @@ public:
   //! Constructor
   LCD_DISCO_F429ZI();
 
+  //! Constructor that leaves the hardware alone when init is false: the
+  //! caller brings up the LTDC, panel and SDRAM, then calls InitLayers()
+  LCD_DISCO_F429ZI(bool init);
+
   //! Destructor
   ~LCD_DISCO_F429ZI();
 
@@ -62,6 +66,14 @@ public:
     */
   uint8_t Init(void);
 
+  /**
+    * @brief  Sets up both layers as the constructor does, layer 1 hidden and
+    *         layer 0 selected and cleared. Needs the LTDC and SDRAM running.
+    * @param  None
+    * @retval None
+    */
+  void InitLayers(void);
+
   /**
     * @brief  Gets the LCD X size.
     * @param  None    
@@ -117,6 +129,13 @@ public:
     */
   void SetLayerAddress(uint32_t LayerIndex, uint32_t Address);
 
+  /**
+    * @brief  Gets a LCD layer frame buffer address.
+    * @param  LayerIndex: specifies the Layer foreground or background
+    * @retval Frame buffer address
+    */
+  uint32_t GetLayerAddress(uint32_t LayerIndex);
+
   /**
     * @brief  Sets the Display window.
     * @param  LayerIndex: layer index
@@ -312,6 +331,58 @@ public:
     */
   void DrawBitmap(uint32_t X, uint32_t Y, uint8_t *pBmp);
 
+  /**
+    * @brief  Displays an ARGB8888 image stored in memory with one DMA2D copy.
+    * @param  Xpos: the X position
+    * @param  Ypos: the Y position
+    * @param  Width: image width
+    * @param  Height: image height
+    * @param  pSrc: pointer to the image pixels
+    * @retval None
+    */
+  void DrawImage(uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Height, uint32_t *pSrc);
+
+  /**
+    * @brief  Draws an 8-bit alpha mask in one color with one DMA2D blend.
+    * @param  Xpos: the X position
+    * @param  Ypos: the Y position
+    * @param  Width: mask width
+    * @param  Height: mask height
+    * @param  pMask: pointer to the mask bytes
+    * @param  Color: the mask color
+    * @retval None
+    */
+  void DrawAlphaMask(uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Height, const uint8_t *pMask, uint32_t Color);
+
+  /**
+    * @brief  Starts converting an RGB565 block into the active layer with DMA2D.
+    * @param  Xpos: the X position
+    * @param  Ypos: the Y position
+    * @param  Width: block width
+    * @param  Height: block height
+    * @param  pSrc: pointer to the pixels, untouched until WaitDMA2D()
+    * @retval None
+    */
+  void DrawRGB565(uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Height, const uint16_t *pSrc);
+
+  /**
+    * @brief  Waits for the transfer started by DrawRGB565().
+    * @retval None
+    */
+  void WaitDMA2D(void);
+
+  /**
+    * @brief  Scrolls a rectangle of a layer to the left with one DMA2D copy.
+    * @param  LayerIndex: the layer to scroll
+    * @param  Xpos: the X position
+    * @param  Ypos: the Y position
+    * @param  Width: rectangle width
+    * @param  Height: rectangle height
+    * @param  Pixels: scroll distance in pixels
+    * @retval None
+    */
+  void ScrollLeft(uint32_t LayerIndex, uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Height, uint16_t Pixels);
+
   /**
     * @brief  Displays a full rectangle.
     * @param  Xpos: the X position
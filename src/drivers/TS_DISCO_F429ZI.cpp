@@ -61,6 +61,16 @@ void TS_DISCO_F429ZI::ITClear(void)
   BSP_TS_ITClear();
 }
 
+uint8_t TS_DISCO_F429ZI::IsTouched(void)
+{
+  return BSP_TS_IsTouched();
+}
+
+uint8_t TS_DISCO_F429ZI::ReadFIFO(TS_StateTypeDef* TsState, uint8_t Max)
+{
+  return BSP_TS_ReadFIFO(TsState, Max);
+}
+
 //=================================================================================================================
 // Private methods
 //=================================================================================================================
@@ -91,7 +91,7 @@ public:
   uint8_t ITGetStatus(void);
 
   /**
-    * @brief  Returns status and positions of the touch screen.
+    * @brief  Returns status and raw 12-bit position of the touch screen.
     * @param  TsState: Pointer to touch screen current state structure
     * @retval None.
     */
@@ -103,6 +103,21 @@ public:
     * @retval None
     */  
   void ITClear(void);
+
+  /**
+    * @brief  Checks whether the panel is being touched.
+    * @param  None
+    * @retval 1 while touched, 0 otherwise
+    */
+  uint8_t IsTouched(void);
+
+  /**
+    * @brief  Takes the points queued in the controller FIFO in one burst.
+    * @param  TsState: Array receiving the points, raw 12-bit values
+    * @param  Max: Size of the array
+    * @retval Number of points read
+    */
+  uint8_t ReadFIFO(TS_StateTypeDef* TsState, uint8_t Max);
   
 private:
 
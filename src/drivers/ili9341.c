@@ -117,6 +117,21 @@ LCD_DrvTypeDef   ili9341_drv =
   * @retval None
   */
 void ili9341_Init(void)
+{
+  ili9341_PowerOn();
+  LCD_Delay(ILI9341_SLEEP_OUT_DELAY);
+  ili9341_WriteReg(LCD_DISPLAY_ON);
+  /* GRAM start writing */
+  ili9341_WriteReg(LCD_GRAM);
+}
+
+/**
+  * @brief  Configures the LCD and takes it out of sleep mode, without waiting.
+  *         The panel needs ILI9341_SLEEP_OUT_DELAY ms before ili9341_DisplayOn().
+  * @param  None
+  * @retval None
+  */
+void ili9341_PowerOn(void)
 {
   /* Initialize ILI9341 low level bus layer ----------------------------------*/
   LCD_IO_Init();
@@ -234,10 +249,6 @@ void ili9341_Init(void)
   ili9341_WriteData(0x0F);
   
   ili9341_WriteReg(LCD_SLEEP_OUT);
-  LCD_Delay(200);
-  ili9341_WriteReg(LCD_DISPLAY_ON);
-  /* GRAM start writing */
-  ili9341_WriteReg(LCD_GRAM);
 }
 
 /**
@@ -75,6 +75,11 @@
   */ 
 #define ILI9341_ID                  0x9341
 
+/** 
+  * @brief  ILI9341 wait after the sleep out command, in ms  
+  */  
+#define ILI9341_SLEEP_OUT_DELAY     200
+
 /** 
   * @brief  ILI9341 Size  
   */  
@@ -205,6 +210,7 @@
   * @{
   */ 
 void     ili9341_Init(void);
+void     ili9341_PowerOn(void);
 uint16_t ili9341_ReadID(void);
 void     ili9341_WriteReg(uint8_t LCD_Reg);
 void     ili9341_WriteData(uint16_t RegValue);
@@ -109,6 +109,7 @@ uint32_t SpixTimeout = SPIx_TIMEOUT_MAX; /*<! Value of Timeout when SPI communic
 I2C_HandleTypeDef EEP_I2cHandle;
 static SPI_HandleTypeDef SpiHandle;
 static uint8_t Is_LCD_IO_Initialized = 0;
+static uint32_t IOE_Transfers = 0; /*<! I2C transactions with the IO expander */
 
 /**
   * @}
@@ -929,6 +930,7 @@ void IOE_ITConfig(void)
   */
 void IOE_Write(uint8_t Addr, uint8_t Reg, uint8_t Value)
 {
+  IOE_Transfers++;
   I2Cx_WriteData(Addr, Reg, Value);
 }
 
@@ -940,6 +942,7 @@ void IOE_Write(uint8_t Addr, uint8_t Reg, uint8_t Value)
   */
 uint8_t IOE_Read(uint8_t Addr, uint8_t Reg)
 {
+  IOE_Transfers++;
   return I2Cx_ReadData(Addr, Reg);
 }
 
@@ -952,6 +955,7 @@ uint8_t IOE_Read(uint8_t Addr, uint8_t Reg)
   */
 void IOE_WriteMultiple(uint8_t Addr, uint8_t Reg, uint8_t *pBuffer, uint16_t Length)
 {
+  IOE_Transfers++;
   I2Cx_WriteBuffer(Addr, Reg, pBuffer, Length);
 }
 
@@ -965,9 +969,19 @@ void IOE_WriteMultiple(uint8_t Addr, uint8_t Reg, uint8_t *pBuffer, uint16_t Len
   */
 uint16_t IOE_ReadMultiple(uint8_t Addr, uint8_t Reg, uint8_t *pBuffer, uint16_t Length)
 {
+ IOE_Transfers++;
  return I2Cx_ReadBuffer(Addr, Reg, pBuffer, Length);
 }
 
+/**
+  * @brief  IOE transaction count.
+  * @retval Number of I2C reads and writes addressed to the IO expander so far
+  */
+uint32_t IOE_GetTransfers(void)
+{
+  return IOE_Transfers;
+}
+
 /**
   * @brief  IOE Delay.
   * @param  Delay in ms
@@ -74,6 +74,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "stm32f429i_discovery_lcd.h"
 #include "fonts.h"
+#include <stdlib.h>
 //#include "font24.c"
 //#include "font20.c"
 //#include "font16.c"
@@ -96,6 +97,13 @@
 /** @defgroup STM32F429I_DISCOVERY_LCD_Private_TypesDefinitions STM32F429I DISCOVERY LCD Private TypesDefinitions
   * @{
   */ 
+typedef struct
+{
+  int16_t X;
+  int16_t Y;
+  int16_t Width;
+  int16_t Height;
+} LCD_SpanTypeDef;
 /**
   * @}
   */ 
@@ -105,6 +113,15 @@
   */
 #define POLY_X(Z)              ((int32_t)((Points + Z)->X))
 #define POLY_Y(Z)              ((int32_t)((Points + Z)->Y))
+
+/* Filled shapes are rasterized into spans first and drawn as a batch of
+   rectangles; set to 0 to draw them line by line as before */
+#ifndef LCD_SPAN_FILL
+#define LCD_SPAN_FILL          1
+#endif
+#define LCD_SPAN_MAX           512   /* spans buffered before a flush */
+#define LCD_SPAN_ROWS          ILI9341_LCD_PIXEL_HEIGHT
+#define LCD_SPAN_CPU_MAX_PIXELS 32   /* smaller rectangles are filled by the CPU */
 /**
   * @}
   */ 
@@ -128,6 +145,15 @@ static RCC_PeriphCLKInitTypeDef  PeriphClkInitStruct;
 static uint32_t ActiveLayer = 0;
 static LCD_DrawPropTypeDef DrawProp[MAX_LAYER_NUMBER];
 LCD_DrvTypeDef  *LcdDrv;
+
+#if (LCD_SPAN_FILL == 1)
+/* Span rasterizer state */
+static LCD_SpanTypeDef Spans[LCD_SPAN_MAX];
+static uint32_t SpanCount = 0;
+static int16_t RowLeft[LCD_SPAN_ROWS];
+static int16_t RowRight[LCD_SPAN_ROWS];
+static int32_t RowTop, RowBottom;
+#endif
 /**
   * @}
   */ 
@@ -138,6 +164,19 @@ LCD_DrvTypeDef  *LcdDrv;
 static void DrawChar(uint16_t Xpos, uint16_t Ypos, const uint8_t *c);
 static void FillBuffer(uint32_t LayerIndex, void *pDst, uint32_t xSize, uint32_t ySize, uint32_t OffLine, uint32_t ColorIndex);
 static void ConvertLineToARGB8888(void *pSrc, void *pDst, uint32_t xSize, uint32_t ColorMode);
+static void CopyBuffer(void *pSrc, void *pDst, uint32_t xSize, uint32_t ySize, uint32_t SrcOffLine, uint32_t DstOffLine);
+static void BlendMask(const uint8_t *pMask, void *pDst, uint32_t xSize, uint32_t ySize, uint32_t DstOffLine, uint32_t ColorIndex);
+static void StartConvertRGB565(const uint16_t *pSrc, void *pDst, uint32_t xSize, uint32_t ySize, uint32_t DstOffLine);
+#if (LCD_SPAN_FILL == 1)
+static void SpanRowsBegin(void);
+static void SpanRowsAdd(int32_t Ypos, int32_t X1, int32_t X2);
+static void SpanRowsLine(uint16_t X1, uint16_t Y1, uint16_t X2, uint16_t Y2);
+static void SpanRowsTriangle(uint16_t X1, uint16_t X2, uint16_t X3, uint16_t Y1, uint16_t Y2, uint16_t Y3);
+static void SpanRowsEmit(void);
+static void SpanAdd(int32_t Ypos, int32_t X1, int32_t X2);
+static void SpanFlush(void);
+static void FillRects(uint32_t LayerIndex, LCD_SpanTypeDef *pRects, uint32_t Count, uint32_t ColorIndex);
+#endif
 /**
   * @}
   */ 
@@ -151,6 +190,24 @@ static void ConvertLineToARGB8888(void *pSrc, void *pDst, uint32_t xSize, uint32
   * @retval LCD state
   */
 uint8_t BSP_LCD_Init(void)
+{ 
+  BSP_LCD_InitLTDC();
+
+  /* LCD Init */	 
+  LcdDrv->Init();
+
+  /* Initialize the SDRAM */
+  BSP_SDRAM_Init();
+
+  return LCD_OK;
+}  
+
+/**
+  * @brief  Configures the LTDC and selects the panel driver. The panel and the
+  *         SDRAM holding the frame buffers are left alone, so their power-up
+  *         waits can be overlapped: see BSP_LCD_PanelPowerOn() and BSP_SDRAM_Init().
+  */
+void BSP_LCD_InitLTDC(void)
 { 
   /* On STM32F429I-DISCO, it is not possible to read ILI9341 ID because */
   /* PIN EXTC is not connected to VDD and then LCD_READ_ID4 is not accessible. */
@@ -217,17 +274,18 @@ uint8_t BSP_LCD_Init(void)
     /* Select the device */
     LcdDrv = &ili9341_drv;
 
-    /* LCD Init */	 
-    LcdDrv->Init();
-
-    /* Initialize the SDRAM */
-    BSP_SDRAM_Init();
-
     /* Initialize the font */
-    BSP_LCD_SetFont(&LCD_DEFAULT_FONT);
+    BSP_LCD_SetFont(LCD_DEFAULT_FONT);
+}
 
-  return LCD_OK;
-}  
+/**
+  * @brief  Sends the panel configuration over SPI and takes it out of sleep.
+  *         BSP_LCD_DisplayOn() may follow once LCD_SLEEP_OUT_DELAY ms have passed.
+  */
+void BSP_LCD_PanelPowerOn(void)
+{
+  ili9341_PowerOn();
+}
 
 /**
   * @brief  Gets the LCD X size.  
@@ -276,7 +334,7 @@ void BSP_LCD_LayerDefaultInit(uint16_t LayerIndex, uint32_t FB_Address)
   HAL_LTDC_ConfigLayer(&LtdcHandler, &Layercfg, LayerIndex); 
 
   DrawProp[LayerIndex].BackColor = LCD_COLOR_WHITE;
-  DrawProp[LayerIndex].pFont     = &Font24;
+  DrawProp[LayerIndex].pFont     = LCD_DEFAULT_FONT;
   DrawProp[LayerIndex].TextColor = LCD_COLOR_BLACK; 
 
   /* Dithering activation */
@@ -577,6 +635,10 @@ void BSP_LCD_Clear(uint32_t Color)
 void BSP_LCD_ClearStringLine(uint32_t Line)
 {
   uint32_t colorbackup = DrawProp[ActiveLayer].TextColor;
+  if (DrawProp[ActiveLayer].pFont == NULL)
+  {
+    return;
+  }
   DrawProp[ActiveLayer].TextColor = DrawProp[ActiveLayer].BackColor;
 
   /* Draw rectangle with background color */
@@ -594,6 +656,10 @@ void BSP_LCD_ClearStringLine(uint32_t Line)
   */
 void BSP_LCD_DisplayChar(uint16_t Xpos, uint16_t Ypos, uint8_t Ascii)
 {
+  if (DrawProp[ActiveLayer].pFont == NULL)
+  {
+    return;
+  }
   DrawChar(Xpos, Ypos, &DrawProp[ActiveLayer].pFont->table[(Ascii-' ') *\
               DrawProp[ActiveLayer].pFont->Height * ((DrawProp[ActiveLayer].pFont->Width + 7) / 8)]);
 }
@@ -615,6 +681,11 @@ void BSP_LCD_DisplayStringAt(uint16_t X, uint16_t Y, uint8_t *pText, Text_AlignM
   uint32_t size = 0, xsize = 0; 
   uint8_t  *ptr = pText;
   
+  if (DrawProp[ActiveLayer].pFont == NULL)
+  {
+    return;
+  }
+
   /* Get the text size */
   while (*ptr++) size ++ ;
   
@@ -948,6 +1019,120 @@ void BSP_LCD_DrawBitmap(uint32_t X, uint32_t Y, uint8_t *pBmp)
   }
 }
 
+/**
+  * @brief  Displays an ARGB8888 image stored in memory (e.g. a prerendered
+  *         sprite in SDRAM) with a single DMA2D memory to memory transfer.
+  * @param  Xpos: the X position
+  * @param  Ypos: the Y position
+  * @param  Width: image width
+  * @param  Height: image height
+  * @param  pSrc: pointer to the image pixels, Width*Height words
+  */
+void BSP_LCD_DrawImage(uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Height, uint32_t *pSrc)
+{
+  uint32_t xaddress = 0;
+
+  /* Get the image start address */
+  xaddress = (LtdcHandler.LayerCfg[ActiveLayer].FBStartAdress) + 4*(BSP_LCD_GetXSize()*Ypos + Xpos);
+
+  /* Copy the image */
+  CopyBuffer(pSrc, (uint32_t *)xaddress, Width, Height, 0, (BSP_LCD_GetXSize() - Width));
+}
+
+/**
+  * @brief  Scrolls a rectangle of a layer to the left with a single DMA2D
+  *         memory to memory transfer. The rightmost Pixels columns keep their
+  *         old content and are meant to be redrawn by the caller.
+  * @note   Source and destination overlap; this is safe because DMA2D reads
+  *         each line from left to right ahead of its writes.
+  * @param  LayerIndex: the layer to scroll, need not be the active one
+  * @param  Xpos: the X position
+  * @param  Ypos: the Y position
+  * @param  Width: rectangle width
+  * @param  Height: rectangle height
+  * @param  Pixels: scroll distance in pixels
+  */
+void BSP_LCD_ScrollLeft(uint32_t LayerIndex, uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Height, uint16_t Pixels)
+{
+  uint32_t xaddress = 0;
+  uint32_t offline = 0;
+
+  if(Pixels >= Width)
+  {
+    return;
+  }
+
+  /* Get the rectangle start address */
+  xaddress = (LtdcHandler.LayerCfg[LayerIndex].FBStartAdress) + 4*(BSP_LCD_GetXSize()*Ypos + Xpos);
+  offline = BSP_LCD_GetXSize() - (Width - Pixels);
+
+  /* Shift the rectangle */
+  CopyBuffer((uint32_t *)(xaddress + 4*Pixels), (uint32_t *)xaddress, Width - Pixels, Height, offline, offline);
+}
+
+/**
+  * @brief  Draws an 8-bit alpha mask (e.g. a cached glyph) in one color,
+  *         blended over the active layer with a single DMA2D transfer.
+  * @param  Xpos: the X position
+  * @param  Ypos: the Y position
+  * @param  Width: mask width
+  * @param  Height: mask height
+  * @param  pMask: pointer to the mask, Width*Height bytes, 0 = transparent
+  * @param  Color: the color drawn where the mask is opaque
+  */
+void BSP_LCD_DrawAlphaMask(uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Height, const uint8_t *pMask, uint32_t Color)
+{
+  uint32_t xaddress = 0;
+
+  /* Get the mask start address */
+  xaddress = (LtdcHandler.LayerCfg[ActiveLayer].FBStartAdress) + 4*(BSP_LCD_GetXSize()*Ypos + Xpos);
+
+  /* Blend the mask over the frame buffer */
+  BlendMask(pMask, (uint32_t *)xaddress, Width, Height, (BSP_LCD_GetXSize() - Width), Color);
+}
+
+/**
+  * @brief  Displays an RGB565 block (e.g. lines from an image decoder)
+  *         converted to ARGB8888 by a single DMA2D transfer. The transfer
+  *         is only started: the caller may prepare the next block meanwhile,
+  *         but must call BSP_LCD_WaitDMA2D() before reusing pSrc.
+  * @param  Xpos: the X position
+  * @param  Ypos: the Y position
+  * @param  Width: block width
+  * @param  Height: block height
+  * @param  pSrc: pointer to the pixels, Width*Height halfwords, not in CCM RAM
+  */
+void BSP_LCD_DrawRGB565(uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Height, const uint16_t *pSrc)
+{
+  uint32_t xaddress = 0;
+
+  /* Get the block start address */
+  xaddress = (LtdcHandler.LayerCfg[ActiveLayer].FBStartAdress) + 4*(BSP_LCD_GetXSize()*Ypos + Xpos);
+
+  /* Wait for the previous block, then convert this one in the background */
+  BSP_LCD_WaitDMA2D();
+  StartConvertRGB565(pSrc, (uint32_t *)xaddress, Width, Height, (BSP_LCD_GetXSize() - Width));
+}
+
+/**
+  * @brief  Waits for a DMA2D transfer started by BSP_LCD_DrawRGB565().
+  *         Returns at once if none is running.
+  */
+void BSP_LCD_WaitDMA2D(void)
+{
+  HAL_DMA2D_PollForTransfer(&Dma2dHandler, 10);
+}
+
+/**
+  * @brief  Gets a layer frame buffer address.
+  * @param  LayerIndex: the layer foreground or background
+  * @retval Frame buffer address
+  */
+uint32_t BSP_LCD_GetLayerAddress(uint32_t LayerIndex)
+{
+  return LtdcHandler.LayerCfg[LayerIndex].FBStartAdress;
+}
+
 /**
   * @brief  Displays a full rectangle.
   * @param  Xpos: the X position
@@ -986,6 +1171,32 @@ void BSP_LCD_FillCircle(uint16_t Xpos, uint16_t Ypos, uint16_t Radius)
   curx = 0;
   cury = Radius;
   
+#if (LCD_SPAN_FILL == 1)
+  SpanRowsBegin();
+
+  while (curx <= cury)
+  {
+    /* Each row gets the horizontal line plus the two outline pixels at its ends */
+    SpanRowsAdd((int32_t)Ypos + curx, (int32_t)Xpos - cury, (int32_t)Xpos + cury);
+    SpanRowsAdd((int32_t)Ypos - curx, (int32_t)Xpos - cury, (int32_t)Xpos + cury);
+    SpanRowsAdd((int32_t)Ypos + cury, (int32_t)Xpos - curx, (int32_t)Xpos + curx);
+    SpanRowsAdd((int32_t)Ypos - cury, (int32_t)Xpos - curx, (int32_t)Xpos + curx);
+
+    if (d < 0)
+    { 
+      d += (curx << 2) + 6;
+    }
+    else
+    {
+      d += ((curx - cury) << 2) + 10;
+      cury--;
+    }
+    curx++;
+  }
+
+  SpanRowsEmit();
+  SpanFlush();
+#else
   BSP_LCD_SetTextColor(DrawProp[ActiveLayer].TextColor);
 
   while (curx <= cury)
@@ -1015,6 +1226,7 @@ void BSP_LCD_FillCircle(uint16_t Xpos, uint16_t Ypos, uint16_t Radius)
 
   BSP_LCD_SetTextColor(DrawProp[ActiveLayer].TextColor);
   BSP_LCD_DrawCircle(Xpos, Ypos, Radius);
+#endif
 }
 
 /**
@@ -1028,6 +1240,12 @@ void BSP_LCD_FillCircle(uint16_t Xpos, uint16_t Ypos, uint16_t Radius)
   */
 void BSP_LCD_FillTriangle(uint16_t X1, uint16_t X2, uint16_t X3, uint16_t Y1, uint16_t Y2, uint16_t Y3)
 { 
+#if (LCD_SPAN_FILL == 1)
+  SpanRowsBegin();
+  SpanRowsTriangle(X1, X2, X3, Y1, Y2, Y3);
+  SpanRowsEmit();
+  SpanFlush();
+#else
   int16_t deltax = 0, deltay = 0, x = 0, y = 0, xinc1 = 0, xinc2 = 0, 
   yinc1 = 0, yinc2 = 0, den = 0, num = 0, numadd = 0, numpixels = 0, 
   curpixel = 0;
@@ -1092,6 +1310,7 @@ void BSP_LCD_FillTriangle(uint16_t X1, uint16_t X2, uint16_t X3, uint16_t Y1, ui
     x += xinc2;                 /* Change the x as appropriate */
     y += yinc2;                 /* Change the y as appropriate */
   } 
+#endif
 }
 
 /**
@@ -1150,14 +1369,32 @@ void BSP_LCD_FillPolygon(pPoint Points, uint16_t PointCount)
     x2 = Points->X;
     y2 = Points->Y;    
   
+#if (LCD_SPAN_FILL == 1)
+    /* One fan triangle per row table, the union is done by the span merge */
+    SpanRowsBegin();
+    SpanRowsTriangle(x, x2, xcenter, y, y2, ycenter);
+    SpanRowsTriangle(x, xcenter, x2, y, ycenter, y2);
+    SpanRowsTriangle(xcenter, x2, x, ycenter, y2, y);
+    SpanRowsEmit();
+#else
     BSP_LCD_FillTriangle(x, x2, xcenter, y, y2, ycenter);
     BSP_LCD_FillTriangle(x, xcenter, x2, y, ycenter, y2);
     BSP_LCD_FillTriangle(xcenter, x2, x, ycenter, y2, y);   
+#endif
   }
   
+#if (LCD_SPAN_FILL == 1)
+  SpanRowsBegin();
+  SpanRowsTriangle(xfirst, x2, xcenter, yfirst, y2, ycenter);
+  SpanRowsTriangle(xfirst, xcenter, x2, yfirst, ycenter, y2);
+  SpanRowsTriangle(xcenter, x2, xfirst, ycenter, y2, yfirst);
+  SpanRowsEmit();
+  SpanFlush();
+#else
   BSP_LCD_FillTriangle(xfirst, x2, xcenter, yfirst, y2, ycenter);
   BSP_LCD_FillTriangle(xfirst, xcenter, x2, yfirst, ycenter, y2);
   BSP_LCD_FillTriangle(xcenter, x2, xfirst, ycenter, y2, yfirst);   
+#endif
 }
 
 /**
@@ -1176,10 +1413,19 @@ void BSP_LCD_FillEllipse(int Xpos, int Ypos, int XRadius, int YRadius)
   rad2 = YRadius;
   K = (float)(rad2/rad1);
   
+#if (LCD_SPAN_FILL == 1)
+  SpanRowsBegin();
+#endif
+
   do 
   { 
+#if (LCD_SPAN_FILL == 1)
+    SpanRowsAdd(Ypos+y, Xpos-(uint16_t)(x/K), Xpos+(uint16_t)(x/K));
+    SpanRowsAdd(Ypos-y, Xpos-(uint16_t)(x/K), Xpos+(uint16_t)(x/K));
+#else
     BSP_LCD_DrawHLine((Xpos-(uint16_t)(x/K)), (Ypos+y), (2*(uint16_t)(x/K) + 1));
     BSP_LCD_DrawHLine((Xpos-(uint16_t)(x/K)), (Ypos-y), (2*(uint16_t)(x/K) + 1));
+#endif
     
     e2 = err;
     if (e2 <= x) 
@@ -1190,6 +1436,11 @@ void BSP_LCD_FillEllipse(int Xpos, int Ypos, int XRadius, int YRadius)
     if (e2 > y) err += ++y*2+1;
   }
   while (y <= 0);
+
+#if (LCD_SPAN_FILL == 1)
+  SpanRowsEmit();
+  SpanFlush();
+#endif
 }
 
 /**
@@ -1398,6 +1649,427 @@ static void FillBuffer(uint32_t LayerIndex, void * pDst, uint32_t xSize, uint32_
   } 
 }
 
+/**
+  * @brief  Copies an ARGB8888 rectangle.
+  * @param  pSrc: pointer to source buffer
+  * @param  pDst: pointer to destination buffer
+  * @param  xSize: rectangle width
+  * @param  ySize: rectangle height
+  * @param  SrcOffLine: source offset
+  * @param  DstOffLine: destination offset
+  */
+static void CopyBuffer(void *pSrc, void *pDst, uint32_t xSize, uint32_t ySize, uint32_t SrcOffLine, uint32_t DstOffLine)
+{
+  /* Memory to memory mode with ARGB8888 as color Mode */
+  Dma2dHandler.Init.Mode         = DMA2D_M2M;
+  Dma2dHandler.Init.ColorMode    = DMA2D_ARGB8888;
+  Dma2dHandler.Init.OutputOffset = DstOffLine;
+
+  /* Foreground Configuration */
+  Dma2dHandler.LayerCfg[1].AlphaMode = DMA2D_NO_MODIF_ALPHA;
+  Dma2dHandler.LayerCfg[1].InputAlpha = 0xFF;
+  Dma2dHandler.LayerCfg[1].InputColorMode = CM_ARGB8888;
+  Dma2dHandler.LayerCfg[1].InputOffset = SrcOffLine;
+
+  Dma2dHandler.Instance = DMA2D;
+
+  /* DMA2D Initialization */
+  if(HAL_DMA2D_Init(&Dma2dHandler) == HAL_OK)
+  {
+    if(HAL_DMA2D_ConfigLayer(&Dma2dHandler, 1) == HAL_OK)
+    {
+      if (HAL_DMA2D_Start(&Dma2dHandler, (uint32_t)pSrc, (uint32_t)pDst, xSize, ySize) == HAL_OK)
+      {
+        /* Polling For DMA transfer */
+        HAL_DMA2D_PollForTransfer(&Dma2dHandler, 10);
+      }
+    }
+  }
+}
+
+/**
+  * @brief  Blends an A8 mask in one color over an ARGB8888 rectangle.
+  * @param  pMask: pointer to the mask
+  * @param  pDst: pointer to destination buffer, also the background
+  * @param  xSize: rectangle width
+  * @param  ySize: rectangle height
+  * @param  DstOffLine: destination offset
+  * @param  ColorIndex: mask color
+  */
+static void BlendMask(const uint8_t *pMask, void *pDst, uint32_t xSize, uint32_t ySize, uint32_t DstOffLine, uint32_t ColorIndex)
+{
+  /* Memory to memory with blending, ARGB8888 as output color Mode */
+  Dma2dHandler.Init.Mode         = DMA2D_M2M_BLEND;
+  Dma2dHandler.Init.ColorMode    = DMA2D_ARGB8888;
+  Dma2dHandler.Init.OutputOffset = DstOffLine;
+
+  /* Foreground Configuration: A8 takes its color from InputAlpha */
+  Dma2dHandler.LayerCfg[1].AlphaMode = DMA2D_NO_MODIF_ALPHA;
+  Dma2dHandler.LayerCfg[1].InputAlpha = ColorIndex;
+  Dma2dHandler.LayerCfg[1].InputColorMode = CM_A8;
+  Dma2dHandler.LayerCfg[1].InputOffset = 0;
+
+  /* Background Configuration: the frame buffer itself */
+  Dma2dHandler.LayerCfg[0].AlphaMode = DMA2D_NO_MODIF_ALPHA;
+  Dma2dHandler.LayerCfg[0].InputAlpha = 0xFF;
+  Dma2dHandler.LayerCfg[0].InputColorMode = CM_ARGB8888;
+  Dma2dHandler.LayerCfg[0].InputOffset = DstOffLine;
+
+  Dma2dHandler.Instance = DMA2D;
+
+  /* DMA2D Initialization */
+  if(HAL_DMA2D_Init(&Dma2dHandler) == HAL_OK)
+  {
+    if((HAL_DMA2D_ConfigLayer(&Dma2dHandler, 1) == HAL_OK) && (HAL_DMA2D_ConfigLayer(&Dma2dHandler, 0) == HAL_OK))
+    {
+      if (HAL_DMA2D_BlendingStart(&Dma2dHandler, (uint32_t)pMask, (uint32_t)pDst, (uint32_t)pDst, xSize, ySize) == HAL_OK)
+      {
+        /* Polling For DMA transfer */
+        HAL_DMA2D_PollForTransfer(&Dma2dHandler, 10);
+      }
+    }
+  }
+}
+
+#if (LCD_SPAN_FILL == 1)
+/**
+  * @brief  Starts collecting the rows of one shape.
+  */
+static void SpanRowsBegin(void)
+{
+  uint32_t y = 0;
+
+  for(y = 0; y < LCD_SPAN_ROWS; y++)
+  {
+    RowLeft[y] = INT16_MAX;
+    RowRight[y] = INT16_MIN;
+  }
+  RowTop = LCD_SPAN_ROWS;
+  RowBottom = -1;
+}
+
+/**
+  * @brief  Extends the collected row Ypos to cover X1..X2.
+  * @param  Ypos: the row
+  * @param  X1: first pixel
+  * @param  X2: last pixel
+  */
+static void SpanRowsAdd(int32_t Ypos, int32_t X1, int32_t X2)
+{
+  if((Ypos < 0) || (Ypos >= (int32_t)LCD_SPAN_ROWS))
+  {
+    return;
+  }
+
+  if(X1 < RowLeft[Ypos])
+  {
+    RowLeft[Ypos] = X1;
+  }
+  if(X2 > RowRight[Ypos])
+  {
+    RowRight[Ypos] = X2;
+  }
+  if(Ypos < RowTop)
+  {
+    RowTop = Ypos;
+  }
+  if(Ypos > RowBottom)
+  {
+    RowBottom = Ypos;
+  }
+}
+
+/**
+  * @brief  Adds the pixels of BSP_LCD_DrawLine(X1, Y1, X2, Y2) to the collected rows.
+  * @param  X1: the point 1 X position
+  * @param  Y1: the point 1 Y position
+  * @param  X2: the point 2 X position
+  * @param  Y2: the point 2 Y position
+  */
+static void SpanRowsLine(uint16_t X1, uint16_t Y1, uint16_t X2, uint16_t Y2)
+{
+  int16_t deltax = 0, deltay = 0, x = 0, y = 0, xinc1 = 0, xinc2 = 0, 
+  yinc1 = 0, yinc2 = 0, den = 0, num = 0, numadd = 0, numpixels = 0, 
+  curpixel = 0;
+
+  deltax = ABS(X2 - X1);
+  deltay = ABS(Y2 - Y1);
+  x = X1;
+  y = Y1;
+
+  xinc1 = xinc2 = (X2 >= X1) ? 1 : -1;
+  yinc1 = yinc2 = (Y2 >= Y1) ? 1 : -1;
+
+  if (deltax >= deltay)
+  {
+    xinc1 = 0;
+    yinc2 = 0;
+    den = deltax;
+    num = deltax / 2;
+    numadd = deltay;
+    numpixels = deltax;
+  }
+  else
+  {
+    xinc2 = 0;
+    yinc1 = 0;
+    den = deltay;
+    num = deltay / 2;
+    numadd = deltax;
+    numpixels = deltay;
+  }
+
+  for (curpixel = 0; curpixel <= numpixels; curpixel++)
+  {
+    /* Same pixel sequence as BSP_LCD_DrawLine */
+    SpanRowsAdd(y, x, x);
+    num += numadd;
+    if (num >= den)
+    {
+      num -= den;
+      x += xinc1;
+      y += yinc1;
+    }
+    x += xinc2;
+    y += yinc2;
+  }
+}
+
+/**
+  * @brief  Adds a filled triangle to the collected rows. The edges are walked
+  *         in the directions the line based BSP_LCD_FillTriangle draws them.
+  * @param  X1: the point 1 x position
+  * @param  X2: the point 2 x position
+  * @param  X3: the point 3 x position
+  * @param  Y1: the point 1 y position
+  * @param  Y2: the point 2 y position
+  * @param  Y3: the point 3 y position
+  */
+static void SpanRowsTriangle(uint16_t X1, uint16_t X2, uint16_t X3, uint16_t Y1, uint16_t Y2, uint16_t Y3)
+{
+  SpanRowsLine(X1, Y1, X2, Y2);
+  SpanRowsLine(X1, Y1, X3, Y3);
+  SpanRowsLine(X2, Y2, X3, Y3);
+}
+
+/**
+  * @brief  Turns every collected row into a span.
+  */
+static void SpanRowsEmit(void)
+{
+  int32_t y = 0;
+
+  for(y = RowTop; y <= RowBottom; y++)
+  {
+    if(RowLeft[y] <= RowRight[y])
+    {
+      SpanAdd(y, RowLeft[y], RowRight[y]);
+    }
+  }
+}
+
+/**
+  * @brief  Queues the span X1..X2 of row Ypos, clipped to the screen.
+  * @param  Ypos: the row
+  * @param  X1: first pixel
+  * @param  X2: last pixel
+  */
+static void SpanAdd(int32_t Ypos, int32_t X1, int32_t X2)
+{
+  int32_t xsize = BSP_LCD_GetXSize();
+
+  if((Ypos < 0) || (Ypos >= (int32_t)BSP_LCD_GetYSize()))
+  {
+    return;
+  }
+  if(X1 < 0)
+  {
+    X1 = 0;
+  }
+  if(X2 >= xsize)
+  {
+    X2 = xsize - 1;
+  }
+  if(X1 > X2)
+  {
+    return;
+  }
+
+  if(SpanCount == LCD_SPAN_MAX)
+  {
+    /* Overlapping fills of one color are harmless, flush and go on */
+    SpanFlush();
+  }
+
+  Spans[SpanCount].X = X1;
+  Spans[SpanCount].Y = Ypos;
+  Spans[SpanCount].Width = X2 - X1 + 1;
+  Spans[SpanCount].Height = 1;
+  SpanCount++;
+}
+
+/**
+  * @brief  Orders spans by row, then by first pixel.
+  */
+static int SpanCompare(const void *a, const void *b)
+{
+  const LCD_SpanTypeDef *sa = (const LCD_SpanTypeDef *)a;
+  const LCD_SpanTypeDef *sb = (const LCD_SpanTypeDef *)b;
+
+  if(sa->Y != sb->Y)
+  {
+    return sa->Y - sb->Y;
+  }
+  return sa->X - sb->X;
+}
+
+/**
+  * @brief  Merges the queued spans into rectangles and fills them with the
+  *         text color of the active layer.
+  */
+static void SpanFlush(void)
+{
+  uint32_t i = 0, out = 0;
+  LCD_SpanTypeDef *last;
+
+  if(SpanCount == 0)
+  {
+    return;
+  }
+
+  qsort(Spans, SpanCount, sizeof(LCD_SpanTypeDef), SpanCompare);
+
+  /* Merge overlapping and adjacent runs of a row */
+  for(i = 1; i < SpanCount; i++)
+  {
+    last = &Spans[out];
+    if((Spans[i].Y == last->Y) && (Spans[i].X <= last->X + last->Width))
+    {
+      if(Spans[i].X + Spans[i].Width > last->X + last->Width)
+      {
+        last->Width = Spans[i].X + Spans[i].Width - last->X;
+      }
+    }
+    else
+    {
+      Spans[++out] = Spans[i];
+    }
+  }
+  SpanCount = out + 1;
+
+  /* Stack runs of equal extent on consecutive rows into one rectangle */
+  out = 0;
+  for(i = 1; i < SpanCount; i++)
+  {
+    last = &Spans[out];
+    if((Spans[i].X == last->X) && (Spans[i].Width == last->Width) && (Spans[i].Y == last->Y + last->Height))
+    {
+      last->Height++;
+    }
+    else
+    {
+      Spans[++out] = Spans[i];
+    }
+  }
+  SpanCount = out + 1;
+
+  FillRects(ActiveLayer, Spans, SpanCount, DrawProp[ActiveLayer].TextColor);
+  SpanCount = 0;
+}
+
+/**
+  * @brief  Fills rectangles with one DMA2D setup; each large rectangle is one
+  *         register-to-memory job, small ones are written by the CPU.
+  * @param  LayerIndex: layer index
+  * @param  pRects: rectangles
+  * @param  Count: number of rectangles
+  * @param  ColorIndex: color
+  */
+static void FillRects(uint32_t LayerIndex, LCD_SpanTypeDef *pRects, uint32_t Count, uint32_t ColorIndex)
+{
+  uint32_t i = 0, x = 0, y = 0, dma2d_ready = 0;
+  uint32_t xsize = BSP_LCD_GetXSize();
+  uint32_t *pDst;
+
+  for(i = 0; i < Count; i++)
+  {
+    pDst = (uint32_t *)(LtdcHandler.LayerCfg[LayerIndex].FBStartAdress) + xsize*pRects[i].Y + pRects[i].X;
+
+    if((uint32_t)(pRects[i].Width * pRects[i].Height) > LCD_SPAN_CPU_MAX_PIXELS)
+    {
+      if(dma2d_ready == 0)
+      {
+        /* Register to memory mode with ARGB8888 as color Mode, set up once per batch */
+        Dma2dHandler.Init.Mode         = DMA2D_R2M;
+        Dma2dHandler.Init.ColorMode    = DMA2D_ARGB8888;
+        Dma2dHandler.Init.OutputOffset = 0;
+        Dma2dHandler.Instance = DMA2D;
+
+        if((HAL_DMA2D_Init(&Dma2dHandler) == HAL_OK) && (HAL_DMA2D_ConfigLayer(&Dma2dHandler, LayerIndex) == HAL_OK))
+        {
+          dma2d_ready = 1;
+        }
+      }
+
+      if(dma2d_ready != 0)
+      {
+        /* Only the output offset changes between jobs */
+        Dma2dHandler.Instance->OOR = xsize - pRects[i].Width;
+        if (HAL_DMA2D_Start(&Dma2dHandler, ColorIndex, (uint32_t)pDst, pRects[i].Width, pRects[i].Height) == HAL_OK)
+        {
+          /* Polling For DMA transfer */
+          HAL_DMA2D_PollForTransfer(&Dma2dHandler, 10);
+        }
+        continue;
+      }
+    }
+
+    for(y = 0; y < (uint32_t)pRects[i].Height; y++)
+    {
+      for(x = 0; x < (uint32_t)pRects[i].Width; x++)
+      {
+        pDst[x] = ColorIndex;
+      }
+      pDst += xsize;
+    }
+  }
+}
+#endif /* LCD_SPAN_FILL == 1 */
+
+/**
+  * @brief  Starts converting an RGB565 block into the frame buffer.
+  * @param  pSrc: pointer to source buffer
+  * @param  pDst: pointer to destination buffer
+  * @param  xSize: block width
+  * @param  ySize: block height
+  * @param  DstOffLine: destination offset
+  */
+static void StartConvertRGB565(const uint16_t *pSrc, void *pDst, uint32_t xSize, uint32_t ySize, uint32_t DstOffLine)
+{
+  /* Memory to memory with pixel format conversion, ARGB8888 as output */
+  Dma2dHandler.Init.Mode         = DMA2D_M2M_PFC;
+  Dma2dHandler.Init.ColorMode    = DMA2D_ARGB8888;
+  Dma2dHandler.Init.OutputOffset = DstOffLine;
+
+  /* Foreground Configuration */
+  Dma2dHandler.LayerCfg[1].AlphaMode = DMA2D_NO_MODIF_ALPHA;
+  Dma2dHandler.LayerCfg[1].InputAlpha = 0xFF;
+  Dma2dHandler.LayerCfg[1].InputColorMode = CM_RGB565;
+  Dma2dHandler.LayerCfg[1].InputOffset = 0;
+
+  Dma2dHandler.Instance = DMA2D;
+
+  /* DMA2D Initialization */
+  if(HAL_DMA2D_Init(&Dma2dHandler) == HAL_OK)
+  {
+    if(HAL_DMA2D_ConfigLayer(&Dma2dHandler, 1) == HAL_OK)
+    {
+      /* No polling, BSP_LCD_WaitDMA2D() finishes the transfer */
+      HAL_DMA2D_Start(&Dma2dHandler, (uint32_t)pSrc, (uint32_t)pDst, xSize, ySize);
+    }
+  }
+}
+
 /**
   * @brief  Converts Line to ARGB8888 pixel format.
   * @param  pSrc: pointer to source buffer
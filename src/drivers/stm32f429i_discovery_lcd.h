@@ -140,9 +140,25 @@ typedef enum
 #define LCD_COLOR_ORANGE        0xFFFFA500
 #define LCD_COLOR_TRANSPARENT   0xFF000000
 /** 
-  * @brief LCD default font 
+  * @brief LCD default font. The app draws its text from a packed font
+  *        (src/packed_font.h), so by default no layer gets a BSP font and none
+  *        of the Font8 to Font24 tables is linked; BSP_LCD_DisplayChar() and
+  *        the string functions then draw nothing until BSP_LCD_SetFont().
+  *        Set LCD_BSP_FONTS to 1 for the BSP's Font24 and Font16 defaults.
   */ 
-#define LCD_DEFAULT_FONT         Font24
+#ifndef LCD_BSP_FONTS
+#define LCD_BSP_FONTS            0
+#endif
+#if LCD_BSP_FONTS
+#define LCD_DEFAULT_FONT         (&Font24)
+#else
+#define LCD_DEFAULT_FONT         NULL
+#endif
+
+/** 
+  * @brief LCD wait between BSP_LCD_PanelPowerOn() and BSP_LCD_DisplayOn(), in ms 
+  */ 
+#define LCD_SLEEP_OUT_DELAY      ILI9341_SLEEP_OUT_DELAY
 
 /** 
   * @brief  LCD Reload Types
@@ -182,6 +198,8 @@ typedef enum
   * @{
   */ 
 uint8_t  BSP_LCD_Init(void);
+void     BSP_LCD_InitLTDC(void);
+void     BSP_LCD_PanelPowerOn(void);
 uint32_t BSP_LCD_GetXSize(void);
 uint32_t BSP_LCD_GetYSize(void);
 
@@ -199,6 +217,7 @@ void     BSP_LCD_SetLayerWindow(uint16_t LayerIndex, uint16_t Xpos, uint16_t Ypo
 void     BSP_LCD_SetLayerWindow_NoReload(uint16_t LayerIndex, uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Height);
 void     BSP_LCD_SelectLayer(uint32_t LayerIndex);
 void     BSP_LCD_SetLayerVisible(uint32_t LayerIndex, FunctionalState state);
+uint32_t BSP_LCD_GetLayerAddress(uint32_t LayerIndex);
 void     BSP_LCD_SetLayerVisible_NoReload(uint32_t LayerIndex, FunctionalState State);
 void     BSP_LCD_Relaod(uint32_t ReloadType);
 
@@ -225,6 +244,11 @@ void     BSP_LCD_DrawCircle(uint16_t Xpos, uint16_t Ypos, uint16_t Radius);
 void     BSP_LCD_DrawPolygon(pPoint Points, uint16_t PointCount);
 void     BSP_LCD_DrawEllipse(int Xpos, int Ypos, int XRadius, int YRadius);
 void     BSP_LCD_DrawBitmap(uint32_t X, uint32_t Y, uint8_t *pBmp);
+void     BSP_LCD_ScrollLeft(uint32_t LayerIndex, uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Height, uint16_t Pixels);
+void     BSP_LCD_DrawImage(uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Height, uint32_t *pSrc);
+void     BSP_LCD_DrawAlphaMask(uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Height, const uint8_t *pMask, uint32_t Color);
+void     BSP_LCD_DrawRGB565(uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Height, const uint16_t *pSrc);
+void     BSP_LCD_WaitDMA2D(void);
 
 void     BSP_LCD_FillRect(uint16_t Xpos, uint16_t Ypos, uint16_t Width, uint16_t Height);
 void     BSP_LCD_FillCircle(uint16_t Xpos, uint16_t Ypos, uint16_t Radius);
@@ -77,7 +77,6 @@
   * @{
   */
 static TS_DrvTypeDef     *TsDrv;
-static uint16_t          TsXBoundary, TsYBoundary; 
 /**
   * @}
   */
@@ -96,17 +95,18 @@ static uint16_t          TsXBoundary, TsYBoundary;
 /**
   * @brief  Initializes and configures the touch screen functionalities and 
   *         configures all necessary hardware resources (GPIOs, clocks..).
-  * @param  XSize: The maximum X size of the TS area on LCD
-  * @param  YSize: The maximum Y size of the TS area on LCD  
+  * @note   Positions are reported as raw 12-bit panel values; mapping them
+  *         to pixels is left to the application's calibration.
+  * @param  XSize: The maximum X size of the TS area on LCD (unused)
+  * @param  YSize: The maximum Y size of the TS area on LCD (unused)
   * @retval TS_OK: if all initializations are OK. Other value if error.
   */
 uint8_t BSP_TS_Init(uint16_t XSize, uint16_t YSize)
 {
   uint8_t ret = TS_ERROR;
 
-  /* Initialize x and y positions boundaries */
-  TsXBoundary = XSize;
-  TsYBoundary = YSize;
+  (void)XSize;
+  (void)YSize;
 
   /* Read ID and verify if the IO expander is ready */
   if(stmpe811_ts_drv.ReadID(TS_I2C_ADDRESS) == STMPE811_ID)
@@ -136,6 +136,12 @@ uint8_t BSP_TS_ITConfig(void)
   /* Enable the TS ITs */
   TsDrv->EnableIT(TS_I2C_ADDRESS);
 
+  /* Interrupt on touch and release and once TS_FIFO_THRESHOLD points are
+     queued. FIFO empty and full are left off, emptying the FIFO on every
+     read would raise another interrupt each time */
+  IOE_Write(TS_I2C_ADDRESS, STMPE811_REG_FIFO_TH, TS_FIFO_THRESHOLD);
+  IOE_Write(TS_I2C_ADDRESS, STMPE811_REG_INT_EN, STMPE811_GIT_TOUCH | STMPE811_GIT_FTH | STMPE811_GIT_FOV);
+
   return TS_OK;
 }
 
@@ -150,82 +156,77 @@ uint8_t BSP_TS_ITGetStatus(void)
 }
 
 /**
-  * @brief  Returns status and positions of the touch screen.
+  * @brief  Returns status and raw position of the touch screen.
   * @param  TsState: Pointer to touch screen current state structure
   */
 void BSP_TS_GetState(TS_StateTypeDef* TsState)
 {
-  static uint32_t _x = 0, _y = 0;
-  uint16_t xDiff, yDiff , x , y, xr, yr;
+  uint16_t x, y;
   
   TsState->TouchDetected = TsDrv->DetectTouch(TS_I2C_ADDRESS);
   
   if(TsState->TouchDetected)
   {
     TsDrv->GetXY(TS_I2C_ADDRESS, &x, &y);
-    
-    /* Y value first correction */
-    y -= 360;  
-    
-    /* Y value second correction */
-    yr = y / 11;
-    
-    /* Return y position value */
-    if(yr <= 0)
-    {
-      yr = 0;
-    }
-    else if (yr > TsYBoundary)
-    {
-      yr = TsYBoundary - 1;
-    }
-    else
-    {}
-    y = yr;
-    
-    /* X value first correction */
-    if(x <= 3000)
-    {
-      x = 3870 - x;
-    }
-    else
-    {
-      x = 3800 - x;
-    }
-    
-    /* X value second correction */  
-    xr = x / 15;
-    
-    /* Return X position value */
-    if(xr <= 0)
-    {
-      xr = 0;
-    }
-    else if (xr > TsXBoundary)
-    {
-      xr = TsXBoundary - 1;
-    }
-    else 
-    {}
-    
-    x = xr;
-    xDiff = x > _x? (x - _x): (_x - x);
-    yDiff = y > _y? (y - _y): (_y - y); 
-    
-    if (xDiff + yDiff > 5)
-    {
-      _x = x;
-      _y = y; 
-    }
-    
-    /* Update the X position */
-    TsState->X = _x;
-    
-    /* Update the Y position */  
-    TsState->Y = _y;
+    TsState->X = x;
+    TsState->Y = y;
   }
 }
 
+/**
+  * @brief  Checks whether the panel is being touched, in one I2C read.
+  * @retval 1 while touched, 0 otherwise
+  */
+uint8_t BSP_TS_IsTouched(void)
+{
+  return (IOE_Read(TS_I2C_ADDRESS, STMPE811_REG_TSC_CTRL) & STMPE811_TS_CTRL_STATUS) != 0;
+}
+
+/**
+  * @brief  Takes the points queued in the STMPE811 FIFO, all of them read in
+  *         one I2C burst from the non-incrementing data register.
+  * @param  TsState: Array receiving the points, raw 12-bit values
+  * @param  Max: Size of the array
+  * @retval Number of points read, at most Max and TS_FIFO_BURST
+  */
+uint8_t BSP_TS_ReadFIFO(TS_StateTypeDef *TsState, uint8_t Max)
+{
+  uint8_t dataXYZ[TS_FIFO_BURST * 4];
+  uint32_t uXYZ;
+  uint16_t x, y;
+  uint8_t count, i;
+
+  count = IOE_Read(TS_I2C_ADDRESS, STMPE811_REG_FIFO_SIZE);
+  if(count > Max)
+  {
+    count = Max;
+  }
+  if(count > TS_FIFO_BURST)
+  {
+    count = TS_FIFO_BURST;
+  }
+
+  if(count > 0)
+  {
+    IOE_ReadMultiple(TS_I2C_ADDRESS, STMPE811_REG_TSC_DATA_NON_INC, dataXYZ, count * 4);
+  }
+
+  for(i = 0; i < count; i++)
+  {
+    /* 12 bits X, 12 bits Y and 8 bits Z per point */
+    uXYZ = ((uint32_t)dataXYZ[4 * i] << 24) | (dataXYZ[4 * i + 1] << 16) | (dataXYZ[4 * i + 2] << 8) | dataXYZ[4 * i + 3];
+    x = (uXYZ >> 20) & 0x00000FFF;
+    y = (uXYZ >> 8) & 0x00000FFF;
+
+    TsState[i].TouchDetected = 1;
+    TsState[i].X = x;
+    TsState[i].Y = y;
+    TsState[i].Z = uXYZ & 0xFF;
+  }
+
+  return count;
+}
+
 /**
   * @brief  Clears all touch screen interrupts.
   */  
@@ -81,6 +81,15 @@ typedef struct
 #define TS_SWAP_Y                       0x02
 #define TS_SWAP_XY                      0x04
 
+/* Points queued in the STMPE811 FIFO before it raises the FIFO threshold
+   interrupt; higher means fewer interrupts but later touch positions */
+#ifndef TS_FIFO_THRESHOLD
+#define TS_FIFO_THRESHOLD               4
+#endif
+
+/* Most points BSP_TS_ReadFIFO() takes in one I2C burst, 4 bytes each */
+#define TS_FIFO_BURST                   32
+
 typedef enum 
 {
   TS_OK       = 0x00,
@@ -106,6 +115,8 @@ void    BSP_TS_GetState(TS_StateTypeDef *TsState);
 uint8_t BSP_TS_ITConfig(void);
 uint8_t BSP_TS_ITGetStatus(void);
 void    BSP_TS_ITClear(void);
+uint8_t BSP_TS_IsTouched(void);
+uint8_t BSP_TS_ReadFIFO(TS_StateTypeDef *TsState, uint8_t Max);
 
 /**
   * @}
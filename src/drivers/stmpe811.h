@@ -260,6 +260,7 @@ void     IOE_Delay(uint32_t delay);
 void     IOE_Write(uint8_t addr, uint8_t reg, uint8_t value);
 uint8_t  IOE_Read(uint8_t addr, uint8_t reg);
 uint16_t IOE_ReadMultiple(uint8_t addr, uint8_t reg, uint8_t *buffer, uint16_t length);
+uint32_t IOE_GetTransfers(void);
 
 /* Touch screen driver structure */
 extern TS_DrvTypeDef stmpe811_ts_drv;
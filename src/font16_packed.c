@@ -0,0 +1,184 @@
+/* Generated by tools/font_pack.py from font16.c, do not edit */
+#include "packed_font.h"
+
+static const uint8_t Font16P_Runs[] = {
+    0x0F, 0x01, 0x22, 0x03, 0x16, 0x13, 0x11, 0x31, 0x21, 0x31, 0x21, 0x31, 0x10, 0x22, 0x12, 0x32,
+    0x12, 0x32, 0x12, 0x32, 0x12, 0x18, 0x12, 0x12, 0x28, 0x12, 0x12, 0x32, 0x12, 0x32, 0x12, 0x32,
+    0x12, 0x20, 0x31, 0x48, 0x34, 0x35, 0x54, 0x44, 0x55, 0x34, 0x38, 0x41, 0x61, 0x30, 0x12, 0x51,
+    0x21, 0x41, 0x21, 0x52, 0x32, 0x34, 0x24, 0x32, 0x32, 0x51, 0x21, 0x41, 0x21, 0x52, 0x10, 0x24,
+    0x22, 0x52, 0x52, 0x62, 0x43, 0x14, 0x13, 0x12, 0x22, 0x23, 0x12, 0x06, 0x11, 0x21, 0x21, 0x10,
+    0x22, 0x22, 0x12, 0x13, 0x12, 0x22, 0x22, 0x22, 0x23, 0x22, 0x32, 0x22, 0x02, 0x22, 0x32, 0x32,
+    0x22, 0x22, 0x22, 0x22, 0x22, 0x12, 0x13, 0x12, 0x20, 0x32, 0x62, 0x3F, 0x01, 0x24, 0x36, 0x22,
+    0x22, 0x10, 0x31, 0x61, 0x61, 0x37, 0x31, 0x61, 0x61, 0x30, 0x12, 0x11, 0x12, 0x11, 0x21, 0x20,
+    0x07, 0x04, 0x62, 0x62, 0x52, 0x62, 0x52, 0x62, 0x52, 0x52, 0x62, 0x52, 0x62, 0x52, 0x62, 0x60,
+    0x23, 0x32, 0x12, 0x12, 0x34, 0x34, 0x34, 0x34, 0x34, 0x32, 0x12, 0x12, 0x33, 0x20, 0x32, 0x35,
+    0x62, 0x62, 0x62, 0x62, 0x62, 0x62, 0x62, 0x38, 0x24, 0x22, 0x24, 0x34, 0x32, 0x42, 0x42, 0x42,
+    0x42, 0x42, 0x57, 0x16, 0x12, 0x42, 0x62, 0x52, 0x35, 0x63, 0x62, 0x64, 0x42, 0x16, 0x10, 0x33,
+    0x43, 0x34, 0x31, 0x12, 0x22, 0x12, 0x21, 0x22, 0x12, 0x22, 0x17, 0x42, 0x35, 0x16, 0x12, 0x52,
+    0x52, 0x55, 0x21, 0x32, 0x52, 0x53, 0x42, 0x15, 0x10, 0x34, 0x13, 0x42, 0x42, 0x52, 0x13, 0x13,
+    0x24, 0x34, 0x32, 0x12, 0x22, 0x24, 0x10, 0x08, 0x42, 0x52, 0x42, 0x52, 0x52, 0x52, 0x42, 0x52,
+    0x52, 0x20, 0x15, 0x12, 0x34, 0x34, 0x32, 0x15, 0x12, 0x34, 0x34, 0x34, 0x32, 0x15, 0x10, 0x14,
+    0x22, 0x22, 0x12, 0x34, 0x34, 0x23, 0x13, 0x12, 0x52, 0x42, 0x43, 0x14, 0x30, 0x04, 0x64, 0x22,
+    0x22, 0xD2, 0x21, 0x21, 0x31, 0x30, 0x72, 0x52, 0x61, 0x62, 0x52, 0x92, 0x91, 0x92, 0x92, 0x09,
+    0x99, 0x02, 0x92, 0x91, 0x92, 0x92, 0x52, 0x61, 0x62, 0x52, 0x70, 0x15, 0x12, 0x34, 0x32, 0x52,
+    0x33, 0x32, 0x52, 0xC2, 0x30, 0x23, 0x21, 0x32, 0x42, 0x42, 0x24, 0x11, 0x22, 0x11, 0x22, 0x24,
+    0x61, 0x31, 0x23, 0x10, 0x16, 0x64, 0x61, 0x21, 0x52, 0x22, 0x42, 0x22, 0x46, 0x32, 0x42, 0x22,
+    0x42, 0x14, 0x24, 0x07, 0x22, 0x32, 0x12, 0x32, 0x12, 0x32, 0x16, 0x22, 0x32, 0x12, 0x32, 0x12,
+    0x39, 0x10, 0x25, 0x11, 0x12, 0x44, 0x63, 0x72, 0x72, 0x72, 0x61, 0x12, 0x41, 0x35, 0x20, 0x07,
+    0x32, 0x32, 0x22, 0x42, 0x12, 0x42, 0x12, 0x42, 0x12, 0x42, 0x12, 0x42, 0x12, 0x32, 0x17, 0x20,
+    0x08, 0x12, 0x41, 0x12, 0x41, 0x12, 0x21, 0x35, 0x32, 0x21, 0x32, 0x41, 0x12, 0x49, 0x09, 0x12,
+    0x51, 0x12, 0x51, 0x12, 0x21, 0x45, 0x42, 0x21, 0x42, 0x72, 0x65, 0x40, 0x24, 0x11, 0x22, 0x32,
+    0x12, 0x51, 0x12, 0x72, 0x72, 0x27, 0x42, 0x22, 0x32, 0x35, 0x20, 0x04, 0x14, 0x12, 0x32, 0x22,
+    0x32, 0x22, 0x32, 0x27, 0x22, 0x32, 0x22, 0x32, 0x22, 0x32, 0x14, 0x14, 0x08, 0x32, 0x62, 0x62,
+    0x62, 0x62, 0x62, 0x62, 0x38, 0x27, 0x52, 0x72, 0x72, 0x72, 0x22, 0x32, 0x22, 0x32, 0x22, 0x32,
+    0x35, 0x30, 0x04, 0x14, 0x12, 0x32, 0x22, 0x22, 0x32, 0x12, 0x44, 0x55, 0x42, 0x22, 0x32, 0x32,
+    0x14, 0x23, 0x06, 0x52, 0x72, 0x72, 0x72, 0x72, 0x41, 0x22, 0x41, 0x22, 0x4A, 0x03, 0x53, 0x12,
+    0x52, 0x23, 0x33, 0x24, 0x14, 0x22, 0x11, 0x11, 0x12, 0x22, 0x13, 0x12, 0x22, 0x21, 0x22, 0x22,
+    0x52, 0x15, 0x15, 0x03, 0x24, 0x12, 0x32, 0x23, 0x22, 0x24, 0x12, 0x22, 0x11, 0x12, 0x22, 0x14,
+    0x22, 0x23, 0x22, 0x32, 0x14, 0x22, 0x10, 0x25, 0x32, 0x32, 0x12, 0x54, 0x54, 0x54, 0x54, 0x52,
+    0x12, 0x32, 0x35, 0x20, 0x07, 0x22, 0x32, 0x12, 0x32, 0x12, 0x32, 0x12, 0x32, 0x16, 0x22, 0x62,
+    0x56, 0x20, 0x25, 0x32, 0x32, 0x12, 0x54, 0x54, 0x54, 0x54, 0x52, 0x12, 0x32, 0x35, 0x52, 0x22,
+    0x26, 0x10, 0x07, 0x42, 0x32, 0x32, 0x32, 0x32, 0x32, 0x35, 0x52, 0x22, 0x42, 0x32, 0x32, 0x32,
+    0x25, 0x23, 0x18, 0x34, 0x35, 0x55, 0x55, 0x34, 0x38, 0x10, 0x09, 0x22, 0x22, 0x22, 0x22, 0x22,
+    0x21, 0x32, 0x62, 0x62, 0x62, 0x46, 0x10, 0x04, 0x14, 0x12, 0x32, 0x22, 0x32, 0x22, 0x32, 0x22,
+    0x32, 0x22, 0x32, 0x22, 0x32, 0x22, 0x32, 0x35, 0x20, 0x04, 0x14, 0x12, 0x32, 0x22, 0x32, 0x32,
+    0x12, 0x42, 0x12, 0x42, 0x12, 0x51, 0x11, 0x63, 0x63, 0x30, 0x05, 0x15, 0x12, 0x52, 0x22, 0x21,
+    0x22, 0x22, 0x13, 0x12, 0x22, 0x13, 0x12, 0x31, 0x11, 0x11, 0x11, 0x43, 0x13, 0x43, 0x13, 0x42,
+    0x32, 0x20, 0x04, 0x14, 0x12, 0x32, 0x32, 0x12, 0x53, 0x63, 0x63, 0x52, 0x12, 0x32, 0x32, 0x14,
+    0x14, 0x04, 0x24, 0x12, 0x42, 0x32, 0x22, 0x54, 0x72, 0x82, 0x82, 0x82, 0x66, 0x20, 0x08, 0x43,
+    0x32, 0x42, 0x51, 0x52, 0x42, 0x33, 0x48, 0x06, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+    0x22, 0x24, 0x02, 0x62, 0x72, 0x62, 0x72, 0x62, 0x72, 0x72, 0x62, 0x72, 0x62, 0x72, 0x62, 0x04,
+    0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x26, 0x31, 0x51, 0x11, 0x41, 0x11, 0x31,
+    0x31, 0x11, 0x52, 0x51, 0x0B, 0x01, 0x31, 0x31, 0x15, 0x72, 0x62, 0x26, 0x12, 0x32, 0x12, 0x23,
+    0x23, 0x13, 0x03, 0x72, 0x72, 0x72, 0x13, 0x33, 0x22, 0x22, 0x42, 0x12, 0x42, 0x12, 0x42, 0x13,
+    0x22, 0x13, 0x13, 0x20, 0x24, 0x11, 0x12, 0x34, 0x53, 0x62, 0x51, 0x12, 0x32, 0x25, 0x10, 0x53,
+    0x72, 0x72, 0x33, 0x12, 0x22, 0x23, 0x12, 0x42, 0x12, 0x42, 0x12, 0x42, 0x22, 0x23, 0x33, 0x13,
+    0x25, 0x32, 0x32, 0x12, 0x5D, 0x82, 0x42, 0x26, 0x10, 0x36, 0x22, 0x72, 0x57, 0x42, 0x72, 0x72,
+    0x72, 0x72, 0x57, 0x20, 0x23, 0x13, 0x12, 0x23, 0x12, 0x42, 0x12, 0x42, 0x12, 0x42, 0x22, 0x23,
+    0x33, 0x12, 0x72, 0x72, 0x35, 0x20, 0x03, 0x72, 0x72, 0x72, 0x13, 0x33, 0x22, 0x22, 0x32, 0x22,
+    0x32, 0x22, 0x32, 0x22, 0x32, 0x14, 0x14, 0x32, 0x62, 0xC4, 0x62, 0x62, 0x62, 0x62, 0x62, 0x38,
+    0x32, 0x42, 0x76, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x47, 0x10, 0x03, 0x72, 0x72, 0x72,
+    0x14, 0x22, 0x12, 0x44, 0x54, 0x52, 0x12, 0x42, 0x22, 0x23, 0x15, 0x14, 0x62, 0x62, 0x62, 0x62,
+    0x62, 0x62, 0x62, 0x62, 0x38, 0x08, 0x32, 0x12, 0x12, 0x22, 0x12, 0x12, 0x22, 0x12, 0x12, 0x22,
+    0x12, 0x12, 0x22, 0x12, 0x12, 0x13, 0x12, 0x13, 0x03, 0x13, 0x33, 0x22, 0x22, 0x32, 0x22, 0x32,
+    0x22, 0x32, 0x22, 0x32, 0x14, 0x14, 0x25, 0x32, 0x32, 0x12, 0x54, 0x54, 0x52, 0x12, 0x32, 0x35,
+    0x20, 0x03, 0x13, 0x33, 0x22, 0x22, 0x42, 0x12, 0x42, 0x12, 0x42, 0x13, 0x22, 0x22, 0x13, 0x32,
+    0x72, 0x65, 0x40, 0x23, 0x13, 0x12, 0x23, 0x12, 0x42, 0x12, 0x42, 0x12, 0x42, 0x22, 0x23, 0x33,
+    0x12, 0x72, 0x72, 0x55, 0x04, 0x13, 0x33, 0x22, 0x22, 0x72, 0x72, 0x72, 0x57, 0x20, 0x18, 0x36,
+    0x45, 0x55, 0x38, 0x10, 0x22, 0x62, 0x62, 0x47, 0x32, 0x62, 0x62, 0x62, 0x62, 0x31, 0x34, 0x10,
+    0x03, 0x23, 0x22, 0x32, 0x22, 0x32, 0x22, 0x32, 0x22, 0x32, 0x22, 0x23, 0x33, 0x13, 0x04, 0x14,
+    0x12, 0x32, 0x22, 0x32, 0x32, 0x12, 0x42, 0x12, 0x53, 0x63, 0x30, 0x04, 0x34, 0x12, 0x52, 0x22,
+    0x21, 0x22, 0x22, 0x13, 0x12, 0x33, 0x13, 0x43, 0x13, 0x42, 0x32, 0x20, 0x04, 0x14, 0x22, 0x12,
+    0x53, 0x63, 0x63, 0x52, 0x12, 0x24, 0x14, 0x04, 0x24, 0x12, 0x42, 0x32, 0x22, 0x42, 0x22, 0x51,
+    0x12, 0x64, 0x72, 0x82, 0x72, 0x65, 0x40, 0x08, 0x42, 0x42, 0x33, 0x32, 0x42, 0x48, 0x22, 0x12,
+    0x22, 0x22, 0x22, 0x22, 0x12, 0x32, 0x22, 0x22, 0x22, 0x32, 0x0F, 0x09, 0x02, 0x32, 0x22, 0x22,
+    0x22, 0x22, 0x32, 0x12, 0x22, 0x22, 0x22, 0x12, 0x20, 0x12, 0x41, 0x21, 0x21, 0x42, 0x10,
+};
+
+static const PackedGlyph Font16P_Glyphs[] = {
+    {5, 0, 0, 0, 0}, // ' '
+    {4, 1, 2, 10, 0}, // '!'
+    {9, 2, 7, 5, 3}, // '"'
+    {10, 1, 8, 11, 13}, // '#'
+    {9, 0, 7, 13, 34}, // '$'
+    {10, 1, 8, 10, 46}, // '%'
+    {9, 2, 7, 9, 63}, // '&'
+    {5, 2, 3, 5, 75}, // '''
+    {6, 1, 4, 12, 80}, // '('
+    {6, 1, 4, 12, 92}, // ')'
+    {10, 1, 8, 7, 105}, // '*'
+    {9, 3, 7, 7, 114}, // '+'
+    {5, 9, 3, 5, 122}, // ','
+    {9, 6, 7, 1, 128}, // '-'
+    {4, 9, 2, 2, 129}, // '.'
+    {10, 0, 8, 13, 130}, // '/'
+    {9, 1, 7, 10, 144}, // '0'
+    {10, 1, 8, 10, 158}, // '1'
+    {9, 1, 7, 10, 168}, // '2'
+    {10, 1, 8, 10, 179}, // '3'
+    {9, 1, 7, 10, 191}, // '4'
+    {9, 1, 7, 10, 205}, // '5'
+    {9, 1, 7, 10, 217}, // '6'
+    {9, 1, 7, 10, 231}, // '7'
+    {9, 1, 7, 10, 242}, // '8'
+    {9, 1, 7, 10, 255}, // '9'
+    {4, 4, 2, 7, 269}, // ':'
+    {6, 4, 4, 9, 271}, // ';'
+    {11, 2, 9, 9, 278}, // '<'
+    {11, 5, 9, 3, 287}, // '='
+    {11, 2, 9, 9, 289}, // '>'
+    {9, 2, 7, 9, 299}, // '?'
+    {8, 1, 6, 11, 309}, // '@'
+    {12, 2, 10, 9, 324}, // 'A'
+    {10, 2, 8, 9, 339}, // 'B'
+    {11, 2, 9, 9, 354}, // 'C'
+    {11, 2, 9, 9, 367}, // 'D'
+    {10, 2, 8, 9, 384}, // 'E'
+    {11, 2, 9, 9, 398}, // 'F'
+    {11, 2, 9, 9, 412}, // 'G'
+    {11, 2, 9, 9, 427}, // 'H'
+    {10, 2, 8, 9, 444}, // 'I'
+    {11, 2, 9, 9, 453}, // 'J'
+    {11, 2, 9, 9, 466}, // 'K'
+    {11, 2, 9, 9, 482}, // 'L'
+    {13, 2, 11, 9, 493}, // 'M'
+    {11, 2, 9, 9, 515}, // 'N'
+    {11, 2, 9, 9, 535}, // 'O'
+    {10, 2, 8, 9, 548}, // 'P'
+    {11, 2, 9, 11, 562}, // 'Q'
+    {12, 2, 10, 9, 578}, // 'R'
+    {9, 2, 7, 9, 594}, // 'S'
+    {10, 2, 8, 9, 602}, // 'T'
+    {11, 2, 9, 9, 615}, // 'U'
+    {11, 2, 9, 9, 633}, // 'V'
+    {13, 2, 11, 9, 650}, // 'W'
+    {11, 2, 9, 9, 674}, // 'X'
+    {12, 2, 10, 9, 689}, // 'Y'
+    {9, 2, 7, 9, 702}, // 'Z'
+    {6, 1, 4, 12, 711}, // '['
+    {10, 0, 8, 13, 722}, // '\\'
+    {6, 1, 4, 12, 735}, // ']'
+    {9, 0, 7, 6, 746}, // '^'
+    {13, 15, 11, 1, 756}, // '_'
+    {5, 0, 3, 3, 757}, // '`'
+    {10, 4, 8, 7, 760}, // 'a'
+    {11, 1, 9, 10, 770}, // 'b'
+    {10, 4, 8, 7, 788}, // 'c'
+    {11, 1, 9, 10, 799}, // 'd'
+    {11, 4, 9, 7, 816}, // 'e'
+    {11, 1, 9, 10, 825}, // 'f'
+    {11, 4, 9, 10, 836}, // 'g'
+    {11, 1, 9, 10, 854}, // 'h'
+    {10, 1, 8, 10, 871}, // 'i'
+    {8, 1, 6, 13, 880}, // 'j'
+    {11, 1, 9, 10, 892}, // 'k'
+    {10, 1, 8, 10, 907}, // 'l'
+    {12, 4, 10, 7, 917}, // 'm'
+    {11, 4, 9, 7, 936}, // 'n'
+    {11, 4, 9, 7, 950}, // 'o'
+    {11, 4, 9, 10, 961}, // 'p'
+    {11, 4, 9, 10, 979}, // 'q'
+    {11, 4, 9, 7, 996}, // 'r'
+    {9, 4, 7, 7, 1006}, // 's'
+    {10, 1, 8, 10, 1012}, // 't'
+    {11, 4, 9, 7, 1024}, // 'u'
+    {11, 4, 9, 7, 1038}, // 'v'
+    {13, 4, 11, 7, 1051}, // 'w'
+    {11, 4, 9, 7, 1068}, // 'x'
+    {12, 4, 10, 10, 1079}, // 'y'
+    {9, 4, 7, 7, 1095}, // 'z'
+    {6, 1, 4, 12, 1102}, // '{'
+    {4, 1, 2, 12, 1114}, // '|'
+    {6, 1, 4, 12, 1116}, // '}'
+    {9, 5, 7, 3, 1129}, // '~'
+};
+
+const PackedFont Font16P = {
+    Font16P_Glyphs,
+    Font16P_Runs,
+    0x20, // first character
+    95, // glyphs
+    16, // line height
+    11, // widest ink box
+    1, // ink box offset from the pen
+};
@@ -0,0 +1,232 @@
+#include "mbed.h"
+#include "font_atlas.h"
+#include "ui.h"
+
+typedef struct
+{
+    const PackedFont *font; // NULL = empty slot
+    char c;
+    GlyphMask mask;
+} GlyphEntry;
+
+static GlyphEntry entries[GLYPH_CACHE_SLOTS];
+static FontCacheStats stats;
+static Timer font_timer;
+
+/*******************************************************************************
+ * @brief drop all cached glyphs and reset the counters
+ * ****************************************************************************/
+void font_cache_init(){
+    memset(entries, 0, sizeof(entries));
+    memset(&stats, 0, sizeof(stats));
+    font_timer.start();
+}
+
+/*******************************************************************************
+ * @brief get the glyph table entry of a character
+ * @param font: packed font
+ * @param c: character
+ * @return the entry, or NULL if the font has no such character
+ * ****************************************************************************/
+static const PackedGlyph *find_glyph(const PackedFont *font, char c){
+    uint8_t index = (uint8_t)c - font->first;
+    if ((uint8_t)c < font->first || index >= font->count){
+        return NULL;
+    }
+    return &font->glyphs[index];
+}
+
+/*******************************************************************************
+ * @brief expand the runs of a glyph into an alpha mask
+ * @param font: packed font
+ * @param glyph: glyph to decode
+ * @param alpha: destination, glyph->width * glyph->height bytes
+ * ****************************************************************************/
+static void decode_glyph(const PackedFont *font, const PackedGlyph *glyph, uint8_t *alpha){
+    const uint8_t *run = font->runs + glyph->offset;
+    uint8_t *end = alpha + glyph->width * glyph->height;
+
+    while (alpha < end){
+        uint8_t pair = *run++;
+        for (int n = pair >> 4; n > 0 && alpha < end; n--){
+            *alpha++ = 0x00;
+        }
+        for (int n = pair & 0x0F; n > 0 && alpha < end; n--){
+            *alpha++ = 0xFF;
+        }
+    }
+}
+
+/*******************************************************************************
+ * @brief get the alpha mask of a character, decoding it on a miss
+ * @param font: packed font
+ * @param c: character
+ * @return the mask, or NULL for blank or missing glyphs
+ * ****************************************************************************/
+const GlyphMask *font_glyph(const PackedFont *font, char c){
+    const PackedGlyph *glyph = find_glyph(font, c);
+    if (glyph == NULL || glyph->width == 0 || glyph->width * glyph->height > GLYPH_SLOT_SIZE){
+        return NULL;
+    }
+
+    uint32_t slot = ((uint32_t)(uintptr_t)font / 4 * 7 + (uint8_t)c) % GLYPH_CACHE_SLOTS;
+    GlyphEntry *entry = &entries[slot];
+    if (entry->font == font && entry->c == c){
+        stats.hits++;
+        return &entry->mask;
+    }
+
+    stats.misses++;
+    if (entry->font != NULL){
+        stats.evictions++;
+    }
+
+    uint32_t start = font_timer.elapsed_time().count();
+    uint8_t *alpha = (uint8_t *)(SDRAM_GLYPH_CACHE_ADDR + slot * GLYPH_SLOT_SIZE);
+    decode_glyph(font, glyph, alpha);
+    stats.decode_us += font_timer.elapsed_time().count() - start;
+
+    entry->font = font;
+    entry->c = c;
+    entry->mask.width = glyph->width;
+    entry->mask.height = glyph->height;
+    entry->mask.y = glyph->y;
+    entry->mask.alpha = alpha;
+    return &entry->mask;
+}
+
+/*******************************************************************************
+ * @brief get the advance of a character
+ * @param font: packed font
+ * @param c: character
+ * @return the advance in pixels, 0 if the font has no such character
+ * ****************************************************************************/
+int font_char_width(const PackedFont *font, char c){
+    const PackedGlyph *glyph = find_glyph(font, c);
+    return glyph ? glyph->advance : 0;
+}
+
+/*******************************************************************************
+ * @brief measure a string without decoding any glyph
+ * @param font: packed font
+ * @param text: string to measure
+ * @return the width in pixels
+ * ****************************************************************************/
+int font_text_width(const PackedFont *font, const char *text){
+    int width = 0;
+    for (; *text != 0; text++){
+        width += font_char_width(font, *text);
+    }
+    return width;
+}
+
+/*******************************************************************************
+ * @brief draw a string into the selected LCD layer
+ * @param x: x position of the pen
+ * @param y: y position of the line top
+ * @param text: string to draw
+ * @param font: packed font
+ * @param color: text color
+ * @param back: text box color, or FONT_NO_BACK
+ * ****************************************************************************/
+void font_draw_text(int x, int y, const char *text, const PackedFont *font, uint32_t color, uint32_t back){
+    uint32_t start = font_timer.elapsed_time().count();
+    int right = lcd.GetXSize();
+
+    if (back != FONT_NO_BACK){
+        int width = min(font_text_width(font, text), right - x);
+        if (width > 0){
+            uint32_t text_color = lcd.GetTextColor();
+            lcd.SetTextColor(back);
+            lcd.FillRect(x, y, width, font->height);
+            lcd.SetTextColor(text_color);
+        }
+    }
+
+    for (; *text != 0; text++){
+        int advance = font_char_width(font, *text);
+        const GlyphMask *mask = font_glyph(font, *text);
+        if (mask != NULL){
+            if (x + font->bearing + mask->width > right){
+                break;
+            }
+            lcd.DrawAlphaMask(x + font->bearing, y + mask->y, mask->width, mask->height, mask->alpha, color);
+        }
+        x += advance;
+    }
+
+    stats.strings++;
+    stats.draw_us += font_timer.elapsed_time().count() - start;
+}
+
+/*******************************************************************************
+ * @brief get the counters
+ * @return the counters
+ * ****************************************************************************/
+FontCacheStats font_cache_stats(){
+    return stats;
+}
+
+/*******************************************************************************
+ * @brief print the counters
+ * ****************************************************************************/
+void font_cache_print_stats(){
+    printf("Glyph cache: %lu hits, %lu misses, %lu evictions, %lu us decoding; %lu strings, avg %lu us\n",
+           (unsigned long)stats.hits, (unsigned long)stats.misses, (unsigned long)stats.evictions,
+           (unsigned long)stats.decode_us, (unsigned long)stats.strings,
+           (unsigned long)(stats.strings ? stats.draw_us / stats.strings : 0));
+}
+
+/*******************************************************************************
+ * @brief time the BSP text path against the packed font and print both
+ *
+ * Draws into the selected layer, so it has to run before the screen is drawn.
+ * ****************************************************************************/
+void font_benchmark(){
+#if FONT_BENCHMARK
+    const int runs = 20;
+    sFONT *bsp_font = &Font16; // the BSP font the text was drawn in before
+    lcd.SetFont(bsp_font);
+    uint32_t start, bsp_us, packed_us, cold_us, bsp_width_ns, packed_width_ns;
+    volatile int width = 0;
+
+    start = font_timer.elapsed_time().count();
+    for (int i = 0; i < runs; i++){
+        lcd.DisplayStringAt(0, 0, (uint8_t *)title, LEFT_MODE);
+    }
+    bsp_us = (font_timer.elapsed_time().count() - start) / runs;
+
+    start = font_timer.elapsed_time().count();
+    font_draw_text(0, 0, title, &UI_FONT, LCD_COLOR_WHITE, LCD_COLOR_BLUE);
+    cold_us = font_timer.elapsed_time().count() - start;
+
+    start = font_timer.elapsed_time().count();
+    for (int i = 0; i < runs; i++){
+        font_draw_text(0, 0, title, &UI_FONT, LCD_COLOR_WHITE, LCD_COLOR_BLUE);
+    }
+    packed_us = (font_timer.elapsed_time().count() - start) / runs;
+
+    // 1000 calls, so the elapsed us are ns per call. The BSP can only
+    // multiply, which is wrong for anything proportional
+    start = font_timer.elapsed_time().count();
+    for (int i = 0; i < 1000; i++){
+        width = strlen(title) * bsp_font->Width;
+    }
+    bsp_width_ns = font_timer.elapsed_time().count() - start;
+
+    start = font_timer.elapsed_time().count();
+    for (int i = 0; i < 1000; i++){
+        width = font_text_width(&UI_FONT, title);
+    }
+    packed_width_ns = font_timer.elapsed_time().count() - start;
+
+    printf("Font: \"%s\" BSP %u px wide, %lu us per draw; packed %d px wide, %lu us cold, %lu us per draw\n",
+           title, (unsigned)(strlen(title) * bsp_font->Width), (unsigned long)bsp_us, width,
+           (unsigned long)cold_us, (unsigned long)packed_us);
+    printf("Font: width of \"%s\" %lu ns (strlen * Width), %lu ns (glyph table)\n",
+           title, (unsigned long)bsp_width_ns, (unsigned long)packed_width_ns);
+
+    stats.strings = 0;
+    stats.draw_us = 0;
+#endif
+}
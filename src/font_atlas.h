@@ -0,0 +1,69 @@
+#ifndef FONT_ATLAS_H
+#define FONT_ATLAS_H
+
+#include "mbed.h"
+#include "sdram_map.h"
+#include "packed_font.h"
+
+// Decoded glyphs are 8-bit alpha masks in fixed size SDRAM slots,
+// direct mapped by font and character
+#define GLYPH_SLOT_SIZE 512 // bytes, Font24 ink boxes are at most 17x24
+#define GLYPH_CACHE_SLOTS (SDRAM_GLYPH_CACHE_SIZE / GLYPH_SLOT_SIZE)
+
+// Back color that leaves the pixels around the glyphs untouched
+#define FONT_NO_BACK 0x00000000
+
+// Print a DisplayStringAt vs packed font comparison once at boot. It draws
+// with the BSP's Font16, which is then linked in; not measured on the board
+// yet
+#ifndef FONT_BENCHMARK
+#define FONT_BENCHMARK 0
+#endif
+
+// Decoded glyph
+typedef struct
+{
+    uint8_t width;  // ink box size
+    uint8_t height;
+    uint8_t y;      // ink box top, relative to the line top
+    const uint8_t *alpha; // width * height bytes, 0 transparent, 255 ink
+} GlyphMask;
+
+// Cache and draw counters
+typedef struct
+{
+    uint32_t hits;      // glyphs served from the cache
+    uint32_t misses;    // glyphs decoded
+    uint32_t evictions; // glyphs replaced in their slot
+    uint32_t decode_us; // time spent decoding runs
+    uint32_t strings;   // strings drawn with font_draw_text
+    uint32_t draw_us;   // time spent in font_draw_text
+} FontCacheStats;
+
+// Drop all cached glyphs and reset the counters
+void font_cache_init();
+
+// Get the alpha mask of a character, decoding it on a miss.
+// Returns NULL for blank glyphs and characters outside the font.
+const GlyphMask *font_glyph(const PackedFont *font, char c);
+
+// Advance of a character in pixels
+int font_char_width(const PackedFont *font, char c);
+
+// Width of a string in pixels, from the glyph table only
+int font_text_width(const PackedFont *font, const char *text);
+
+// Draw a string into the selected LCD layer, one DMA2D blend per glyph.
+// Unless back is FONT_NO_BACK the text box is filled with it first.
+void font_draw_text(int x, int y, const char *text, const PackedFont *font, uint32_t color, uint32_t back);
+
+// Get the counters
+FontCacheStats font_cache_stats();
+
+// Print the counters
+void font_cache_print_stats();
+
+// Time the BSP monospace text path against the packed font and print both
+void font_benchmark();
+
+#endif
@@ -16,6 +16,8 @@ float sensitivity = 0.0f;
 
 Gyroscope_RawData *gyro_raw;
 
+Kernel::Clock::time_point poweron_time; // when CTRL_REG_1 last turned the axes on
+
 // Write I/O
 void WriteIO(uint8_t address, uint8_t data)
 {
@@ -26,7 +28,7 @@ void WriteIO(uint8_t address, uint8_t data)
 }
 
 // Get raw data from gyroscope
-void ReadIO(Gyroscope_RawData *rawdata)
+RAMFUNC void ReadIO(Gyroscope_RawData *rawdata)
 {
   cs = 0;
   gyroscope.write(OUT_X_L | 0x80 | 0x40); // auto-incremented read
@@ -46,6 +48,13 @@ void GyroscopeCalibration(Gyroscope_RawData *rawdata)
   int16_t sumY = 0;
   int16_t sumZ = 0;
   printf("========[Calibrating...]========\r\n");
+
+  // The LCD panel shares SPI5 and may have changed the bus format since power on
+  gyroscope.format(8, 3);
+  gyroscope.frequency(1000000);
+
+  // Let the zero rate level settle; usually over already when started at boot
+  ThisThread::sleep_until(poweron_time + chrono::milliseconds(POWERON_SETTLE_MS));
   for (int i = 0; i < 128; i++)
   {
     ReadIO(rawdata);
@@ -64,10 +73,19 @@ void GyroscopeCalibration(Gyroscope_RawData *rawdata)
   printf("========[Calibration finish.]========\r\n");
 }
 
-// Initiate gyroscope, set up control registers
+// Initiate gyroscope, set up control registers and calibrate
 void InitiateGyroscope(Gyroscope_Init_Parameters *init_parameters, Gyroscope_RawData *init_raw_data)
 {
   printf("\r\n========[Initializing gyroscope...]========\r\n");
+  PowerOnGyroscope(init_parameters, init_raw_data);
+  GyroscopeCalibration(gyro_raw); // calibrate the gyroscope and find the threshold for x, y, and z.
+  printf("========[Initiation finish.]========\r\n");
+}
+
+// Set up control registers and turn the gyroscope on, returns without waiting
+// for it to settle so the caller can do other work meanwhile
+void PowerOnGyroscope(Gyroscope_Init_Parameters *init_parameters, Gyroscope_RawData *init_raw_data)
+{
   gyro_raw = init_raw_data;
   cs = 1;
   // set up gyroscope
@@ -77,6 +95,7 @@ void InitiateGyroscope(Gyroscope_Init_Parameters *init_parameters, Gyroscope_Raw
   WriteIO(CTRL_REG_1, init_parameters->conf1 | POWERON); // set ODR Bandwidth and enable all 3 axises
   WriteIO(CTRL_REG_3, init_parameters->conf3);           // DRDY enable
   WriteIO(CTRL_REG_4, init_parameters->conf4);           // LSB, full sacle selection: 500dps
+  poweron_time = Kernel::Clock::now();
 
   switch (init_parameters->conf4)
   {
@@ -96,9 +115,6 @@ void InitiateGyroscope(Gyroscope_Init_Parameters *init_parameters, Gyroscope_Raw
     sensitivity = SENSITIVITY_2000;
     break;
   }
-
-  GyroscopeCalibration(gyro_raw); // calibrate the gyroscope and find the threshold for x, y, and z.
-  printf("========[Initiation finish.]========\r\n");
 }
 
 // convert raw data to dps
@@ -128,7 +144,7 @@ float GetDistance(int16_t arr[])
 }
 
 // convert raw data to calibrated data directly
-void GetCalibratedRawData()
+RAMFUNC void GetCalibratedRawData()
 {
   ReadIO(gyro_raw);
 
@@ -1,4 +1,8 @@
+#ifndef GYRO_H
+#define GYRO_H
+
 #include <mbed.h>
+#include "ramfunc.h"
 
 #define WHO_AM_I 0x0F // device id
 
@@ -89,6 +93,7 @@
 
 #define POWERON 0x0f  // turn on gyroscope
 #define POWEROFF 0x00 // turn off gyroscope
+#define POWERON_SETTLE_MS 250 // wait after power on before sampling the zero rate level
 
 #define SAMPLE_TIME_20 20
 #define SAMPLE_INTERVAL_0_05 0.005f
@@ -121,11 +126,14 @@ typedef struct
 void WriteIO(uint8_t address, uint8_t data);
 
 // Read IO
-void ReadIO(Gyroscope_RawData *rawdata);
+RAMFUNC void ReadIO(Gyroscope_RawData *rawdata);
 
 // Gyroscope calibration
 void GyroscopeCalibration(Gyroscope_RawData *rawdata);
 
+// Gyroscope power on, without calibration
+void PowerOnGyroscope(Gyroscope_Init_Parameters *init_parameters, Gyroscope_RawData *init_raw_data);
+
 // Gyroscope initialization
 void InitiateGyroscope(Gyroscope_Init_Parameters *init_parameters, Gyroscope_RawData *init_raw_data);
 
@@ -139,7 +147,9 @@ float ConvertVelocity(int16_t rawdata);
 float GetDistance(int16_t arr[]);
 
 // Get calibrated data
-void GetCalibratedRawData();
+RAMFUNC void GetCalibratedRawData();
 
 // Turn off the gyroscope
-void PowerOff();
\ No newline at end of file
+void PowerOff();
+
+#endif
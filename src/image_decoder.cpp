@@ -0,0 +1,154 @@
+#include "mbed.h"
+#include "image_decoder.h"
+#include "ui.h"
+
+// Not in CCM RAM, the DMA2D reads them
+static uint16_t blocks[2][IMAGE_BLOCK_PIXELS];
+static ImageStats stats;
+static Timer image_timer;
+
+static inline uint32_t color_hash(uint16_t color){
+    return ((color >> 11) * 3 + ((color >> 5) & 0x3F) * 5 + (color & 0x1F) * 7) & 63;
+}
+
+/*******************************************************************************
+ * @brief start decoding an image
+ * @param stream: decoder state
+ * @param image: packed image
+ * ****************************************************************************/
+void image_stream_begin(ImageStream *stream, const PackedImage *image){
+    stream->in = image->data;
+    stream->end = image->data + image->size;
+    stream->prev = 0;
+    stream->run = 0;
+    memset(stream->index, 0, sizeof(stream->index));
+}
+
+/*******************************************************************************
+ * @brief decode the next pixels of an image
+ * @param stream: decoder state
+ * @param out: destination, count pixels
+ * @param count: pixels wanted
+ * @return pixels decoded, less than count only at the end of the data
+ * ****************************************************************************/
+uint32_t image_stream_read(ImageStream *stream, uint16_t *out, uint32_t count){
+    const uint8_t *in = stream->in;
+    uint16_t prev = stream->prev;
+    uint32_t done = 0;
+
+    // finish a run left over from the previous call
+    while (stream->run > 0 && done < count){
+        out[done++] = prev;
+        stream->run--;
+    }
+
+    while (done < count && in < stream->end){
+        uint8_t op = *in++;
+
+        if (op == IMAGE_OP_RGB){
+            prev = in[0] | (in[1] << 8);
+            in += 2;
+        }
+        else if ((op & 0xC0) == IMAGE_OP_INDEX){
+            prev = stream->index[op];
+        }
+        else if ((op & 0xC0) == IMAGE_OP_DIFF){
+            uint32_t r = ((prev >> 11) + ((op >> 4) & 3) - 2) & 0x1F;
+            uint32_t g = (((prev >> 5) & 0x3F) + ((op >> 2) & 3) - 2) & 0x3F;
+            uint32_t b = ((prev & 0x1F) + (op & 3) - 2) & 0x1F;
+            prev = (r << 11) | (g << 5) | b;
+        }
+        else if ((op & 0xC0) == IMAGE_OP_LUMA){
+            int32_t dg = (op & 0x3F) - 32;
+            uint8_t rb = *in++;
+            uint32_t r = ((prev >> 11) + dg + (rb >> 4) - 8) & 0x1F;
+            uint32_t g = (((prev >> 5) & 0x3F) + dg) & 0x3F;
+            uint32_t b = ((prev & 0x1F) + dg + (rb & 0x0F) - 8) & 0x1F;
+            prev = (r << 11) | (g << 5) | b;
+        }
+        else{
+            // run: prev once now, the rest possibly in the next call
+            uint32_t run = (op & 0x3F) + 1;
+            uint32_t n = min(run, count - done);
+            for (uint32_t i = 0; i < n; i++){
+                out[done++] = prev;
+            }
+            stream->run = run - n;
+            continue;
+        }
+
+        stream->index[color_hash(prev)] = prev;
+        out[done++] = prev;
+    }
+
+    stream->in = in;
+    stream->prev = prev;
+    return done;
+}
+
+/*******************************************************************************
+ * @brief draw an image into the selected layer
+ *
+ * Decodes a block of whole rows into one buffer while the DMA2D converts the
+ * previous block from the other one to ARGB8888 in the frame buffer.
+ * @param x: left edge
+ * @param y: top edge
+ * @param image: packed image
+ * @return false if the image does not fit on the screen or is wider than a block
+ * ****************************************************************************/
+bool image_draw(int x, int y, const PackedImage *image){
+    if (x < 0 || y < 0 || x + image->width > (int)lcd.GetXSize() || y + image->height > (int)lcd.GetYSize() ||
+        image->width > IMAGE_BLOCK_PIXELS){
+        return false;
+    }
+
+    image_timer.start();
+    uint32_t start = image_timer.elapsed_time().count();
+    uint32_t decode_us = 0;
+    uint32_t rows_per_block = IMAGE_BLOCK_PIXELS / image->width;
+    int current = 0;
+
+    ImageStream stream;
+    image_stream_begin(&stream, image);
+
+    for (uint32_t row = 0; row < image->height; row += rows_per_block){
+        uint32_t rows = min(rows_per_block, (uint32_t)image->height - row);
+        uint32_t decode_start = image_timer.elapsed_time().count();
+        uint32_t pixels = image_stream_read(&stream, blocks[current], rows * image->width);
+        decode_us += image_timer.elapsed_time().count() - decode_start;
+        if (pixels < rows * image->width){
+            // truncated data, keep the screen tidy
+            memset(blocks[current] + pixels, 0, (rows * image->width - pixels) * sizeof(uint16_t));
+        }
+
+        // waits for the other block, then returns while this one converts
+        lcd.DrawRGB565(x, y + row, image->width, rows, blocks[current]);
+        current ^= 1;
+    }
+    lcd.WaitDMA2D();
+
+    stats.images++;
+    stats.pixels += image->width * image->height;
+    stats.packed_bytes += image->size;
+    stats.decode_us += decode_us;
+    stats.draw_us += image_timer.elapsed_time().count() - start;
+    return true;
+}
+
+/*******************************************************************************
+ * @brief get the counters
+ * @return the counters
+ * ****************************************************************************/
+ImageStats image_stats(){
+    return stats;
+}
+
+/*******************************************************************************
+ * @brief print the counters
+ * ****************************************************************************/
+void image_print_stats(){
+    printf("Images: %lu drawn, %lu px from %lu bytes (%lu%% of RGB565), decode %lu us, draw %lu us\n",
+           (unsigned long)stats.images, (unsigned long)stats.pixels, (unsigned long)stats.packed_bytes,
+           (unsigned long)(stats.pixels ? 100ULL * stats.packed_bytes / (2ULL * stats.pixels) : 0),
+           (unsigned long)stats.decode_us, (unsigned long)stats.draw_us);
+}
@@ -0,0 +1,47 @@
+#ifndef IMAGE_DECODER_H
+#define IMAGE_DECODER_H
+
+#include "mbed.h"
+#include "packed_image.h"
+
+// RGB565 pixels decoded per DMA2D transfer; two such buffers are used so
+// the CPU decodes one while the DMA2D converts the other
+#define IMAGE_BLOCK_PIXELS 2048
+
+// Decoder state, an image can be decoded in any number of pieces
+typedef struct
+{
+    const uint8_t *in;
+    const uint8_t *end;
+    uint16_t prev;
+    uint8_t run;         // repeats of prev still to output
+    uint16_t index[64];
+} ImageStream;
+
+// Counters over all image_draw() calls
+typedef struct
+{
+    uint32_t images;
+    uint32_t pixels;
+    uint32_t packed_bytes;
+    uint32_t decode_us;  // CPU time decoding
+    uint32_t draw_us;    // whole calls, decoding overlapped with DMA2D
+} ImageStats;
+
+// Start decoding an image
+void image_stream_begin(ImageStream *stream, const PackedImage *image);
+
+// Decode the next pixels; returns how many were written, less than count
+// only at the end of the data
+uint32_t image_stream_read(ImageStream *stream, uint16_t *out, uint32_t count);
+
+// Draw an image into the selected layer; false if it does not fit
+bool image_draw(int x, int y, const PackedImage *image);
+
+// Get the counters
+ImageStats image_stats();
+
+// Print the counters
+void image_print_stats();
+
+#endif
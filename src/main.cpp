@@ -12,504 +12,1273 @@
 #include <cmath>
 #include <math.h>
 #include "gyro.h"
+#include "ui.h"
+#include "sprite_cache.h"
+#include "font_atlas.h"
+#include "trace_plot.h"
+#include "render.h"
+#include "image_decoder.h"
+#include "boot.h"
+#include "touch.h"
+#include "widgets.h"
+#include "state_log.h"
+#include "store_worker.h"
+#include "template_codec.h"
+#include "settings.h"
+#include "arena.h"
+#include "sdram_map.h"
+#include "ccm_map.h"
+#include "ramfunc.h"
+#include "dma_copy.h"
+#include "audit_log.h"
 #include "drivers/LCD_DISCO_F429ZI.h"
 #include "drivers/TS_DISCO_F429ZI.h"
 #define USER_BUTTON PA_0
 
-// Event flags
-#define KEY_FLAG 1
-#define UNLOCK_FLAG 2
-#define ERASE_FLAG 4
-#define DATA_READY_FLAG 8
-
-//LCD font size
-#define FONT_SIZE 22
+// Application states
+#define APP_IDLE 0
+#define APP_WAIT 1      // "Pls Wait", then until the gyroscope is calibrated
+#define APP_COUNTDOWN 2 // "Recording in 3..."
+#define APP_RECORDING 3 // sampling the gyroscope
+#define APP_MATCHING 4  // saving the key or comparing with it
+#define APP_ARMED 5     // fast flow: sampling, waiting for the gesture to start
+#define APP_STATES 6
+
+// Application events
+#define APP_EV_RECORD 0 // RECORD clicked
+#define APP_EV_UNLOCK 1 // UNLOCK clicked
+#define APP_EV_ERASE 2  // user button
+#define APP_EV_TIMER 3  // the state's timer ran out
+#define APP_EV_DONE 4   // the state's work is finished
+#define APP_EV_MOTION 5 // the gesture started
+#define APP_EV_STILL 6  // the gesture ended
+#define APP_EV_MODE 7   // button held: switch between the guided and fast flow
+
+// Flows, selected at runtime by holding a button
+#define APP_FLOW_GUIDED 0 // "Pls Wait", countdown, fixed capture time
+#define APP_FLOW_FAST 1   // capture from the click, cut by motion
+
+// Flow at reset
+#ifndef APP_FAST_UNLOCK
+#define APP_FAST_UNLOCK 0
+#endif
+
+// Step timings of a recording
+#define APP_WAIT_TIME 1s
+#define APP_GYRO_POLL 50ms
+#define APP_COUNTDOWN_STEP 1s
+#define APP_COUNTDOWN_FROM 3
+#define APP_RECORD_TIME 5s
+#define APP_SAMPLE_PERIOD 50ms // 20Hz
+
+// Longest recording: the capture time and the fast flow's pre-roll
+#define APP_MAX_SAMPLES (APP_RECORD_TIME / APP_SAMPLE_PERIOD + APP_PREROLL_SAMPLES + 1)
+
+// Motion detection of the fast flow, on |x| + |y| + |z| in dps. The gyro
+// bias is cached from the boot calibration, so none of it is spent here.
+#define APP_MOTION_START_DPS 30.0f
+#define APP_MOTION_START_SAMPLES 2 // this many in a row above start
+#define APP_MOTION_STOP_DPS 10.0f
+#define APP_MOTION_STOP_SAMPLES 6  // this many in a row below stop, 300 ms
+#define APP_PREROLL_SAMPLES 4      // kept from before the start was detected
+#define APP_ARM_TIMEOUT 5s         // no gesture by then gives up
+
+// Queued events, each waiting call takes one slot
+#define APP_QUEUE_EVENTS 16
+
+// Values of err after a match
+#define APP_ERR_TOO_SHORT -1  // recordings too short to compare
+#define APP_ERR_KEY_FORMAT -2 // the saved key is in a format this build cannot decode
+
+// Store slot of the gesture key
+#define APP_KEY_SLOT 0
+
+// Wait between tries to read the key in place while the store erases,
+// MATCHING handles its timer meanwhile; an erase takes up to 4 s, the
+// unlock is given up after APP_STORE_WAIT_MAX
+#define APP_STORE_RETRY 20ms
+#define APP_STORE_WAIT_MAX 6s
+
+// app_key_map() results
+#define APP_KEY_RAM 0   // match against the RAM copy
+#define APP_KEY_FLASH 1 // mapped in place
+#define APP_KEY_BUSY 2  // only on flash, which is being erased: try again later
+
+// Format the key is stored in, see template_codec.h. The default is exact
+// and under half the size of the floats; TEMPLATE_INT8 packed is a fifth
+// but lossy, TEMPLATE_F32 matches the floats without decoding.
+#ifndef APP_KEY_FORMAT
+#define APP_KEY_FORMAT (TEMPLATE_INT16 | TEMPLATE_PACKED)
+#endif
+
+// Key samples decoded at a time while matching, into the match scratch
+#define APP_DECODE_BLOCK 32
+
+// Set to 1 to print every recording as sample lines for tools/template_codec
+#ifndef APP_DUMP_RECORDING
+#define APP_DUMP_RECORDING 0
+#endif
+
+// Set to 1 to time the match stage at boot with its scratch in CCM, SRAM and
+// SDRAM, with the display idle and while the DMA2D redraws the whole frame
+#ifndef APP_MATCH_BENCH
+#define APP_MATCH_BENCH 0
+#endif
+#define APP_BENCH_RUNS 20
+
+// Set to 1 to time the gyroscope read and the match stage at boot, alone
+// and during a flash erase; build with RAMFUNC_ENABLED 0 and 1 to compare
+// flash and RAM. The erase is of a bank 2 sector below the store, which
+// nothing else uses; one erase per boot.
+#ifndef APP_RAM_BENCH
+#define APP_RAM_BENCH 0
+#endif
+#define APP_BENCH_ERASE_ADDR 0x081A0000 // sector 21
 
 // set limit for unlocking
 #define CORRELATION_LIMIT 0.1f
 
-InterruptIn gyro_int2(PA_2, PullDown);
+DigitalIn gyro_int2(PA_2, PullDown); // gyroscope data ready
 InterruptIn user_button(USER_BUTTON, PullDown);
 
 DigitalOut green_led(LED1);
 DigitalOut red_led(LED2);
 
-LCD_DISCO_F429ZI lcd; // LCD object
-TS_DISCO_F429ZI ts; // Touch screen object
-
-EventFlags flags; // Event flags
+LCD_DISCO_F429ZI lcd(false); // LCD object, brought up by boot_init()
 
-Timer timer; // Timer
+// Runs the application state machine on app_thread
+EventQueue app_queue(APP_QUEUE_EVENTS * EVENTS_EVENT_SIZE);
 
 
 // -------------Initializing Functions for data processing, threads, flash and filters--------------
 
-void draw_rounded_button(int x, int y, int width, int height, const char *label);
-bool touch_button_validation(int touch_x, int touch_y, int button_x, int button_y, int button_width, int button_height);
-
-float euclidean_distance(const array<float, 3> &a, const array<float, 3> &b);
-float dtwDistance(const vector<array<float, 3>> &s, const vector<array<float, 3>> &t);
-void trim_gyro_data(vector<array<float, 3>> &data);
-float correlation(const vector<float> &a, const vector<float> &b);
-array<float, 3> calculateCorrelation(vector<array<float, 3>>& vec1, vector<array<float, 3>>& vec2);
 
-void gyroscope_thread();
+// A recording, in the SDRAM arena for the length of an attempt
+typedef vector<array<float, 3>, ArenaAllocator<array<float, 3>>> Recording;
+
+// Samples read where they are, in flash or in a vector
+typedef struct
+{
+    const array<float, 3> *samples;
+    size_t size;
+} GestureSpan;
+
+// Kept in the EEPROM, see settings.h
+typedef struct
+{
+    uint8_t flow; // APP_FLOW_*, as last switched to
+} AppSettings;
+
+typedef struct
+{
+    uint32_t boots;
+    uint32_t keys_saved;
+    uint32_t unlock_attempts;
+    uint32_t unlocked;
+} AppCounters;
+
+// Running sums of the correlation of each axis, added to a block at a time
+typedef struct
+{
+    float sum_1[3], sum_2[3], sum_12[3], sq_sum_1[3], sq_sum_2[3];
+    size_t n;
+} CorrelationSums;
+
+// Scratch of the match stage, read and written on every step of the kernels
+// and by nothing but the CPU: kept in CCM
+typedef struct
+{
+    CorrelationSums sums;
+    float dtw_rows[2][APP_MAX_SAMPLES + 1];  // last two rows of the DTW matrix
+    array<float, 3> block[APP_DECODE_BLOCK]; // key samples decoded from flash
+} MatchScratch;
+
+// The key taken a block at a time against a recording
+typedef struct
+{
+    MatchScratch *scratch;
+    GestureSpan record;
+    size_t key_done;           // key samples taken so far
+    float *previous, *current; // DTW rows, record.size + 1 each
+} Match;
+
+typedef struct
+{
+    array<float, 3> correlation; // of each axis
+    float dtw;                   // DTW distance, infinity if not computed
+} MatchResult;
+
+// Samples are handed to template_codec.h as float[3], and TEMPLATE_F32
+// keys matched in place from the store
+static_assert(sizeof(array<float, 3>) == 3 * sizeof(float) && alignof(array<float, 3>) <= STORE_ALIGN,
+              "samples must be readable in place from the store");
+
+RAMFUNC float euclidean_distance(const array<float, 3> &a, const array<float, 3> &b);
+void trim_gyro_data(Recording &data);
+RAMFUNC void correlation_add(CorrelationSums &sums, const array<float, 3> *key, const array<float, 3> *record, size_t count);
+array<float, 3> correlation_result(const CorrelationSums &sums);
+RAMFUNC void dtw_add_row(Match &match, const array<float, 3> &sample);
+void match_begin(Match &match, MatchScratch *scratch, const GestureSpan &record);
+void match_add(Match &match, const array<float, 3> *key, size_t count);
+MatchResult match_result(const Match &match);
+MatchResult match_span(MatchScratch *scratch, const GestureSpan &key, const GestureSpan &record);
+MatchResult app_match_key(TemplateDecoder *key, const GestureSpan &record);
+void app_match_bench();
+void app_ram_bench();
+
+void app_post(uint8_t event);
+void app_handle(uint8_t event, uint32_t event_us);
+void app_sample();
 void touch_screen_thread();
-
-bool storeGyroDataToFlash(vector<array<float, 3>> &gesture_key, uint32_t flash_address);
-vector<array<float, 3>> readGyroDataFromFlash(uint32_t flash_address, size_t data_size);
+void app_load_key();
+void app_load_settings();
+bool app_unlock_match();
+void app_audit(uint8_t verdict, const MatchResult &match, size_t samples);
+bool app_has_key();
+void app_dump_recording(const char *name, const Recording &recording);
 
 
 
 //-----------------------------------Callback functions----------------------------------------
-void button_press(){ // button press
-    flags.set(ERASE_FLAG);
-}
-void onGyroDataReady(){ // Gyrscope data ready
-
-    flags.set(DATA_READY_FLAG);
+RAMFUNC void button_press(){ // button press
+    app_post(APP_EV_ERASE);
 }
 
 
 //--------------------------------------Initialize Global Variables -----------------------------
-vector<array<float, 3>> gesture_key; // gesture key
-vector<array<float, 3>> unlocking_record; // unlocking record
-
-const int button_x_1 = 60; //record button x axis
-const int button_y_1 = 80; // record button y axis
-const int button1_width = 120; // record button block width
-const int button1_height = 50; // record button block height
-const char *button1_label = "RECORD"; //main button label
-const int button_x_2 = 60; // unlock button x axis
-const int button_y_2 = 180; // unlock button y axis
-const int button2_width = 120; // unlock button width
-const int button2_height = 50; // ublock button height
-const char *button2_label = "UNLOCK"; // main button label
-const int title_x = 5; // main title x axis
-const int title_y = 30;  // main title y axis
-const char *title = "PASSWORD UNLOCKER"; // main title
-const int text_x = 5;
-const int text_y = 270;
+// Large buffers of one attempt: the recordings
+Arena app_arena;
+ArenaMark app_attempt_mark; // top of the arena before the attempt
+
+vector<array<float, 3>> gesture_key; // gesture key, until it can be read in place from the store
+bool app_key_stored = false; // the store holds the key
+Recording unlocking_record{ArenaAllocator<array<float, 3>>(&app_arena)}; // unlocking record
+Recording temp_key{ArenaAllocator<array<float, 3>>(&app_arena)}; // the recording in progress
+
+// The unlocking record while it is matched: the DTW reads it once per key
+// sample, so it is moved out of SDRAM by DMA. Not in CCM, the DMA writes it.
+array<float, 3> app_match_record[APP_MAX_SAMPLES];
+GestureSpan app_unlock_record;  // the unlocking record, where it is matched from
+uint32_t app_unlock_ticket;     // its DMA copy
+uint32_t app_unlock_tries;      // key lookups the store was busy for
+
+const char *const app_state_names[] = {"IDLE", "WAIT", "COUNTDOWN", "RECORDING", "MATCHING", "ARMED"};
+const char *const app_event_names[] = {"record", "unlock", "erase", "timer", "done", "motion", "still", "mode"};
+const char *const app_flow_names[] = {"guided", "fast"};
+
+uint8_t app_state = APP_IDLE;
+uint8_t app_flow = APP_FAST_UNLOCK ? APP_FLOW_FAST : APP_FLOW_GUIDED;
+uint8_t app_mode;       // APP_EV_RECORD or APP_EV_UNLOCK, what the recording is for
+int app_countdown;
+int app_timer_id = 0;   // pending state timer, 0 if none
+int app_sample_id = 0;  // periodic sampling during a recording
+int app_motion_count;   // samples in a row past the start or stop threshold
+uint32_t app_dropped = 0; // events lost to a full queue
+AppCounters app_counters; // over all resets
+
+// Sampling delays, this recording
+uint32_t app_sample_due;           // us ticker when the next sample is due
+uint32_t app_sample_late_us;       // most a sample ran after it was due
+uint32_t app_sample_late_store_us; // the same, while the store was writing
+
+// Time spent in each state, for the phase breakdown
+uint32_t app_state_since;             // us ticker when the current state was entered
+uint32_t app_dispatch_us;             // click posted to handled, this attempt
+uint32_t app_phase_us[APP_STATES];    // this attempt
+uint32_t app_phase_total_us[2][APP_STATES + 1]; // per flow, the last entry is the dispatch
+uint32_t app_attempts[2];
+
+Thread touchscreen_thread(osPriorityNormal, 2048);
+
+// Dispatches app_queue: sampling, matching and the DTW recursion run here,
+// so its stack is in CCM. Nothing on it is a DMA source or destination:
+// the gyroscope SPI is polled, render commands copy their text, the EEPROM
+// and store buffers are static, and dma_copy() copies CCM on the CPU.
+typedef uint64_t AppStack[CCM_APP_STACK_SIZE / sizeof(uint64_t)];
+CCM_OVERLAY(AppStack, app_stack, CCM_APP_STACK_ADDR, CCM_APP_STACK_SIZE);
+Thread app_thread(osPriorityNormal, sizeof(AppStack), (unsigned char *)app_stack);
+
 const char *text_0 = "NO PASS RECORDED";
 const char *text_1 = "LOCKED";
 
 int err = 0; // debug
 
+CCM_OVERLAY(MatchScratch, match_scratch, CCM_MATCH_ADDR, CCM_MATCH_SIZE);
+
+// Gyroscope configuration and the sample GetCalibratedRawData() reads into
+Gyroscope_Init_Parameters gyro_init_param = {ODR_200_CUTOFF_50, INT2_DRDY, FULL_SCALE_500};
+Gyroscope_RawData raw_data;
+
 /*****************************************************************************
  * @brief main function
  * ***************************************************************************/
 int main(){
-    lcd.Clear(LCD_COLOR_MAGENTA);
+    // Before anything in RAMFUNC runs, the gyroscope read of the boot thread
+    // first
+    ramfunc_init();
+
+    // Display path up here, panel and gyroscope power up in the background
+    boot_init(&gyro_init_param, &raw_data);
 
-    // Draw 2 touch screen buttons
-    draw_rounded_button(button_x_1, button_y_1, button1_width, button1_height, button1_label);
-    draw_rounded_button(button_x_2, button_y_2, button2_width, button2_height, button2_label);
+    // Scribbles on the status layer, before it is drawn
+    app_match_bench();
 
-    // Display the welcome message
-    lcd.DisplayStringAt(title_x, title_y, (uint8_t *)title, CENTER_MODE);
+    // Draw the static screen once and set up the status layer
+    ui_init();
+    boot_show_frame();
+    image_print_stats();
+
+    // Waits for the gyroscope calibration
+    app_ram_bench();
+
+    // Live gesture plot, idle until a recording starts
+    trace_plot_init();
+
+    // SDRAM is up with the display path
+    arena_init(&app_arena, "SDRAM", (void *)SDRAM_ARENA_ADDR, SDRAM_ARENA_SIZE);
+    dma_copy_init();
+    dma_copy_benchmark((void *)SDRAM_FREE_ADDR);
+
+    // From here on only the render thread touches the LCD
+    render_init();
 
     // initialize all interrupts
     user_button.rise(&button_press);
-    gyro_int2.rise(&onGyroDataReady);
+
+    // Settings and counters from the EEPROM, before the touch thread
+    // shares its bus
+    app_load_settings();
+
+    // The key saved before the reset
+    app_load_key();
 
     // initialize LEDs
-    if (gesture_key.empty()){
-        lcd.DisplayStringAt(text_x, text_y, (uint8_t *)text_0, CENTER_MODE);
+    if (!app_has_key()){
+        ui_show_status(text_0);
     }
     else{
-        lcd.DisplayStringAt(text_x, text_y, (uint8_t *)text_1, CENTER_MODE);
+        ui_show_status(text_1);
     }
 
-    // Create the gyroscope thread
-    Thread save_key;
-    save_key.start(callback(gyroscope_thread));
-
     // Create the touch screen thread
-    Thread touchscreen_thread;
     touchscreen_thread.start(callback(touch_screen_thread));
 
-    // keep main thread alive
-    while (1){
-        ThisThread::sleep_for(100ms);
+    // The app thread runs the application from here on, it only wakes
+    // for button presses and the timers of a recording
+    app_thread.start(callback(&app_queue, &EventQueue::dispatch_forever));
+}
+
+/**************************************************************************
+ * @brief queue an event for the state machine; safe from interrupts and
+ *        any thread
+ * @param event: APP_EV_RECORD, APP_EV_UNLOCK or APP_EV_ERASE
+ * ***********************************************************************/
+void app_post(uint8_t event){
+    if (app_queue.call(app_handle, event, us_ticker_read()) == 0){
+        app_dropped++;
+    }
+}
+
+/**************************************************************************
+ * @brief post APP_EV_TIMER after a delay, in place of a sleep; replaces a
+ *        timer still pending
+ * @param delay: time until it fires
+ * ***********************************************************************/
+void app_timer(Kernel::Clock::duration_u32 delay){
+    if (app_timer_id){
+        app_queue.cancel(app_timer_id);
+    }
+    // Its latency is counted from when it was due
+    uint32_t due_us = us_ticker_read() + chrono::duration_cast<chrono::microseconds>(delay).count();
+    app_timer_id = app_queue.call_in(delay, app_handle, (uint8_t)APP_EV_TIMER, due_us);
+}
+
+/**************************************************************************
+ * @brief change state and log the transition
+ * @param to: new state
+ * @param event: event that caused it
+ * @param event_us: when the event was posted or its timer was due
+ * ***********************************************************************/
+void app_enter(uint8_t to, uint8_t event, uint32_t event_us){
+    uint32_t now = us_ticker_read();
+    state_log_record(app_state, to, event, event_us);
+
+    if (app_state == APP_IDLE){
+        // A new attempt
+        memset(app_phase_us, 0, sizeof(app_phase_us));
+        app_dispatch_us = now - event_us;
+    }
+    else{
+        app_phase_us[app_state] += now - app_state_since;
+    }
+    app_state_since = now;
+    app_state = to;
+}
+
+/**************************************************************************
+ * @brief print where the time of the last attempt went, and the average
+ *        per flow
+ * ***********************************************************************/
+void app_print_phases(){
+    uint32_t *total = app_phase_total_us[app_flow];
+    uint32_t attempts = ++app_attempts[app_flow];
+    uint32_t sum = app_dispatch_us;
+
+    total[APP_STATES] += app_dispatch_us;
+    for (int i = 0; i < APP_STATES; i++){
+        total[i] += app_phase_us[i];
+        sum += app_phase_us[i];
+    }
+
+    printf("App: %s attempt %lu ms: dispatch %lu us", app_flow_names[app_flow], (unsigned long)(sum / 1000),
+           (unsigned long)app_dispatch_us);
+    for (int i = APP_WAIT; i < APP_STATES; i++){
+        if (total[i]){
+            printf(", %s %lu ms", app_state_names[i], (unsigned long)(app_phase_us[i] / 1000));
+        }
     }
+    printf("\nApp: %s average of %lu: dispatch %lu us", app_flow_names[app_flow], (unsigned long)attempts,
+           (unsigned long)(total[APP_STATES] / attempts));
+    for (int i = APP_WAIT; i < APP_STATES; i++){
+        if (total[i]){
+            printf(", %s %lu ms", app_state_names[i], (unsigned long)(total[i] / attempts / 1000));
+        }
+    }
+    printf("\n");
 }
 
 /**************************************************************************
- * @brief gyroscope gesture key saving thread
+ * @brief start sampling the gyroscope; the attempt's buffers come from the
+ *        arena from here on
  * ***********************************************************************/
-void gyroscope_thread(){
-    // Add your gyroscope initialization parameters here
-    Gyroscope_Init_Parameters gyro_init_param;
-    gyro_init_param.conf1 = ODR_200_CUTOFF_50;
-    gyro_init_param.conf3 = INT2_DRDY;
-    gyro_init_param.conf4 = FULL_SCALE_500;
+void app_start_sampling(){
+    app_attempt_mark = arena_mark(&app_arena);
+    temp_key.clear();
+    temp_key.reserve(APP_MAX_SAMPLES);
+    app_motion_count = 0;
+    app_sample_late_us = 0;
+    app_sample_late_store_us = 0;
+    app_sample_due = us_ticker_read() + chrono::microseconds(APP_SAMPLE_PERIOD).count();
+    app_sample_id = app_queue.call_every(APP_SAMPLE_PERIOD, app_sample);
+}
 
-    // Set up gyroscope's raw data
-    Gyroscope_RawData raw_data;
+/**************************************************************************
+ * @brief hand the attempt's buffers back to the arena at once
+ * ***********************************************************************/
+void app_end_attempt(){
+    Recording(ArenaAllocator<array<float, 3>>(&app_arena)).swap(temp_key);
+    Recording(ArenaAllocator<array<float, 3>>(&app_arena)).swap(unlocking_record);
+    uint32_t most = arena_reset(&app_arena, app_attempt_mark);
+    printf("App: attempt took %lu bytes of the SDRAM arena at most\n", (unsigned long)most);
+}
 
-    // initialize a string display_buffer that can be draw on the LCD to dispaly the status
-    char display_buffer[50];
+/**************************************************************************
+ * @brief start drawing the capture and bound it to APP_RECORD_TIME
+ * @param event: event that started it
+ * @param event_us: when the event was posted
+ * ***********************************************************************/
+void app_start_recording(uint8_t event, uint32_t event_us){
+    ui_show_status("Recording...");
+    trace_plot_start();
+    for (const auto &sample : temp_key){
+        trace_plot_push(sample[0], sample[1], sample[2]); // the fast flow's pre-roll
+    }
+    app_enter(APP_RECORDING, event, event_us);
+    app_motion_count = 0;
+    app_timer(APP_RECORD_TIME);
+}
 
-    //manually check the signal and set the flag
-    // for the first sample.
-    if (!(flags.get() & DATA_READY_FLAG) && (gyro_int2.read() == 1)){
-        flags.set(DATA_READY_FLAG);
+/**************************************************************************
+ * @brief take one gyroscope sample; runs every APP_SAMPLE_PERIOD while
+ *        armed or recording
+ *
+ * Armed, the last few samples are kept as pre-roll until the rate stays
+ * above APP_MOTION_START_DPS. Recording in the fast flow ends once it
+ * stays below APP_MOTION_STOP_DPS; the still tail is dropped.
+ * ***********************************************************************/
+void app_sample(){
+    // How late the queue ran it; flash work must not show up here
+    int32_t late = us_ticker_read() - app_sample_due;
+    app_sample_due += chrono::microseconds(APP_SAMPLE_PERIOD).count();
+    if (late > 0){
+        app_sample_late_us = max(app_sample_late_us, (uint32_t)late);
+        if (store_worker_busy()){
+            app_sample_late_store_us = max(app_sample_late_store_us, (uint32_t)late);
+        }
     }
 
-    while (1){
-        vector<array<float, 3>> temp_key; // temporary key to store the recording gyro data
-
-        auto flag_check = flags.wait_any(KEY_FLAG | UNLOCK_FLAG | ERASE_FLAG);
-
-        if (flag_check & ERASE_FLAG){
-            // Erase the gesture key
-            sprintf(display_buffer, "Deleting....");
-            lcd.SetTextColor(LCD_COLOR_MAGENTA);               //bg
-            lcd.FillRect(0, text_y, lcd.GetXSize(), FONT_SIZE); // clear
-            lcd.SetTextColor(LCD_COLOR_WHITE);                   // text
-            lcd.DisplayStringAt(text_x, text_y, (uint8_t *)display_buffer, CENTER_MODE);
-            gesture_key.clear();
-            
-            // Erase the unlocking record
-            sprintf(display_buffer, "Pass delete finished.");
-            lcd.SetTextColor(LCD_COLOR_MAGENTA);               //bg
-            lcd.FillRect(0, text_y, lcd.GetXSize(), FONT_SIZE); // clear
-            lcd.SetTextColor(LCD_COLOR_WHITE);                //text
-            lcd.DisplayStringAt(text_x, text_y, (uint8_t *)display_buffer, CENTER_MODE);
-            unlocking_record.clear();
-
-            sprintf(display_buffer, "All delete finished.");
-            lcd.SetTextColor(LCD_COLOR_MAGENTA);              //bg
-            lcd.FillRect(0, text_y, lcd.GetXSize(), FONT_SIZE); // clear
-            lcd.SetTextColor(LCD_COLOR_WHITE);             //text
-            lcd.DisplayStringAt(text_x, text_y, (uint8_t *)display_buffer, CENTER_MODE);
-        }
-
-        if (flag_check & (KEY_FLAG | UNLOCK_FLAG)){
-            sprintf(display_buffer, "Pls Wait");
-            lcd.SetTextColor(LCD_COLOR_MAGENTA);           //bg
-            lcd.FillRect(0, text_y, lcd.GetXSize(), FONT_SIZE); // clear
-            lcd.SetTextColor(LCD_COLOR_WHITE);                //text color
-            lcd.DisplayStringAt(text_x, text_y, (uint8_t *)display_buffer, CENTER_MODE);
-
-            ThisThread::sleep_for(1s);
-
-            sprintf(display_buffer, "Calibrating...");
-            lcd.SetTextColor(LCD_COLOR_MAGENTA);            //bg
-            lcd.FillRect(0, text_y, lcd.GetXSize(), FONT_SIZE); // clear
-            lcd.SetTextColor(LCD_COLOR_WHITE);                 // text color
-            lcd.DisplayStringAt(text_x, text_y, (uint8_t *)display_buffer, CENTER_MODE);
-
-            // Initiate gyroscope
-            InitiateGyroscope(&gyro_init_param, &raw_data);
-
-            // start recording gesture
-            sprintf(display_buffer, "Recording in 3...");
-            lcd.SetTextColor(LCD_COLOR_MAGENTA);              //bg
-            lcd.FillRect(0, text_y, lcd.GetXSize(), FONT_SIZE); // clear
-            lcd.SetTextColor(LCD_COLOR_WHITE);                   // text color
-            lcd.DisplayStringAt(text_x, text_y, (uint8_t *)display_buffer, CENTER_MODE);
-            ThisThread::sleep_for(1s);
-            sprintf(display_buffer, "Recording in 2...");
-            lcd.SetTextColor(LCD_COLOR_MAGENTA);           //bg
-            lcd.FillRect(0, text_y, lcd.GetXSize(), FONT_SIZE); // clear
-            lcd.SetTextColor(LCD_COLOR_WHITE);                   // text color
-            lcd.DisplayStringAt(text_x, text_y, (uint8_t *)display_buffer, CENTER_MODE);
-            ThisThread::sleep_for(1s);
-            sprintf(display_buffer, "Recording in 1...");
-            lcd.SetTextColor(LCD_COLOR_MAGENTA);        //bg
-            lcd.FillRect(0, text_y, lcd.GetXSize(), FONT_SIZE); // clear
-            lcd.SetTextColor(LCD_COLOR_WHITE);            //text color
-            lcd.DisplayStringAt(text_x, text_y, (uint8_t *)display_buffer, CENTER_MODE);
-            ThisThread::sleep_for(1s);
-
-            sprintf(display_buffer, "Recording...");
-            lcd.SetTextColor(LCD_COLOR_MAGENTA);         //bg
-            lcd.FillRect(0, text_y, lcd.GetXSize(), FONT_SIZE); // clear
-            lcd.SetTextColor(LCD_COLOR_WHITE);          //text color
-            lcd.DisplayStringAt(text_x, text_y, (uint8_t *)display_buffer, CENTER_MODE);
-            
-            timer.start();
-            while (timer.elapsed_time() < 5s){ // gyro data recording loop
-                // Wait for the gyroscope data to be ready
-                flags.wait_all(DATA_READY_FLAG);
-                // Read the data from the gyroscope
-                GetCalibratedRawData();
-                // Add the converted data to the gesture_key vector
-                temp_key.push_back({ConvertDPS(raw_data.x_raw), ConvertDPS(raw_data.y_raw), ConvertDPS(raw_data.z_raw)});
-                ThisThread::sleep_for(50ms); // 20Hz
-            }
-            timer.stop();  // Stop timer
-            timer.reset(); // Reset timer
-
-            trim_gyro_data(temp_key);
-
-            sprintf(display_buffer, "Finished...");
-            lcd.SetTextColor(LCD_COLOR_MAGENTA);    //bg 
-            lcd.FillRect(0, text_y, lcd.GetXSize(), FONT_SIZE); // clear
-            lcd.SetTextColor(LCD_COLOR_WHITE);           // text color
-            lcd.DisplayStringAt(text_x, text_y, (uint8_t *)display_buffer, CENTER_MODE);
-        }
-
-        // check the flag see if it is recording or unlocking
-        if (flag_check & KEY_FLAG){
-            // if recording finished, and there is no current pass
-            if (gesture_key.empty()){
-                sprintf(display_buffer, "Saving Pass...");
-                lcd.SetTextColor(LCD_COLOR_MAGENTA);   //bg               
-                lcd.FillRect(0, text_y, lcd.GetXSize(), FONT_SIZE);  //clear
-                lcd.SetTextColor(LCD_COLOR_WHITE);   // text color               
-                lcd.DisplayStringAt(text_x, text_y, (uint8_t *)display_buffer, CENTER_MODE);
-
-                // save the key
-                gesture_key = temp_key;
-
-                // clear key
-                temp_key.clear();
-
-                // confirm the pass saved
-                sprintf(display_buffer, "Pass saved...");
-                lcd.SetTextColor(LCD_COLOR_MAGENTA);               //bg
-                lcd.FillRect(0, text_y, lcd.GetXSize(), FONT_SIZE); // clear
-                lcd.SetTextColor(LCD_COLOR_WHITE);                   // text color
-                lcd.DisplayStringAt(text_x, text_y, (uint8_t *)display_buffer, CENTER_MODE);
-            }
-            else{
-                // if recording finished, and there is a current pass, 
-                //remove the old pass and replace with new recording
-                sprintf(display_buffer, "Removing old key...");
-                lcd.SetTextColor(LCD_COLOR_MAGENTA);               // bg
-                lcd.FillRect(0, text_y, lcd.GetXSize(), FONT_SIZE); // clear
-                lcd.SetTextColor(LCD_COLOR_WHITE);                  // text color
-                lcd.DisplayStringAt(text_x, text_y, (uint8_t *)display_buffer, CENTER_MODE);
-
-                ThisThread::sleep_for(1s);
-                
-                // clear old key
-                gesture_key.clear();
-
-                // save new key
-                gesture_key = temp_key;
-                // confirm new pass saved
-                sprintf(display_buffer, "New pass is saved.");
-                lcd.SetTextColor(LCD_COLOR_MAGENTA);                // bg
-                lcd.FillRect(0, text_y, lcd.GetXSize(), FONT_SIZE); // clear
-                lcd.SetTextColor(LCD_COLOR_WHITE);                   // text color
-                lcd.DisplayStringAt(text_x, text_y, (uint8_t *)display_buffer, CENTER_MODE);
-
-                // clear temp_key
-                temp_key.clear();
-            }
+    // Data ready is only missing when a sample was read right before
+    if (gyro_int2.read() == 0){
+        return;
+    }
+    // Read the data from the gyroscope
+    GetCalibratedRawData();
+    // Add the converted data to the gesture_key vector
+    temp_key.push_back({ConvertDPS(raw_data.x_raw), ConvertDPS(raw_data.y_raw), ConvertDPS(raw_data.z_raw)});
+    const array<float, 3> &sample = temp_key.back();
+    float motion = fabsf(sample[0]) + fabsf(sample[1]) + fabsf(sample[2]);
+
+    if (app_state == APP_ARMED){
+        if (temp_key.size() > APP_PREROLL_SAMPLES){
+            temp_key.erase(temp_key.begin());
         }
-        else if (flag_check & UNLOCK_FLAG){
-            flags.clear(UNLOCK_FLAG);
-            sprintf(display_buffer, "Unlocking...");
-            lcd.SetTextColor(LCD_COLOR_MAGENTA);                // bg
-            lcd.FillRect(0, text_y, lcd.GetXSize(), FONT_SIZE); // clear
-            lcd.SetTextColor(LCD_COLOR_WHITE);                 // text color
-            lcd.DisplayStringAt(text_x, text_y, (uint8_t *)display_buffer, CENTER_MODE);
-
-            unlocking_record = temp_key; // save the unlocking record
-            temp_key.clear(); // clear temp_key
-
-            // check if the gesture key is empty
-            if (gesture_key.empty()){
-                sprintf(display_buffer, "NO KEY SAVED.");
-                lcd.SetTextColor(LCD_COLOR_MAGENTA);               // bg
-                lcd.FillRect(0, text_y, lcd.GetXSize(), FONT_SIZE); // clear
-                lcd.SetTextColor(LCD_COLOR_WHITE);                  //text color
-                lcd.DisplayStringAt(text_x, text_y, (uint8_t *)display_buffer, CENTER_MODE);
-
-                unlocking_record.clear(); // clear unlocking record
-            }
-            else{ // compare the unlock gesture with password
-                int unlock = 0; // count for above limit
-                array<float, 3> correlationResult = calculateCorrelation(gesture_key, unlocking_record);
-                if (err != 0){
-                    printf("Error: vectors are not the same size\n");
-                }
-                else{
-                    printf("Correlation values: x = %f, y = %f, z = %f\n", correlationResult[0], correlationResult[1], correlationResult[2]);
-                    
-                    // check if all values are above limit
-                    for (size_t i = 0; i < correlationResult.size(); i++){
-                        if (correlationResult[i] > CORRELATION_LIMIT){
-                            unlock++;
-                        }
-                    }
-                }
+        app_motion_count = motion > APP_MOTION_START_DPS ? app_motion_count + 1 : 0;
+        if (app_motion_count >= APP_MOTION_START_SAMPLES){
+            app_handle(APP_EV_MOTION, us_ticker_read());
+        }
+        return;
+    }
+
+    // Hand the sample to the plot thread without waiting on the LCD
+    trace_plot_push(sample[0], sample[1], sample[2]);
+
+    if (app_flow == APP_FLOW_FAST){
+        app_motion_count = motion < APP_MOTION_STOP_DPS ? app_motion_count + 1 : 0;
+        if (app_motion_count >= APP_MOTION_STOP_SAMPLES){
+            temp_key.resize(temp_key.size() - APP_MOTION_STOP_SAMPLES + 1);
+            app_handle(APP_EV_STILL, us_ticker_read());
+        }
+    }
+}
+
+/**************************************************************************
+ * @brief erase the stored key and the last unlocking record
+ * ***********************************************************************/
+void app_erase(){
+    // Erase the gesture key
+    ui_show_status("Deleting....");
+    gesture_key.clear();
+    app_key_stored = false;
+    if (store_worker_erase(APP_KEY_SLOT) != STORE_OK){
+        printf("Store: cannot erase the key\n");
+    }
+
+    // Erase the unlocking record
+    ui_show_status("Pass delete finished.");
+    unlocking_record.clear();
+
+    ui_show_status("All delete finished.");
+}
+
+/**************************************************************************
+ * @brief save the recording as the key
+ * ***********************************************************************/
+void app_save_key(){
+    uint32_t ticket = 0;
+    app_dump_recording("key", temp_key);
+
+    // if recording finished, and there is no current pass
+    if (!app_has_key()){
+        ui_show_status("Saving Pass...");
+
+        // save the key, copied by DMA while it is encoded below
+        gesture_key.resize(temp_key.size());
+        ticket = dma_copy(gesture_key.data(), temp_key.data(), temp_key.size() * sizeof(temp_key[0]));
+
+        // confirm the pass saved
+        ui_show_status("Pass saved...");
+    }
+    else{
+        // if recording finished, and there is a current pass,
+        //remove the old pass and replace with new recording
+        ui_show_status("Removing old key...");
+
+        // save new key, copied by DMA while it is encoded below
+        gesture_key.resize(temp_key.size());
+        ticket = dma_copy(gesture_key.data(), temp_key.data(), temp_key.size() * sizeof(temp_key[0]));
+
+        // confirm new pass saved
+        ui_show_status("New pass is saved.");
+    }
+
+    // keep it over a reset; written to flash in the background, matched
+    // from the RAM copy until then
+    vector<uint8_t> encoded(template_encoded_max(temp_key.size()));
+    uint32_t length = template_encode((const float (*)[3])temp_key.data(), temp_key.size(), APP_KEY_FORMAT,
+                                      ConvertDPS(1), encoded.data(), encoded.size()); // one gyroscope step
+    app_key_stored = length && store_worker_save(APP_KEY_SLOT, encoded.data(), length) == STORE_OK;
+    printf("App: key of %u samples encoded in %lu bytes, %lu as floats\n", (unsigned)temp_key.size(),
+           (unsigned long)length, (unsigned long)(temp_key.size() * sizeof(temp_key[0])));
+    if (!app_key_stored){
+        ui_show_status("Pass not stored!", LCD_COLOR_RED);
+    }
+    app_counters.keys_saved++;
+    settings_set(SETTINGS_COUNTERS, &app_counters, sizeof(app_counters));
+
+    // the RAM copy is matched against, and temp_key goes with the arena
+    dma_copy_wait(ticket);
+    // clear temp_key
+    temp_key.clear();
+}
+
+/**************************************************************************
+ * @brief mount the template store; the key saved in it stays there
+ * ***********************************************************************/
+void app_load_key(){
+    if (store_worker_init() != STORE_OK){
+        printf("Store: cannot mount\n");
+        return;
+    }
+    app_key_stored = store_worker_length(APP_KEY_SLOT) > 0;
+    store_worker_print_stats();
+}
+
+/**************************************************************************
+ * @brief read the flow and counters kept in the EEPROM, and count the boot
+ * ***********************************************************************/
+void app_load_settings(){
+    bool eeprom = settings_init();
+    audit_log_init(eeprom);
+
+    AppSettings settings;
+    if (settings_get(SETTINGS_APP, &settings, sizeof(settings)) == sizeof(settings) && settings.flow <= APP_FLOW_FAST){
+        app_flow = settings.flow;
+    }
+    if (settings_get(SETTINGS_COUNTERS, &app_counters, sizeof(app_counters)) != sizeof(app_counters)){
+        memset(&app_counters, 0, sizeof(app_counters));
+    }
+    app_counters.boots++;
+    settings_set(SETTINGS_COUNTERS, &app_counters, sizeof(app_counters));
+    printf("App: boot %lu, %s flow, %lu keys saved, %lu of %lu unlocks succeeded\n", (unsigned long)app_counters.boots,
+           app_flow_names[app_flow], (unsigned long)app_counters.keys_saved, (unsigned long)app_counters.unlocked,
+           (unsigned long)app_counters.unlock_attempts);
+}
+
+/**************************************************************************
+ * @brief check for a key, in the store or not written yet
+ * ***********************************************************************/
+bool app_has_key(){
+    return app_key_stored || !gesture_key.empty();
+}
+
+/**************************************************************************
+ * @brief point at the key in flash once it is written there; the RAM copy
+ *        is then freed. Never waits.
+ * @param stored: set to the flash span, to release after the match
+ * @return APP_KEY_RAM, APP_KEY_FLASH or APP_KEY_BUSY
+ * ***********************************************************************/
+int app_key_map(StoreSpan *stored){
+    stored->data = NULL;
+    if (!app_key_stored){
+        return APP_KEY_RAM;
+    }
+    // The RAM copy covers a save still being written; without one only an
+    // erase is in the way, and it is not started while a span is out
+    int result = store_worker_map(APP_KEY_SLOT, stored);
+    if (result == STORE_BUSY && gesture_key.empty()){
+        return APP_KEY_BUSY;
+    }
+    if (result != STORE_OK){
+        return APP_KEY_RAM;
+    }
+    if (gesture_key.capacity()){
+        printf("App: key on flash, %lu bytes of RAM freed\n",
+               (unsigned long)(gesture_key.capacity() * sizeof(gesture_key[0])));
+        vector<array<float, 3>>().swap(gesture_key);
+    }
+    return APP_KEY_FLASH;
+}
 
-                if (unlock==1){
-                    sprintf(display_buffer, "UNLOCK: SUCCESS");
-                    lcd.SetTextColor(LCD_COLOR_GREEN);                 // bg 
-                    lcd.FillRect(0, text_y, lcd.GetXSize(), FONT_SIZE); // clear
-                    lcd.SetTextColor(LCD_COLOR_WHITE);                 // text color
-                    lcd.DisplayStringAt(text_x, text_y, (uint8_t *)display_buffer, CENTER_MODE);
+/**************************************************************************
+ * @brief print a recording as lines for tools/template_codec
+ * @param name: what it was recorded for
+ * ***********************************************************************/
+void app_dump_recording(const char *name, const Recording &recording){
+#if APP_DUMP_RECORDING
+    printf("# %s, %u samples\n", name, (unsigned)recording.size());
+    for (const auto &sample : recording){
+        printf("g %.4f %.4f %.4f\n", sample[0], sample[1], sample[2]);
+    }
+#endif
+}
+
+/**************************************************************************
+ * @brief time the match stage with its scratch in CCM, SRAM and SDRAM,
+ *        first with only the LTDC scanning the display, then with the DMA2D
+ *        also redrawing the whole frame from SDRAM under every run
+ *
+ * The recording is in SDRAM as in an attempt and the key in SRAM, copied a
+ * block at a time into the scratch as the decoder does. Draws into the
+ * status layer, still hidden, so it has to run before ui_init().
+ * ***********************************************************************/
+void app_match_bench(){
+#if APP_MATCH_BENCH
+    static MatchScratch sram_scratch;
+    static array<float, 3> key[APP_MAX_SAMPLES];
+    const size_t n = APP_MAX_SAMPLES;
+
+    // Free SDRAM: the frame the DMA2D converts, then the SDRAM scratch and
+    // the recording
+    uint32_t frame_pixels = lcd.GetXSize() * lcd.GetYSize();
+    uint16_t *frame = (uint16_t *)SDRAM_FREE_ADDR;
+    MatchScratch *sdram_scratch = (MatchScratch *)(SDRAM_FREE_ADDR + ((frame_pixels * 2 + 7) & ~7));
+    array<float, 3> *record = (array<float, 3> *)(sdram_scratch + 1);
+    memset(frame, 0, frame_pixels * 2);
+
+    // Two takes of the same gesture, a little apart
+    for (size_t i = 0; i < n; i++){
+        for (int axis = 0; axis < 3; axis++){
+            key[i][axis] = 200 * sinf(0.1f * i + axis);
+            record[i][axis] = 180 * sinf(0.1f * i + 0.2f + axis);
+        }
+    }
 
-                    // clear
-                    unlocking_record.clear();
-                    unlock = 0;
+    const struct
+    {
+        const char *name;
+        MatchScratch *scratch;
+    } places[] = {{CCM_PLACEMENT ? "CCM" : "SRAM", &match_scratch}, {"SRAM", &sram_scratch}, {"SDRAM", sdram_scratch}};
+    const char *const loads[] = {"display idle", "full refresh"};
+    uint32_t us[2][3];
+    volatile float sink; // keeps the runs from being optimised out
+
+    lcd.SelectLayer(UI_STATUS_LAYER);
+    for (int load = 0; load < 2; load++){
+        for (int p = 0; p < 3; p++){
+            uint32_t total = 0;
+            for (int run = 0; run < APP_BENCH_RUNS; run++){
+                if (load){
+                    // Waits for the frame before, then runs alongside
+                    lcd.DrawRGB565(0, 0, lcd.GetXSize(), lcd.GetYSize(), frame);
                 }
-                else{
-                    sprintf(display_buffer, "UNLOCK: FAILED");
-                    lcd.SetTextColor(LCD_COLOR_RED);                 // bg
-                    lcd.FillRect(0, text_y, lcd.GetXSize(), FONT_SIZE); // clear
-                    lcd.SetTextColor(LCD_COLOR_WHITE);                // text color
-                    lcd.DisplayStringAt(text_x, text_y, (uint8_t *)display_buffer, CENTER_MODE);
-
-                    // clear unlocking record
-                    unlocking_record.clear();
-                    unlock = 0;
+                uint32_t start = us_ticker_read();
+                Match match;
+                match_begin(match, places[p].scratch, {record, n});
+                for (size_t done = 0; done < n; done += APP_DECODE_BLOCK){
+                    size_t count = min((size_t)APP_DECODE_BLOCK, n - done);
+                    memcpy(places[p].scratch->block, &key[done], count * sizeof(key[0]));
+                    match_add(match, places[p].scratch->block, count);
                 }
+                sink = match_result(match).dtw;
+                total += us_ticker_read() - start;
             }
+            (void)sink;
+            us[load][p] = total / APP_BENCH_RUNS;
         }
-        ThisThread::sleep_for(100ms);
     }
+    lcd.WaitDMA2D();
+
+    for (int load = 0; load < 2; load++){
+        printf("Bench: match of %u x %u samples, %s: %s %lu us, %s %lu us, %s %lu us\n", (unsigned)n, (unsigned)n,
+               loads[load], places[0].name, (unsigned long)us[load][0], places[1].name, (unsigned long)us[load][1],
+               places[2].name, (unsigned long)us[load][2]);
+    }
+    printf("Bench: under full refresh the scratch in %s is %.2fx SRAM, %.2fx SDRAM\n", places[0].name,
+           (float)us[1][1] / max(us[1][0], (uint32_t)1), (float)us[1][2] / max(us[1][0], (uint32_t)1));
+#endif
 }
 
-/********************************************************************
- * @brief touch screen thread
- * *****************************************************************/
-void touch_screen_thread(){
-    TS_StateTypeDef ts_state;
+#if APP_RAM_BENCH
+static_assert(APP_BENCH_ERASE_ADDR + STORE_SECTOR_SIZE <= STORE_FLASH_BASE, "the bench must not erase the store");
 
-    if (ts.Init(lcd.GetXSize(), lcd.GetYSize()) != TS_OK){
-        printf("error: touch screen failure\r\n");
+FlashIAP bench_flash;
+volatile bool bench_erasing = false;
+
+/**************************************************************************
+ * @brief erase the bench sector, from a thread below the bench
+ * ***********************************************************************/
+void bench_erase(){
+    bench_flash.init();
+    bench_flash.erase(APP_BENCH_ERASE_ADDR, bench_flash.get_sector_size(APP_BENCH_ERASE_ADDR));
+    bench_flash.deinit();
+    bench_erasing = false;
+}
+#endif
+
+/**************************************************************************
+ * @brief time GetCalibratedRawData() and the match stage, first alone and
+ *        then while a flash sector is erased
+ *
+ * Whether the code runs from flash or RAM is up to RAMFUNC_ENABLED, so the
+ * two are compared over two builds. The recordings are in SRAM here, to
+ * leave only the code fetches between the builds.
+ * ***********************************************************************/
+void app_ram_bench(){
+#if APP_RAM_BENCH
+    static array<float, 3> key[APP_MAX_SAMPLES], record[APP_MAX_SAMPLES];
+    static Thread eraser(osPriorityLow, 1024);
+    const size_t n = APP_MAX_SAMPLES;
+    uint32_t read_us[2], match_us[2];
+    bool overlapped = true;
+    volatile float sink; // keeps the runs from being optimised out
+
+    if (APP_BENCH_ERASE_ADDR < FLASHIAP_APP_ROM_END_ADDR){
+        printf("Bench: the firmware reaches into 0x%08lx, not erasing it\n", (unsigned long)APP_BENCH_ERASE_ADDR);
         return;
     }
+    for (size_t i = 0; i < n; i++){
+        for (int axis = 0; axis < 3; axis++){
+            key[i][axis] = 200 * sinf(0.1f * i + axis);
+            record[i][axis] = 180 * sinf(0.1f * i + 0.2f + axis);
+        }
+    }
+    boot_wait_gyro();
+
+    for (int erase = 0; erase < 2; erase++){
+        if (erase){
+            // The eraser only gets the CPU while this thread sleeps, long
+            // enough to start the erase; it then polls until the end
+            bench_erasing = true;
+            eraser.start(callback(bench_erase));
+            ThisThread::sleep_for(1ms);
+        }
+        uint32_t start = us_ticker_read();
+        for (int run = 0; run < APP_BENCH_RUNS; run++){
+            GetCalibratedRawData();
+        }
+        read_us[erase] = (us_ticker_read() - start) / APP_BENCH_RUNS;
 
-    // initialize a string display_buffer that can be draw on the LCD to dispaly the status
-    char display_buffer[50];
+        start = us_ticker_read();
+        for (int run = 0; run < APP_BENCH_RUNS; run++){
+            sink = match_span(&match_scratch, {key, n}, {record, n}).dtw;
+        }
+        match_us[erase] = (us_ticker_read() - start) / APP_BENCH_RUNS;
+        (void)sink;
+        if (erase){
+            overlapped = bench_erasing;
+        }
+    }
+    eraser.join();
+
+    const char *from = RAMFUNC_ENABLED ? "RAM" : "flash";
+    printf("Bench: code from %s: gyroscope read %lu us, match of %u x %u samples %lu us\n", from,
+           (unsigned long)read_us[0], (unsigned)n, (unsigned)n, (unsigned long)match_us[0]);
+    printf("Bench: code from %s, erasing 0x%08lx: gyroscope read %lu us, match %lu us%s\n", from,
+           (unsigned long)APP_BENCH_ERASE_ADDR, (unsigned long)read_us[1], (unsigned long)match_us[1],
+           overlapped ? "" : " (the erase ended first)");
+#endif
+}
 
-    while (1){
-        ts.GetState(&ts_state);
-        if (ts_state.TouchDetected){
-            int touch_x = ts_state.X;
-            int touch_y = ts_state.Y;
-
-            // Check if the touch is inside record button
-            if (touch_button_validation(touch_x, touch_y, button_x_2, button_y_2, button1_width, button1_height)){
-                sprintf(display_buffer, "Recording Initiated...");
-                lcd.SetTextColor(LCD_COLOR_MAGENTA);                // bg
-                lcd.FillRect(0, text_y, lcd.GetXSize(), FONT_SIZE); // clear
-                lcd.SetTextColor(LCD_COLOR_WHITE);                   // text color
-                lcd.DisplayStringAt(text_x, text_y, (uint8_t *)display_buffer, CENTER_MODE);
-                ThisThread::sleep_for(1s);
-                flags.set(KEY_FLAG);
-            }
+/**************************************************************************
+ * @brief compare the recording with the key
+ * @return false if the key cannot be read yet, app_unlock_match() then
+ *         finishes it
+ * ***********************************************************************/
+bool app_unlock(){
+    ui_show_status("Unlocking...");
 
-            // Check if the touch is inside unlock button
-            if (touch_button_validation(touch_x, touch_y, button_x_1, button_y_1, button2_width, button2_height)){
-                sprintf(display_buffer, "Unlocking Initiated...");
-                lcd.SetTextColor(LCD_COLOR_MAGENTA);                // bg
-                lcd.FillRect(0, text_y, lcd.GetXSize(), FONT_SIZE); // clear
-                lcd.SetTextColor(LCD_COLOR_WHITE);                  // text color
-                lcd.DisplayStringAt(text_x, text_y, (uint8_t *)display_buffer, CENTER_MODE);
-                ThisThread::sleep_for(1s);
-                flags.set(UNLOCK_FLAG);
-            }
-        }
-        ThisThread::sleep_for(10ms);
+    unlocking_record.swap(temp_key); // save the unlocking record, temp_key is left empty
+    app_dump_recording("unlock", unlocking_record);
+
+    // check if the gesture key is empty
+    if (!app_has_key()){
+        ui_show_status("NO KEY SAVED.");
+        app_audit(AUDIT_NO_KEY, {{0, 0, 0}, numeric_limits<float>::infinity()}, unlocking_record.size());
+
+        unlocking_record.clear(); // clear unlocking record
+        return true;
     }
+
+    // The record moves to SRAM while the key is looked up
+    app_unlock_record = {unlocking_record.data(), unlocking_record.size()};
+    app_unlock_ticket = 0;
+    app_unlock_tries = 0;
+    if (app_unlock_record.size <= APP_MAX_SAMPLES){
+        app_unlock_ticket = dma_copy(app_match_record, app_unlock_record.samples,
+                                     app_unlock_record.size * sizeof(app_unlock_record.samples[0]));
+        app_unlock_record.samples = app_match_record;
+    }
+    return app_unlock_match();
 }
 
-/*******************************************************************************
- * @brief store data to flash
- * @param gesture_key: store data
- * @param flash_address: flash address
- * @return true if the data is stored successfully, false otherwise
- * ****************************************************************************/
-bool storeGyroDataToFlash(vector<array<float, 3>> &gesture_key, uint32_t flash_address){
-    FlashIAP flash;
-    flash.init();
+/**************************************************************************
+ * @brief match the unlocking record with the key and show the verdict
+ * @return false if the store is erasing and the key is only on flash; try
+ *         again after APP_STORE_RETRY
+ * ***********************************************************************/
+bool app_unlock_match(){
+    // compare the unlock gesture with password, the key decoded in place
+    int unlock = 0; // count for above limit
+    StoreSpan stored;
+    TemplateDecoder decoder;
+    const GestureSpan &record = app_unlock_record;
+    MatchResult match = {{0, 0, 0}, numeric_limits<float>::infinity()};
+    array<float, 3> &correlationResult = match.correlation;
+    err = 0;
+    uint32_t start = us_ticker_read();
+
+    int key = app_key_map(&stored);
+    if (key == APP_KEY_BUSY){
+        // Nothing of the copy is left in flight while the thread waits
+        dma_copy_wait(app_unlock_ticket);
+        return false;
+    }
+    bool decodable = key == APP_KEY_FLASH && template_decode_init(&decoder, stored.data, stored.length);
+    dma_copy_wait(app_unlock_ticket);
+
+    if (key == APP_KEY_RAM){
+        match = match_span(&match_scratch, {gesture_key.data(), gesture_key.size()}, record);
+    }
+    else if (decodable){
+        match = app_match_key(&decoder, record);
+        printf("App: key of %lu samples matched in place at 0x%08lx from %lu bytes\n",
+               (unsigned long)decoder.samples, (unsigned long)(uintptr_t)stored.data, (unsigned long)stored.length);
+    }
+    else{
+        err = APP_ERR_KEY_FORMAT;
+    }
+    printf("App: match stage %lu us, scratch in %s\n", (unsigned long)(us_ticker_read() - start),
+           CCM_PLACEMENT ? "CCM" : "SRAM");
+    if (stored.data){
+        store_worker_unmap(&stored);
+    }
+    if (err == APP_ERR_KEY_FORMAT){
+        printf("Error: saved key in an unknown format, record it again\n");
+    }
+    else if (err != 0){
+        printf("Error: recordings too short to compare\n");
+    }
+    else{
+        printf("Correlation values: x = %f, y = %f, z = %f\n", correlationResult[0], correlationResult[1], correlationResult[2]);
+        printf("DTW distance: %f\n", match.dtw);
 
-    // total size of the data to be stored in bytes
-    uint32_t data_size = gesture_key.size() * sizeof(array<float, 3>);
+        // check if all values are above limit
+        for (size_t i = 0; i < correlationResult.size(); i++){
+            if (correlationResult[i] > CORRELATION_LIMIT){
+                unlock++;
+            }
+        }
+    }
+
+    if (unlock==1){
+        ui_show_status("UNLOCK: SUCCESS", LCD_COLOR_GREEN);
+        app_counters.unlocked++;
+    }
+    else{
+        ui_show_status("UNLOCK: FAILED", LCD_COLOR_RED);
+    }
+    app_audit(err != 0 ? AUDIT_ERROR : unlock == 1 ? AUDIT_GRANTED : AUDIT_DENIED, match, unlocking_record.size());
+    // clear unlocking record
+    unlocking_record.clear();
+    return true;
+}
 
-    // Erase the flash sector
-    flash.erase(flash_address, data_size);
+/**************************************************************************
+ * @brief give up an unlock the store kept the key from for
+ *        APP_STORE_WAIT_MAX
+ * ***********************************************************************/
+void app_unlock_busy(){
+    printf("Error: key store busy for %lu tries, unlock given up\n", (unsigned long)app_unlock_tries);
+    ui_show_status("BUSY, TRY AGAIN", LCD_COLOR_RED);
+    app_audit(AUDIT_ERROR, {{0, 0, 0}, numeric_limits<float>::infinity()}, unlocking_record.size());
+    unlocking_record.clear();
+}
 
-    // Write the data to flash
-    int write_result = flash.program(gesture_key.data(), flash_address, data_size);
+/**************************************************************************
+ * @brief end the attempt once the key is saved or the verdict shown
+ * ***********************************************************************/
+void app_finish_match(){
+    app_end_attempt();
+    arena_print_stats(&app_arena);
+    app_enter(APP_IDLE, APP_EV_DONE, us_ticker_read());
+    state_log_print("App", app_state_names, app_event_names);
+    app_print_phases();
+    if (app_dropped){
+        printf("App: %lu events dropped\n", (unsigned long)app_dropped);
+    }
+}
 
-    flash.deinit();
+/**************************************************************************
+ * @brief log an unlock attempt and count it
+ * @param verdict: AUDIT_*
+ * @param match: the scores the verdict was taken on
+ * @param samples: of the unlocking record
+ * ***********************************************************************/
+void app_audit(uint8_t verdict, const MatchResult &match, size_t samples){
+    // Click to now: the state being left has not been added to the phases
+    uint32_t now = us_ticker_read();
+    uint32_t duration = app_dispatch_us + (now - app_state_since);
+    for (int i = 0; i < APP_STATES; i++){
+        duration += app_phase_us[i];
+    }
 
-    return write_result == 0;
+    AuditRecord record;
+    record.sequence = app_counters.unlock_attempts;
+    record.boot = app_counters.boots;
+    record.uptime_ms = (uint32_t)Kernel::Clock::now().time_since_epoch().count();
+    record.duration_us = duration;
+    for (int i = 0; i < 3; i++){
+        record.correlation[i] = match.correlation[i];
+    }
+    record.dtw = match.dtw;
+    record.samples = (uint16_t)min(samples, (size_t)UINT16_MAX);
+    record.verdict = verdict;
+    record.flow = app_flow;
+    audit_log_append(&record);
+
+    // written back in the background, a burst of attempts as one write
+    app_counters.unlock_attempts++;
+    settings_set(SETTINGS_COUNTERS, &app_counters, sizeof(app_counters));
 }
 
-/*******************************************************************************
- *
- * @brief read data from flash
- * @param flash_address: the address of the flash
- * @param data_size: the size of the data in bytes
- * @return a vector of array<float, 3> containing the data
+/**************************************************************************
+ * @brief application state machine, run by app_queue on app_thread
  *
- * ****************************************************************************/
-vector<array<float, 3>> readGyroDataFromFlash(uint32_t flash_address, size_t data_size){
-    vector<array<float, 3>> gesture_key(data_size);
+ * Guided: IDLE --record/unlock--> WAIT --timer--> COUNTDOWN --3 timers-->
+ * RECORDING --timer--> MATCHING --done--> IDLE.
+ * Fast: IDLE --record/unlock--> ARMED --motion--> RECORDING --still or
+ * timer--> MATCHING --done--> IDLE, through WAIT only if the gyroscope is
+ * still calibrating. An unlock waits in MATCHING on timers while the store
+ * erases the bank the key is on, for APP_STORE_WAIT_MAX at most.
+ * Every wait is a queue timer, so the thread sleeps in the queue between
+ * steps. Clicks while a recording or match is under way are ignored, like
+ * the erase button and the flow switch.
+ * @param event: APP_EV_*
+ * @param event_us: when the event was posted or its timer was due
+ * ***********************************************************************/
+void app_handle(uint8_t event, uint32_t event_us){
+    char text[RENDER_MAX_TEXT];
 
-    FlashIAP flash;
-    flash.init();
+    if (event == APP_EV_TIMER){
+        app_timer_id = 0;
+    }
 
-    // Read the data from flash
-    flash.read(gesture_key.data(), flash_address, data_size * sizeof(array<float, 3>));
+    switch (app_state){
+    case APP_IDLE:
+        if (event == APP_EV_ERASE){
+            app_erase();
+        }
+        else if (event == APP_EV_MODE){
+            app_flow = app_flow == APP_FLOW_FAST ? APP_FLOW_GUIDED : APP_FLOW_FAST;
+            ui_show_status(app_flow == APP_FLOW_FAST ? "Fast unlock" : "Guided unlock");
+            AppSettings settings = {app_flow};
+            settings_set(SETTINGS_APP, &settings, sizeof(settings));
+        }
+        else if ((event == APP_EV_RECORD || event == APP_EV_UNLOCK) && app_flow == APP_FLOW_FAST && boot_gyro_ready()){
+            app_mode = event;
+            ui_show_status("Go!");
+            app_enter(APP_ARMED, event, event_us);
+            app_start_sampling();
+            app_timer(APP_ARM_TIMEOUT);
+        }
+        else if (event == APP_EV_RECORD || event == APP_EV_UNLOCK){
+            app_mode = event;
+            ui_show_status("Pls Wait");
+            app_enter(APP_WAIT, event, event_us);
+            // The fast flow only waits for the calibration
+            app_timer(app_flow == APP_FLOW_FAST ? APP_GYRO_POLL : APP_WAIT_TIME);
+        }
+        break;
+
+    case APP_WAIT:
+        if (event != APP_EV_TIMER){
+            break;
+        }
+        // Calibrated in the background since boot, only an early press waits
+        if (!boot_gyro_ready()){
+            ui_show_status("Calibrating...");
+            app_timer(APP_GYRO_POLL);
+            break;
+        }
+        if (app_flow == APP_FLOW_FAST){
+            ui_show_status("Go!");
+            app_enter(APP_ARMED, event, event_us);
+            app_start_sampling();
+            app_timer(APP_ARM_TIMEOUT);
+            break;
+        }
+        // start recording gesture
+        app_countdown = APP_COUNTDOWN_FROM;
+        snprintf(text, sizeof(text), "Recording in %d...", app_countdown);
+        ui_show_status(text);
+        app_enter(APP_COUNTDOWN, event, event_us);
+        app_timer(APP_COUNTDOWN_STEP);
+        break;
+
+    case APP_COUNTDOWN:
+        if (event != APP_EV_TIMER){
+            break;
+        }
+        if (--app_countdown > 0){
+            snprintf(text, sizeof(text), "Recording in %d...", app_countdown);
+            ui_show_status(text);
+            app_timer(APP_COUNTDOWN_STEP);
+            break;
+        }
+        app_start_sampling();
+        app_start_recording(event, event_us);
+        break;
 
-    flash.deinit();
+    case APP_ARMED:
+        if (event == APP_EV_MOTION){
+            app_start_recording(event, event_us);
+        }
+        else if (event == APP_EV_TIMER){
+            app_queue.cancel(app_sample_id);
+            app_sample_id = 0;
+            app_end_attempt();
+            ui_show_status("No motion");
+            app_enter(APP_IDLE, event, event_us);
+            app_print_phases();
+        }
+        break;
 
-    return gesture_key;
+    case APP_RECORDING:
+        if (event != APP_EV_TIMER && event != APP_EV_STILL){
+            break;
+        }
+        app_queue.cancel(app_sample_id);
+        app_sample_id = 0;
+        if (app_timer_id){
+            app_queue.cancel(app_timer_id);
+            app_timer_id = 0;
+        }
+        trace_plot_stop();
+        app_enter(APP_MATCHING, event, event_us);
+
+        trim_gyro_data(temp_key);
+
+        ui_show_status("Finished...");
+        sprite_cache_print_stats();
+        font_cache_print_stats();
+        render_print_stats();
+        touch_print_stats();
+        store_worker_print_stats();
+        settings_print_stats();
+        dma_copy_print_stats();
+        audit_log_print_stats();
+        printf("App: sampling ran %lu us late at most, %lu us while the store was writing\n",
+               (unsigned long)app_sample_late_us, (unsigned long)app_sample_late_store_us);
+
+        // check whether it was recording or unlocking
+        if (app_mode == APP_EV_RECORD){
+            app_save_key();
+        }
+        else if (!app_unlock()){
+            // The store is erasing the key's bank: wait for it here
+            app_timer(APP_STORE_RETRY);
+            break;
+        }
+        app_finish_match();
+        break;
+
+    case APP_MATCHING:
+        if (event != APP_EV_TIMER){
+            break;
+        }
+        if (app_unlock_match()){
+            app_finish_match();
+        }
+        else if (++app_unlock_tries < APP_STORE_WAIT_MAX / APP_STORE_RETRY){
+            app_timer(APP_STORE_RETRY);
+        }
+        else{
+            app_unlock_busy();
+            app_finish_match();
+        }
+        break;
+    }
 }
 
-/*******************************************************************************
- * @brief draw button with rounded corneers
- * @param x: x coordinate of the button
- * @param y: y coordinate of the button
- * @param width: width of the button
- * @param height: height of the button
- * @param label: label of the button
- * ****************************************************************************/
-void draw_rounded_button(int x, int y, int width, int height, const char *label) {
-    int radius = 10;  // Radius for the rounded corners
+// What a button does when clicked
+typedef struct
+{
+    const char *status;
+    uint8_t event;
+} ButtonAction;
 
-    // Draw the main rectangular body (excluding corners)
-    lcd.FillRect(x + radius, y, width - 2 * radius, height);
+const ButtonAction record_action = {"Recording Initiated...", APP_EV_RECORD};
+const ButtonAction unlock_action = {"Unlocking Initiated...", APP_EV_UNLOCK};
 
-    // Draw circles at each corner for rounded edges
-    lcd.FillCircle(x + radius, y + radius, radius);                     // Top-left
-    lcd.FillCircle(x + width - radius, y + radius, radius);             // Top-right
-    lcd.FillCircle(x + radius, y + height - radius, radius);            // Bottom-left
-    lcd.FillCircle(x + width - radius, y + height - radius, radius);    // Bottom-right
+/********************************************************************
+ * @brief widget handler of the two buttons
+ * @param widget: widget id
+ * @param action: WIDGET_DOWN ... WIDGET_CANCEL
+ * @param context: the button's ButtonAction
+ * *****************************************************************/
+void button_handler(uint8_t widget, uint8_t action, void *context){
+    const ButtonAction *button = (const ButtonAction *)context;
 
-    int font_width = 16; 
-    int font_height = 16; 
-    int text_width = strlen(label) * font_width;  // Width of the label
+    // Fire once per touch, on release, however long the finger stays
+    if (action == WIDGET_UP){
+        ui_show_status(button->status);
+        app_post(button->event);
+    }
+    // Holding either button switches between the guided and fast flow
+    else if (action == WIDGET_LONG_PRESS){
+        app_post(APP_EV_MODE);
+    }
+}
 
-    int text_x_position = x + (width - text_width) / 2; // Center horizontally
-    int text_y_position = y + (height - font_height) / 2; // Center vertically
+// Set once a long press on the title is let go
+bool calibrate_requested = false;
 
-    // adjustments for text position
-    text_x_position += 12; // Adjust to move text right
-    text_y_position -= 1; // Adjust to move text up
+/********************************************************************
+ * @brief widget handler of the title: a long press starts the touch
+ *        calibration once the finger is lifted
+ * @param widget: widget id
+ * @param action: WIDGET_DOWN ... WIDGET_CANCEL
+ * @param context: unused
+ * *****************************************************************/
+void title_handler(uint8_t widget, uint8_t action, void *context){
+    static bool held = false;
 
-    // Set background and text color
-    lcd.SetBackColor(LCD_COLOR_BLUE);  // Background color for text
-    lcd.SetTextColor(LCD_COLOR_WHITE); // Text color
+    if (action == WIDGET_LONG_PRESS){
+        ui_show_status("Release to calibrate");
+        held = true;
+    }
+    else if (action == WIDGET_CANCEL && held){
+        calibrate_requested = true; // a release after a long press ends in a cancel
+        held = false;
+    }
+    else if (action == WIDGET_DOWN){
+        held = false;
+    }
+}
 
-    // Display the label
-    lcd.DisplayStringAt(text_x_position, text_y_position, (uint8_t *)label, LEFT_MODE);
+/********************************************************************
+ * @brief milliseconds of the kernel clock, for the touch state machine
+ * *****************************************************************/
+uint32_t touch_now_ms(){
+    return Kernel::Clock::now().time_since_epoch().count();
 }
 
-/*******************************************************************************
- * @brief Check if the touch point is inside the button
- * @param touch_x: x coordinate of the touch point
- * @param touch_y: y coordinate of the touch point
- * @param button_x: x coordinate of the button
- * @param button_y: y coordinate of the button
- * @param button_width: width of the button
- * @param button_height: height of the button
- * ****************************************************************************/
-bool touch_button_validation(int touch_x, int touch_y, int button_x, int button_y, int button_width, int button_height){
-    return (touch_x >= button_x && touch_x <= button_x + button_width &&
-            touch_y >= button_y && touch_y <= button_y + button_height);
+/********************************************************************
+ * @brief touch screen thread
+ * *****************************************************************/
+void touch_screen_thread(){
+    TouchEvent event;
+
+    if (!touch_init()){
+        printf("error: touch screen failure\r\n");
+        return;
+    }
+
+    widget_add(button_x_1, button_y_1, button1_width, button1_height, button_handler, (void *)&record_action);
+    widget_add(button_x_2, button_y_2, button2_width, button2_height, button_handler, (void *)&unlock_action);
+    widget_add(0, 0, lcd.GetXSize(), button_y_1, title_handler, NULL);
+
+    while (1){
+        // Sleeps until the controller interrupts or a long press or
+        // debounced release is due, no polling
+        if (!touch_get(&event, widget_timeout(touch_now_ms()))){
+            widget_tick(touch_now_ms());
+        }
+        else{
+            uint32_t now = touch_now_ms();
+#if TOUCH_TRACE
+            printf("%lu %c %u %u\n", (unsigned long)now, "?dum"[event.kind], event.x, event.y);
+#endif
+            switch (event.kind){
+            case TOUCH_PRESS:
+                widget_down(event.x, event.y, now);
+                break;
+            case TOUCH_MOVE:
+                widget_move(event.x, event.y, now);
+                break;
+            case TOUCH_RELEASE:
+                widget_up(event.x, event.y, now);
+                break;
+            }
+        }
+
+        // The calibration reads the touch events itself, so it runs here
+        // with the widgets idle
+        if (calibrate_requested){
+            calibrate_requested = false;
+            touch_calibrate();
+        }
+    }
 }
 
 /*******************************************************************************
@@ -518,7 +1287,7 @@ bool touch_button_validation(int touch_x, int touch_y, int button_x, int button_
  * @param vec2: vector 2
  * @return the euclidean distance between the two vectors
  * ****************************************************************************/
-float euclidean_distance(const array<float, 3> &vec1, const array<float, 3> &vec2){
+RAMFUNC float euclidean_distance(const array<float, 3> &vec1, const array<float, 3> &vec2){
     float sum = 0;
     for (size_t i = 0; i < 3; ++i)
     {
@@ -528,33 +1297,30 @@ float euclidean_distance(const array<float, 3> &vec1, const array<float, 3> &vec
 }
 
 /*******************************************************************************
- * @brief Calculate the DTW distance between two vectors
- * @param vector1: vector 1
- * @param vector2: vector 2
- * @return the DTW distance between the two vectors
+ * @brief Add a row of the DTW matrix: one key sample against the whole
+ *        recording, from the row before
+ * @param match: the match, its rows swapped after
+ * @param sample: the key sample
  * ****************************************************************************/
-float dtwDistance(const vector<array<float, 3>> &vector1, const vector<array<float, 3>> &vector2){
-    vector<vector<float>> dtw_matrix(vector1.size() + 1, vector<float>(vector2.size() + 1, numeric_limits<float>::infinity()));
+RAMFUNC void dtw_add_row(Match &match, const array<float, 3> &sample){
+    float *previous = match.previous, *current = match.current;
+    current[0] = numeric_limits<float>::infinity();
 
-    dtw_matrix[0][0] = 0;
-
-    for (size_t i = 1; i <= vector1.size(); ++i)
+    for (size_t j = 1; j <= match.record.size; ++j)
     {
-        for (size_t j = 1; j <= vector2.size(); ++j)
-        {
-            float cost = euclidean_distance(vector1[i - 1], vector2[j - 1]);
-            dtw_matrix[i][j] = cost + min({dtw_matrix[i - 1][j], dtw_matrix[i][j - 1], dtw_matrix[i - 1][j - 1]});
-        }
+        float cost = euclidean_distance(sample, match.record.samples[j - 1]);
+        current[j] = cost + min({previous[j], current[j - 1], previous[j - 1]});
     }
 
-    return dtw_matrix[vector1.size()][vector2.size()];
+    match.previous = current;
+    match.current = previous;
 }
 
 /*******************************************************************************
  * @brief Trim the gyro data
  * @param data: the gyro data to trim 
  * ****************************************************************************/
-void trim_gyro_data(vector<array<float, 3>> &data){
+void trim_gyro_data(Recording &data){
     float threshold = 0.00001;
     auto ptr = data.begin();
     // find the first element where data from any
@@ -591,71 +1357,157 @@ void trim_gyro_data(vector<array<float, 3>> &data){
 }
 
 /*******************************************************************************
- * @brief Calculate the correlation between two vectors
- * @param vect1: the first vector
- * @param vect2: the second vector
- * @return the correlation between the two vectors
+ * @brief Add samples to the correlation sums of each axis
+ * @param sums: running sums, zeroed before the first samples
+ * @param key: samples of the key
+ * @param record: as many samples of the recording, at the same positions
+ * @param count: number of samples
  * ****************************************************************************/
-float correlation(const vector<float> &vect1, const vector<float> &vect2){
-    // check if the size of the two vectors are the same
-    if (vect1.size() != vect2.size())
+RAMFUNC void correlation_add(CorrelationSums &sums, const array<float, 3> *key, const array<float, 3> *record, size_t count){
+    for (int axis = 0; axis < 3; axis++)
     {
-        err = -1;
-        return 0.0f;
+        float sum_1 = sums.sum_1[axis], sum_2 = sums.sum_2[axis], sum_12 = sums.sum_12[axis];
+        float sq_sum_1 = sums.sq_sum_1[axis], sq_sum_2 = sums.sq_sum_2[axis];
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            float a = key[i][axis];
+            float b = record[i][axis];
+            sum_1 += a;
+            sum_2 += b;
+            sum_12 += a * b;
+            sq_sum_1 += a * a;
+            sq_sum_2 += b * b;
+        }
+
+        sums.sum_1[axis] = sum_1;
+        sums.sum_2[axis] = sum_2;
+        sums.sum_12[axis] = sum_12;
+        sums.sq_sum_1[axis] = sq_sum_1;
+        sums.sq_sum_2[axis] = sq_sum_2;
     }
+    sums.n += count;
+}
 
-    float sum_1 = 0, sum_2 = 0, sum_12 = 0, sq_sum_1 = 0, sq_sum_2 = 0;
+/*******************************************************************************
+ * @brief Calculate the correlation of each axis from the sums
+ * @param sums: of the samples both recordings have
+ * @return the correlation of each axis
+ * ****************************************************************************/
+array<float, 3> correlation_result(const CorrelationSums &sums){
+    array<float, 3> result = {0, 0, 0};
+    size_t n = sums.n; // number of elements
 
-    for (size_t i = 0; i < vect1.size(); ++i)
+    // check there is something to correlate
+    if (n < 2)
     {
-        sum_1 += vect1[i];
-        sum_2 += vect2[i];
-        sum_12 += vect1[i] * vect2[i];
-        sq_sum_1 += vect1[i] * vect1[i];
-        sq_sum_2 += vect2[i] * vect2[i];
+        err = APP_ERR_TOO_SHORT;
+        return result;
     }
 
-    size_t n = vect1.size(); // number of elements
+    for (int axis = 0; axis < 3; axis++)
+    {
+        float numerator = n * sums.sum_12[axis] - sums.sum_1[axis] * sums.sum_2[axis]; // Covariance
 
-    float numerator = n * sum_12 - sum_1 * sum_2; // Covariance
-    
-    float denominator = sqrt((n * sq_sum_1 - sum_1 * sum_1) * (n * sq_sum_2 - sum_2 * sum_2)); // Standard deviation
+        float denominator = sqrt((n * sums.sq_sum_1[axis] - sums.sum_1[axis] * sums.sum_1[axis]) *
+                                 (n * sums.sq_sum_2[axis] - sums.sum_2[axis] * sums.sum_2[axis])); // Standard deviation
 
-    return numerator / denominator;
+        result[axis] = numerator / denominator;
+    }
+    return result;
 }
 
 /*******************************************************************************
- * @brief Calculate the correlation between two vectors
- * @param vect1: the first vector
- * @param vect2: the second vector
- * @return the correlation between the two vectors
+ * @brief Start matching a key against a recording
+ * @param scratch: sums and rows, in CCM
+ * @param record: the unlocking record, read in place
  * ****************************************************************************/
-array<float, 3> calculateCorrelation(vector<array<float, 3>>& vec1, vector<array<float, 3>>& vec2) {
-    array<float, 3> result;
-
-    // Calculate the correlation for each coordinate
-    for (int i = 0; i < 3; i++) {
-        vector<float> vect1;
-        vector<float> vect2;
+void match_begin(Match &match, MatchScratch *scratch, const GestureSpan &record){
+    match.scratch = scratch;
+    match.record = record;
+    match.key_done = 0;
+    scratch->sums = {};
+
+    // Two rows of the DTW matrix are all it needs; a recording longer than
+    // the scratch has them from the arena, dropped with the attempt
+    size_t columns = record.size + 1;
+    float *rows = scratch->dtw_rows[0];
+    if (columns > APP_MAX_SAMPLES + 1){
+        rows = (float *)arena_alloc(&app_arena, 2 * columns * sizeof(float));
+    }
+    if (rows == NULL){
+        printf("Error: no room for the DTW rows of %u samples\n", (unsigned)record.size);
+        match.previous = match.current = NULL;
+        return;
+    }
+    match.previous = rows;
+    match.current = rows + columns;
+    match.previous[0] = 0;
+    fill(match.previous + 1, match.previous + columns, numeric_limits<float>::infinity());
+}
 
-        // Populate 'a' and 'b' with the ith coordinates of vec1 and vec2
-        for (const auto& arr : vec1) {
-            vect1.push_back(arr[i]);
-        }
-        for (const auto& arr : vec2) {
-            vect2.push_back(arr[i]);
+/*******************************************************************************
+ * @brief Take the next key samples: correlation over the samples both have,
+ *        DTW rows for all
+ * @param key: samples of the key, following the ones taken before
+ * @param count: number of samples
+ * ****************************************************************************/
+void match_add(Match &match, const array<float, 3> *key, size_t count){
+    if (match.key_done < match.record.size){
+        correlation_add(match.scratch->sums, key, match.record.samples + match.key_done,
+                        min(count, match.record.size - match.key_done));
+    }
+    if (match.previous){
+        for (size_t i = 0; i < count; i++){
+            dtw_add_row(match, key[i]);
         }
+    }
+    match.key_done += count;
+}
 
-        // Resize 'a' to match the size of 'b', if necessary
-        if (vect1.size() > vect2.size()) {
-            vect1.resize(vect2.size(), 0);
-        } else if (vect2.size() > vect2.size()) {
-            vect2.resize(vect1.size(), 0);
-        }
+/*******************************************************************************
+ * @brief Correlation and DTW distance of the key taken so far
+ * ****************************************************************************/
+MatchResult match_result(const Match &match){
+    MatchResult result;
+    result.correlation = correlation_result(match.scratch->sums);
+    result.dtw = match.previous && match.key_done ? match.previous[match.record.size] : numeric_limits<float>::infinity();
+    return result;
+}
+
+/*******************************************************************************
+ * @brief Match a key read in place against a recording
+ * @param scratch: sums and rows
+ * @param key: the key, read in place
+ * @param record: the unlocking record
+ * @return the correlation of each axis, over the length of the shorter one,
+ *         and the DTW distance
+ * ****************************************************************************/
+MatchResult match_span(MatchScratch *scratch, const GestureSpan &key, const GestureSpan &record){
+    Match match;
+    match_begin(match, scratch, record);
+    match_add(match, key.samples, key.size);
+    return match_result(match);
+}
 
-        // Calculate the correlation and store the result
-        result[i] = correlation(vect1, vect2);
+/*******************************************************************************
+ * @brief Match the stored key against a recording, decoding the key a block
+ *        at a time into the scratch as it goes
+ * @param key: decoder of the key, mapped in place
+ * @param record: the unlocking record
+ * @return the correlation of each axis and the DTW distance
+ * ****************************************************************************/
+MatchResult app_match_key(TemplateDecoder *key, const GestureSpan &record){
+    if (key->raw){
+        // Floats: nothing to decode
+        return match_span(&match_scratch, {(const array<float, 3> *)key->raw, key->samples}, record);
     }
 
-    return result;
+    Match match;
+    match_begin(match, &match_scratch, record);
+    size_t n;
+    while ((n = template_decode(key, (float (*)[3])match_scratch.block, APP_DECODE_BLOCK)) > 0){
+        match_add(match, match_scratch.block, n);
+    }
+    return match_result(match);
 }
@@ -0,0 +1,39 @@
+#ifndef PACKED_FONT_H
+#define PACKED_FONT_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Proportional fonts generated by tools/font_pack.py. Only the ink box of a
+// glyph is stored, as run pairs: high nibble transparent pixels, low nibble
+// ink pixels, row by row through the box.
+typedef struct
+{
+    uint8_t advance;  // pen movement after the glyph
+    uint8_t y;        // ink box top, relative to the line top
+    uint8_t width;    // ink box size, 0 for blank glyphs
+    uint8_t height;
+    uint16_t offset;  // first run byte of the glyph
+} PackedGlyph;
+
+typedef struct
+{
+    const PackedGlyph *glyphs;
+    const uint8_t *runs;
+    uint8_t first;     // character of glyphs[0]
+    uint8_t count;     // number of glyphs
+    uint8_t height;    // line height
+    uint8_t max_width; // widest ink box
+    uint8_t bearing;   // ink box offset from the pen
+} PackedFont;
+
+extern const PackedFont Font16P;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef PACKED_IMAGE_H
+#define PACKED_IMAGE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Images generated by tools/image_pack.py. Pixels are RGB565 in row order,
+// coded as one stream of QOI-style ops; the previous pixel starts as black
+// and every decoded pixel is stored in a 64-entry table of recent colors at
+// (r * 3 + g * 5 + b * 7) % 64. Runs may cross rows.
+#define IMAGE_OP_INDEX 0x00 // 00iiiiii              table entry i
+#define IMAGE_OP_DIFF  0x40 // 01rrggbb              r, g, b change by -2..1
+#define IMAGE_OP_LUMA  0x80 // 10gggggg rrrrbbbb     g by -32..31, r and b by g -8..7
+#define IMAGE_OP_RUN   0xC0 // 11nnnnnn              previous pixel n + 1 more times, n < 62
+#define IMAGE_OP_RGB   0xFE // 11111110 lo hi        literal RGB565
+
+typedef struct
+{
+    uint16_t width;
+    uint16_t height;
+    uint32_t size;       // bytes of data
+    const uint8_t *data;
+} PackedImage;
+
+extern const PackedImage BootScreen;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef RAMFUNC_H
+#define RAMFUNC_H
+
+#include "mbed.h"
+
+// Functions run from SRAM instead of flash: the gyroscope read path, the
+// match kernels and the app's interrupt handlers.
+//
+// Code in flash waits on the flash wait states whenever the ART cache
+// misses, and stops altogether while the flash is programmed or erased in
+// the same bank. RAMFUNC puts a function in .data.ramfunc: mbed's linker
+// script gathers .data* into RAM with a load address in flash, and the
+// startup code copies it over with the initialised data, so nothing else is
+// needed. long_call lets calls reach from flash to RAM and back, beyond the
+// 16 MB range of a BL; noinline keeps the body from being inlined back into
+// a caller in flash. Put it on the declaration, so callers see long_call.
+//
+// Only the function itself moves: what it calls, the SPI driver under
+// ReadIO() or mbed's EXTI dispatch in front of the handlers, stays in
+// flash.
+//
+// mbed's MPU manager marks RAM execute-never at boot, so the first call
+// into RAM would take a MemManage fault. ramfunc_init() lifts that for good
+// through mbed_mpu_manager_lock_ram_execution(), the lock
+// ScopedRamExecutionLock takes and never giving it back; call it first in
+// main(), before the boot thread reads the gyroscope or an interrupt is
+// hooked. RAM stays writable and executable from then on, the MPU's guard
+// against running stray data given up. Set APP_RAM_BENCH in main.cpp to
+// time both builds; the option stays off until that has been measured on
+// the board.
+
+// Set to 1 to run them from RAM
+#ifndef RAMFUNC_ENABLED
+#define RAMFUNC_ENABLED 0
+#endif
+
+#if RAMFUNC_ENABLED
+#define RAMFUNC __attribute__((section(".data.ramfunc"), long_call, noinline))
+#else
+#define RAMFUNC
+#endif
+
+// Let code run from RAM: first thing in main()
+inline void ramfunc_init(){
+#if RAMFUNC_ENABLED
+    mbed_mpu_manager_lock_ram_execution();
+#endif
+}
+
+#endif
@@ -0,0 +1,235 @@
+#include "mbed.h"
+#include <atomic>
+#include "render.h"
+#include "ui.h"
+#include "trace_plot.h"
+
+#define RENDER_WAKE_FLAG 1
+
+// Bounded MPSC ring. Each slot carries a sequence number: equal to the
+// position when the slot is free for that position, position + 1 once the
+// command is written. Producers claim positions with a CAS on enqueue_pos,
+// the render thread is the only consumer.
+typedef struct
+{
+    std::atomic<uint32_t> sequence;
+    RenderCommand command;
+} RenderSlot;
+
+static RenderSlot slots[RENDER_QUEUE_SIZE];
+static std::atomic<uint32_t> enqueue_pos(0);
+static uint32_t dequeue_pos = 0; // render thread only
+static std::atomic<uint32_t> dropped(0);
+
+static Thread render_thread(osPriorityNormal, 4096);
+static EventFlags render_flags;
+static Timer render_timer;
+
+static RenderStats stats;
+
+/*******************************************************************************
+ * @brief append a command to the queue
+ * @param command: command to copy in
+ * @return false if the queue is full
+ * ****************************************************************************/
+static bool queue_push(const RenderCommand &command){
+    uint32_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    while (1){
+        RenderSlot *slot = &slots[pos & (RENDER_QUEUE_SIZE - 1)];
+        int32_t diff = (int32_t)(slot->sequence.load(std::memory_order_acquire) - pos);
+        if (diff == 0){
+            // on failure pos is reloaded and the loop retries
+            if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                slot->command = command;
+                slot->sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0){
+            return false; // the consumer has not freed this slot yet
+        }
+        else{
+            pos = enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+/*******************************************************************************
+ * @brief take the oldest command off the queue
+ * @param command: destination
+ * @return false if no complete command is waiting
+ * ****************************************************************************/
+static bool queue_pop(RenderCommand *command){
+    RenderSlot *slot = &slots[dequeue_pos & (RENDER_QUEUE_SIZE - 1)];
+    if ((int32_t)(slot->sequence.load(std::memory_order_acquire) - (dequeue_pos + 1)) < 0){
+        return false;
+    }
+    *command = slot->command;
+    slot->sequence.store(dequeue_pos + RENDER_QUEUE_SIZE, std::memory_order_release);
+    dequeue_pos++;
+    return true;
+}
+
+/*******************************************************************************
+ * @brief drain the queue and draw; only the newest status update is drawn
+ * @return true if anything was drawn
+ * ****************************************************************************/
+static bool draw_commands(){
+    RenderCommand batch[RENDER_QUEUE_SIZE];
+    uint32_t count = 0;
+    while (count < RENDER_QUEUE_SIZE && queue_pop(&batch[count])){
+        count++;
+    }
+    if (count == 0){
+        return false;
+    }
+
+    int last_status = -1;
+    int last_target = -1;
+    uint32_t oldest_us = batch[0].posted_us;
+    for (uint32_t i = 0; i < count; i++){
+        if (batch[i].kind == RENDER_STATUS){
+            if (last_status >= 0){
+                stats.coalesced++;
+            }
+            last_status = i;
+        }
+        else if (batch[i].kind == RENDER_TARGET){
+            if (last_target >= 0){
+                stats.coalesced++;
+            }
+            last_target = i;
+        }
+        oldest_us = min(oldest_us, batch[i].posted_us);
+    }
+
+    if (last_target >= 0){
+        ui_draw_target(batch[last_target].x, batch[last_target].y);
+    }
+    if (last_status >= 0){
+        ui_draw_status(batch[last_status].text, batch[last_status].color);
+    }
+
+    uint32_t latency = render_timer.elapsed_time().count() - oldest_us;
+    stats.batches++;
+    stats.commands += count;
+    stats.max_depth = max(stats.max_depth, count);
+    stats.total_latency_us += latency;
+    stats.max_latency_us = max(stats.max_latency_us, latency);
+    return true;
+}
+
+/*******************************************************************************
+ * @brief render thread: sleep until woken or the next plot frame is due
+ * ****************************************************************************/
+static void render_thread_main(){
+    auto next_frame = Kernel::Clock::now();
+
+    while (1){
+        if (trace_plot_active()){
+            render_flags.wait_any_until(RENDER_WAKE_FLAG, next_frame);
+        }
+        else{
+            render_flags.wait_any(RENDER_WAKE_FLAG);
+            next_frame = Kernel::Clock::now();
+        }
+
+        uint32_t start = render_timer.elapsed_time().count();
+        bool drawn = draw_commands();
+
+        if (trace_plot_active() && Kernel::Clock::now() >= next_frame){
+            drawn |= trace_plot_frame();
+            next_frame += TRACE_PLOT_FRAME_PERIOD;
+        }
+
+        if (drawn){
+            uint32_t elapsed = render_timer.elapsed_time().count() - start;
+            stats.frames++;
+            stats.total_frame_us += elapsed;
+            stats.max_frame_us = max(stats.max_frame_us, elapsed);
+        }
+    }
+}
+
+/*******************************************************************************
+ * @brief start the render thread
+ * ****************************************************************************/
+void render_init(){
+    for (uint32_t i = 0; i < RENDER_QUEUE_SIZE; i++){
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    render_timer.start();
+    render_thread.start(callback(render_thread_main));
+}
+
+/*******************************************************************************
+ * @brief queue a status line update
+ * @param text: message, cut to RENDER_MAX_TEXT - 1 characters
+ * @param color: strip color
+ * @return false if the queue is full
+ * ****************************************************************************/
+bool render_post_status(const char *text, uint32_t color){
+    RenderCommand command;
+    command.kind = RENDER_STATUS;
+    command.color = color;
+    strncpy(command.text, text, RENDER_MAX_TEXT - 1);
+    command.text[RENDER_MAX_TEXT - 1] = 0;
+    command.posted_us = render_timer.elapsed_time().count();
+
+    if (!queue_push(command)){
+        dropped++;
+        return false;
+    }
+    render_wake();
+    return true;
+}
+
+/*******************************************************************************
+ * @brief queue a calibration target
+ * @param x, y: target center, x < 0 to restore the screen
+ * @return false if the queue is full
+ * ****************************************************************************/
+bool render_post_target(int x, int y){
+    RenderCommand command;
+    command.kind = RENDER_TARGET;
+    command.x = x;
+    command.y = y;
+    command.posted_us = render_timer.elapsed_time().count();
+
+    if (!queue_push(command)){
+        dropped++;
+        return false;
+    }
+    render_wake();
+    return true;
+}
+
+/*******************************************************************************
+ * @brief wake the render thread
+ * ****************************************************************************/
+void render_wake(){
+    render_flags.set(RENDER_WAKE_FLAG);
+}
+
+/*******************************************************************************
+ * @brief get the counters
+ * @return the counters
+ * ****************************************************************************/
+RenderStats render_stats(){
+    RenderStats result = stats;
+    result.dropped = dropped.load();
+    return result;
+}
+
+/*******************************************************************************
+ * @brief print the counters
+ * ****************************************************************************/
+void render_print_stats(){
+    RenderStats s = render_stats();
+    printf("Render: %lu frames, %lu commands, %lu coalesced, %lu dropped, max depth %lu/%u\n",
+           (unsigned long)s.frames, (unsigned long)s.commands, (unsigned long)s.coalesced,
+           (unsigned long)s.dropped, (unsigned long)s.max_depth, RENDER_QUEUE_SIZE);
+    printf("Render: latency avg %lu us max %lu us, frame avg %lu us max %lu us\n",
+           (unsigned long)(s.batches ? s.total_latency_us / s.batches : 0), (unsigned long)s.max_latency_us,
+           (unsigned long)(s.frames ? s.total_frame_us / s.frames : 0), (unsigned long)s.max_frame_us);
+}
@@ -0,0 +1,62 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "mbed.h"
+
+// Draw commands buffered between the application threads and the render
+// thread, power of 2
+#define RENDER_QUEUE_SIZE 16
+
+// Longest status message, longer ones are cut
+#define RENDER_MAX_TEXT 32
+
+// Draw command kinds
+#define RENDER_STATUS 1 // redraw the status line
+#define RENDER_TARGET 2 // show or remove the calibration target
+
+typedef struct
+{
+    uint8_t kind;
+    uint32_t color;            // status strip color
+    char text[RENDER_MAX_TEXT];
+    int16_t x, y;              // calibration target, x < 0 for none
+    uint32_t posted_us;        // when the command was queued
+} RenderCommand;
+
+// Render thread counters
+typedef struct
+{
+    uint32_t frames;     // wakeups that drew something
+    uint32_t batches;    // frames that drained queued commands
+    uint32_t commands;   // commands taken from the queue
+    uint32_t coalesced;  // status updates skipped for a newer one
+    uint32_t dropped;    // commands lost to a full queue
+    uint32_t max_depth;  // most commands waiting at once
+    uint32_t total_latency_us; // post to drawn, oldest command of each frame
+    uint32_t max_latency_us;
+    uint32_t total_frame_us;   // time spent drawing
+    uint32_t max_frame_us;
+} RenderStats;
+
+// Start the render thread. From here on it owns the LCD; everything else
+// posts commands. Call after the static screen is drawn.
+void render_init();
+
+// Queue a status line update; never blocks, safe from any thread.
+// Returns false if the queue is full.
+bool render_post_status(const char *text, uint32_t color);
+
+// Queue a calibration target at x, y, or x < 0 to restore the screen.
+// Returns false if the queue is full.
+bool render_post_target(int x, int y);
+
+// Wake the render thread, e.g. when a plot starts
+void render_wake();
+
+// Get the counters
+RenderStats render_stats();
+
+// Print the counters
+void render_print_stats();
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef SDRAM_MAP_H
+#define SDRAM_MAP_H
+
+#include "drivers/stm32f429i_discovery_sdram.h"
+
+// Layout of the 8 MB SDRAM at SDRAM_DEVICE_ADDR
+//
+//   0x000000  layer 1 frame buffer   (LCD_DISCO_F429ZI, 0x130000)
+//   0x130000  layer 0 frame buffer   (LCD_DISCO_F429ZI, 0x130000)
+//   0x260000  converted frame buffer (LCD_DISCO_F429ZI, 0x130000)
+//   0x390000  sprite cache
+//   0x410000  glyph cache
+//   0x420000  arena of the app's large transient buffers (src/arena.h)
+//   0x520000  unlock attempt log (src/audit_log.h)
+#define SDRAM_FRAME_BUFFERS_END (SDRAM_DEVICE_ADDR + 0x390000)
+
+#define SDRAM_SPRITE_CACHE_ADDR SDRAM_FRAME_BUFFERS_END
+#define SDRAM_SPRITE_CACHE_SIZE 0x80000 // 512 KB
+
+#define SDRAM_GLYPH_CACHE_ADDR (SDRAM_SPRITE_CACHE_ADDR + SDRAM_SPRITE_CACHE_SIZE)
+#define SDRAM_GLYPH_CACHE_SIZE 0x10000 // 64 KB
+
+#define SDRAM_ARENA_ADDR (SDRAM_GLYPH_CACHE_ADDR + SDRAM_GLYPH_CACHE_SIZE)
+#define SDRAM_ARENA_SIZE 0x100000 // 1 MB
+
+#define SDRAM_AUDIT_ADDR (SDRAM_ARENA_ADDR + SDRAM_ARENA_SIZE)
+#define SDRAM_AUDIT_SIZE 0x10000 // 64 KB
+
+#define SDRAM_FREE_ADDR (SDRAM_AUDIT_ADDR + SDRAM_AUDIT_SIZE)
+
+#endif
@@ -0,0 +1,302 @@
+#include "mbed.h"
+#include "settings.h"
+#include "crc32.h"
+#include "drivers/stm32f429i_discovery_eeprom.h"
+
+#define SETTINGS_WAKE_FLAG 1
+
+#define SHADOW_SIZE (SETTINGS_KEYS * SETTINGS_SLOT_SIZE)
+#define SHADOW_PAGES (SHADOW_SIZE / EEPROM_PAGESIZE)
+
+static_assert(SHADOW_SIZE % EEPROM_PAGESIZE == 0 && SETTINGS_SLOT_SIZE % EEPROM_PAGESIZE == 0,
+              "slots must be whole EEPROM pages");
+static_assert(SETTINGS_EEPROM_ADDR % EEPROM_PAGESIZE == 0 && SETTINGS_EEPROM_ADDR + SHADOW_SIZE <= EEPROM_MAX_SIZE,
+              "slots must fit the EEPROM");
+
+static Thread worker_thread(SETTINGS_WORKER_PRIORITY, SETTINGS_WORKER_STACK);
+static EventFlags worker_flags;
+static Mutex shadow_mutex;
+static Mutex bus_mutex;
+
+// Read into by DMA at init
+static uint8_t shadow[SHADOW_SIZE];
+static uint32_t dirty[(SHADOW_PAGES + 31) / 32];
+static bool valid[SETTINGS_KEYS];
+static Kernel::Clock::time_point dirty_since; // when the oldest waiting change was made
+static bool eeprom_ok = false;
+
+static SettingsStats stats;
+
+/*******************************************************************************
+ * @brief take the shadow, counting the wait
+ * ****************************************************************************/
+static void lock(){
+    uint32_t start = us_ticker_read();
+    shadow_mutex.lock();
+    stats.max_wait_us = max(stats.max_wait_us, us_ticker_read() - start);
+}
+
+/*******************************************************************************
+ * @brief check the slot of a key in the shadow
+ * ****************************************************************************/
+static bool slot_valid(uint8_t key){
+    const uint8_t *slot = &shadow[key * SETTINGS_SLOT_SIZE];
+    SettingsHeader header;
+    memcpy(&header, slot, sizeof(header));
+    if (header.magic != SETTINGS_MAGIC || header.key != key || header.length > SETTINGS_VALUE_MAX){
+        return false;
+    }
+    uint32_t crc;
+    memcpy(&crc, slot + sizeof(header) + header.length, sizeof(crc));
+    return crc == crc32(0, slot, sizeof(header) + header.length);
+}
+
+/*******************************************************************************
+ * @brief copy bytes into the shadow, marking the pages that change; shadow
+ *        locked
+ * @return true if any byte changed
+ * ****************************************************************************/
+static bool write_shadow(uint32_t offset, const uint8_t *bytes, uint32_t length){
+    bool changed = false;
+    for (uint32_t page = offset / EEPROM_PAGESIZE; page * EEPROM_PAGESIZE < offset + length; page++){
+        uint32_t start = max(offset, page * EEPROM_PAGESIZE);
+        uint32_t end = min(offset + length, (page + 1) * EEPROM_PAGESIZE);
+        if (memcmp(&shadow[start], &bytes[start - offset], end - start) == 0){
+            continue;
+        }
+        memcpy(&shadow[start], &bytes[start - offset], end - start);
+        changed = true;
+
+        uint32_t bit = 1u << (page % 32);
+        if (dirty[page / 32] & bit){
+            stats.coalesced++;
+        }
+        else{
+            if (stats.dirty++ == 0){
+                dirty_since = Kernel::Clock::now();
+            }
+            dirty[page / 32] |= bit;
+        }
+    }
+    return changed;
+}
+
+/*******************************************************************************
+ * @brief take the next dirty page off the list; shadow locked
+ * @param copy: its bytes as they are now
+ * @return the page, or -1 if none is dirty
+ * ****************************************************************************/
+static int take_dirty_page(uint8_t *copy){
+    for (uint32_t i = 0; i < sizeof(dirty) / sizeof(dirty[0]); i++){
+        if (dirty[i]){
+            uint32_t page = i * 32 + __builtin_ctz(dirty[i]);
+            dirty[i] &= dirty[i] - 1;
+            stats.dirty--;
+            memcpy(copy, &shadow[page * EEPROM_PAGESIZE], EEPROM_PAGESIZE);
+            return page;
+        }
+    }
+    return -1;
+}
+
+/*******************************************************************************
+ * @brief put a page whose write failed back on the list; shadow locked
+ * ****************************************************************************/
+static void redirty_page(uint32_t page){
+    uint32_t bit = 1u << (page % 32);
+    if (!(dirty[page / 32] & bit)){
+        if (stats.dirty++ == 0){
+            dirty_since = Kernel::Clock::now();
+        }
+        dirty[page / 32] |= bit;
+    }
+}
+
+/*******************************************************************************
+ * @brief write dirty pages back a page at a time, within the budget, then
+ *        sleep until something changes
+ * ****************************************************************************/
+static void worker(){
+    static uint8_t page_data[EEPROM_PAGESIZE]; // DMA source
+    Kernel::Clock::time_point period_end = Kernel::Clock::now() + SETTINGS_BUDGET_PERIOD;
+    stats.budget_left = SETTINGS_BUDGET_PAGES;
+
+    while (1){
+        worker_flags.wait_any(SETTINGS_WAKE_FLAG);
+
+        // Let the changes of a burst pile up on the same pages
+        lock();
+        Kernel::Clock::time_point due = dirty_since + SETTINGS_FLUSH_DELAY;
+        shadow_mutex.unlock();
+        ThisThread::sleep_until(due);
+
+        while (1){
+            if (Kernel::Clock::now() >= period_end){
+                period_end = Kernel::Clock::now() + SETTINGS_BUDGET_PERIOD;
+                stats.budget_left = SETTINGS_BUDGET_PAGES;
+            }
+            if (stats.budget_left == 0){
+                stats.throttled++;
+                ThisThread::sleep_until(period_end);
+                continue;
+            }
+
+            lock();
+            int page = take_dirty_page(page_data);
+            shadow_mutex.unlock();
+            if (page < 0){
+                break;
+            }
+
+            // The write cycle is waited out in the driver, bus held
+            uint8_t length = EEPROM_PAGESIZE;
+            uint32_t start = us_ticker_read();
+            bus_mutex.lock();
+            bool ok = BSP_EEPROM_WritePage(page_data, SETTINGS_EEPROM_ADDR + page * EEPROM_PAGESIZE, &length) == EEPROM_OK;
+            bus_mutex.unlock();
+            stats.max_write_us = max(stats.max_write_us, us_ticker_read() - start);
+            stats.budget_left--;
+
+            if (ok){
+                stats.pages_written++;
+            }
+            else{
+                stats.failed++;
+                lock();
+                redirty_page(page);
+                shadow_mutex.unlock();
+                ThisThread::sleep_for(SETTINGS_RETRY);
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+ * @brief bring up the EEPROM, fill the shadow and start the writer
+ * @return false if there is no EEPROM
+ * ****************************************************************************/
+bool settings_init(){
+    uint16_t length = SHADOW_SIZE;
+    eeprom_ok = BSP_EEPROM_Init() == EEPROM_OK &&
+                BSP_EEPROM_ReadBuffer(shadow, SETTINGS_EEPROM_ADDR, &length) == EEPROM_OK;
+    if (!eeprom_ok){
+        printf("Settings: no EEPROM, nothing is kept over a reset\n");
+        memset(shadow, 0xFF, sizeof(shadow));
+        return false;
+    }
+    for (uint8_t key = 0; key < SETTINGS_KEYS; key++){
+        valid[key] = slot_valid(key);
+        stats.loaded += valid[key];
+    }
+    worker_thread.start(callback(worker));
+    return true;
+}
+
+/*******************************************************************************
+ * @brief copy a value out of the shadow
+ * @param key: SETTINGS_*
+ * @param value: destination
+ * @param size: its size
+ * @return the value's length, 0 if unset or larger than size
+ * ****************************************************************************/
+uint32_t settings_get(uint8_t key, void *value, uint32_t size){
+    if (key >= SETTINGS_KEYS){
+        return 0;
+    }
+    lock();
+    stats.gets++;
+    const uint8_t *slot = &shadow[key * SETTINGS_SLOT_SIZE];
+    uint32_t length = 0;
+    if (valid[key]){
+        length = ((const SettingsHeader *)slot)->length;
+        if (length <= size){
+            memcpy(value, slot + sizeof(SettingsHeader), length);
+        }
+        else{
+            length = 0;
+        }
+    }
+    shadow_mutex.unlock();
+    return length;
+}
+
+/*******************************************************************************
+ * @brief replace a value and queue it for writing back
+ * @param key: SETTINGS_*
+ * @param value: the bytes
+ * @param length: SETTINGS_VALUE_MAX at most
+ * @return false if the key or length is out of range
+ * ****************************************************************************/
+bool settings_set(uint8_t key, const void *value, uint32_t length){
+    if (key >= SETTINGS_KEYS || length > SETTINGS_VALUE_MAX){
+        return false;
+    }
+    uint8_t slot[SETTINGS_SLOT_SIZE];
+    SettingsHeader header = {SETTINGS_MAGIC, key, (uint8_t)length};
+    memcpy(slot, &header, sizeof(header));
+    memcpy(slot + sizeof(header), value, length);
+    uint32_t crc = crc32(0, slot, sizeof(header) + length);
+    memcpy(slot + sizeof(header) + length, &crc, sizeof(crc));
+
+    lock();
+    stats.sets++;
+    valid[key] = true;
+    bool changed = write_shadow(key * SETTINGS_SLOT_SIZE, slot, sizeof(header) + length + sizeof(crc));
+    if (!changed){
+        stats.unchanged++;
+    }
+    shadow_mutex.unlock();
+    if (changed){
+        worker_flags.set(SETTINGS_WAKE_FLAG);
+    }
+    return true;
+}
+
+/*******************************************************************************
+ * @brief forget a value: its header is cleared
+ * @param key: SETTINGS_*
+ * ****************************************************************************/
+void settings_clear(uint8_t key){
+    if (key >= SETTINGS_KEYS){
+        return;
+    }
+    const uint8_t blank[sizeof(SettingsHeader)] = {0};
+    lock();
+    valid[key] = false;
+    bool changed = write_shadow(key * SETTINGS_SLOT_SIZE, blank, sizeof(blank));
+    shadow_mutex.unlock();
+    if (changed){
+        worker_flags.set(SETTINGS_WAKE_FLAG);
+    }
+}
+
+void settings_lock_bus(){
+    bus_mutex.lock();
+}
+
+void settings_unlock_bus(){
+    bus_mutex.unlock();
+}
+
+/*******************************************************************************
+ * @brief get the counters
+ * @return a copy of the counters
+ * ****************************************************************************/
+SettingsStats settings_stats(){
+    return stats;
+}
+
+/*******************************************************************************
+ * @brief print the counters
+ * ****************************************************************************/
+void settings_print_stats(){
+    SettingsStats s = settings_stats();
+    printf("Settings: %lu keys loaded, %lu gets, %lu sets, %lu unchanged, %lu page changes coalesced\n",
+           (unsigned long)s.loaded, (unsigned long)s.gets, (unsigned long)s.sets, (unsigned long)s.unchanged,
+           (unsigned long)s.coalesced);
+    printf("Settings: %lu pages written, %lu failed, %lu waiting, budget %lu of %u left, throttled %lu times, "
+           "longest write %lu us, callers waited %lu us at most\n",
+           (unsigned long)s.pages_written, (unsigned long)s.failed, (unsigned long)s.dirty,
+           (unsigned long)s.budget_left, SETTINGS_BUDGET_PAGES, (unsigned long)s.throttled,
+           (unsigned long)s.max_write_us, (unsigned long)s.max_wait_us);
+}
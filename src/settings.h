@@ -0,0 +1,97 @@
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+#include "mbed.h"
+
+// Small values kept over a reset in the I2C EEPROM: the touch calibration,
+// app settings and counters.
+//
+// Each value has a key and a fixed slot in the EEPROM. settings_init() reads
+// the slots once into a RAM shadow. From then on settings_get() reads the
+// shadow and settings_set() writes it, marking the EEPROM pages whose bytes
+// changed; neither touches I2C. A thread below every other one writes the
+// dirty pages back, one page per I2C3 hold:
+//   - it starts SETTINGS_FLUSH_DELAY after a page first changes, so a run
+//     of updates, a counter bumped on each attempt, costs one write per page;
+//   - it spends at most SETTINGS_BUDGET_PAGES page writes per
+//     SETTINGS_BUDGET_PERIOD, the rest wait for the next period. Each page
+//     write wears the EEPROM and keeps the touch controller off the bus for
+//     the write cycle, about 5 ms.
+//
+// A slot holds a SettingsHeader, the value, then a CRC-32 of both. A reset
+// while a slot is half written back loses the value: it reads as unset.
+
+// Start of the slots in the EEPROM, and their size
+#define SETTINGS_EEPROM_ADDR 0x0000
+#define SETTINGS_SLOT_SIZE 64
+
+// Keys, one slot each
+#define SETTINGS_TOUCH_CAL 0 // TouchCal, src/touch.cpp
+#define SETTINGS_APP 1       // AppSettings, src/main.cpp
+#define SETTINGS_COUNTERS 2  // AppCounters, src/main.cpp
+#define SETTINGS_KEYS 8      // slots set aside
+
+// Largest value
+#define SETTINGS_VALUE_MAX (SETTINGS_SLOT_SIZE - sizeof(SettingsHeader) - sizeof(uint32_t))
+
+#define SETTINGS_MAGIC 0x5653 // "SV"
+
+// Write-back pacing
+#define SETTINGS_FLUSH_DELAY 2s
+#define SETTINGS_BUDGET_PAGES 32
+#define SETTINGS_BUDGET_PERIOD 60s
+#define SETTINGS_RETRY 1s      // after a failed page write
+
+#define SETTINGS_WORKER_PRIORITY osPriorityLow
+#define SETTINGS_WORKER_STACK 1024
+
+typedef struct
+{
+    uint16_t magic;   // SETTINGS_MAGIC
+    uint8_t key;
+    uint8_t length;   // of the value
+} SettingsHeader;
+
+typedef struct
+{
+    uint32_t loaded;        // keys found valid by settings_init()
+    uint32_t gets;
+    uint32_t sets;
+    uint32_t unchanged;     // sets that changed no byte, nothing to write
+    uint32_t coalesced;     // page changes folded into a write already pending
+    uint32_t pages_written;
+    uint32_t failed;        // page writes the EEPROM refused, retried
+    uint32_t throttled;     // times the budget ran out and the writes waited
+    uint32_t dirty;         // pages waiting now
+    uint32_t budget_left;   // page writes left this period
+    uint32_t max_write_us;  // longest page write, I2C3 held meanwhile
+    uint32_t max_wait_us;   // longest a caller waited for the shadow
+} SettingsStats;
+
+// Bring up the EEPROM, fill the shadow from it and start the writer. Call
+// before any other thread uses I2C3. Returns false if there is no EEPROM:
+// values then live until the next reset.
+bool settings_init();
+
+// Copy a value out of the shadow; returns its length, 0 if it is unset or
+// longer than size
+uint32_t settings_get(uint8_t key, void *value, uint32_t size);
+
+// Replace a value in the shadow and queue the pages that changed for
+// writing back; false if the key or length is out of range
+bool settings_set(uint8_t key, const void *value, uint32_t length);
+
+// Forget a value; it reads as unset from now on
+void settings_clear(uint8_t key);
+
+// The STMPE811 and the EEPROM share I2C3: hold the bus around transfers
+void settings_lock_bus();
+void settings_unlock_bus();
+
+// Get the counters
+SettingsStats settings_stats();
+
+// Print the counters
+void settings_print_stats();
+
+#endif
@@ -0,0 +1,312 @@
+#include "mbed.h"
+#include "sprite_cache.h"
+#include "font_atlas.h"
+
+// Sprite kinds
+#define SPRITE_BUTTON 1
+#define SPRITE_TEXT_STRIP 2
+
+// Everything a sprite is rendered from; two requests with equal keys
+// produce identical pixels
+typedef struct
+{
+    uint8_t kind;
+    uint8_t antialias;
+    uint16_t width;
+    uint16_t height;
+    int16_t radius; // corner radius, or text x position for strips
+    uint32_t fill_color;
+    uint32_t screen_color;
+    uint32_t text_color;
+    uint32_t text_back;
+    const PackedFont *font;
+    char text[SPRITE_MAX_TEXT];
+} SpriteKey;
+
+typedef struct
+{
+    SpriteKey key;
+    Sprite sprite;
+    uint32_t last_used; // use tick, 0 = empty slot
+} SpriteEntry;
+
+static SpriteEntry entries[SPRITE_MAX_SLOTS];
+static SpriteCacheStats stats;
+static uint32_t use_tick = 0;
+
+/*******************************************************************************
+ * @brief set the cache budget and drop all sprites
+ * @param budget_bytes: SDRAM bytes the cache may use
+ * ****************************************************************************/
+void sprite_cache_init(uint32_t budget_bytes){
+    memset(entries, 0, sizeof(entries));
+    memset(&stats, 0, sizeof(stats));
+    use_tick = 0;
+
+    stats.slots_budget = budget_bytes / SPRITE_SLOT_SIZE;
+    if (stats.slots_budget > SPRITE_MAX_SLOTS){
+        stats.slots_budget = SPRITE_MAX_SLOTS;
+    }
+}
+
+/*******************************************************************************
+ * @brief find a cached sprite or claim a slot for a new one
+ * @param key: sprite description
+ * @param hit: set to true when the sprite is already rendered
+ * @return the slot, or NULL when the sprite does not fit in a slot
+ * ****************************************************************************/
+static SpriteEntry *claim_entry(const SpriteKey &key, bool *hit){
+    *hit = false;
+
+    if (stats.slots_budget == 0 || (uint32_t)key.width * key.height * 4 > SPRITE_SLOT_SIZE){
+        stats.uncached++;
+        return NULL;
+    }
+
+    SpriteEntry *victim = NULL;
+    for (uint32_t i = 0; i < stats.slots_budget; i++){
+        SpriteEntry *entry = &entries[i];
+        if (entry->last_used != 0 && memcmp(&entry->key, &key, sizeof(key)) == 0){
+            entry->last_used = ++use_tick;
+            stats.hits++;
+            *hit = true;
+            return entry;
+        }
+        // prefer an empty slot, otherwise the least recently used one
+        if (victim == NULL || entry->last_used < victim->last_used){
+            victim = entry;
+        }
+    }
+
+    stats.misses++;
+    if (victim->last_used != 0){
+        stats.evictions++;
+    }
+    else{
+        stats.slots_used++;
+    }
+
+    victim->key = key;
+    victim->last_used = ++use_tick;
+    victim->sprite.width = key.width;
+    victim->sprite.height = key.height;
+    victim->sprite.pixels = (uint32_t *)(SDRAM_SPRITE_CACHE_ADDR + (victim - entries) * SPRITE_SLOT_SIZE);
+    return victim;
+}
+
+/*******************************************************************************
+ * @brief blend two ARGB8888 colors
+ * @param fg: foreground color
+ * @param bg: background color
+ * @param alpha: foreground coverage, 0..255
+ * @return the blended color
+ * ****************************************************************************/
+static uint32_t blend(uint32_t fg, uint32_t bg, uint32_t alpha){
+    uint32_t result = 0xFF000000;
+    for (int shift = 0; shift < 24; shift += 8){
+        uint32_t f = (fg >> shift) & 0xFF;
+        uint32_t b = (bg >> shift) & 0xFF;
+        result |= ((f * alpha + b * (255 - alpha) + 127) / 255) << shift;
+    }
+    return result;
+}
+
+/*******************************************************************************
+ * @brief draw a string into a sprite from the glyph cache, clipped to the sprite
+ * @param sprite: target sprite
+ * @param x: x position of the pen
+ * @param y: y position of the line top
+ * @param text: string to draw
+ * @param font: packed font
+ * @param text_color: glyph color
+ * @param text_back: color of the text box behind the glyphs
+ * ****************************************************************************/
+static void raster_text(Sprite *sprite, int x, int y, const char *text, const PackedFont *font,
+                        uint32_t text_color, uint32_t text_back){
+    // text box, like the glyph cells of the BSP text functions
+    int right = min(x + font_text_width(font, text), (int)sprite->width);
+    for (int py = max(y, 0); py < min(y + font->height, (int)sprite->height); py++){
+        uint32_t *dst = sprite->pixels + py * sprite->width;
+        for (int px = max(x, 0); px < right; px++){
+            dst[px] = text_back;
+        }
+    }
+
+    for (; *text != 0 && x < sprite->width; text++){
+        const GlyphMask *mask = font_glyph(font, *text);
+        for (int i = 0; mask != NULL && i < mask->height; i++){
+            int py = y + mask->y + i;
+            if (py < 0 || py >= sprite->height){
+                continue;
+            }
+
+            const uint8_t *alpha = mask->alpha + i * mask->width;
+            uint32_t *dst = sprite->pixels + py * sprite->width;
+            for (int j = 0; j < mask->width; j++){
+                int px = x + font->bearing + j;
+                if (px < 0 || px >= sprite->width || alpha[j] == 0){
+                    continue;
+                }
+                dst[px] = alpha[j] == 255 ? text_color : blend(text_color, dst[px], alpha[j]);
+            }
+        }
+        x += font_char_width(font, *text);
+    }
+}
+
+/*******************************************************************************
+ * @brief coverage of a pixel by a rounded rectangle
+ * @param px: pixel x
+ * @param py: pixel y
+ * @param width: rectangle width
+ * @param height: rectangle height
+ * @param radius: corner radius
+ * @param antialias: sample 4x4 points instead of the pixel center
+ * @return coverage, 0..255
+ * ****************************************************************************/
+static uint32_t rounded_rect_coverage(int px, int py, int width, int height, int radius, bool antialias){
+    // corner circle centers, matching FillCircle(x + radius, y + radius, radius)
+    int cx = px < radius ? radius : (px > width - radius ? width - radius : px);
+    int cy = py < radius ? radius : (py > height - radius ? height - radius : py);
+
+    if (!antialias){
+        int dx = px - cx;
+        int dy = py - cy;
+        return (dx * dx + dy * dy <= (radius + 0.5f) * (radius + 0.5f)) ? 255 : 0;
+    }
+
+    uint32_t inside = 0;
+    for (int sy = 0; sy < 4; sy++){
+        for (int sx = 0; sx < 4; sx++){
+            float dx = px + (sx - 1.5f) * 0.25f - cx;
+            float dy = py + (sy - 1.5f) * 0.25f - cy;
+            if (dx * dx + dy * dy <= (radius + 0.5f) * (radius + 0.5f)){
+                inside++;
+            }
+        }
+    }
+    return inside * 255 / 16;
+}
+
+/*******************************************************************************
+ * @brief get a rounded button sprite
+ * @param width: button width
+ * @param height: button height
+ * @param radius: corner radius
+ * @param fill_color: button color
+ * @param screen_color: color around the rounded corners
+ * @param label: button label
+ * @param font: label font
+ * @param text_color: label color
+ * @param text_back: label cell background color
+ * @param antialias: blend the corner edges into screen_color
+ * @return the sprite, or NULL if it does not fit in a slot
+ * ****************************************************************************/
+const Sprite *sprite_button(int width, int height, int radius, uint32_t fill_color, uint32_t screen_color,
+                            const char *label, const PackedFont *font, uint32_t text_color, uint32_t text_back, bool antialias){
+    if (strlen(label) >= SPRITE_MAX_TEXT){
+        stats.uncached++;
+        return NULL;
+    }
+
+    SpriteKey key;
+    memset(&key, 0, sizeof(key)); // keys are compared bytewise
+    key.kind = SPRITE_BUTTON;
+    key.antialias = antialias;
+    key.width = width;
+    key.height = height;
+    key.radius = radius;
+    key.fill_color = fill_color;
+    key.screen_color = screen_color;
+    key.text_color = text_color;
+    key.text_back = text_back;
+    key.font = font;
+    strcpy(key.text, label);
+
+    bool hit;
+    SpriteEntry *entry = claim_entry(key, &hit);
+    if (entry == NULL || hit){
+        return entry ? &entry->sprite : NULL;
+    }
+
+    Sprite *sprite = &entry->sprite;
+    for (int py = 0; py < height; py++){
+        uint32_t *dst = sprite->pixels + py * width;
+        for (int px = 0; px < width; px++){
+            uint32_t coverage = rounded_rect_coverage(px, py, width, height, radius, antialias);
+            dst[px] = coverage == 255 ? fill_color : blend(fill_color, screen_color, coverage);
+        }
+    }
+
+    // label centered on its measured width
+    int text_x_position = (width - font_text_width(font, label)) / 2;
+    int text_y_position = (height - font->height) / 2;
+    raster_text(sprite, text_x_position, text_y_position, label, font, text_color, text_back);
+
+    return sprite;
+}
+
+/*******************************************************************************
+ * @brief get a text strip sprite, text centered between the margins
+ * @param width: strip width
+ * @param height: strip height
+ * @param x: left and right margin
+ * @param text: text to display
+ * @param font: text font
+ * @param bg_color: strip color
+ * @param text_color: text color
+ * @param text_back: text cell background color
+ * @return the sprite, or NULL if it does not fit in a slot
+ * ****************************************************************************/
+const Sprite *sprite_text_strip(int width, int height, int x, const char *text, const PackedFont *font,
+                                uint32_t bg_color, uint32_t text_color, uint32_t text_back){
+    if (strlen(text) >= SPRITE_MAX_TEXT){
+        stats.uncached++;
+        return NULL;
+    }
+
+    SpriteKey key;
+    memset(&key, 0, sizeof(key)); // keys are compared bytewise
+    key.kind = SPRITE_TEXT_STRIP;
+    key.width = width;
+    key.height = height;
+    key.radius = x;
+    key.fill_color = bg_color;
+    key.text_color = text_color;
+    key.text_back = text_back;
+    key.font = font;
+    strcpy(key.text, text);
+
+    bool hit;
+    SpriteEntry *entry = claim_entry(key, &hit);
+    if (entry == NULL || hit){
+        return entry ? &entry->sprite : NULL;
+    }
+
+    Sprite *sprite = &entry->sprite;
+    for (int i = 0; i < width * height; i++){
+        sprite->pixels[i] = bg_color;
+    }
+
+    int column = x + max(width - 2 * x - font_text_width(font, text), 0) / 2;
+    raster_text(sprite, column, (height - font->height) / 2, text, font, text_color, text_back);
+
+    return sprite;
+}
+
+/*******************************************************************************
+ * @brief get the cache counters
+ * @return the counters
+ * ****************************************************************************/
+SpriteCacheStats sprite_cache_stats(){
+    return stats;
+}
+
+/*******************************************************************************
+ * @brief print the cache counters
+ * ****************************************************************************/
+void sprite_cache_print_stats(){
+    printf("Sprite cache: %lu hits, %lu misses, %lu evictions, %lu uncached, %lu/%lu slots\n",
+           (unsigned long)stats.hits, (unsigned long)stats.misses, (unsigned long)stats.evictions,
+           (unsigned long)stats.uncached, (unsigned long)stats.slots_used, (unsigned long)stats.slots_budget);
+}
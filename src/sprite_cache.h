@@ -0,0 +1,57 @@
+#ifndef SPRITE_CACHE_H
+#define SPRITE_CACHE_H
+
+#include "mbed.h"
+#include "sdram_map.h"
+#include "packed_font.h"
+
+// Every sprite lives in a fixed size slot of the SDRAM cache region.
+// 24 KB holds a 120x50 button or a 240x22 status strip in ARGB8888.
+#define SPRITE_SLOT_SIZE 0x6000
+#define SPRITE_MAX_SLOTS (SDRAM_SPRITE_CACHE_SIZE / SPRITE_SLOT_SIZE)
+
+// Longest label or message that can be cached
+#define SPRITE_MAX_TEXT 32
+
+// Prerendered ARGB8888 image
+typedef struct
+{
+    uint16_t width;  // width in pixels
+    uint16_t height; // height in pixels
+    uint32_t *pixels; // width * height words in SDRAM
+} Sprite;
+
+// Cache counters
+typedef struct
+{
+    uint32_t hits;      // lookups served from the cache
+    uint32_t misses;    // lookups that had to rasterize
+    uint32_t evictions; // least recently used sprites dropped
+    uint32_t uncached;  // requests too large for a slot
+    uint32_t slots_used;   // slots holding a sprite
+    uint32_t slots_budget; // slots allowed by the budget
+} SpriteCacheStats;
+
+// Set the cache budget in bytes (rounded down to whole slots) and drop all sprites
+void sprite_cache_init(uint32_t budget_bytes);
+
+// Get a rounded button sprite, rasterizing it on a miss.
+// Pixels outside the rounded corners are filled with screen_color; with
+// antialias the corner edges are blended into it.
+// Returns NULL if the button does not fit in a slot.
+const Sprite *sprite_button(int width, int height, int radius, uint32_t fill_color, uint32_t screen_color,
+                            const char *label, const PackedFont *font, uint32_t text_color, uint32_t text_back, bool antialias);
+
+// Get a text strip sprite, the text centered between margins of x pixels,
+// rasterizing it on a miss.
+// Returns NULL if the strip does not fit in a slot or the text is too long.
+const Sprite *sprite_text_strip(int width, int height, int x, const char *text, const PackedFont *font,
+                                uint32_t bg_color, uint32_t text_color, uint32_t text_back);
+
+// Get the cache counters
+SpriteCacheStats sprite_cache_stats();
+
+// Print the cache counters
+void sprite_cache_print_stats();
+
+#endif
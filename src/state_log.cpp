@@ -0,0 +1,66 @@
+#include "mbed.h"
+#include "state_log.h"
+
+static StateTransition entries[STATE_LOG_SIZE];
+static uint32_t head = 0;    // entries ever recorded
+static uint32_t printed = 0; // entries already printed
+static StateLogStats stats;
+
+/*******************************************************************************
+ * @brief log a transition
+ * @param from: state left
+ * @param to: state entered
+ * @param event: event that caused it
+ * @param event_us: us ticker when the event was posted or its timer was due
+ * ****************************************************************************/
+void state_log_record(uint8_t from, uint8_t to, uint8_t event, uint32_t event_us){
+    uint32_t now = us_ticker_read();
+    StateTransition *entry = &entries[head & (STATE_LOG_SIZE - 1)];
+    entry->from = from;
+    entry->to = to;
+    entry->event = event;
+    entry->at_us = now;
+    entry->latency_us = now - event_us;
+    head++;
+
+    stats.transitions++;
+    stats.total_latency_us += entry->latency_us;
+    stats.max_latency_us = max(stats.max_latency_us, entry->latency_us);
+}
+
+/*******************************************************************************
+ * @brief get the counters
+ * @return a copy of the counters
+ * ****************************************************************************/
+StateLogStats state_log_stats(){
+    return stats;
+}
+
+/*******************************************************************************
+ * @brief print the transitions logged since the last call
+ * @param prefix: line prefix, e.g. "App"
+ * @param states: state names, indexed by state
+ * @param events: event names, indexed by event
+ * ****************************************************************************/
+void state_log_print(const char *prefix, const char *const *states, const char *const *events){
+    uint32_t previous = 0;
+    if (head - printed > STATE_LOG_SIZE){
+        stats.overwritten += head - printed - STATE_LOG_SIZE;
+        printed = head - STATE_LOG_SIZE;
+        previous = entries[printed & (STATE_LOG_SIZE - 1)].at_us;
+    }
+    else if (printed > 0){
+        previous = entries[(printed - 1) & (STATE_LOG_SIZE - 1)].at_us;
+    }
+    for (; printed != head; printed++){
+        const StateTransition *entry = &entries[printed & (STATE_LOG_SIZE - 1)];
+        printf("%s: %-10s -> %-10s on %-7s %8lu us (+%lu us), %lu us after the event\n", prefix,
+               states[entry->from], states[entry->to], events[entry->event], (unsigned long)entry->at_us,
+               (unsigned long)(entry->at_us - previous), (unsigned long)entry->latency_us);
+        previous = entry->at_us;
+    }
+    printf("%s: %lu transitions, latency avg %lu us max %lu us, %lu not printed\n", prefix,
+           (unsigned long)stats.transitions,
+           (unsigned long)(stats.transitions ? stats.total_latency_us / stats.transitions : 0),
+           (unsigned long)stats.max_latency_us, (unsigned long)stats.overwritten);
+}
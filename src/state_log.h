@@ -0,0 +1,38 @@
+#ifndef STATE_LOG_H
+#define STATE_LOG_H
+
+#include "mbed.h"
+
+// Transitions kept between two state_log_print() calls, power of 2;
+// older ones are counted but overwritten
+#define STATE_LOG_SIZE 32
+
+typedef struct
+{
+    uint8_t from;
+    uint8_t to;
+    uint8_t event;       // event that caused it
+    uint32_t at_us;      // when the new state was entered
+    uint32_t latency_us; // from the event being posted, or its timer falling due
+} StateTransition;
+
+// Transition counters
+typedef struct
+{
+    uint32_t transitions;
+    uint32_t overwritten;      // lost before they were printed
+    uint32_t total_latency_us;
+    uint32_t max_latency_us;
+} StateLogStats;
+
+// Log a transition; call from the thread that runs the state machine
+void state_log_record(uint8_t from, uint8_t to, uint8_t event, uint32_t event_us);
+
+// Get the counters
+StateLogStats state_log_stats();
+
+// Print the transitions logged since the last call, by name, with the
+// time between them and their latency
+void state_log_print(const char *prefix, const char *const *states, const char *const *events);
+
+#endif
@@ -0,0 +1,76 @@
+#include "mbed.h"
+#include "store_flash.h"
+
+static FlashIAP flash;
+
+/*******************************************************************************
+ * @brief address of a sector of the store
+ * @param sector: 0 ... STORE_SECTOR_COUNT - 1
+ * ****************************************************************************/
+static uint32_t sector_address(uint8_t sector){
+    return STORE_FLASH_BASE + sector * STORE_SECTOR_SIZE;
+}
+
+/*******************************************************************************
+ * @brief set up FlashIAP and check the sectors are where the store expects
+ * @return STORE_FLASH_OK, STORE_FLASH_ERROR if the geometry differs
+ * ****************************************************************************/
+int store_flash_init(){
+    if (flash.init() != 0){
+        return STORE_FLASH_ERROR;
+    }
+    for (uint8_t sector = 0; sector < STORE_SECTOR_COUNT; sector++){
+        if (flash.get_sector_size(sector_address(sector)) != STORE_SECTOR_SIZE){
+            return STORE_FLASH_ERROR;
+        }
+    }
+    return STORE_FLASH_OK;
+}
+
+/*******************************************************************************
+ * @brief read from the store
+ * @param sector: sector of the store
+ * @param offset: offset into it
+ * @param buffer: destination
+ * @param size: bytes to read
+ * ****************************************************************************/
+int store_flash_read(uint8_t sector, uint32_t offset, void *buffer, uint32_t size){
+    // Memory mapped, a copy is cheaper than a FlashIAP call
+    memcpy(buffer, store_flash_map(sector, offset), size);
+    return STORE_FLASH_OK;
+}
+
+/*******************************************************************************
+ * @brief program an erased range
+ * @param sector: sector of the store
+ * @param offset: offset into it
+ * @param buffer: data
+ * @param size: bytes to program
+ * ****************************************************************************/
+int store_flash_program(uint8_t sector, uint32_t offset, const void *buffer, uint32_t size){
+    return flash.program(buffer, sector_address(sector) + offset, size) == 0 ? STORE_FLASH_OK : STORE_FLASH_ERROR;
+}
+
+/*******************************************************************************
+ * @brief erase a sector of the store
+ * @param sector: sector of the store
+ * ****************************************************************************/
+int store_flash_erase(uint8_t sector){
+    return flash.erase(sector_address(sector), STORE_SECTOR_SIZE) == 0 ? STORE_FLASH_OK : STORE_FLASH_ERROR;
+}
+
+/*******************************************************************************
+ * @brief address of an offset into the store, for reading in place
+ * @param sector: sector of the store
+ * @param offset: offset into it
+ * ****************************************************************************/
+const void *store_flash_map(uint8_t sector, uint32_t offset){
+    return (const void *)(sector_address(sector) + offset);
+}
+
+/*******************************************************************************
+ * @brief microsecond clock
+ * ****************************************************************************/
+uint32_t store_flash_time_us(){
+    return us_ticker_read();
+}
@@ -0,0 +1,42 @@
+#ifndef STORE_FLASH_H
+#define STORE_FLASH_H
+
+#include <stdint.h>
+
+// Flash under the template store. store_flash.cpp drives the internal flash
+// through FlashIAP; tools/flash_sim implements the same functions on a RAM
+// image of the sectors, with erase counting and power cuts.
+
+// Sectors 22 and 23, the last two 128 KB sectors of bank 2. The firmware
+// sits at the bottom of bank 1, and the banks read while the other writes,
+// so programming and erasing here never stalls the code.
+#define STORE_FLASH_BASE 0x081C0000
+#define STORE_SECTOR_SIZE (128 * 1024)
+#define STORE_SECTOR_COUNT 2
+
+// Value of erased flash
+#define STORE_FLASH_ERASED 0xFF
+
+// Return values
+#define STORE_FLASH_OK 0
+#define STORE_FLASH_ERROR -1
+
+// Set up the flash
+int store_flash_init();
+
+// Read from an offset into a sector
+int store_flash_read(uint8_t sector, uint32_t offset, void *buffer, uint32_t size);
+
+// Program an erased range; bits can only be cleared
+int store_flash_program(uint8_t sector, uint32_t offset, const void *buffer, uint32_t size);
+
+// Erase a whole sector
+int store_flash_erase(uint8_t sector);
+
+// Address an offset into a sector reads at; the flash is memory mapped
+const void *store_flash_map(uint8_t sector, uint32_t offset);
+
+// Microsecond clock for the statistics
+uint32_t store_flash_time_us();
+
+#endif
@@ -0,0 +1,174 @@
+#include "mbed.h"
+#include <atomic>
+#include "store_worker.h"
+
+#define STORE_WAKE_FLAG 1
+
+static Thread worker_thread(STORE_WORKER_PRIORITY, STORE_WORKER_STACK);
+static EventFlags worker_flags;
+static Mutex store_mutex;
+
+// template_store_busy() as of the last change to the queue, set under the
+// store lock so store_worker_busy() can read it without taking it
+static std::atomic<bool> busy(false);
+
+static StoreWorkerStats stats;
+
+/*******************************************************************************
+ * @brief take the store, counting the wait
+ * ****************************************************************************/
+static void lock(){
+    uint32_t start = us_ticker_read();
+    store_mutex.lock();
+    stats.max_wait_us = max(stats.max_wait_us, us_ticker_read() - start);
+}
+
+/*******************************************************************************
+ * @brief step the store until it runs out of work, then sleep until more is
+ *        queued
+ * ****************************************************************************/
+static void worker(){
+    while (1){
+        worker_flags.wait_any(STORE_WAKE_FLAG);
+        stats.wakeups++;
+
+        while (1){
+            uint8_t sector;
+            uint32_t start = us_ticker_read();
+            store_mutex.lock();
+            int step = template_store_step(&sector);
+            busy.store(template_store_busy(), std::memory_order_release);
+            store_mutex.unlock();
+            if (step == STORE_STEP_IDLE){
+                break;
+            }
+            stats.steps++;
+            stats.max_step_us = max(stats.max_step_us, us_ticker_read() - start);
+
+            // Hundreds of ms to seconds: nothing else touches the sector,
+            // so the store stays unlocked
+            if (step == STORE_STEP_ERASE){
+                start = us_ticker_read();
+                bool ok = store_flash_erase(sector) == STORE_FLASH_OK;
+                uint32_t elapsed = us_ticker_read() - start;
+                stats.erases++;
+                stats.max_erase_us = max(stats.max_erase_us, elapsed);
+
+                store_mutex.lock();
+                template_store_erased(sector, ok);
+                busy.store(template_store_busy(), std::memory_order_release);
+                store_mutex.unlock();
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+ * @brief mount the store and start the worker
+ * @return the result of template_store_init()
+ * ****************************************************************************/
+int store_worker_init(){
+    int result = template_store_init();
+    busy.store(template_store_busy(), std::memory_order_release);
+    worker_thread.start(callback(worker));
+    worker_flags.set(STORE_WAKE_FLAG);
+    return result;
+}
+
+/*******************************************************************************
+ * @brief queue a template
+ * @param slot, data, length: as template_store_save()
+ * ****************************************************************************/
+int store_worker_save(uint8_t slot, const void *data, uint32_t length){
+    lock();
+    int result = template_store_save(slot, data, length);
+    busy.store(template_store_busy(), std::memory_order_release);
+    store_mutex.unlock();
+    worker_flags.set(STORE_WAKE_FLAG);
+    return result;
+}
+
+/*******************************************************************************
+ * @brief queue emptying a slot
+ * @param slot: as template_store_erase()
+ * ****************************************************************************/
+int store_worker_erase(uint8_t slot){
+    lock();
+    int result = template_store_erase(slot);
+    busy.store(template_store_busy(), std::memory_order_release);
+    store_mutex.unlock();
+    worker_flags.set(STORE_WAKE_FLAG);
+    return result;
+}
+
+/*******************************************************************************
+ * @brief length of a template
+ * @param slot: as template_store_length()
+ * ****************************************************************************/
+int store_worker_length(uint8_t slot){
+    lock();
+    int result = template_store_length(slot);
+    store_mutex.unlock();
+    return result;
+}
+
+/*******************************************************************************
+ * @brief copy a template out
+ * @param slot, buffer, size: as template_store_read()
+ * ****************************************************************************/
+int store_worker_read(uint8_t slot, void *buffer, uint32_t size){
+    lock();
+    int result = template_store_read(slot, buffer, size);
+    store_mutex.unlock();
+    return result;
+}
+
+/*******************************************************************************
+ * @brief point at a template in flash
+ * @param slot, span: as template_store_map()
+ * ****************************************************************************/
+int store_worker_map(uint8_t slot, StoreSpan *span){
+    lock();
+    int result = template_store_map(slot, span);
+    store_mutex.unlock();
+    return result;
+}
+
+/*******************************************************************************
+ * @brief release a span; the worker may have an erase waiting for it
+ * @param span: as template_store_unmap()
+ * ****************************************************************************/
+void store_worker_unmap(StoreSpan *span){
+    lock();
+    template_store_unmap(span);
+    store_mutex.unlock();
+    worker_flags.set(STORE_WAKE_FLAG);
+}
+
+/*******************************************************************************
+ * @brief check for writes not on flash yet, without taking the store
+ * ****************************************************************************/
+bool store_worker_busy(){
+    return busy.load(std::memory_order_acquire);
+}
+
+/*******************************************************************************
+ * @brief get the counters
+ * @return a copy of the counters
+ * ****************************************************************************/
+StoreWorkerStats store_worker_stats(){
+    return stats;
+}
+
+/*******************************************************************************
+ * @brief print the counters
+ * ****************************************************************************/
+void store_worker_print_stats(){
+    lock();
+    template_store_print_stats();
+    store_mutex.unlock();
+    printf("Store: worker %lu wakeups, %lu steps, longest %lu us, %lu erases, longest %lu us, "
+           "callers waited %lu us at most\n", (unsigned long)stats.wakeups, (unsigned long)stats.steps,
+           (unsigned long)stats.max_step_us, (unsigned long)stats.erases, (unsigned long)stats.max_erase_us,
+           (unsigned long)stats.max_wait_us);
+}
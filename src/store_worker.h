@@ -0,0 +1,53 @@
+#ifndef STORE_WORKER_H
+#define STORE_WORKER_H
+
+#include "mbed.h"
+#include "template_store.h"
+
+// Thread that writes the template store. It runs below every other thread,
+// so programming and erasing only take time nothing else wants, and the
+// store sectors are in bank 2 while the code runs from bank 1, so the
+// erase does not stall instruction fetches. The calls below only copy or
+// queue and return at once; they wait at most one step of the worker,
+// about STORE_CHUNK byte programs. Only a read of a template already on
+// flash, at boot, can stall on an erase, the store sectors sharing a bank.
+#define STORE_WORKER_PRIORITY osPriorityLow
+#define STORE_WORKER_STACK 1024
+
+// Worker counters
+typedef struct
+{
+    uint32_t wakeups;
+    uint32_t steps;
+    uint32_t max_step_us;    // longest step, the store locked meanwhile
+    uint32_t erases;
+    uint32_t max_erase_us;   // longest erase, the store unlocked meanwhile
+    uint32_t max_wait_us;    // longest a caller waited for the store
+} StoreWorkerStats;
+
+// Mount the store and start the worker, which then checks the spare sector
+// is erased
+int store_worker_init();
+
+// template_store_save(), template_store_erase(), template_store_length()
+// and template_store_read() from any thread
+int store_worker_save(uint8_t slot, const void *data, uint32_t length);
+int store_worker_erase(uint8_t slot);
+int store_worker_length(uint8_t slot);
+int store_worker_read(uint8_t slot, void *buffer, uint32_t size);
+
+// template_store_map() and template_store_unmap() from any thread
+int store_worker_map(uint8_t slot, StoreSpan *span);
+void store_worker_unmap(StoreSpan *span);
+
+// True while saves are queued or being written; never waits, safe from the
+// sampling path
+bool store_worker_busy();
+
+// Get the counters
+StoreWorkerStats store_worker_stats();
+
+// Print the counters, the store's included
+void store_worker_print_stats();
+
+#endif
@@ -0,0 +1,314 @@
+#include <math.h>
+#include <string.h>
+#include "template_codec.h"
+
+static_assert(sizeof(TemplateHeader) % 4 == 0, "TEMPLATE_F32 samples must start aligned");
+
+#define INT16_LIMIT 32767
+#define INT8_LIMIT 127
+
+// Widest difference: of two int16, zig-zag coded
+#define WIDTH_LIMIT 17
+
+/*******************************************************************************
+ * @brief map a signed difference to an unsigned one, small either way:
+ *        0, -1, 1, -2... become 0, 1, 2, 3...
+ * ****************************************************************************/
+static inline uint32_t zigzag(int32_t value){
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t value){
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+/*******************************************************************************
+ * @brief bits needed for a value
+ * ****************************************************************************/
+static uint32_t bit_width(uint32_t value){
+    uint32_t width = 0;
+    while (value){
+        width++;
+        value >>= 1;
+    }
+    return width;
+}
+
+/*******************************************************************************
+ * @brief a sample as a sensor integer
+ * @param value: in the unit of the samples
+ * @param scale: value of one sensor step
+ * @param shift: further divide by 2^shift, rounding
+ * ****************************************************************************/
+static int32_t quantize(float value, float scale, uint8_t shift){
+    long q = lrintf(value / scale);
+    if (q > INT16_LIMIT){
+        q = INT16_LIMIT;
+    }
+    if (q < -INT16_LIMIT - 1){
+        q = -INT16_LIMIT - 1;
+    }
+    if (shift){
+        q = (q + (1L << (shift - 1))) >> shift;
+    }
+    return (int32_t)q;
+}
+
+/*******************************************************************************
+ * @brief smallest shift that brings every sample into int8
+ * ****************************************************************************/
+static uint8_t int8_shift(const float (*samples)[3], uint32_t count, float scale){
+    int32_t low = 0;
+    int32_t high = 0;
+    for (uint32_t i = 0; i < count; i++){
+        for (int axis = 0; axis < 3; axis++){
+            int32_t q = quantize(samples[i][axis], scale, 0);
+            low = q < low ? q : low;
+            high = q > high ? q : high;
+        }
+    }
+    uint8_t shift = 0;
+    while (((high + (shift ? 1L << (shift - 1) : 0)) >> shift) > INT8_LIMIT ||
+           ((low + (shift ? 1L << (shift - 1) : 0)) >> shift) < -INT8_LIMIT - 1){
+        shift++;
+    }
+    return shift;
+}
+
+/*******************************************************************************
+ * @brief largest template_encode() output
+ * @param samples: number of samples
+ * ****************************************************************************/
+uint32_t template_encoded_max(uint32_t samples){
+    uint32_t raw = samples * 3 * sizeof(float);
+    // The difference of two int16 takes 17 bits: 3 varint bytes, or 17 bits
+    // and a share of the block's widths when packed
+    uint32_t coded = samples * 3 * 3 + (samples + TEMPLATE_BLOCK - 1) / TEMPLATE_BLOCK * 3;
+    return sizeof(TemplateHeader) + (raw > coded ? raw : coded);
+}
+
+/*******************************************************************************
+ * @brief serialise samples
+ * @param samples: count samples of three axes
+ * @param format: TEMPLATE_F32, TEMPLATE_INT16 or TEMPLATE_INT8, the last two
+ *        or'ed with TEMPLATE_PACKED to bit-pack them
+ * @param scale: value of one sensor step
+ * @param out: template_encoded_max(count) bytes at least
+ * @return bytes written, 0 if out is too small or the format unknown
+ * ****************************************************************************/
+uint32_t template_encode(const float (*samples)[3], uint32_t count, uint8_t format, float scale, uint8_t *out,
+                         uint32_t size){
+    uint8_t kind = format & ~TEMPLATE_PACKED;
+    if (size < template_encoded_max(count) || kind > TEMPLATE_INT8 || (format == (TEMPLATE_F32 | TEMPLATE_PACKED))){
+        return 0;
+    }
+
+    TemplateHeader header = {TEMPLATE_MAGIC, format, 0, count, scale};
+    if (kind == TEMPLATE_INT8){
+        header.shift = int8_shift(samples, count, scale);
+    }
+    memcpy(out, &header, sizeof(header));
+    uint8_t *next = out + sizeof(header);
+
+    if (kind == TEMPLATE_F32){
+        memcpy(next, samples, count * sizeof(samples[0]));
+        return sizeof(header) + count * sizeof(samples[0]);
+    }
+
+    int32_t previous[3] = {0, 0, 0};
+    if (!(format & TEMPLATE_PACKED)){
+        for (uint32_t i = 0; i < count; i++){
+            for (int axis = 0; axis < 3; axis++){
+                int32_t q = quantize(samples[i][axis], scale, header.shift);
+                uint32_t z = zigzag(q - previous[axis]);
+                previous[axis] = q;
+                while (z >= 0x80){
+                    *next++ = (uint8_t)(z | 0x80);
+                    z >>= 7;
+                }
+                *next++ = (uint8_t)z;
+            }
+        }
+        return next - out;
+    }
+
+    // Bit-packed: per block the three widths, then the samples one after the
+    // other, LSB first, the block ending on a byte
+    uint32_t z[TEMPLATE_BLOCK][3];
+    for (uint32_t start = 0; start < count; start += TEMPLATE_BLOCK){
+        uint32_t n = count - start < TEMPLATE_BLOCK ? count - start : TEMPLATE_BLOCK;
+        uint8_t width[3] = {0, 0, 0};
+        for (uint32_t i = 0; i < n; i++){
+            for (int axis = 0; axis < 3; axis++){
+                int32_t q = quantize(samples[start + i][axis], scale, header.shift);
+                z[i][axis] = zigzag(q - previous[axis]);
+                previous[axis] = q;
+                uint32_t w = bit_width(z[i][axis]);
+                width[axis] = w > width[axis] ? w : width[axis];
+            }
+        }
+        *next++ = width[0];
+        *next++ = width[1];
+        *next++ = width[2];
+
+        uint64_t bits = 0;
+        uint32_t bit_count = 0;
+        for (uint32_t i = 0; i < n; i++){
+            for (int axis = 0; axis < 3; axis++){
+                bits |= (uint64_t)z[i][axis] << bit_count;
+                bit_count += width[axis];
+                while (bit_count >= 8){
+                    *next++ = (uint8_t)bits;
+                    bits >>= 8;
+                    bit_count -= 8;
+                }
+            }
+        }
+        if (bit_count){
+            *next++ = (uint8_t)bits;
+        }
+    }
+    return next - out;
+}
+
+/*******************************************************************************
+ * @brief start decoding a template
+ * @param decoder: state to set up
+ * @param data: the template, e.g. mapped in place; must outlive the decoder
+ * @param length: its size in bytes
+ * @return false if it is not a template, or is cut short
+ * ****************************************************************************/
+bool template_decode_init(TemplateDecoder *decoder, const void *data, uint32_t length){
+    TemplateHeader header;
+    if (length < sizeof(header)){
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+    uint8_t kind = header.format & ~TEMPLATE_PACKED;
+    if (header.magic != TEMPLATE_MAGIC || kind > TEMPLATE_INT8 || header.shift > 15 || !(header.scale > 0.0f)){
+        return false;
+    }
+
+    memset(decoder, 0, sizeof(*decoder));
+    decoder->data = (const uint8_t *)data + sizeof(header);
+    decoder->end = (const uint8_t *)data + length;
+    decoder->format = header.format;
+    decoder->step = header.scale * (float)(1 << header.shift);
+    decoder->samples = header.samples;
+    decoder->remaining = header.samples;
+    if (kind == TEMPLATE_F32){
+        if ((header.format & TEMPLATE_PACKED) || length - sizeof(header) != header.samples * 3 * sizeof(float)){
+            return false;
+        }
+        decoder->raw = (const float (*)[3])decoder->data;
+    }
+    return true;
+}
+
+/*******************************************************************************
+ * @brief decode the next samples
+ * @param decoder: from template_decode_init()
+ * @param out: room for max samples
+ * @return samples decoded; 0 at the end, or early if the data runs out
+ * ****************************************************************************/
+uint32_t template_decode(TemplateDecoder *decoder, float (*out)[3], uint32_t max){
+    uint32_t n = decoder->remaining < max ? decoder->remaining : max;
+    const uint8_t *data = decoder->data;
+    const uint8_t *end = decoder->end;
+    const float step = decoder->step;
+    int32_t x = decoder->previous[0];
+    int32_t y = decoder->previous[1];
+    int32_t z = decoder->previous[2];
+    uint32_t done = 0;
+
+    if (decoder->raw){
+        memcpy(out, data, n * sizeof(out[0]));
+        data += n * sizeof(out[0]);
+        done = n;
+    }
+    else if (!(decoder->format & TEMPLATE_PACKED)){
+        for (; done < n; done++){
+            uint32_t value[3];
+            for (int axis = 0; axis < 3; axis++){
+                uint32_t v = 0;
+                uint32_t shift = 0;
+                uint8_t byte;
+                do {
+                    if (data == end || shift > 28){
+                        goto corrupt;
+                    }
+                    byte = *data++;
+                    v |= (uint32_t)(byte & 0x7F) << shift;
+                    shift += 7;
+                } while (byte & 0x80);
+                value[axis] = v;
+            }
+            x += unzigzag(value[0]);
+            y += unzigzag(value[1]);
+            z += unzigzag(value[2]);
+            out[done][0] = (float)x * step;
+            out[done][1] = (float)y * step;
+            out[done][2] = (float)z * step;
+        }
+    }
+    else {
+        uint64_t bits = decoder->bits;
+        uint32_t bit_count = decoder->bit_count;
+        for (; done < n; done++){
+            if (decoder->block_left == 0){
+                // Blocks end on a byte: drop the padding
+                if (end - data < 3){
+                    goto corrupt;
+                }
+                bits = 0;
+                bit_count = 0;
+                decoder->width[0] = data[0];
+                decoder->width[1] = data[1];
+                decoder->width[2] = data[2];
+                data += 3;
+                if (decoder->width[0] > WIDTH_LIMIT || decoder->width[1] > WIDTH_LIMIT ||
+                    decoder->width[2] > WIDTH_LIMIT){
+                    goto corrupt;
+                }
+                decoder->block_left = TEMPLATE_BLOCK;
+            }
+            uint32_t wx = decoder->width[0];
+            uint32_t wy = decoder->width[1];
+            uint32_t wz = decoder->width[2];
+            while (bit_count < wx + wy + wz){
+                if (data == end){
+                    goto corrupt;
+                }
+                bits |= (uint64_t)*data++ << bit_count;
+                bit_count += 8;
+            }
+            x += unzigzag((uint32_t)bits & (uint32_t)((1ULL << wx) - 1));
+            bits >>= wx;
+            y += unzigzag((uint32_t)bits & (uint32_t)((1ULL << wy) - 1));
+            bits >>= wy;
+            z += unzigzag((uint32_t)bits & (uint32_t)((1ULL << wz) - 1));
+            bits >>= wz;
+            bit_count -= wx + wy + wz;
+            decoder->block_left--;
+
+            out[done][0] = (float)x * step;
+            out[done][1] = (float)y * step;
+            out[done][2] = (float)z * step;
+        }
+        decoder->bits = bits;
+        decoder->bit_count = bit_count;
+    }
+
+    decoder->data = data;
+    decoder->previous[0] = x;
+    decoder->previous[1] = y;
+    decoder->previous[2] = z;
+    decoder->remaining -= done;
+    return done;
+
+corrupt:
+    // Keep what decoded; nothing more will
+    decoder->data = end;
+    decoder->remaining = 0;
+    return done;
+}
@@ -0,0 +1,76 @@
+#ifndef TEMPLATE_CODEC_H
+#define TEMPLATE_CODEC_H
+
+#include <stdint.h>
+
+// Serialised gesture templates: a TemplateHeader, then the samples.
+//
+// The gyroscope reports int16 steps of its sensitivity, so the samples are
+// stored as those integers, each axis as the zig-zag coded difference to
+// the sample before. Consecutive samples are close, so the differences are
+// small. They are written either as varints, 7 bits a byte, or bit-packed:
+// blocks of TEMPLATE_BLOCK samples with one bit width per axis, the width
+// of the largest difference in the block.
+//
+//   TEMPLATE_F32     raw floats, 12 bytes a sample, readable in place
+//   TEMPLATE_INT16   the sensor's integers, exact
+//   TEMPLATE_INT8    integers shifted right until they fit in 8 bits, lossy;
+//                    the shift is chosen per template
+//
+// template_decode() streams the samples out a block at a time, so a
+// template is matched without ever being expanded in full. Kept free of
+// mbed for tools/template_codec.
+
+#define TEMPLATE_MAGIC 0x5447 // "GT"
+
+// Formats, TEMPLATE_PACKED may be or'ed into the integer ones
+#define TEMPLATE_F32 0
+#define TEMPLATE_INT16 1
+#define TEMPLATE_INT8 2
+#define TEMPLATE_PACKED 0x80
+
+// Samples per bit-packed block
+#define TEMPLATE_BLOCK 16
+
+typedef struct
+{
+    uint16_t magic;   // TEMPLATE_MAGIC
+    uint8_t format;
+    uint8_t shift;    // TEMPLATE_INT8: the integers were divided by 2^shift
+    uint32_t samples;
+    float scale;      // value of one integer step, the gyroscope sensitivity
+} TemplateHeader;
+// followed by the samples; TEMPLATE_F32 ones start 4-byte aligned
+
+typedef struct
+{
+    const float (*raw)[3]; // TEMPLATE_F32: the samples, in place
+    const uint8_t *data;   // next byte
+    const uint8_t *end;
+    uint8_t format;
+    float step;            // value of one stored integer
+    uint32_t samples;      // in the template
+    uint32_t remaining;    // not decoded yet
+    int32_t previous[3];   // last value of each axis
+    uint8_t width[3];      // bit-packed: of the current block
+    uint32_t block_left;   // samples left in it
+    uint64_t bits;         // bits read ahead
+    uint32_t bit_count;
+} TemplateDecoder;
+
+// Largest template_encode() output for a number of samples
+uint32_t template_encoded_max(uint32_t samples);
+
+// Serialise samples. scale is the value of one sensor step; samples that
+// are not multiples of it are rounded. Returns the bytes written, 0 if
+// they do not fit.
+uint32_t template_encode(const float (*samples)[3], uint32_t count, uint8_t format, float scale, uint8_t *out,
+                         uint32_t size);
+
+// Start decoding; false if the data is not a whole template
+bool template_decode_init(TemplateDecoder *decoder, const void *data, uint32_t length);
+
+// Decode up to max samples; returns how many, 0 at the end
+uint32_t template_decode(TemplateDecoder *decoder, float (*out)[3], uint32_t max);
+
+#endif
@@ -0,0 +1,716 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "template_store.h"
+#include "crc32.h"
+
+// The layout template_store_map() promises
+static_assert(sizeof(StoreSectorHeader) % STORE_ALIGN == 0, "records must start aligned");
+static_assert(sizeof(StoreRecordHeader) % STORE_ALIGN == 0, "payloads must start aligned");
+static_assert(STORE_SECTOR_SIZE % STORE_ALIGN == 0, "sectors must start aligned");
+
+// State of the sector the next compaction copies into
+#define SPARE_UNKNOWN 0  // not looked at since the mount
+#define SPARE_CHECKING 1 // being read back for erased flash
+#define SPARE_DIRTY 2    // needs an erase
+#define SPARE_ERASING 3  // erase handed to the caller
+#define SPARE_READY 4
+#define SPARE_FAILED 5   // the erase failed, no more compactions
+
+// Steps of a queued write
+#define JOB_START 0   // find room, compacting if there is none
+#define JOB_COPY 1    // compaction: copying the live records
+#define JOB_SECTOR 2  // compaction: committing the new sector
+#define JOB_HEADER 3
+#define JOB_PAYLOAD 4
+#define JOB_COMMIT 5
+
+// Where the newest record of a slot is
+typedef struct
+{
+    uint32_t offset;  // of the record header, in the live sector
+    uint32_t length;
+    uint32_t version;
+    uint8_t type;     // 0 if the slot was never written
+} StoreSlot;
+
+// A write waiting for the flash
+typedef struct
+{
+    uint8_t type;     // STORE_RECORD_DATA or STORE_RECORD_DELETE, 0 if none
+    uint8_t slot;
+    uint32_t length;
+    uint8_t *data;    // staging copy of the payload
+} StoreJob;
+
+static StoreSlot slots[STORE_SLOTS];
+static uint8_t live;           // live sector
+static uint32_t append;        // offset of the next record in it
+static uint32_t next_version;
+static TemplateStoreStats stats;
+
+// The write in progress and the one after it; a newer save of the same
+// slot replaces the second
+static uint8_t staging[2][STORE_MAX_LENGTH];
+static StoreJob active = {0, 0, 0, staging[0]};
+static StoreJob queued = {0, 0, 0, staging[1]};
+static uint8_t phase;
+static uint32_t job_offset;    // of the record being written
+static uint32_t job_done;      // bytes of it written, or of the record being copied
+static uint32_t job_version;
+static bool job_waited;        // counted in stats.waits
+
+// Compaction in progress
+static StoreSlot moved[STORE_SLOTS]; // the index once it commits
+static uint8_t copy_slot;            // slot being copied
+static uint32_t copy_to;             // where the next byte goes in the spare
+
+static uint8_t spare;
+static uint8_t spare_state;
+static uint32_t spare_checked; // bytes read back as erased
+static bool spare_counted;     // its pending erase is in the live sector's counts
+
+static uint32_t pins;          // spans not released yet
+
+// Staging for reads: CRC checks, compaction, the erased check
+static uint8_t chunk[STORE_CHUNK];
+
+/*******************************************************************************
+ * @brief round up to the record alignment
+ * ****************************************************************************/
+static uint32_t align(uint32_t size){
+    return (size + STORE_ALIGN - 1) & ~(uint32_t)(STORE_ALIGN - 1);
+}
+
+/*******************************************************************************
+ * @brief flash taken by a record
+ * @param length: payload bytes
+ * ****************************************************************************/
+static uint32_t record_size(uint32_t length){
+    return sizeof(StoreRecordHeader) + align(length) + sizeof(uint32_t);
+}
+
+/*******************************************************************************
+ * @brief smaller of two sizes
+ * ****************************************************************************/
+static uint32_t min_size(uint32_t a, uint32_t b){
+    return a < b ? a : b;
+}
+
+/*******************************************************************************
+ * @brief program and count
+ * ****************************************************************************/
+static int program(uint8_t sector, uint32_t offset, const void *data, uint32_t size){
+    stats.bytes_programmed += size;
+    return store_flash_program(sector, offset, data, size);
+}
+
+/*******************************************************************************
+ * @brief check if a range reads as erased flash
+ * ****************************************************************************/
+static bool is_erased(const void *data, uint32_t size){
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (uint32_t i = 0; i < size; i++){
+        if (bytes[i] != STORE_FLASH_ERASED){
+            return false;
+        }
+    }
+    return true;
+}
+
+/*******************************************************************************
+ * @brief CRC of a range of flash
+ * @param sector, offset, size: range
+ * ****************************************************************************/
+static uint32_t flash_crc(uint8_t sector, uint32_t offset, uint32_t size){
+    uint32_t crc = 0;
+    while (size > 0){
+        uint32_t n = min_size(size, sizeof(chunk));
+        store_flash_read(sector, offset, chunk, n);
+        crc = crc32(crc, chunk, n);
+        offset += n;
+        size -= n;
+    }
+    return crc;
+}
+
+/*******************************************************************************
+ * @brief read a sector header
+ * @param sector: sector of the store
+ * @param header: destination
+ * @return true if the sector holds a store
+ * ****************************************************************************/
+static bool read_sector_header(uint8_t sector, StoreSectorHeader *header){
+    store_flash_read(sector, 0, header, sizeof(*header));
+    return header->magic == STORE_SECTOR_MAGIC && header->crc == crc32(0, header, offsetof(StoreSectorHeader, crc));
+}
+
+/*******************************************************************************
+ * @brief write the header that commits a sector as live, after the records
+ *        it should hold
+ * @param sector: sector of the store
+ * @param sequence: its sequence number
+ * ****************************************************************************/
+static int write_sector_header(uint8_t sector, uint32_t sequence){
+    StoreSectorHeader header;
+    header.magic = STORE_SECTOR_MAGIC;
+    header.sequence = sequence;
+    memcpy(header.erase_count, stats.erase_count, sizeof(header.erase_count));
+    header.crc = crc32(0, &header, offsetof(StoreSectorHeader, crc));
+    return program(sector, 0, &header, sizeof(header));
+}
+
+/*******************************************************************************
+ * @brief walk the records of the live sector and index the newest of each
+ *        slot
+ * ****************************************************************************/
+static void scan(){
+    append = sizeof(StoreSectorHeader);
+    while (append + sizeof(StoreRecordHeader) <= STORE_SECTOR_SIZE){
+        StoreRecordHeader header;
+        store_flash_read(live, append, &header, sizeof(header));
+
+        // The end of the log
+        if (is_erased(&header, sizeof(header))){
+            return;
+        }
+
+        // A header cut short, or damage: what follows cannot be walked, and
+        // the next save compacts the sector
+        if (header.magic != STORE_RECORD_MAGIC || header.crc != crc32(0, &header, offsetof(StoreRecordHeader, crc)) ||
+            header.slot >= STORE_SLOTS || header.length > STORE_MAX_LENGTH ||
+            (header.type != STORE_RECORD_DATA && header.type != STORE_RECORD_DELETE) ||
+            append + record_size(header.length) > STORE_SECTOR_SIZE){
+            stats.corrupt++;
+            append = STORE_SECTOR_SIZE;
+            return;
+        }
+
+        // Its version is taken even if the payload was cut short
+        if (header.version >= next_version){
+            next_version = header.version + 1;
+        }
+
+        uint32_t commit;
+        uint32_t payload = append + sizeof(StoreRecordHeader);
+        store_flash_read(live, payload + align(header.length), &commit, sizeof(commit));
+        if (commit != flash_crc(live, payload, header.length)){
+            stats.torn++;
+        }
+        else{
+            stats.records++;
+            StoreSlot *slot = &slots[header.slot];
+            if (slot->type == 0 || header.version > slot->version){
+                slot->offset = append;
+                slot->length = header.length;
+                slot->version = header.version;
+                slot->type = header.type;
+            }
+        }
+        append += record_size(header.length);
+    }
+}
+
+/*******************************************************************************
+ * @brief start the store over on the first sector
+ * ****************************************************************************/
+static int format(){
+    memset(slots, 0, sizeof(slots));
+    live = 0;
+    append = sizeof(StoreSectorHeader);
+    next_version = 1;
+    stats.sequence = 1;
+    stats.erase_count[live]++;
+    if (store_flash_erase(live) != STORE_FLASH_OK){
+        return STORE_ERROR;
+    }
+    return write_sector_header(live, stats.sequence) == STORE_FLASH_OK ? STORE_OK : STORE_ERROR;
+}
+
+/*******************************************************************************
+ * @brief mount the store
+ * @return STORE_OK, STORE_ERROR if the flash failed
+ * ****************************************************************************/
+int template_store_init(){
+    uint32_t start = store_flash_time_us();
+    memset(slots, 0, sizeof(slots));
+    memset(&stats, 0, sizeof(stats));
+    next_version = 1;
+    active.type = 0;
+    queued.type = 0;
+    pins = 0;
+
+    if (store_flash_init() != STORE_FLASH_OK){
+        return STORE_ERROR;
+    }
+
+    // The live sector has the highest sequence. A compaction cut short left
+    // no valid header on its sector, so the one it copied from still wins.
+    bool found = false;
+    for (uint8_t sector = 0; sector < STORE_SECTOR_COUNT; sector++){
+        StoreSectorHeader header;
+        if (!read_sector_header(sector, &header)){
+            continue;
+        }
+        if (!found || header.sequence > stats.sequence){
+            found = true;
+            live = sector;
+            stats.sequence = header.sequence;
+            memcpy(stats.erase_count, header.erase_count, sizeof(stats.erase_count));
+        }
+    }
+
+    int result = STORE_OK;
+    if (found){
+        scan();
+    }
+    else{
+        result = format();
+    }
+
+    // Whether the spare is erased is found out in the background
+    spare = (live + 1) % STORE_SECTOR_COUNT;
+    spare_state = SPARE_UNKNOWN;
+    spare_counted = false;
+
+    stats.live_sector = live;
+    stats.used = append;
+    stats.mount_us = store_flash_time_us() - start;
+    return result;
+}
+
+/*******************************************************************************
+ * @brief the write of a slot not on flash yet
+ * @param slot: 0 ... STORE_SLOTS - 1
+ * @return the newest queued write of the slot, NULL if none
+ * ****************************************************************************/
+static const StoreJob *pending(uint8_t slot){
+    if (queued.type != 0 && queued.slot == slot){
+        return &queued;
+    }
+    if (active.type != 0 && active.slot == slot){
+        return &active;
+    }
+    return NULL;
+}
+
+/*******************************************************************************
+ * @brief queue a write behind the one in progress
+ * @param slot, type: of the record
+ * @param data, length: payload, copied
+ * ****************************************************************************/
+static int queue_job(uint8_t slot, uint8_t type, const void *data, uint32_t length){
+    if (queued.type != 0){
+        if (queued.slot != slot){
+            return STORE_BUSY;
+        }
+        stats.coalesced++;
+    }
+    if (length > 0){
+        memcpy(queued.data, data, length);
+    }
+    queued.slot = slot;
+    queued.length = length;
+    queued.type = type;
+    return STORE_OK;
+}
+
+/*******************************************************************************
+ * @brief give up the write in progress
+ * ****************************************************************************/
+static void fail_job(){
+    stats.failed++;
+    active.type = 0;
+}
+
+/*******************************************************************************
+ * @brief next step of the write in progress
+ * @return false if it waits for the spare sector
+ * ****************************************************************************/
+static bool job_step(){
+    switch (phase){
+    case JOB_START:{
+        uint32_t size = record_size(active.length);
+        if (append + size <= STORE_SECTOR_SIZE){
+            // Taken before writing: after a failure its bytes are in an
+            // unknown state
+            job_offset = append;
+            job_version = next_version++;
+            append += size;
+            stats.used = append;
+            phase = JOB_HEADER;
+            return true;
+        }
+
+        // Full: the newest record of every slot moves to the spare
+        uint32_t needed = sizeof(StoreSectorHeader) + size;
+        for (uint8_t i = 0; i < STORE_SLOTS; i++){
+            if (slots[i].type == STORE_RECORD_DATA){
+                needed += record_size(slots[i].length);
+            }
+        }
+        if (needed > STORE_SECTOR_SIZE || spare_state == SPARE_FAILED){
+            fail_job();
+            return true;
+        }
+        if (spare_state != SPARE_READY){
+            if (!job_waited){
+                job_waited = true;
+                stats.waits++;
+            }
+            return false;
+        }
+        copy_slot = 0;
+        copy_to = sizeof(StoreSectorHeader);
+        job_done = 0;
+        phase = JOB_COPY;
+        return true;
+    }
+
+    case JOB_COPY:{
+        // Records are copied as they are, the erased padding included, so
+        // their CRCs still hold. Deleted slots are left behind.
+        while (copy_slot < STORE_SLOTS && slots[copy_slot].type != STORE_RECORD_DATA){
+            moved[copy_slot++].type = 0;
+        }
+        if (copy_slot == STORE_SLOTS){
+            phase = JOB_SECTOR;
+            return true;
+        }
+        if (job_done == 0){
+            moved[copy_slot] = slots[copy_slot];
+            moved[copy_slot].offset = copy_to;
+        }
+        uint32_t size = record_size(slots[copy_slot].length);
+        uint32_t n = min_size(size - job_done, sizeof(chunk));
+        store_flash_read(live, slots[copy_slot].offset + job_done, chunk, n);
+        if (program(spare, copy_to, chunk, n) != STORE_FLASH_OK){
+            spare_state = SPARE_DIRTY;
+            fail_job();
+            return true;
+        }
+        copy_to += n;
+        job_done += n;
+        if (job_done == size){
+            copy_slot++;
+            job_done = 0;
+        }
+        return true;
+    }
+
+    case JOB_SECTOR:{
+        // The spare after this one is erased straight after the commit, so
+        // its count goes in now
+        uint8_t next = (spare + 1) % STORE_SECTOR_COUNT;
+        stats.erase_count[next]++;
+
+        // The commit: from here on the spare is live
+        if (write_sector_header(spare, stats.sequence + 1) != STORE_FLASH_OK){
+            stats.erase_count[next]--;
+            spare_state = SPARE_DIRTY;
+            fail_job();
+            return true;
+        }
+        memcpy(slots, moved, sizeof(slots));
+        live = spare;
+        append = copy_to;
+        spare = next;
+        spare_state = SPARE_DIRTY;
+        spare_counted = true;
+        stats.sequence++;
+        stats.compactions++;
+        stats.live_sector = live;
+        stats.used = append;
+        phase = JOB_START;
+        return true;
+    }
+
+    case JOB_HEADER:{
+        StoreRecordHeader header;
+        header.magic = STORE_RECORD_MAGIC;
+        header.type = active.type;
+        header.slot = active.slot;
+        header.version = job_version;
+        header.length = active.length;
+        header.crc = crc32(0, &header, offsetof(StoreRecordHeader, crc));
+        if (program(live, job_offset, &header, sizeof(header)) != STORE_FLASH_OK){
+            fail_job();
+            return true;
+        }
+        job_done = 0;
+        phase = JOB_PAYLOAD;
+        return true;
+    }
+
+    case JOB_PAYLOAD:{
+        uint32_t n = min_size(active.length - job_done, sizeof(chunk));
+        if (n > 0 && program(live, job_offset + sizeof(StoreRecordHeader) + job_done, active.data + job_done, n) !=
+                         STORE_FLASH_OK){
+            fail_job();
+            return true;
+        }
+        job_done += n;
+        if (job_done == active.length){
+            phase = JOB_COMMIT;
+        }
+        return true;
+    }
+
+    case JOB_COMMIT:{
+        // The CRC that commits the header and payload
+        uint32_t commit = crc32(0, active.data, active.length);
+        if (program(live, job_offset + sizeof(StoreRecordHeader) + align(active.length), &commit, sizeof(commit)) !=
+            STORE_FLASH_OK){
+            fail_job();
+            return true;
+        }
+        StoreSlot *slot = &slots[active.slot];
+        slot->offset = job_offset;
+        slot->length = active.length;
+        slot->version = job_version;
+        slot->type = active.type;
+        if (active.type == STORE_RECORD_DATA){
+            stats.saves++;
+            stats.bytes_saved += active.length;
+        }
+        active.type = 0;
+        return true;
+    }
+    }
+    return true;
+}
+
+/*******************************************************************************
+ * @brief next step of getting the spare sector erased
+ * @param sector: set to the sector to erase on STORE_STEP_ERASE
+ * ****************************************************************************/
+static int spare_step(uint8_t *sector){
+    switch (spare_state){
+    case SPARE_UNKNOWN:
+        spare_checked = 0;
+        spare_state = SPARE_CHECKING;
+        // fall through
+    case SPARE_CHECKING:{
+        // Erased already if the last erase finished and nothing since
+        uint32_t n = min_size(STORE_SECTOR_SIZE - spare_checked, sizeof(chunk));
+        store_flash_read(spare, spare_checked, chunk, n);
+        if (!is_erased(chunk, n)){
+            spare_state = SPARE_DIRTY;
+        }
+        else if ((spare_checked += n) == STORE_SECTOR_SIZE){
+            spare_state = SPARE_READY;
+        }
+        return STORE_STEP_MORE;
+    }
+    case SPARE_DIRTY:
+        // Reading a span while the bank erases would stall
+        if (pins > 0){
+            return STORE_STEP_IDLE;
+        }
+        spare_state = SPARE_ERASING;
+        *sector = spare;
+        return STORE_STEP_ERASE;
+    default:
+        return STORE_STEP_IDLE;
+    }
+}
+
+/*******************************************************************************
+ * @brief do the next chunk of work
+ * @param sector: set to the sector to erase on STORE_STEP_ERASE
+ * @return STORE_STEP_IDLE, STORE_STEP_MORE or STORE_STEP_ERASE
+ * ****************************************************************************/
+int template_store_step(uint8_t *sector){
+    stats.steps++;
+    if (active.type == 0 && queued.type != 0){
+        // Swap the staging buffers, the queued one becomes the active one
+        uint8_t *data = active.data;
+        active = queued;
+        queued.type = 0;
+        queued.data = data;
+        phase = JOB_START;
+        job_waited = false;
+    }
+    if (active.type != 0 && job_step()){
+        return STORE_STEP_MORE;
+    }
+    return spare_step(sector);
+}
+
+/*******************************************************************************
+ * @brief the erase asked for by template_store_step() is done
+ * @param sector: the sector
+ * @param ok: false if the flash refused it
+ * ****************************************************************************/
+void template_store_erased(uint8_t sector, bool ok){
+    if (sector != spare || spare_state != SPARE_ERASING){
+        return;
+    }
+    if (!ok){
+        spare_state = SPARE_FAILED;
+        return;
+    }
+    if (!spare_counted){
+        stats.erase_count[sector]++;
+    }
+    spare_counted = false;
+    spare_state = SPARE_READY;
+}
+
+/*******************************************************************************
+ * @brief check for writes not on flash yet
+ * ****************************************************************************/
+bool template_store_busy(){
+    return active.type != 0 || queued.type != 0;
+}
+
+/*******************************************************************************
+ * @brief do all the queued work now
+ * @return STORE_OK, STORE_ERROR if a write failed
+ * ****************************************************************************/
+int template_store_flush(){
+    uint32_t failed = stats.failed;
+    uint8_t sector;
+    int step;
+    while ((step = template_store_step(&sector)) != STORE_STEP_IDLE){
+        if (step == STORE_STEP_ERASE){
+            template_store_erased(sector, store_flash_erase(sector) == STORE_FLASH_OK);
+        }
+    }
+    return stats.failed == failed ? STORE_OK : STORE_ERROR;
+}
+
+/*******************************************************************************
+ * @brief queue a template
+ * @param slot: 0 ... STORE_SLOTS - 1
+ * @param data, length: the template, copied
+ * @return STORE_OK or an error
+ * ****************************************************************************/
+int template_store_save(uint8_t slot, const void *data, uint32_t length){
+    if (slot >= STORE_SLOTS){
+        return STORE_NOT_FOUND;
+    }
+    if (length > STORE_MAX_LENGTH){
+        return STORE_TOO_BIG;
+    }
+    return queue_job(slot, STORE_RECORD_DATA, data, length);
+}
+
+/*******************************************************************************
+ * @brief length of a template
+ * @param slot: 0 ... STORE_SLOTS - 1
+ * @return bytes, or STORE_NOT_FOUND
+ * ****************************************************************************/
+int template_store_length(uint8_t slot){
+    if (slot >= STORE_SLOTS){
+        return STORE_NOT_FOUND;
+    }
+    const StoreJob *job = pending(slot);
+    if (job){
+        return job->type == STORE_RECORD_DATA ? (int)job->length : STORE_NOT_FOUND;
+    }
+    return slots[slot].type == STORE_RECORD_DATA ? (int)slots[slot].length : STORE_NOT_FOUND;
+}
+
+/*******************************************************************************
+ * @brief copy a template out
+ * @param slot: 0 ... STORE_SLOTS - 1
+ * @param buffer, size: destination
+ * @return bytes copied, STORE_NOT_FOUND or STORE_TOO_BIG
+ * ****************************************************************************/
+int template_store_read(uint8_t slot, void *buffer, uint32_t size){
+    int length = template_store_length(slot);
+    if (length < 0){
+        return length;
+    }
+    if ((uint32_t)length > size){
+        return STORE_TOO_BIG;
+    }
+    const StoreJob *job = pending(slot);
+    if (job){
+        memcpy(buffer, job->data, length);
+    }
+    else{
+        store_flash_read(live, slots[slot].offset + sizeof(StoreRecordHeader), buffer, length);
+    }
+    return length;
+}
+
+/*******************************************************************************
+ * @brief point at a template in flash
+ * @param slot: 0 ... STORE_SLOTS - 1
+ * @param span: destination, valid until template_store_unmap()
+ * @return STORE_OK, STORE_NOT_FOUND or STORE_BUSY
+ * ****************************************************************************/
+int template_store_map(uint8_t slot, StoreSpan *span){
+    if (slot >= STORE_SLOTS){
+        return STORE_NOT_FOUND;
+    }
+    if (pending(slot) || spare_state == SPARE_ERASING){
+        return STORE_BUSY;
+    }
+    if (slots[slot].type != STORE_RECORD_DATA){
+        return STORE_NOT_FOUND;
+    }
+    span->data = (const uint8_t *)store_flash_map(live, slots[slot].offset + sizeof(StoreRecordHeader));
+    span->length = slots[slot].length;
+    pins++;
+    stats.maps++;
+    stats.bytes_mapped += span->length;
+    return STORE_OK;
+}
+
+/*******************************************************************************
+ * @brief release a span
+ * @param span: from template_store_map(), cleared
+ * ****************************************************************************/
+void template_store_unmap(StoreSpan *span){
+    if (span->data && pins > 0){
+        pins--;
+    }
+    span->data = NULL;
+    span->length = 0;
+}
+
+/*******************************************************************************
+ * @brief queue emptying a slot
+ * @param slot: 0 ... STORE_SLOTS - 1
+ * @return STORE_OK or an error
+ * ****************************************************************************/
+int template_store_erase(uint8_t slot){
+    if (slot >= STORE_SLOTS){
+        return STORE_NOT_FOUND;
+    }
+    if (template_store_length(slot) == STORE_NOT_FOUND){
+        return STORE_OK;
+    }
+    return queue_job(slot, STORE_RECORD_DELETE, NULL, 0);
+}
+
+/*******************************************************************************
+ * @brief get the counters
+ * @return a copy of the counters
+ * ****************************************************************************/
+TemplateStoreStats template_store_stats(){
+    return stats;
+}
+
+/*******************************************************************************
+ * @brief print the counters
+ * ****************************************************************************/
+void template_store_print_stats(){
+    printf("Store: sector %u live, sequence %lu, %lu of %lu bytes used\n", stats.live_sector,
+           (unsigned long)stats.sequence, (unsigned long)stats.used, (unsigned long)STORE_SECTOR_SIZE);
+    printf("Store: mounted in %lu us, %lu records, %lu torn, %lu corrupt\n", (unsigned long)stats.mount_us,
+           (unsigned long)stats.records, (unsigned long)stats.torn, (unsigned long)stats.corrupt);
+    printf("Store: %lu saves, %lu coalesced, %lu failed, %lu bytes saved, %lu programmed in %lu steps\n",
+           (unsigned long)stats.saves, (unsigned long)stats.coalesced, (unsigned long)stats.failed,
+           (unsigned long)stats.bytes_saved, (unsigned long)stats.bytes_programmed, (unsigned long)stats.steps);
+    printf("Store: %lu maps, %lu bytes read in place\n", (unsigned long)stats.maps, (unsigned long)stats.bytes_mapped);
+    printf("Store: %lu compactions, %lu waited for an erase, erases", (unsigned long)stats.compactions,
+           (unsigned long)stats.waits);
+    for (uint8_t sector = 0; sector < STORE_SECTOR_COUNT; sector++){
+        printf(" %lu", (unsigned long)stats.erase_count[sector]);
+    }
+    printf("\n");
+}
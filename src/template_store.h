@@ -0,0 +1,166 @@
+#ifndef TEMPLATE_STORE_H
+#define TEMPLATE_STORE_H
+
+#include <stdint.h>
+#include "store_flash.h"
+
+// Gesture templates kept in flash as an append-only log.
+//
+// The store owns STORE_SECTOR_COUNT sectors. One of them is live: it starts
+// with a sector header and holds records one after the other. Saving a slot
+// appends a record with a higher version; the newest complete record of a
+// slot wins. When the live sector is full, the newest record of every slot
+// is copied into the next sector, which then becomes live. The sectors are
+// used in turn, so they wear evenly.
+//
+// Every write ends with a commit word, so a write cut by a reset is found
+// and ignored at the next mount:
+//   - a record counts once its payload CRC, written last, matches;
+//   - a compaction counts once the new sector header, written after the
+//     copied records, is valid. Until then the old sector stays live.
+//
+// Writes never block the caller. template_store_save() copies the template
+// and queues it; template_store_step() then does the flash work a chunk at
+// a time, for a low-priority thread to call (src/store_worker.cpp). The
+// sector a compaction will copy into is erased ahead of time, right after
+// the compaction before, so a save only waits on an erase when saves come
+// faster than the erases.
+//
+// Templates can also be read in place: template_store_map() returns a
+// read-only span into the memory-mapped flash. The payload is contiguous
+// and starts on a STORE_ALIGN boundary, and the span stays valid until
+// template_store_unmap(). Meanwhile no erase starts, since the store
+// sectors share a bank and a read during an erase stalls the CPU for its
+// whole length.
+//
+// Kept free of mbed and of locks so tools/flash_sim runs the same code on a
+// simulated flash; callers on several threads serialise the calls.
+
+// Templates the store holds, addressed by slot
+#define STORE_SLOTS 4
+
+// Largest payload of a record
+#define STORE_MAX_LENGTH 4096
+
+// Records, and so payloads, start on this boundary; enough for the
+// floats, int16 and int32 templates are made of
+#define STORE_ALIGN 4
+
+// Most bytes one template_store_step() reads or programs
+#ifndef STORE_CHUNK
+#define STORE_CHUNK 256
+#endif
+
+#define STORE_SECTOR_MAGIC 0x52545354 // "TSTR"
+#define STORE_RECORD_MAGIC 0x5254     // "TR"
+
+// Record types
+#define STORE_RECORD_DATA 1   // a template
+#define STORE_RECORD_DELETE 2 // the slot was erased
+
+// Return values
+#define STORE_OK 0
+#define STORE_ERROR -1     // flash failed
+#define STORE_NOT_FOUND -2 // the slot is empty
+#define STORE_TOO_BIG -3   // larger than the buffer, or than a sector can hold
+#define STORE_BUSY -4      // a save of another slot is already queued, or
+                           // the flash cannot be read in place right now
+
+// template_store_step() results
+#define STORE_STEP_IDLE 0  // nothing left to do
+#define STORE_STEP_MORE 1  // call again
+#define STORE_STEP_ERASE 2 // erase the sector, then call template_store_erased()
+
+typedef struct
+{
+    uint32_t magic;       // STORE_SECTOR_MAGIC
+    uint32_t sequence;    // higher on each compaction, the highest is live
+    uint32_t erase_count[STORE_SECTOR_COUNT]; // of every sector, the pending erase of the old one included
+    uint32_t crc;         // of the fields above
+} StoreSectorHeader;
+
+typedef struct
+{
+    uint16_t magic;   // STORE_RECORD_MAGIC, erased flash ends the log
+    uint8_t type;     // STORE_RECORD_DATA or STORE_RECORD_DELETE
+    uint8_t slot;
+    uint32_t version; // higher on each save, over all slots
+    uint32_t length;  // payload bytes
+    uint32_t crc;     // of the fields above
+} StoreRecordHeader;
+// followed by the payload, padded to STORE_ALIGN, and its CRC
+
+// A template read in place
+typedef struct
+{
+    const uint8_t *data; // memory-mapped flash, STORE_ALIGN aligned
+    uint32_t length;
+} StoreSpan;
+
+typedef struct
+{
+    uint32_t mount_us;         // last template_store_init(), scan included
+    uint32_t records;          // found by the last mount
+    uint32_t torn;             // writes found cut short, ignored
+    uint32_t corrupt;          // headers that did not check, the rest of the sector skipped
+    uint32_t saves;
+    uint32_t coalesced;        // queued saves replaced by a newer one before being written
+    uint32_t failed;           // saves the flash refused
+    uint32_t compactions;
+    uint32_t waits;            // compactions that had to wait for the erase of their sector
+    uint32_t steps;
+    uint32_t bytes_saved;      // payload handed to template_store_save()
+    uint32_t bytes_programmed; // everything written, compaction and headers included
+    uint32_t maps;
+    uint32_t bytes_mapped;     // read in place, never copied to RAM
+    uint32_t erase_count[STORE_SECTOR_COUNT];
+    uint8_t live_sector;
+    uint32_t sequence;         // of the live sector
+    uint32_t used;             // bytes of the live sector written
+} TemplateStoreStats;
+
+// Mount the store: find the live sector and rebuild the index, formatting
+// the flash if it holds no store. Only reads, except when formatting.
+int template_store_init();
+
+// Queue a template for a slot, replacing the one there. The data is copied.
+int template_store_save(uint8_t slot, const void *data, uint32_t length);
+
+// Length of the template in a slot, STORE_NOT_FOUND if empty. Queued
+// saves and erases are seen at once.
+int template_store_length(uint8_t slot);
+
+// Copy the template of a slot; returns its length or an error
+int template_store_read(uint8_t slot, void *buffer, uint32_t size);
+
+// Point a span at the template of a slot in flash. STORE_BUSY while a write
+// of the slot is queued, so the span would be stale, or an erase runs.
+int template_store_map(uint8_t slot, StoreSpan *span);
+
+// Release a span; erases wait until every span is released
+void template_store_unmap(StoreSpan *span);
+
+// Queue emptying a slot
+int template_store_erase(uint8_t slot);
+
+// Do the next chunk of the queued writes, or of preparing the spare sector.
+// On STORE_STEP_ERASE, *sector needs erasing; no other store call touches
+// it meanwhile, so the erase may run without the caller's lock.
+int template_store_step(uint8_t *sector);
+
+// Report the erase asked for by template_store_step()
+void template_store_erased(uint8_t sector, bool ok);
+
+// True while saves are queued or being written
+bool template_store_busy();
+
+// Step until idle, erasing in line
+int template_store_flush();
+
+// Get the counters
+TemplateStoreStats template_store_stats();
+
+// Print the counters
+void template_store_print_stats();
+
+#endif
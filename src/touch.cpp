@@ -0,0 +1,377 @@
+#include "mbed.h"
+#include "touch.h"
+#include "ui.h"
+#include "settings.h"
+#include "ramfunc.h"
+
+#define TOUCH_IRQ_FLAG 1
+#define TOUCH_CAL_FLAG 2
+
+static_assert(sizeof(TouchCal) <= SETTINGS_VALUE_MAX, "the calibration must fit its settings slot");
+
+// A sample mapped to pixels, with the raw values it came from
+typedef struct
+{
+    uint16_t x, y;
+    uint16_t raw_x, raw_y;
+} TouchPoint;
+
+TS_DISCO_F429ZI ts; // Touch screen object
+
+static InterruptIn touch_int(TOUCH_INT_PIN, PullUp);
+static Thread touch_thread(osPriorityAboveNormal, 1536);
+static EventFlags touch_flags;
+static Mail<TouchEvent, TOUCH_QUEUE_SIZE> touch_events;
+
+// First interrupt edge the touch thread has not picked up yet
+static volatile uint32_t irq_us;
+static volatile bool irq_pending = false;
+
+static TouchCal cal;          // touch thread only
+static TouchFilter filter;    // touch thread only
+static TouchAverage average;  // touch thread only, of the current touch
+static TouchCal pending_cal;  // handed over by touch_set_calibration()
+
+static TouchStats stats;
+static uint32_t start_transfers;
+static uint32_t release_transfers;
+static uint32_t release_us;
+
+/*******************************************************************************
+ * @brief STMPE811 interrupt: note the time and wake the touch thread
+ * ****************************************************************************/
+RAMFUNC static void touch_irq(){
+    if (!irq_pending){
+        irq_us = us_ticker_read();
+        irq_pending = true;
+    }
+    stats.interrupts++;
+    touch_flags.set(TOUCH_IRQ_FLAG);
+}
+
+/*******************************************************************************
+ * @brief queue an event for the UI
+ * @param kind: TOUCH_PRESS, TOUCH_RELEASE or TOUCH_MOVE
+ * @param point: position
+ * @param irq_time: interrupt the event comes from
+ * ****************************************************************************/
+static void post_event(uint8_t kind, const TouchPoint &point, uint32_t irq_time){
+    TouchEvent *event = touch_events.try_alloc();
+    if (event == nullptr){
+        stats.dropped++;
+        return;
+    }
+    event->kind = kind;
+    event->x = point.x;
+    event->y = point.y;
+    event->raw_x = point.raw_x;
+    event->raw_y = point.raw_y;
+    event->mean_x = point.raw_x;
+    event->mean_y = point.raw_y;
+    if (kind == TOUCH_RELEASE){
+        touch_average_get(&average, &event->mean_x, &event->mean_y);
+    }
+    event->irq_us = irq_time;
+    touch_events.put(event);
+    stats.events++;
+}
+
+/*******************************************************************************
+ * @brief filter a raw FIFO sample and map it to pixels
+ * @param sample: raw sample
+ * @return the filtered sample and its position
+ * ****************************************************************************/
+static TouchPoint map_sample(const TS_StateTypeDef &sample){
+    TouchPoint point;
+    point.raw_x = sample.X;
+    point.raw_y = sample.Y;
+    touch_average_add(&average, sample.X, sample.Y);
+    touch_filter_apply(&filter, &point.raw_x, &point.raw_y);
+    touch_cal_apply(&cal, point.raw_x, point.raw_y, lcd.GetXSize(), lcd.GetYSize(), &point.x, &point.y);
+#if TOUCH_TRACE
+    printf("r %u %u %u %u\n", sample.X, sample.Y, point.x, point.y);
+#endif
+    return point;
+}
+
+/*******************************************************************************
+ * @brief read the calibration stored in the EEPROM
+ * @param stored: destination
+ * @return false if there is none or it is damaged
+ * ****************************************************************************/
+static bool load_calibration(TouchCal *stored){
+    return settings_get(SETTINGS_TOUCH_CAL, stored, sizeof(*stored)) == sizeof(*stored);
+}
+
+/*******************************************************************************
+ * @brief print the matrix and filter as trace lines
+ * ****************************************************************************/
+static void trace_calibration(){
+#if TOUCH_TRACE
+    printf("m %ld %ld %ld %ld %ld %ld\n", (long)cal.a, (long)cal.b, (long)cal.c, (long)cal.d, (long)cal.e, (long)cal.f);
+    printf("f %u\n", filter.shift);
+#endif
+}
+
+/*******************************************************************************
+ * @brief touch thread: sleeps until the STMPE811 interrupts, then drains its
+ *        FIFO in one burst and turns the samples into press, move and
+ *        release events
+ *
+ * The controller keeps its interrupt line low while any status bit is set,
+ * so the thread goes round again until the line is released; a new touch
+ * arriving before the clear would otherwise never produce another edge.
+ *
+ * Every sample goes through the jitter filter, so the filter sees the
+ * panel's full sample rate even though only burst ends are reported.
+ * ****************************************************************************/
+static void touch_loop(){
+    TS_StateTypeDef samples[TS_FIFO_BURST];
+    TouchPoint last = {};
+    TouchPoint reported = {}; // last position sent to the UI
+    bool pressed = false;
+    bool armed = false;      // touch interrupt seen, waiting for its first point
+    uint32_t down_us = 0;
+
+    trace_calibration();
+
+    while (1){
+        uint32_t woken = touch_flags.wait_any(TOUCH_IRQ_FLAG | TOUCH_CAL_FLAG);
+        if (woken & TOUCH_CAL_FLAG){
+            {
+                CriticalSectionLock lock;
+                cal = pending_cal;
+            }
+            trace_calibration();
+        }
+        if (!(woken & TOUCH_IRQ_FLAG)){
+            continue;
+        }
+
+        do{
+            // The EEPROM writer may be in a write cycle, at most one page
+            settings_lock_bus();
+            uint32_t edge_us;
+            {
+                CriticalSectionLock lock;
+                edge_us = irq_us;
+                irq_pending = false;
+            }
+            if (!pressed && !armed){
+                down_us = edge_us;
+                armed = true;
+            }
+
+            uint8_t status = ts.ITGetStatus();
+            if (status & STMPE811_GIT_FOV){
+                stats.overflows++;
+            }
+
+            uint8_t count = ts.ReadFIFO(samples, TS_FIFO_BURST);
+            if (count > 0){
+                stats.points += count;
+                stats.bursts++;
+                uint8_t first = 0;
+                if (!pressed){
+#if TOUCH_TRACE
+                    printf("t\n");
+#endif
+                    touch_filter_reset(&filter);
+                    touch_average_reset(&average);
+                    reported = map_sample(samples[0]);
+                    post_event(TOUCH_PRESS, reported, down_us);
+                    pressed = true;
+                    armed = false;
+                    last = reported;
+                    first = 1;
+                }
+                for (uint8_t i = first; i < count; i++){
+                    last = map_sample(samples[i]);
+                }
+                if (abs(last.x - reported.x) + abs(last.y - reported.y) >= TOUCH_MOVE_MIN_PX){
+                    post_event(TOUCH_MOVE, last, edge_us);
+                    reported = last;
+                }
+            }
+
+            // The touch interrupt fires both on touch and on release
+            if ((status & STMPE811_GIT_TOUCH) && !ts.IsTouched()){
+                if (pressed){
+                    post_event(TOUCH_RELEASE, last, edge_us);
+                    pressed = false;
+                    release_us = us_ticker_read();
+                    release_transfers = IOE_GetTransfers();
+                }
+                armed = false; // a tap too short to be sampled
+            }
+
+            ts.ITClear();
+            settings_unlock_bus();
+        } while (touch_int.read() == 0);
+    }
+}
+
+/*******************************************************************************
+ * @brief set up the touch interrupts and start the touch thread
+ * @return false if the controller does not answer
+ * ****************************************************************************/
+bool touch_init(){
+    settings_lock_bus();
+    bool ok = ts.Init(lcd.GetXSize(), lcd.GetYSize()) == TS_OK;
+    settings_unlock_bus();
+    if (!ok){
+        return false;
+    }
+    start_transfers = IOE_GetTransfers();
+    release_transfers = start_transfers;
+    release_us = us_ticker_read();
+
+    // No EEPROM fitted, or nothing valid in it, leaves the old fixed mapping
+    stats.calibrated = load_calibration(&cal);
+    if (!stats.calibrated){
+        touch_cal_default(&cal);
+    }
+    touch_filter_init(&filter, TOUCH_FILTER_SHIFT);
+
+    // Hook the EXTI line before BSP_TS_ITConfig() enables it in the NVIC
+    touch_int.fall(callback(touch_irq));
+    settings_lock_bus();
+    ts.ITConfig();
+    settings_unlock_bus();
+
+    touch_thread.start(callback(touch_loop));
+
+    // The line may already be low from before the edge was armed
+    touch_flags.set(TOUCH_IRQ_FLAG);
+    return true;
+}
+
+/*******************************************************************************
+ * @brief hand a matrix to the touch thread
+ * @param matrix: matrix to apply
+ * @param save: also store it in the EEPROM, written back in the background
+ * ****************************************************************************/
+void touch_set_calibration(const TouchCal *matrix, bool save){
+    {
+        CriticalSectionLock lock;
+        pending_cal = *matrix;
+    }
+    if (save && !settings_set(SETTINGS_TOUCH_CAL, matrix, sizeof(*matrix))){
+        printf("Touch: calibration not saved\n");
+    }
+    stats.calibrated = true;
+    touch_flags.set(TOUCH_CAL_FLAG);
+}
+
+/*******************************************************************************
+ * @brief measure one touch on a target
+ * @param point: target, its raw_x and raw_y are filled in
+ * @return false if nobody touched within TOUCH_CAL_TIMEOUT_MS
+ *
+ * The press only carries the first sample, taken as the finger lands, and
+ * a steady finger sends no moves; the release carries the mean of every
+ * raw sample of the touch after the first TOUCH_SETTLE_SAMPLES.
+ * ****************************************************************************/
+static bool measure_target(TouchCalPoint *point){
+    TouchEvent event;
+    bool pressed = false;
+
+    ui_show_target(point->x, point->y);
+    while (1){
+        if (!touch_get(&event, pressed ? TOUCH_WAIT_FOREVER : TOUCH_CAL_TIMEOUT_MS)){
+            return false;
+        }
+        if (event.kind == TOUCH_PRESS){
+            pressed = true;
+        }
+        // Not the end of a touch begun before the target showed
+        else if (event.kind == TOUCH_RELEASE && pressed){
+            break;
+        }
+    }
+    point->raw_x = event.mean_x;
+    point->raw_y = event.mean_y;
+#if TOUCH_TRACE
+    printf("c %d %d %u %u\n", point->x, point->y, point->raw_x, point->raw_y);
+#endif
+    return true;
+}
+
+/*******************************************************************************
+ * @brief run the 3-point calibration
+ * @return false if it was given up, the old matrix stays then
+ * ****************************************************************************/
+bool touch_calibrate(){
+    int width = lcd.GetXSize(), height = lcd.GetYSize();
+    // Spread over the screen and not in a line, so the solve is well conditioned
+    TouchCalPoint points[3] = {
+        {TOUCH_CAL_MARGIN, TOUCH_CAL_MARGIN, 0, 0},
+        {(int16_t)(width - TOUCH_CAL_MARGIN), (int16_t)(height / 2), 0, 0},
+        {(int16_t)(width / 2), (int16_t)(height - TOUCH_CAL_MARGIN), 0, 0},
+    };
+
+    bool ok = true;
+    for (int i = 0; ok && i < 3; i++){
+        ok = measure_target(&points[i]);
+    }
+    ui_show_target(-1, -1);
+
+    TouchCal solved;
+    if (!ok || !touch_cal_solve(points, &solved)){
+        ui_show_status("Calibration failed");
+        return false;
+    }
+    touch_set_calibration(&solved, true);
+    ui_show_status("Touch calibrated");
+    return true;
+}
+
+/*******************************************************************************
+ * @brief wait for the next touch event
+ * @param event: destination
+ * @param timeout_ms: longest wait, TOUCH_WAIT_FOREVER for none
+ * @return false if nothing came in time
+ * ****************************************************************************/
+bool touch_get(TouchEvent *event, uint32_t timeout_ms){
+    TouchEvent *queued = touch_events.try_get_for(Kernel::Clock::duration_u32(timeout_ms));
+    if (queued == nullptr){
+        return false;
+    }
+    *event = *queued;
+    touch_events.free(queued);
+
+    uint32_t latency = us_ticker_read() - event->irq_us;
+    stats.total_latency_us += latency;
+    stats.max_latency_us = max(stats.max_latency_us, latency);
+    stats.delivered++;
+    return true;
+}
+
+/*******************************************************************************
+ * @brief get the touch counters
+ * @return a copy of the counters
+ * ****************************************************************************/
+TouchStats touch_stats(){
+    TouchStats s = stats;
+    uint32_t transfers = IOE_GetTransfers();
+    s.transfers = transfers - start_transfers;
+    s.idle_transfers = transfers - release_transfers;
+    s.idle_us = us_ticker_read() - release_us;
+    return s;
+}
+
+/*******************************************************************************
+ * @brief print the touch counters
+ * ****************************************************************************/
+void touch_print_stats(){
+    TouchStats s = touch_stats();
+    uint32_t idle_ms = s.idle_us / 1000;
+    printf("Touch: %lu interrupts, %lu points in %lu bursts, %lu events, %lu dropped, %lu FIFO overflows\n",
+           (unsigned long)s.interrupts, (unsigned long)s.points, (unsigned long)s.bursts,
+           (unsigned long)s.events, (unsigned long)s.dropped, (unsigned long)s.overflows);
+    printf("Touch: %lu I2C transactions, %lu in the last %lu ms idle (%lu/s), latency avg %lu us max %lu us\n",
+           (unsigned long)s.transfers, (unsigned long)s.idle_transfers, (unsigned long)idle_ms,
+           (unsigned long)(idle_ms ? s.idle_transfers * 1000 / idle_ms : 0),
+           (unsigned long)(s.delivered ? s.total_latency_us / s.delivered : 0), (unsigned long)s.max_latency_us);
+    printf("Touch: %s matrix, filter 1/%u\n", s.calibrated ? "calibrated" : "default", 1u << TOUCH_FILTER_SHIFT);
+}
@@ -0,0 +1,88 @@
+#ifndef TOUCH_H
+#define TOUCH_H
+
+#include "mbed.h"
+#include "drivers/TS_DISCO_F429ZI.h"
+#include "touch_cal.h"
+
+// STMPE811 interrupt line, active low
+#define TOUCH_INT_PIN PA_15
+
+// Events buffered between the touch thread and the UI
+#define TOUCH_QUEUE_SIZE 8
+
+// Event kinds
+#define TOUCH_PRESS 1   // finger down, at its first sampled point
+#define TOUCH_RELEASE 2 // finger up, at its last sampled point
+#define TOUCH_MOVE 3    // finger moved, at the last point of a FIFO burst
+
+// Smaller moves are jitter and not reported
+#define TOUCH_MOVE_MIN_PX 3
+
+// touch_get() timeout that never expires
+#define TOUCH_WAIT_FOREVER 0xFFFFFFFF
+
+// Calibration targets, inset from the corners, in pixels
+#define TOUCH_CAL_MARGIN 30
+
+// A calibration target not touched within this is given up
+#define TOUCH_CAL_TIMEOUT_MS 10000
+
+// Set to 1 to print every event and raw sample as trace lines for tools/touch_replay
+#ifndef TOUCH_TRACE
+#define TOUCH_TRACE 0
+#endif
+
+typedef struct
+{
+    uint8_t kind;
+    uint16_t x;
+    uint16_t y;
+    uint16_t raw_x;  // filtered panel values the position was mapped from
+    uint16_t raw_y;
+    uint16_t mean_x; // release: the touch's raw samples averaged once
+    uint16_t mean_y; // settled, touch_average_get()
+    uint32_t irq_us; // STMPE811 interrupt that started the touch or release
+} TouchEvent;
+
+// Touch counters
+typedef struct
+{
+    uint32_t interrupts;    // STMPE811 interrupt edges
+    uint32_t points;        // samples taken from the FIFO
+    uint32_t bursts;        // FIFO reads that returned points
+    uint32_t events;        // events queued
+    uint32_t dropped;       // events lost to a full queue
+    uint32_t overflows;     // FIFO overflowed before it was read
+    uint32_t transfers;     // I2C transactions with the STMPE811 since touch_init()
+    uint32_t idle_transfers; // of those, since the last release
+    uint32_t idle_us;       // time since the last release
+    uint32_t total_latency_us; // interrupt to event taken by the UI
+    uint32_t max_latency_us;
+    uint32_t delivered;     // events taken by the UI
+    bool calibrated;        // matrix from the EEPROM or a calibration, not the default
+} TouchStats;
+
+// Enable the FIFO threshold and touch interrupts and start the touch thread.
+// Returns false if the controller does not answer.
+bool touch_init();
+
+// Wait for the next event, at most timeout_ms. Returns false on timeout.
+bool touch_get(TouchEvent *event, uint32_t timeout_ms = TOUCH_WAIT_FOREVER);
+
+// Run the 3-point calibration: show a target at three places, map the
+// touches onto them, then apply and store the matrix. Takes the events
+// touch_get() would return while it runs. Returns false if a target timed
+// out or the touches were unusable; the old matrix is kept then.
+bool touch_calibrate();
+
+// Apply a matrix from the next FIFO burst on, and store it if save is set
+void touch_set_calibration(const TouchCal *cal, bool save);
+
+// Get the counters
+TouchStats touch_stats();
+
+// Print the counters
+void touch_print_stats();
+
+#endif
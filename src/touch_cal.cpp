@@ -0,0 +1,167 @@
+#include "touch_cal.h"
+
+/*******************************************************************************
+ * @brief divide, rounding to the nearest
+ * @param n: numerator
+ * @param d: denominator, not 0
+ * ****************************************************************************/
+static int64_t div_round(int64_t n, int64_t d){
+    if (d < 0){
+        n = -n;
+        d = -d;
+    }
+    return (n >= 0 ? n + d / 2 : n - d / 2) / d;
+}
+
+/*******************************************************************************
+ * @brief matrix equivalent to the BSP's old fixed correction
+ * @param cal: destination
+ *
+ * Exact over the panel for the raw values the old code handled without
+ * wrapping, except its second X offset past raw 3000.
+ * ****************************************************************************/
+void touch_cal_default(TouchCal *cal){
+    cal->a = -4369;          // -65536 / 15
+    cal->b = 0;
+    cal->c = 258 << 16;      // 3870 / 15
+    cal->d = 0;
+    cal->e = 5958;           // 65536 / 11
+    cal->f = -360 * 5958;
+}
+
+/*******************************************************************************
+ * @brief solve the affine matrix from three touches
+ * @param points: targets and the raw values measured on them
+ * @param cal: destination, untouched on failure
+ * @return false if the points are too close to a line
+ * ****************************************************************************/
+bool touch_cal_solve(const TouchCalPoint points[3], TouchCal *cal){
+    int64_t x0 = points[0].raw_x - points[2].raw_x, y0 = points[0].raw_y - points[2].raw_y;
+    int64_t x1 = points[1].raw_x - points[2].raw_x, y1 = points[1].raw_y - points[2].raw_y;
+    int64_t det = x0 * y1 - x1 * y0;
+    if (det > -TOUCH_CAL_MIN_DET && det < TOUCH_CAL_MIN_DET){
+        return false;
+    }
+
+    // Cramer's rule on the differences to point 2, scaled to Q16
+    int64_t sx0 = points[0].x - points[2].x, sx1 = points[1].x - points[2].x;
+    int64_t sy0 = points[0].y - points[2].y, sy1 = points[1].y - points[2].y;
+    TouchCal m;
+    m.a = div_round((sx0 * y1 - sx1 * y0) << TOUCH_CAL_SHIFT, det);
+    m.b = div_round((x0 * sx1 - x1 * sx0) << TOUCH_CAL_SHIFT, det);
+    m.d = div_round((sy0 * y1 - sy1 * y0) << TOUCH_CAL_SHIFT, det);
+    m.e = div_round((x0 * sy1 - x1 * sy0) << TOUCH_CAL_SHIFT, det);
+
+    // Offsets fitted to all three points, plus a half for the final shift
+    // to round instead of truncate
+    int64_t c = 0, f = 0;
+    for (int i = 0; i < 3; i++){
+        c += ((int64_t)points[i].x << TOUCH_CAL_SHIFT) - (int64_t)m.a * points[i].raw_x - (int64_t)m.b * points[i].raw_y;
+        f += ((int64_t)points[i].y << TOUCH_CAL_SHIFT) - (int64_t)m.d * points[i].raw_x - (int64_t)m.e * points[i].raw_y;
+    }
+    m.c = div_round(c, 3) + (1 << (TOUCH_CAL_SHIFT - 1));
+    m.f = div_round(f, 3) + (1 << (TOUCH_CAL_SHIFT - 1));
+
+    *cal = m;
+    return true;
+}
+
+/*******************************************************************************
+ * @brief map a raw sample to pixels
+ * @param cal: matrix
+ * @param raw_x, raw_y: 12-bit panel values
+ * @param width, height: screen size to clamp to
+ * @param x, y: destination
+ * ****************************************************************************/
+void touch_cal_apply(const TouchCal *cal, uint16_t raw_x, uint16_t raw_y, uint16_t width, uint16_t height,
+                     uint16_t *x, uint16_t *y){
+    int32_t px = ((int64_t)cal->a * raw_x + (int64_t)cal->b * raw_y + cal->c) >> TOUCH_CAL_SHIFT;
+    int32_t py = ((int64_t)cal->d * raw_x + (int64_t)cal->e * raw_y + cal->f) >> TOUCH_CAL_SHIFT;
+    *x = px < 0 ? 0 : px >= width ? width - 1 : px;
+    *y = py < 0 ? 0 : py >= height ? height - 1 : py;
+}
+
+/*******************************************************************************
+ * @brief set up a jitter filter
+ * @param filter: filter
+ * @param shift: strength, 0 for none
+ * ****************************************************************************/
+void touch_filter_init(TouchFilter *filter, uint8_t shift){
+    filter->shift = shift;
+    filter->primed = false;
+}
+
+/*******************************************************************************
+ * @brief start a new touch
+ * @param filter: filter
+ * ****************************************************************************/
+void touch_filter_reset(TouchFilter *filter){
+    filter->primed = false;
+}
+
+/*******************************************************************************
+ * @brief one-pole low-pass on a raw sample
+ * @param filter: filter
+ * @param raw_x, raw_y: sample, replaced by the filtered point
+ * ****************************************************************************/
+void touch_filter_apply(TouchFilter *filter, uint16_t *raw_x, uint16_t *raw_y){
+    int32_t x = (int32_t)*raw_x << TOUCH_FILTER_FRAC;
+    int32_t y = (int32_t)*raw_y << TOUCH_FILTER_FRAC;
+    if (!filter->primed){
+        filter->x = x;
+        filter->y = y;
+        filter->primed = true;
+    }
+    else{
+        filter->x += (x - filter->x) >> filter->shift;
+        filter->y += (y - filter->y) >> filter->shift;
+    }
+    *raw_x = (filter->x + (1 << (TOUCH_FILTER_FRAC - 1))) >> TOUCH_FILTER_FRAC;
+    *raw_y = (filter->y + (1 << (TOUCH_FILTER_FRAC - 1))) >> TOUCH_FILTER_FRAC;
+}
+
+/*******************************************************************************
+ * @brief start averaging a new touch
+ * @param average: average
+ * ****************************************************************************/
+void touch_average_reset(TouchAverage *average){
+    average->sum_x = 0;
+    average->sum_y = 0;
+    average->count = 0;
+}
+
+/*******************************************************************************
+ * @brief add a raw sample of the touch
+ * @param average: average
+ * @param raw_x, raw_y: 12-bit panel values, unfiltered
+ * ****************************************************************************/
+void touch_average_add(TouchAverage *average, uint16_t raw_x, uint16_t raw_y){
+    if (average->count >= TOUCH_SETTLE_SAMPLES){
+        average->sum_x += raw_x;
+        average->sum_y += raw_y;
+    }
+    average->count++;
+    average->last_x = raw_x;
+    average->last_y = raw_y;
+}
+
+/*******************************************************************************
+ * @brief the settled position of the touch
+ * @param average: average
+ * @param raw_x, raw_y: destination, rounded to the nearest
+ * @return false if the touch had no samples
+ * ****************************************************************************/
+bool touch_average_get(const TouchAverage *average, uint16_t *raw_x, uint16_t *raw_y){
+    if (average->count == 0){
+        return false;
+    }
+    if (average->count <= TOUCH_SETTLE_SAMPLES){
+        *raw_x = average->last_x;
+        *raw_y = average->last_y;
+        return true;
+    }
+    uint32_t n = average->count - TOUCH_SETTLE_SAMPLES;
+    *raw_x = (average->sum_x + n / 2) / n;
+    *raw_y = (average->sum_y + n / 2) / n;
+    return true;
+}
@@ -0,0 +1,89 @@
+#ifndef TOUCH_CAL_H
+#define TOUCH_CAL_H
+
+#include <stdint.h>
+
+// Raw STMPE811 samples are mapped to pixels by an affine matrix in Q16,
+//
+//     x = (a * raw_x + b * raw_y + c) >> 16
+//     y = (d * raw_x + e * raw_y + f) >> 16
+//
+// solved from three touches on known targets. Kept free of mbed so the host
+// tools run the same arithmetic as the board.
+#define TOUCH_CAL_SHIFT 16
+
+// Calibration targets closer together than this, in raw units squared,
+// give a matrix too sensitive to noise to keep
+#define TOUCH_CAL_MIN_DET 40000
+
+// Jitter filter: each sample moves the filtered point 1 / 2^shift of the way
+// towards it; 0 passes samples through
+#ifndef TOUCH_FILTER_SHIFT
+#define TOUCH_FILTER_SHIFT 2
+#endif
+
+// Fractional bits the filter keeps
+#define TOUCH_FILTER_FRAC 4
+
+// Samples at the start of a touch left out of its average: the finger is
+// still landing and they are off
+#define TOUCH_SETTLE_SAMPLES 4
+
+typedef struct
+{
+    int32_t a, b, c; // screen x
+    int32_t d, e, f; // screen y
+} TouchCal;
+
+typedef struct
+{
+    int16_t x, y;         // target, in pixels
+    uint16_t raw_x, raw_y; // where the panel reported it
+} TouchCalPoint;
+
+typedef struct
+{
+    int32_t x, y; // in raw units, TOUCH_FILTER_FRAC fractional bits
+    uint8_t shift;
+    bool primed;  // holds a sample of the current touch
+} TouchFilter;
+
+typedef struct
+{
+    uint32_t sum_x, sum_y; // of the samples after the first TOUCH_SETTLE_SAMPLES
+    uint32_t count;        // samples of the touch
+    uint16_t last_x, last_y;
+} TouchAverage;
+
+// Matrix of the fixed correction the BSP used to apply:
+// x = (3870 - raw_x) / 15, y = (raw_y - 360) / 11
+void touch_cal_default(TouchCal *cal);
+
+// Solve the matrix mapping three raw points onto their targets.
+// Returns false if the points are (nearly) collinear.
+bool touch_cal_solve(const TouchCalPoint points[3], TouchCal *cal);
+
+// Map a raw sample to pixels, clamped to width x height
+void touch_cal_apply(const TouchCal *cal, uint16_t raw_x, uint16_t raw_y, uint16_t width, uint16_t height,
+                     uint16_t *x, uint16_t *y);
+
+// Set the filter strength and forget the current touch
+void touch_filter_init(TouchFilter *filter, uint8_t shift);
+
+// Start a new touch: its first sample passes through unfiltered
+void touch_filter_reset(TouchFilter *filter);
+
+// Filter a raw sample in place
+void touch_filter_apply(TouchFilter *filter, uint16_t *raw_x, uint16_t *raw_y);
+
+// Start averaging a new touch
+void touch_average_reset(TouchAverage *average);
+
+// Add a raw sample of the touch
+void touch_average_add(TouchAverage *average, uint16_t raw_x, uint16_t raw_y);
+
+// Mean of the samples after the first TOUCH_SETTLE_SAMPLES, or the last
+// sample if the touch was no longer. Returns false if it had none.
+bool touch_average_get(const TouchAverage *average, uint16_t *raw_x, uint16_t *raw_y);
+
+#endif
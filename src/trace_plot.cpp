@@ -0,0 +1,219 @@
+#include "mbed.h"
+#include <atomic>
+#include "trace_plot.h"
+#include "ui.h"
+#include "render.h"
+#include "ccm_map.h"
+
+#define PLOT_BG_COLOR LCD_COLOR_BLACK
+#define PLOT_AXIS_COLOR LCD_COLOR_DARKGRAY
+
+static const uint32_t axis_colors[3] = {LCD_COLOR_RED, LCD_COLOR_GREEN, LCD_COLOR_CYAN}; // x, y, z
+
+// Single producer (acquisition loop), single consumer (render thread) ring,
+// in CCM: both sides copy samples with the CPU
+typedef array<float, 3> PlotRing[TRACE_PLOT_RING_SIZE];
+CCM_OVERLAY(PlotRing, ring, CCM_PLOT_RING_ADDR, CCM_PLOT_RING_SIZE);
+static std::atomic<uint32_t> ring_head(0); // written by the producer
+static std::atomic<uint32_t> ring_tail(0); // written by the consumer
+static std::atomic<bool> running(false);
+static std::atomic<bool> restart(false); // clear the area before the next frame
+static std::atomic<uint32_t> start_head(0); // ring_head when the run started
+
+static Timer frame_timer;
+
+static TracePlotStats stats;
+static int prev_row[3]; // last plotted row of each axis
+
+/*******************************************************************************
+ * @brief map a rate to a plot row
+ * @param dps: rate in degrees per second
+ * @return the row, 0 at the top
+ * ****************************************************************************/
+static int rate_to_row(float dps){
+    int half = TRACE_PLOT_HEIGHT / 2;
+    int row = half - (int)(dps * half / TRACE_PLOT_RANGE_DPS);
+    if (row < 0){
+        row = 0;
+    }
+    else if (row >= TRACE_PLOT_HEIGHT){
+        row = TRACE_PLOT_HEIGHT - 1;
+    }
+    return row;
+}
+
+/*******************************************************************************
+ * @brief fill one plot column with the background and the zero line
+ * @param column: pointer to the top pixel of the column
+ * @param stride: frame buffer line length in pixels
+ * ****************************************************************************/
+static void clear_column(uint32_t *column, uint32_t stride){
+    for (int row = 0; row < TRACE_PLOT_HEIGHT; row++){
+        column[row * stride] = (row == TRACE_PLOT_HEIGHT / 2) ? PLOT_AXIS_COLOR : PLOT_BG_COLOR;
+    }
+}
+
+/*******************************************************************************
+ * @brief draw the columns of one sample, connecting it to the previous one
+ * @param column: pointer to the top pixel of the first column
+ * @param stride: frame buffer line length in pixels
+ * @param sample: calibrated rates in dps
+ * ****************************************************************************/
+static void draw_sample(uint32_t *column, uint32_t stride, const array<float, 3> &sample){
+    for (int i = 0; i < TRACE_PLOT_PX_PER_SAMPLE; i++){
+        clear_column(column + i, stride);
+    }
+
+    for (int axis = 0; axis < 3; axis++){
+        int row = rate_to_row(sample[axis]);
+
+        // vertical segment in the first column joins the previous sample
+        int top = min(row, prev_row[axis]);
+        int bottom = max(row, prev_row[axis]);
+        for (int r = top; r <= bottom; r++){
+            column[r * stride] = axis_colors[axis];
+        }
+        for (int i = 1; i < TRACE_PLOT_PX_PER_SAMPLE; i++){
+            column[row * stride + i] = axis_colors[axis];
+        }
+        prev_row[axis] = row;
+    }
+}
+
+/*******************************************************************************
+ * @brief clear the plot area and restart the trace at the zero line
+ * ****************************************************************************/
+static void clear_plot(){
+    uint32_t stride = lcd.GetXSize();
+    uint32_t *area = (uint32_t *)lcd.GetLayerAddress(UI_BACKGROUND_LAYER) + TRACE_PLOT_Y * stride + TRACE_PLOT_X;
+    for (int x = 0; x < TRACE_PLOT_WIDTH; x++){
+        clear_column(area + x, stride);
+    }
+    for (int axis = 0; axis < 3; axis++){
+        prev_row[axis] = TRACE_PLOT_HEIGHT / 2;
+    }
+}
+
+/*******************************************************************************
+ * @brief plot all queued samples: one DMA2D scroll, then only the new columns
+ * @return true if anything was drawn
+ * ****************************************************************************/
+bool trace_plot_frame(){
+    bool cleared = restart.exchange(false);
+    if (cleared){
+        // Drop what was left from the last run, but not what was pushed
+        // since trace_plot_start(), e.g. the pre-roll
+        clear_plot();
+        ring_tail.store(start_head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    uint32_t tail = ring_tail.load(std::memory_order_relaxed);
+    uint32_t head = ring_head.load(std::memory_order_acquire);
+    uint32_t count = head - tail;
+    if (count == 0){
+        return cleared;
+    }
+
+    uint32_t start = frame_timer.elapsed_time().count();
+
+    // more samples than fit on screen only need the newest ones
+    uint32_t max_count = TRACE_PLOT_WIDTH / TRACE_PLOT_PX_PER_SAMPLE;
+    if (count > max_count){
+        tail += count - max_count;
+        count = max_count;
+    }
+
+    uint32_t stride = lcd.GetXSize();
+    uint32_t *area = (uint32_t *)lcd.GetLayerAddress(UI_BACKGROUND_LAYER) + TRACE_PLOT_Y * stride + TRACE_PLOT_X;
+    uint32_t *column = area + TRACE_PLOT_WIDTH - count * TRACE_PLOT_PX_PER_SAMPLE;
+
+    lcd.ScrollLeft(UI_BACKGROUND_LAYER, TRACE_PLOT_X, TRACE_PLOT_Y, TRACE_PLOT_WIDTH, TRACE_PLOT_HEIGHT,
+                   count * TRACE_PLOT_PX_PER_SAMPLE);
+
+    for (; tail != head; tail++, column += TRACE_PLOT_PX_PER_SAMPLE){
+        draw_sample(column, stride, ring[tail & (TRACE_PLOT_RING_SIZE - 1)]);
+    }
+    ring_tail.store(tail, std::memory_order_release);
+
+    uint32_t elapsed = frame_timer.elapsed_time().count() - start;
+    stats.frames++;
+    stats.samples += count;
+    stats.total_us += elapsed;
+    stats.max_us = max(stats.max_us, elapsed);
+    return true;
+}
+
+/*******************************************************************************
+ * @brief start the frame timer
+ * ****************************************************************************/
+void trace_plot_init(){
+#if TRACE_PLOT_ENABLED
+    frame_timer.start();
+#endif
+}
+
+/*******************************************************************************
+ * @brief start plotting; the render thread clears the area first and plots
+ *        every sample pushed from here on
+ * ****************************************************************************/
+void trace_plot_start(){
+#if TRACE_PLOT_ENABLED
+    memset(&stats, 0, sizeof(stats));
+    start_head.store(ring_head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    restart.store(true);
+    running.store(true);
+    render_wake();
+#endif
+}
+
+/*******************************************************************************
+ * @brief check whether the render thread should draw plot frames
+ * @return true between trace_plot_start() and trace_plot_stop()
+ * ****************************************************************************/
+bool trace_plot_active(){
+    return running.load();
+}
+
+/*******************************************************************************
+ * @brief stop plotting and print the frame cost
+ * ****************************************************************************/
+void trace_plot_stop(){
+#if TRACE_PLOT_ENABLED
+    running.store(false);
+
+    printf("Trace plot: %lu frames, %lu samples, %lu dropped, avg %lu us, max %lu us per frame (budget %lu us)\n",
+           (unsigned long)stats.frames, (unsigned long)stats.samples, (unsigned long)stats.dropped,
+           (unsigned long)(stats.frames ? stats.total_us / stats.frames : 0), (unsigned long)stats.max_us,
+           (unsigned long)chrono::duration_cast<chrono::microseconds>(TRACE_PLOT_FRAME_PERIOD).count());
+#endif
+}
+
+/*******************************************************************************
+ * @brief queue one sample for the plot
+ * @param x: x rate in dps
+ * @param y: y rate in dps
+ * @param z: z rate in dps
+ * ****************************************************************************/
+void trace_plot_push(float x, float y, float z){
+#if TRACE_PLOT_ENABLED
+    if (!running.load(std::memory_order_relaxed)){
+        return;
+    }
+
+    uint32_t head = ring_head.load(std::memory_order_relaxed);
+    if (head - ring_tail.load(std::memory_order_acquire) >= TRACE_PLOT_RING_SIZE){
+        stats.dropped++; // never wait for the plot
+        return;
+    }
+    ring[head & (TRACE_PLOT_RING_SIZE - 1)] = {x, y, z};
+    ring_head.store(head + 1, std::memory_order_release);
+#endif
+}
+
+/*******************************************************************************
+ * @brief get the frame cost counters
+ * @return the counters
+ * ****************************************************************************/
+TracePlotStats trace_plot_stats(){
+    return stats;
+}
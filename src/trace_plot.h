@@ -0,0 +1,57 @@
+#ifndef TRACE_PLOT_H
+#define TRACE_PLOT_H
+
+#include "mbed.h"
+
+// Set to 0 to build without the live gesture plot
+#ifndef TRACE_PLOT_ENABLED
+#define TRACE_PLOT_ENABLED 1
+#endif
+
+// Plot area in the background layer, between the two buttons
+#define TRACE_PLOT_X 0
+#define TRACE_PLOT_Y 136
+#define TRACE_PLOT_WIDTH 240
+#define TRACE_PLOT_HEIGHT 40
+
+#define TRACE_PLOT_PX_PER_SAMPLE 2 // scroll distance per sample
+#define TRACE_PLOT_RANGE_DPS 250.0f // rate shown at the top and bottom edge
+#define TRACE_PLOT_FRAME_PERIOD 16ms // ~60 fps
+
+// Samples buffered between the acquisition loop and the render thread, power of 2
+#define TRACE_PLOT_RING_SIZE 64
+
+// Per-frame CPU cost of the plot frames
+typedef struct
+{
+    uint32_t frames;       // frames that drew at least one sample
+    uint32_t samples;      // samples plotted
+    uint32_t dropped;      // samples lost to a full ring
+    uint32_t total_us;     // CPU time of all frames
+    uint32_t max_us;       // worst frame
+} TracePlotStats;
+
+// Start the frame timer
+void trace_plot_init();
+
+// Clear the plot area and start plotting the samples pushed from here on
+void trace_plot_start();
+
+// True while a plot is running; the render thread then calls
+// trace_plot_frame() every TRACE_PLOT_FRAME_PERIOD
+bool trace_plot_active();
+
+// Draw the samples queued since the last frame; render thread only.
+// Returns true if anything was drawn.
+bool trace_plot_frame();
+
+// Stop plotting and print the frame cost; the last trace stays on screen
+void trace_plot_stop();
+
+// Queue one calibrated sample in dps; never blocks, safe from the acquisition loop
+void trace_plot_push(float x, float y, float z);
+
+// Get the frame cost counters of the current or last run
+TracePlotStats trace_plot_stats();
+
+#endif
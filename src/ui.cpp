@@ -0,0 +1,173 @@
+#include "mbed.h"
+#include "ui.h"
+#include "sprite_cache.h"
+#include "font_atlas.h"
+#include "render.h"
+#include "image_decoder.h"
+#include "boot.h"
+
+/*******************************************************************************
+ * @brief put the static screen into the selected layer, from the BootScreen
+ *        image when it is built in
+ * ****************************************************************************/
+static void restore_background(){
+#if UI_BOOT_IMAGE
+    if (!image_draw(0, 0, &BootScreen)){
+        ui_draw_background();
+    }
+#else
+    ui_draw_background();
+#endif
+}
+
+/*******************************************************************************
+ * @brief draw the static screen and set up the status overlay
+ *
+ * The title and the two buttons never change, so they are rendered once into
+ * the background layer, normally by decoding the prerendered BootScreen. The
+ * status line lives in the foreground layer, whose LTDC window is shrunk to
+ * the status strip; pixels of UI_KEY_COLOR in it are keyed out and the LTDC
+ * composites both layers in hardware.
+ * ****************************************************************************/
+void ui_init(){
+    sprite_cache_init(SDRAM_SPRITE_CACHE_SIZE);
+    font_cache_init();
+
+    lcd.SelectLayer(UI_BACKGROUND_LAYER);
+    restore_background();
+    boot_stage("first frame");
+
+    // The status layer is still hidden, so the benchmark can scribble on it
+    lcd.SelectLayer(UI_STATUS_LAYER);
+    font_benchmark();
+
+    // Only the status strip is fetched from the foreground layer, its
+    // frame buffer becomes a GetXSize() x FONT_SIZE image
+    lcd.SetLayerWindow(UI_STATUS_LAYER, 0, text_y, lcd.GetXSize(), FONT_SIZE);
+    lcd.SetColorKeying(UI_STATUS_LAYER, UI_KEY_COLOR);
+
+    // Every later draw goes to the status layer
+    lcd.SetBackColor(LCD_COLOR_BLUE);
+    lcd.SetTextColor(UI_KEY_COLOR);
+    lcd.FillRect(0, 0, lcd.GetXSize(), FONT_SIZE);
+    lcd.SetLayerVisible(UI_STATUS_LAYER, ENABLE);
+}
+
+/*******************************************************************************
+ * @brief draw the title and the buttons into the selected layer
+ * ****************************************************************************/
+void ui_draw_background(){
+    lcd.Clear(UI_BACKGROUND_COLOR);
+
+    // Draw 2 touch screen buttons
+    draw_rounded_button(button_x_1, button_y_1, button1_width, button1_height, button1_label);
+    draw_rounded_button(button_x_2, button_y_2, button2_width, button2_height, button2_label);
+
+    // Display the welcome message
+    int title_width = font_text_width(&UI_FONT, title);
+    font_draw_text(title_x + (lcd.GetXSize() - 2 * title_x - title_width) / 2, title_y, title, &UI_FONT,
+                   LCD_COLOR_WHITE, LCD_COLOR_BLUE);
+}
+
+/*******************************************************************************
+ * @brief queue a status message; drawn by the render thread
+ * @param text: message to display
+ * @param bg_color: strip color, UI_KEY_COLOR lets the background show through
+ * ****************************************************************************/
+void ui_show_status(const char *text, uint32_t bg_color){
+    render_post_status(text, bg_color);
+}
+
+/*******************************************************************************
+ * @brief queue a calibration target; drawn by the render thread
+ * @param x, y: target center, x < 0 to restore the screen
+ * ****************************************************************************/
+void ui_show_target(int x, int y){
+    render_post_target(x, y);
+}
+
+/*******************************************************************************
+ * @brief draw a crosshair on an empty background, or restore the screen;
+ *        render thread only
+ * @param x, y: target center, x < 0 to restore the screen
+ * ****************************************************************************/
+void ui_draw_target(int x, int y){
+    lcd.SelectLayer(UI_BACKGROUND_LAYER);
+    if (x < 0){
+        restore_background();
+    }
+    else{
+        // Nothing else on screen, so no button is mistaken for a target
+        lcd.Clear(UI_BACKGROUND_COLOR);
+        lcd.SetTextColor(LCD_COLOR_WHITE);
+        lcd.DrawHLine(x - UI_TARGET_SIZE, y, 2 * UI_TARGET_SIZE + 1);
+        lcd.DrawVLine(x, y - UI_TARGET_SIZE, 2 * UI_TARGET_SIZE + 1);
+        lcd.DrawCircle(x, y, UI_TARGET_SIZE / 2);
+    }
+    lcd.SelectLayer(UI_STATUS_LAYER);
+}
+
+/*******************************************************************************
+ * @brief draw a status message into the status layer; render thread only
+ * @param text: message to display
+ * @param bg_color: strip color, UI_KEY_COLOR lets the background show through
+ * ****************************************************************************/
+void ui_draw_status(const char *text, uint32_t bg_color){
+    // messages come from a small fixed set, so after the first time
+    // each one is a single DMA2D copy out of the sprite cache
+    const Sprite *sprite = sprite_text_strip(lcd.GetXSize(), FONT_SIZE, text_x, text, &UI_FONT,
+                                             bg_color, LCD_COLOR_WHITE, lcd.GetBackColor());
+    if (sprite != NULL){
+        lcd.DrawImage(0, 0, sprite->width, sprite->height, sprite->pixels);
+        return;
+    }
+
+    lcd.SetTextColor(bg_color);                          // bg
+    lcd.FillRect(0, 0, lcd.GetXSize(), FONT_SIZE);       // clear
+    int text_width = font_text_width(&UI_FONT, text);
+    font_draw_text(text_x + max((int)lcd.GetXSize() - 2 * text_x - text_width, 0) / 2, (FONT_SIZE - UI_FONT.height) / 2,
+                   text, &UI_FONT, LCD_COLOR_WHITE, lcd.GetBackColor());
+}
+
+/*******************************************************************************
+ * @brief draw button with rounded corneers
+ * @param x: x coordinate of the button
+ * @param y: y coordinate of the button
+ * @param width: width of the button
+ * @param height: height of the button
+ * @param label: label of the button
+ * ****************************************************************************/
+void draw_rounded_button(int x, int y, int width, int height, const char *label) {
+    int radius = 10;  // Radius for the rounded corners
+
+    // Rasterized once into the sprite cache, then blitted with one DMA2D copy
+    const Sprite *sprite = sprite_button(width, height, radius, lcd.GetTextColor(), UI_BACKGROUND_COLOR,
+                                         label, &UI_FONT, LCD_COLOR_WHITE, LCD_COLOR_BLUE, UI_BUTTON_ANTIALIAS);
+    if (sprite != NULL){
+        lcd.DrawImage(x, y, sprite->width, sprite->height, sprite->pixels);
+        lcd.SetBackColor(LCD_COLOR_BLUE);
+        lcd.SetTextColor(LCD_COLOR_WHITE);
+        return;
+    }
+
+    // Draw the main rectangular body (excluding corners)
+    lcd.FillRect(x + radius, y, width - 2 * radius, height);
+
+    // Draw circles at each corner for rounded edges
+    lcd.FillCircle(x + radius, y + radius, radius);                     // Top-left
+    lcd.FillCircle(x + width - radius, y + radius, radius);             // Top-right
+    lcd.FillCircle(x + radius, y + height - radius, radius);            // Bottom-left
+    lcd.FillCircle(x + width - radius, y + height - radius, radius);    // Bottom-right
+
+    int text_width = font_text_width(&UI_FONT, label);  // Width of the label
+
+    int text_x_position = x + (width - text_width) / 2; // Center horizontally
+    int text_y_position = y + (height - UI_FONT.height) / 2; // Center vertically
+
+    // Set background and text color
+    lcd.SetBackColor(LCD_COLOR_BLUE);  // Background color for text
+    lcd.SetTextColor(LCD_COLOR_WHITE); // Text color
+
+    // Display the label
+    font_draw_text(text_x_position, text_y_position, label, &UI_FONT, LCD_COLOR_WHITE, LCD_COLOR_BLUE);
+}
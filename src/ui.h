@@ -0,0 +1,65 @@
+#ifndef UI_H
+#define UI_H
+
+#include "mbed.h"
+#include "drivers/LCD_DISCO_F429ZI.h"
+#include "packed_font.h"
+#include "ui_layout.h"
+
+// LTDC layers
+#define UI_BACKGROUND_LAYER LCD_BACKGROUND_LAYER // title and buttons, drawn once
+#define UI_STATUS_LAYER LCD_FOREGROUND_LAYER     // status line, windowed over the background
+
+// Status layer pixels of this color are keyed out by the LTDC,
+// so the background layer shows through without any CPU blending
+#define UI_KEY_COLOR LCD_COLOR_MAGENTA
+
+// Background color of the screen and of the status line
+#define UI_BACKGROUND_COLOR LCD_COLOR_MAGENTA
+
+// Half the width of the calibration crosshair
+#define UI_TARGET_SIZE 10
+
+// Blend the rounded button corners into the background
+#define UI_BUTTON_ANTIALIAS true
+
+// Restore the static screen from the prerendered BootScreen image instead of
+// drawing it. Run `make -C tools/lcd_emu boot` after changing anything it shows
+#ifndef UI_BOOT_IMAGE
+#define UI_BOOT_IMAGE 1
+#endif
+
+// Proportional font of all UI text, generated from Font16 by tools/font_pack.py
+#define UI_FONT Font16P
+
+//LCD font size
+#define FONT_SIZE 22
+
+extern LCD_DISCO_F429ZI lcd;
+
+// Draw the static screen into the background layer and set up the status layer
+void ui_init();
+
+// Draw the title and buttons into the selected layer from primitives; this
+// is what tools/lcd_emu renders into the BootScreen image
+void ui_draw_background();
+
+// Show a status message; queued for the render thread, never blocks
+void ui_show_status(const char *text, uint32_t bg_color = UI_KEY_COLOR);
+
+// Draw a status message; only the status layer window is redrawn.
+// Render thread only, everything else calls ui_show_status()
+void ui_draw_status(const char *text, uint32_t bg_color);
+
+// Show a calibration target centered on x, y, or with x < 0 put the screen
+// back; queued for the render thread like ui_show_status()
+void ui_show_target(int x, int y);
+
+// Draw a calibration target on a cleared background layer, or restore the
+// static screen; render thread only
+void ui_draw_target(int x, int y);
+
+// Draw a button with rounded corners into the selected layer
+void draw_rounded_button(int x, int y, int width, int height, const char *label);
+
+#endif
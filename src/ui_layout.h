@@ -0,0 +1,23 @@
+#ifndef UI_LAYOUT_H
+#define UI_LAYOUT_H
+
+// Screen layout, kept free of mbed and driver headers so host tools can
+// share it with the firmware
+
+const int button_x_1 = 60; //record button x axis
+const int button_y_1 = 80; // record button y axis
+const int button1_width = 120; // record button block width
+const int button1_height = 50; // record button block height
+const char *const button1_label = "RECORD"; //main button label
+const int button_x_2 = 60; // unlock button x axis
+const int button_y_2 = 180; // unlock button y axis
+const int button2_width = 120; // unlock button width
+const int button2_height = 50; // ublock button height
+const char *const button2_label = "UNLOCK"; // main button label
+const int title_x = 5; // main title margin
+const int title_y = 30;  // main title y axis
+const char *const title = "PASSWORD UNLOCKER"; // main title
+const int text_x = 5; // status line margin
+const int text_y = 270; // status line y axis
+
+#endif
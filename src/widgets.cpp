@@ -0,0 +1,196 @@
+#include <string.h>
+#include "widgets.h"
+
+// Touch states
+#define STATE_IDLE 0
+#define STATE_PRESSED 1 // down on a widget
+#define STATE_LONG 2    // long press fired, waiting for the release
+#define STATE_OFF 3     // down outside any widget or slid off one
+
+// Hit-test table: bit i of rows[y] is set when widget i spans row y, bit i
+// of cols[x] when it spans column x. A point is on widget i exactly when
+// bit i is set in both, so rows[y] & cols[x] is every widget under it.
+static uint8_t rows[WIDGET_SCREEN_HEIGHT];
+static uint8_t cols[WIDGET_SCREEN_WIDTH];
+
+static WidgetHandler handlers[WIDGET_MAX];
+static void *contexts[WIDGET_MAX];
+static uint8_t widget_count = 0;
+
+static uint8_t state = STATE_IDLE;
+static uint8_t active = WIDGET_NONE;
+static uint32_t down_ms;
+
+static bool release_pending = false;
+static uint32_t release_ms;
+static int release_x, release_y;
+
+/*******************************************************************************
+ * @brief call a widget's handler
+ * @param widget: widget id
+ * @param action: WIDGET_DOWN ... WIDGET_CANCEL
+ * ****************************************************************************/
+static void dispatch(uint8_t widget, uint8_t action){
+    handlers[widget](widget, action, contexts[widget]);
+}
+
+/*******************************************************************************
+ * @brief add a widget to the hit-test table
+ * @param x, y, width, height: rectangle in screen pixels, clipped to the screen
+ * @param handler: called with every action on the widget
+ * @param context: passed to the handler
+ * @return widget id, WIDGET_NONE if WIDGET_MAX are registered
+ * ****************************************************************************/
+uint8_t widget_add(int x, int y, int width, int height, WidgetHandler handler, void *context){
+    if (widget_count == WIDGET_MAX){
+        return WIDGET_NONE;
+    }
+    uint8_t id = widget_count++;
+    handlers[id] = handler;
+    contexts[id] = context;
+
+    for (int row = y < 0 ? 0 : y; row < y + height && row < WIDGET_SCREEN_HEIGHT; row++){
+        rows[row] |= 1 << id;
+    }
+    for (int col = x < 0 ? 0 : x; col < x + width && col < WIDGET_SCREEN_WIDTH; col++){
+        cols[col] |= 1 << id;
+    }
+    return id;
+}
+
+/*******************************************************************************
+ * @brief remove all widgets and forget any touch in progress
+ * ****************************************************************************/
+void widget_clear(){
+    memset(rows, 0, sizeof(rows));
+    memset(cols, 0, sizeof(cols));
+    widget_count = 0;
+    state = STATE_IDLE;
+    active = WIDGET_NONE;
+    release_pending = false;
+}
+
+/*******************************************************************************
+ * @brief find the widget under a point
+ * @param x, y: screen pixels
+ * @return lowest matching widget id, WIDGET_NONE if none
+ * ****************************************************************************/
+uint8_t widget_hit(int x, int y){
+    if (x < 0 || y < 0 || x >= WIDGET_SCREEN_WIDTH || y >= WIDGET_SCREEN_HEIGHT){
+        return WIDGET_NONE;
+    }
+    uint8_t mask = rows[y] & cols[x];
+    return mask ? __builtin_ctz(mask) : WIDGET_NONE;
+}
+
+/*******************************************************************************
+ * @brief end the current touch at the debounced release point
+ * ****************************************************************************/
+static void finish_release(){
+    release_pending = false;
+    if (state == STATE_PRESSED){
+        dispatch(active, widget_hit(release_x, release_y) == active ? WIDGET_UP : WIDGET_CANCEL);
+    }
+    else if (state == STATE_LONG){
+        dispatch(active, WIDGET_CANCEL);
+    }
+    state = STATE_IDLE;
+    active = WIDGET_NONE;
+}
+
+/*******************************************************************************
+ * @brief fire what is due: a debounced release or a long press
+ * @param now_ms: current time
+ * ****************************************************************************/
+void widget_tick(uint32_t now_ms){
+    if (release_pending){
+        if (now_ms - release_ms >= WIDGET_DEBOUNCE_MS){
+            finish_release();
+        }
+        return; // no long press while the finger is up
+    }
+    if (state == STATE_PRESSED && now_ms - down_ms >= WIDGET_LONG_PRESS_MS){
+        state = STATE_LONG;
+        dispatch(active, WIDGET_LONG_PRESS);
+    }
+}
+
+/*******************************************************************************
+ * @brief time until widget_tick() next has work
+ * @param now_ms: current time
+ * @return milliseconds, 0 if overdue, WIDGET_NO_TIMEOUT if nothing is pending
+ * ****************************************************************************/
+uint32_t widget_timeout(uint32_t now_ms){
+    uint32_t elapsed;
+    if (release_pending){
+        elapsed = now_ms - release_ms;
+        return elapsed >= WIDGET_DEBOUNCE_MS ? 0 : WIDGET_DEBOUNCE_MS - elapsed;
+    }
+    if (state == STATE_PRESSED){
+        elapsed = now_ms - down_ms;
+        return elapsed >= WIDGET_LONG_PRESS_MS ? 0 : WIDGET_LONG_PRESS_MS - elapsed;
+    }
+    return WIDGET_NO_TIMEOUT;
+}
+
+/*******************************************************************************
+ * @brief finger moved while down
+ * @param x, y: screen pixels
+ * @param now_ms: current time
+ * ****************************************************************************/
+void widget_move(int x, int y, uint32_t now_ms){
+    widget_tick(now_ms);
+    if (state != STATE_PRESSED && state != STATE_LONG){
+        return;
+    }
+    if (widget_hit(x, y) == active){
+        dispatch(active, WIDGET_MOVE);
+    }
+    else{
+        dispatch(active, WIDGET_CANCEL);
+        state = STATE_OFF;
+    }
+}
+
+/*******************************************************************************
+ * @brief finger down
+ * @param x, y: screen pixels
+ * @param now_ms: current time
+ * ****************************************************************************/
+void widget_down(int x, int y, uint32_t now_ms){
+    if (release_pending && now_ms - release_ms < WIDGET_DEBOUNCE_MS){
+        // Bounce: the touch never ended
+        release_pending = false;
+        widget_move(x, y, now_ms);
+        return;
+    }
+    widget_tick(now_ms);
+    if (state != STATE_IDLE){
+        return; // a press without a release, keep the touch in progress
+    }
+
+    active = widget_hit(x, y);
+    if (active == WIDGET_NONE){
+        state = STATE_OFF;
+        return;
+    }
+    state = STATE_PRESSED;
+    down_ms = now_ms;
+    dispatch(active, WIDGET_DOWN);
+}
+
+/*******************************************************************************
+ * @brief finger lifted; dispatched after WIDGET_DEBOUNCE_MS unless it bounces
+ * @param x, y: last screen position
+ * @param now_ms: current time
+ * ****************************************************************************/
+void widget_up(int x, int y, uint32_t now_ms){
+    widget_tick(now_ms);
+    if (state == STATE_IDLE){
+        return;
+    }
+    release_pending = true;
+    release_ms = now_ms;
+    release_x = x;
+    release_y = y;
+}
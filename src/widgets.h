@@ -0,0 +1,54 @@
+#ifndef WIDGETS_H
+#define WIDGETS_H
+
+#include <stdint.h>
+
+// Touchable rectangles, one bit each in the hit-test table
+#define WIDGET_MAX 8
+#define WIDGET_NONE 0xFF
+
+// Touch panel size in pixels
+#define WIDGET_SCREEN_WIDTH 240
+#define WIDGET_SCREEN_HEIGHT 320
+
+// Held this long without leaving the widget is a long press
+#define WIDGET_LONG_PRESS_MS 800
+
+// A release followed by a press within this is contact bounce; releases are
+// dispatched this much late so the press can still cancel them
+#define WIDGET_DEBOUNCE_MS 30
+
+// widget_timeout() when nothing is pending
+#define WIDGET_NO_TIMEOUT 0xFFFFFFFF
+
+// Actions passed to the widget handler
+#define WIDGET_DOWN 1       // finger down on the widget
+#define WIDGET_MOVE 2       // finger moved, still on the widget
+#define WIDGET_UP 3         // lifted on the widget before a long press: a click
+#define WIDGET_LONG_PRESS 4 // held for WIDGET_LONG_PRESS_MS
+#define WIDGET_CANCEL 5     // slid off the widget, or lifted after a long press
+
+typedef void (*WidgetHandler)(uint8_t widget, uint8_t action, void *context);
+
+// Register a rectangle; earlier widgets win where they overlap.
+// Returns the widget id, or WIDGET_NONE if the table is full.
+uint8_t widget_add(int x, int y, int width, int height, WidgetHandler handler, void *context);
+
+// Remove every widget and reset the touch state
+void widget_clear();
+
+// Widget under a point, WIDGET_NONE if none; two table lookups
+uint8_t widget_hit(int x, int y);
+
+// Feed the touch state machine; now_ms is any free-running millisecond clock
+void widget_down(int x, int y, uint32_t now_ms);
+void widget_move(int x, int y, uint32_t now_ms);
+void widget_up(int x, int y, uint32_t now_ms);
+
+// Fire long presses and debounced releases that are due
+void widget_tick(uint32_t now_ms);
+
+// Milliseconds until widget_tick() has something to do, or WIDGET_NO_TIMEOUT
+uint32_t widget_timeout(uint32_t now_ms);
+
+#endif
@@ -0,0 +1,264 @@
+/*
+ * Decodes the unlock attempt log the firmware prints with AUDIT_DUMP=1, or
+ * from audit_log_dump(), see src/audit_log.h.
+ *
+ * Usage: audit_dump [-g COUNT] [FILE...]
+ *
+ *   FILE      serial output of the board, "-" for stdin; the lines
+ *
+ *                 a <80 hex digits>  one AuditRecord, as it is in the EEPROM
+ *
+ *             are read and any other line skipped
+ *   -g COUNT  instead, make up COUNT attempts over a few boots, print them as
+ *             the board would after writing all but the last batch back, one
+ *             line damaged, and check they all decode but that one
+ *
+ * Records are checked against their CRC, put in attempt order and printed
+ * as a table, then a summary: the verdicts, how long attempts took, and the
+ * attempts missing between the first and the last, overwritten in the
+ * EEPROM, lost to a reset before they were written back, or damaged.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "audit_record.h"
+
+// src/audit_log.h
+#define AUDIT_EEPROM_SLOTS 192
+#define AUDIT_BATCH 8
+
+static const char *const verdict_names[] = {"denied", "granted", "error", "no key"};
+static const char *const flow_names[] = {"guided", "fast"};
+
+static std::map<uint32_t, AuditRecord> records; // by sequence
+static uint32_t lines = 0;
+static uint32_t invalid = 0;
+static uint32_t rng = 1;
+
+static double random_unit(){
+    rng = rng * 1664525 + 1013904223;
+    return (rng >> 8) / (double)(1 << 24);
+}
+
+/*******************************************************************************
+ * @brief take one line of a dump
+ * ****************************************************************************/
+static void add_line(const char *line){
+    AuditRecord record;
+    if (!audit_record_parse(line, &record)){
+        return;
+    }
+    lines++;
+    if (!audit_record_valid(&record)){
+        invalid++;
+        return;
+    }
+    // The same attempt twice: the later line is the newer copy
+    records[record.sequence] = record;
+}
+
+/*******************************************************************************
+ * @brief read the dump lines of a file
+ * ****************************************************************************/
+static bool load(const char *path){
+    FILE *file = strcmp(path, "-") ? fopen(path, "r") : stdin;
+    if (!file){
+        perror(path);
+        return false;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), file)){
+        add_line(line);
+    }
+    if (file != stdin){
+        fclose(file);
+    }
+    return true;
+}
+
+/*******************************************************************************
+ * @brief make up an attempt
+ * ****************************************************************************/
+static AuditRecord synthesize(uint32_t sequence, uint32_t boot, uint32_t uptime_ms){
+    AuditRecord record;
+    memset(&record, 0, sizeof(record));
+    record.sequence = sequence;
+    record.boot = boot;
+    record.uptime_ms = uptime_ms;
+    record.flow = random_unit() < 0.5;
+    record.duration_us = (record.flow ? 1000000 : 8000000) + random_unit() * 4000000;
+    record.samples = 40 + random_unit() * 65;
+    double roll = random_unit();
+    if (roll < 0.02){
+        record.verdict = AUDIT_NO_KEY;
+        record.dtw = INFINITY;
+    }
+    else if (roll < 0.04){
+        record.verdict = AUDIT_ERROR;
+        record.dtw = INFINITY;
+    }
+    else{
+        bool granted = roll < 0.7;
+        for (int axis = 0; axis < 3; axis++){
+            record.correlation[axis] = granted ? 0.1f + random_unit() * 0.85f : random_unit() * 0.4f - 0.2f;
+        }
+        record.dtw = granted ? 50 + random_unit() * 200 : 200 + random_unit() * 800;
+        record.verdict = granted ? AUDIT_GRANTED : AUDIT_DENIED;
+    }
+    audit_record_seal(&record);
+    return record;
+}
+
+/*******************************************************************************
+ * @brief dump COUNT made up attempts as the board would and read them back
+ * @return false if they do not come back as they went
+ * ****************************************************************************/
+static bool round_trip(uint32_t count){
+    std::vector<AuditRecord> attempts;
+    uint32_t boot = 1, uptime_ms = 5000;
+    for (uint32_t sequence = 0; sequence < count; sequence++){
+        if (random_unit() < 0.05){
+            boot++;
+            uptime_ms = 5000;
+        }
+        uptime_ms += 2000 + random_unit() * 60000;
+        attempts.push_back(synthesize(sequence, boot, uptime_ms));
+    }
+
+    // The EEPROM's slots, attempt n in slot n % AUDIT_EEPROM_SLOTS, holding
+    // all but the last batch; the ring holds that
+    uint32_t waiting = count < AUDIT_BATCH ? count : AUDIT_BATCH - 1;
+    uint32_t written = count - waiting;
+    std::vector<std::string> dump;
+    char line[AUDIT_LINE_SIZE];
+    dump.push_back("# audit log, 192 slots");
+    for (uint32_t slot = 0; slot < AUDIT_EEPROM_SLOTS; slot++){
+        uint32_t newest = written > slot ? written - 1 - (written - 1 - slot) % AUDIT_EEPROM_SLOTS : UINT32_MAX;
+        if (newest != UINT32_MAX){
+            audit_record_format(&attempts[newest], line);
+            dump.push_back(line);
+        }
+    }
+    for (uint32_t n = written; n < count; n++){
+        audit_record_format(&attempts[n], line);
+        dump.push_back(line);
+    }
+
+    // A bit flipped on the way
+    uint32_t damaged = UINT32_MAX;
+    if (dump.size() > 1){
+        std::string &victim = dump[1 + random_unit() * (dump.size() - 1)];
+        AuditRecord record;
+        audit_record_parse(victim.c_str(), &record);
+        damaged = record.sequence;
+        victim[2 + 8 * 2] ^= 1; // in uptime_ms
+    }
+
+    for (const auto &text : dump){
+        add_line(text.c_str());
+    }
+
+    uint32_t first = written > AUDIT_EEPROM_SLOTS ? written - AUDIT_EEPROM_SLOTS : 0;
+    bool ok = invalid == (damaged != UINT32_MAX);
+    for (uint32_t n = first; n < count && ok; n++){
+        auto found = records.find(n);
+        if (n == damaged){
+            ok = found == records.end();
+        }
+        else{
+            ok = found != records.end() && !memcmp(&found->second, &attempts[n], sizeof(AuditRecord));
+        }
+        if (!ok){
+            printf("FAIL attempt %u %s\n", n, n == damaged ? "damaged but read back" : "not read back as written");
+        }
+    }
+    if (ok && records.size() != count - first - (damaged != UINT32_MAX)){
+        printf("FAIL %zu records read back, %u expected\n", records.size(), count - first - (damaged != UINT32_MAX));
+        ok = false;
+    }
+    return ok;
+}
+
+/*******************************************************************************
+ * @brief print the records in attempt order
+ * ****************************************************************************/
+static void print_table(){
+    printf("%8s %5s %12s %9s %7s %6s %7s %7s %7s %7s %8s\n", "attempt", "boot", "uptime", "duration", "samples",
+           "flow", "verdict", "corr x", "corr y", "corr z", "dtw");
+    for (const auto &entry : records){
+        const AuditRecord &r = entry.second;
+        uint32_t seconds = r.uptime_ms / 1000;
+        char uptime[32];
+        snprintf(uptime, sizeof(uptime), "%u:%02u:%02u.%03u", seconds / 3600, seconds / 60 % 60, seconds % 60,
+                 r.uptime_ms % 1000);
+        printf("%8u %5u %12s %7.2f s %7u %6s %7s %7.3f %7.3f %7.3f %8.1f\n", r.sequence, r.boot, uptime,
+               r.duration_us / 1e6, r.samples, r.flow < 2 ? flow_names[r.flow] : "?",
+               r.verdict < 4 ? verdict_names[r.verdict] : "?", r.correlation[0], r.correlation[1],
+               r.correlation[2], r.dtw);
+    }
+}
+
+/*******************************************************************************
+ * @brief print the verdicts, durations and gaps
+ * ****************************************************************************/
+static void print_summary(){
+    printf("%u dump lines, %zu records, %u failed their CRC\n", lines, records.size(), invalid);
+    if (records.empty()){
+        return;
+    }
+    uint32_t first = records.begin()->first, last = records.rbegin()->first;
+    uint32_t verdicts[5] = {0};
+    uint32_t min_us = UINT32_MAX, max_us = 0;
+    uint64_t total_us = 0;
+    for (const auto &entry : records){
+        const AuditRecord &r = entry.second;
+        verdicts[r.verdict < 4 ? r.verdict : 4]++;
+        min_us = r.duration_us < min_us ? r.duration_us : min_us;
+        max_us = r.duration_us > max_us ? r.duration_us : max_us;
+        total_us += r.duration_us;
+    }
+    printf("attempts %u to %u, %u missing, boots %u to %u\n", first, last,
+           (uint32_t)(last - first + 1 - records.size()), records.begin()->second.boot,
+           records.rbegin()->second.boot);
+    printf("%u granted, %u denied, %u errors, %u with no key", verdicts[AUDIT_GRANTED], verdicts[AUDIT_DENIED],
+           verdicts[AUDIT_ERROR], verdicts[AUDIT_NO_KEY]);
+    if (verdicts[4]){
+        printf(", %u unknown", verdicts[4]);
+    }
+    printf("\nduration %.2f s at least, %.2f s on average, %.2f s at most\n", min_us / 1e6,
+           total_us / 1e6 / records.size(), max_us / 1e6);
+}
+
+int main(int argc, char **argv){
+    int32_t synthetic = -1;
+    bool files = false;
+    for (int i = 1; i < argc; i++){
+        if (!strcmp(argv[i], "-g") && i + 1 < argc){
+            synthetic = atoi(argv[++i]);
+        }
+        else if (load(argv[i])){
+            files = true;
+        }
+        else{
+            return 1;
+        }
+    }
+    if (synthetic < 0 && !files){
+        fprintf(stderr, "usage: audit_dump [-g COUNT] [FILE...]\n");
+        return 1;
+    }
+
+    if (synthetic >= 0){
+        bool ok = round_trip(synthetic);
+        print_summary();
+        printf(ok ? "PASS\n" : "FAIL\n");
+        return ok ? 0 : 1;
+    }
+    print_table();
+    print_summary();
+    return 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * src/store_flash.h on a RAM image of the sectors.
+ */
+#include <string.h>
+#include <time.h>
+#include "flash_sim.h"
+
+// Aligned like a sector as far as a template mapped in place can tell
+alignas(16) uint8_t flash_sim_image[STORE_SECTOR_COUNT][STORE_SECTOR_SIZE];
+FlashSimCounters flash_sim_counters;
+
+static long cut_after = -1;
+static long operations = 0;
+static uint32_t garbage = 0x12345678;
+
+/*******************************************************************************
+ * @brief count an operation
+ * @return true if the power goes before it completes
+ * ****************************************************************************/
+static bool power_cut(){
+    return cut_after >= 0 && operations++ >= cut_after;
+}
+
+void flash_sim_cut_after(long count){
+    cut_after = count;
+    operations = 0;
+}
+
+long flash_sim_operations(){
+    return operations;
+}
+
+int store_flash_init(){
+    return STORE_FLASH_OK;
+}
+
+int store_flash_read(uint8_t sector, uint32_t offset, void *buffer, uint32_t size){
+    if (sector >= STORE_SECTOR_COUNT || offset + size > STORE_SECTOR_SIZE){
+        return STORE_FLASH_ERROR;
+    }
+    memcpy(buffer, &flash_sim_image[sector][offset], size);
+    flash_sim_counters.read += size;
+    return STORE_FLASH_OK;
+}
+
+int store_flash_program(uint8_t sector, uint32_t offset, const void *buffer, uint32_t size){
+    if (sector >= STORE_SECTOR_COUNT || offset + size > STORE_SECTOR_SIZE){
+        return STORE_FLASH_ERROR;
+    }
+    const uint8_t *bytes = (const uint8_t *)buffer;
+    for (uint32_t i = 0; i < size; i++){
+        if (power_cut()){
+            throw FlashSimPowerCut();
+        }
+        flash_sim_image[sector][offset + i] &= bytes[i];
+        flash_sim_counters.programmed++;
+        flash_sim_counters.busy_us += FLASH_SIM_PROGRAM_US;
+    }
+    return STORE_FLASH_OK;
+}
+
+int store_flash_erase(uint8_t sector){
+    if (sector >= STORE_SECTOR_COUNT){
+        return STORE_FLASH_ERROR;
+    }
+    if (power_cut()){
+        // Whatever the cells hold after an erase cut short
+        for (uint32_t i = 0; i < STORE_SECTOR_SIZE; i++){
+            garbage = garbage * 1103515245 + 12345;
+            flash_sim_image[sector][i] = garbage >> 16;
+        }
+        throw FlashSimPowerCut();
+    }
+    memset(flash_sim_image[sector], STORE_FLASH_ERASED, STORE_SECTOR_SIZE);
+    flash_sim_counters.erases[sector]++;
+    flash_sim_counters.busy_us += FLASH_SIM_ERASE_US;
+    return STORE_FLASH_OK;
+}
+
+const void *store_flash_map(uint8_t sector, uint32_t offset){
+    return &flash_sim_image[sector][offset];
+}
+
+uint32_t store_flash_time_us(){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000u + now.tv_nsec / 1000;
+}
@@ -0,0 +1,38 @@
+#ifndef FLASH_SIM_H
+#define FLASH_SIM_H
+
+#include <stdint.h>
+#include "store_flash.h"
+
+// RAM image of the store's sectors behind src/store_flash.h. Programming
+// only clears bits, as on the chip, and the power can be cut after a given
+// number of operations to leave a write half done.
+
+// Busy time of the F429 at 3.3 V as FlashIAP drives it, byte programming
+#define FLASH_SIM_PROGRAM_US 16        // per byte, typical
+#define FLASH_SIM_ERASE_US 1000000     // per 128 KB sector, typical
+
+// Thrown when the power is cut
+struct FlashSimPowerCut
+{
+};
+
+typedef struct
+{
+    uint32_t erases[STORE_SECTOR_COUNT];
+    uint64_t programmed; // bytes
+    uint64_t read;       // bytes
+    uint64_t busy_us;    // modelled time the flash was busy writing
+} FlashSimCounters;
+
+extern uint8_t flash_sim_image[STORE_SECTOR_COUNT][STORE_SECTOR_SIZE];
+extern FlashSimCounters flash_sim_counters;
+
+// Cut the power after this many operations, a byte programmed or a sector
+// erased counting as one; -1 never. An erase cut short leaves garbage.
+void flash_sim_cut_after(long operations);
+
+// Operations since the last flash_sim_cut_after()
+long flash_sim_operations();
+
+#endif
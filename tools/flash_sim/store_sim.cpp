@@ -0,0 +1,414 @@
+/*
+ * Runs src/template_store.cpp on the simulated flash of flash_sim.cpp.
+ *
+ * Usage: store_sim [SAVES]
+ *
+ *   wear        SAVES saves (default 2000) of random templates to random
+ *               slots, with erases and a remount every 100, checking every
+ *               slot against a copy in RAM; reports erases per sector,
+ *               write amplification and the flash busy time per save
+ *   background  SAVES / 4 saves queued while the writes are stepped a
+ *               little at a time; reports the longest step
+ *   in place    a template read in place stays valid, and its sector
+ *               unerased, through a compaction until released
+ *   mount       mount time of an empty store and of a full sector of small
+ *               records, the worst case
+ *   power cut   cuts the power at every point of a save, and of a save
+ *               that compacts, then remounts: each slot must hold its old
+ *               or its new template, and the store must keep working
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "flash_sim.h"
+#include "template_store.h"
+
+// Template sizes: 1 to 6 s of 3 floats at 20 Hz
+#define MIN_LENGTH (20 * 12)
+#define MAX_LENGTH (120 * 12)
+
+// Cut points tried past the first and before the last few operations
+#define CUT_EDGE 64
+#define CUT_STRIDE 7
+
+typedef std::vector<uint8_t> Template;
+
+// What each slot should hold, empty if nothing
+static Template expected[STORE_SLOTS];
+static uint32_t rng = 1;
+
+static uint32_t random_below(uint32_t n){
+    rng = rng * 1664525 + 1013904223;
+    return (rng >> 8) % n;
+}
+
+static Template random_template(){
+    Template data(MIN_LENGTH + random_below(MAX_LENGTH - MIN_LENGTH + 1));
+    for (auto &byte : data){
+        byte = random_below(256);
+    }
+    return data;
+}
+
+/*******************************************************************************
+ * @brief compare one slot with what it should hold
+ * ****************************************************************************/
+static bool slot_holds(uint8_t slot, const Template &data){
+    static uint8_t buffer[STORE_MAX_LENGTH];
+    int length = template_store_read(slot, buffer, sizeof(buffer));
+    if (data.empty()){
+        return length == STORE_NOT_FOUND;
+    }
+    return length == (int)data.size() && memcmp(buffer, data.data(), length) == 0;
+}
+
+static bool check_slots(const char *when){
+    for (uint8_t slot = 0; slot < STORE_SLOTS; slot++){
+        if (!slot_holds(slot, expected[slot])){
+            printf("FAIL slot %u wrong %s\n", slot, when);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void blank_flash(){
+    memset(flash_sim_image, STORE_FLASH_ERASED, sizeof(flash_sim_image));
+    memset(&flash_sim_counters, 0, sizeof(flash_sim_counters));
+    for (auto &data : expected){
+        data.clear();
+    }
+}
+
+/*******************************************************************************
+ * @brief random saves and erases, with remounts
+ * ****************************************************************************/
+static bool wear(uint32_t saves){
+    blank_flash();
+    if (template_store_init() != STORE_OK){
+        printf("FAIL cannot format\n");
+        return false;
+    }
+
+    uint64_t payload = 0, max_busy_us = 0;
+    uint32_t compactions = 0;
+    for (uint32_t i = 0; i < saves; i++){
+        uint8_t slot = random_below(STORE_SLOTS);
+        uint64_t busy_us = flash_sim_counters.busy_us;
+        uint32_t before = template_store_stats().compactions;
+        if (random_below(20) == 0){
+            expected[slot].clear();
+            if (template_store_erase(slot) != STORE_OK || template_store_flush() != STORE_OK){
+                printf("FAIL erase %lu\n", (unsigned long)i);
+                return false;
+            }
+        }
+        else{
+            expected[slot] = random_template();
+            if (template_store_save(slot, expected[slot].data(), expected[slot].size()) != STORE_OK ||
+                template_store_flush() != STORE_OK){
+                printf("FAIL save %lu\n", (unsigned long)i);
+                return false;
+            }
+            payload += expected[slot].size();
+        }
+        compactions += template_store_stats().compactions - before;
+        busy_us = flash_sim_counters.busy_us - busy_us;
+        max_busy_us = busy_us > max_busy_us ? busy_us : max_busy_us;
+
+        if (!check_slots("after a save")){
+            return false;
+        }
+        if (i % 100 == 99){
+            if (template_store_init() != STORE_OK || !check_slots("after a remount")){
+                return false;
+            }
+        }
+    }
+
+    printf("ok   wear: %lu saves, %lu compactions, erases", (unsigned long)saves, (unsigned long)compactions);
+    for (uint8_t sector = 0; sector < STORE_SECTOR_COUNT; sector++){
+        printf(" %lu", (unsigned long)flash_sim_counters.erases[sector]);
+    }
+    printf("\n     %.2f bytes programmed per byte saved, flash busy %.1f ms per save on average, %.1f ms at most\n",
+           (double)flash_sim_counters.programmed / payload, flash_sim_counters.busy_us / 1000.0 / saves,
+           max_busy_us / 1000.0);
+    return true;
+}
+
+/*******************************************************************************
+ * @brief time a mount
+ * ****************************************************************************/
+static bool mount(const char *what){
+    uint64_t read = flash_sim_counters.read;
+    if (template_store_init() != STORE_OK || !check_slots("after a mount")){
+        return false;
+    }
+    TemplateStoreStats stats = template_store_stats();
+    printf("ok   mount %s: %lu us on the host, %lu records, %lu bytes read\n", what, (unsigned long)stats.mount_us,
+           (unsigned long)stats.records, (unsigned long)(flash_sim_counters.read - read));
+    return true;
+}
+
+static bool mount_times(){
+    blank_flash();
+    if (!mount("blank flash") || !mount("empty store")){
+        return false;
+    }
+
+    // Small records until the sector is about to compact
+    uint8_t slot = 0;
+    while (template_store_stats().used + 2 * (sizeof(StoreRecordHeader) + 8) <= STORE_SECTOR_SIZE){
+        expected[slot].assign(4, slot);
+        if (template_store_save(slot, expected[slot].data(), 4) != STORE_OK || template_store_flush() != STORE_OK){
+            return false;
+        }
+        slot = (slot + 1) % STORE_SLOTS;
+    }
+    return mount("full sector");
+}
+
+/*******************************************************************************
+ * @brief cut the power at every point of one save
+ * @param slot: slot to save
+ * @param data: template to save
+ * @param compacts: whether the save should compact
+ * @param name: for the report
+ * ****************************************************************************/
+static bool power_cuts(uint8_t slot, const Template &data, bool compacts, const char *name){
+    static uint8_t image[STORE_SECTOR_COUNT][STORE_SECTOR_SIZE];
+    Template old_expected[STORE_SLOTS];
+    memcpy(image, flash_sim_image, sizeof(image));
+    for (uint8_t i = 0; i < STORE_SLOTS; i++){
+        old_expected[i] = expected[i];
+    }
+
+    // Operations the save takes when nothing goes wrong, the erase of the
+    // sector a compaction leaves behind included
+    template_store_init();
+    template_store_flush();
+    uint32_t compactions = template_store_stats().compactions;
+    flash_sim_cut_after(1L << 30);
+    template_store_save(slot, data.data(), data.size());
+    template_store_flush();
+    long total = flash_sim_operations();
+    flash_sim_cut_after(-1);
+    bool compacted = template_store_stats().compactions != compactions;
+
+    uint32_t cuts = 0, kept_old = 0, got_new = 0;
+    for (long cut = 0; cut < total; cut += (cut < CUT_EDGE || cut >= total - CUT_EDGE) ? 1 : CUT_STRIDE){
+        memcpy(flash_sim_image, image, sizeof(image));
+        template_store_init();
+        template_store_flush();
+        flash_sim_cut_after(cut);
+        try{
+            template_store_save(slot, data.data(), data.size());
+            template_store_flush();
+            printf("FAIL %s: no power cut after %ld of %ld operations\n", name, cut, total);
+            return false;
+        }
+        catch (FlashSimPowerCut &){
+        }
+        flash_sim_cut_after(-1);
+        cuts++;
+
+        // Back on: the slot holds the old template or the new one, the
+        // others are untouched
+        if (template_store_init() != STORE_OK){
+            printf("FAIL %s: no mount after a cut at %ld\n", name, cut);
+            return false;
+        }
+        for (uint8_t i = 0; i < STORE_SLOTS; i++){
+            expected[i] = old_expected[i];
+        }
+        if (slot_holds(slot, data)){
+            expected[slot] = data;
+            got_new++;
+        }
+        else{
+            kept_old++;
+        }
+        char when[64];
+        snprintf(when, sizeof(when), "after a cut at %ld of %ld", cut, total);
+        if (!check_slots(when)){
+            return false;
+        }
+
+        // And keeps working
+        uint8_t other = (slot + 1) % STORE_SLOTS;
+        expected[other] = random_template();
+        if (template_store_save(other, expected[other].data(), expected[other].size()) != STORE_OK ||
+            template_store_flush() != STORE_OK || !check_slots(when) || template_store_init() != STORE_OK || !check_slots(when)){
+            printf("FAIL %s: store broken after a cut at %ld\n", name, cut);
+            return false;
+        }
+    }
+
+    // Leave the store as it was before the save
+    memcpy(flash_sim_image, image, sizeof(image));
+    for (uint8_t i = 0; i < STORE_SLOTS; i++){
+        expected[i] = old_expected[i];
+    }
+    template_store_init();
+    bool ok = compacted == compacts;
+    printf("%s power cut %s: %lu cuts over %ld operations, %lu kept the old template, %lu the new one\n",
+           ok ? "ok  " : "FAIL", name, (unsigned long)cuts, total, (unsigned long)kept_old, (unsigned long)got_new);
+    return ok;
+}
+
+static bool power_loss(){
+    blank_flash();
+    if (template_store_init() != STORE_OK){
+        return false;
+    }
+    for (uint8_t slot = 0; slot < STORE_SLOTS; slot++){
+        expected[slot] = random_template();
+        template_store_save(slot, expected[slot].data(), expected[slot].size());
+        template_store_flush();
+    }
+    if (!power_cuts(1, random_template(), false, "on a save")){
+        return false;
+    }
+
+    // Fill the sector so the next save compacts
+    while (template_store_stats().used + sizeof(StoreRecordHeader) + MAX_LENGTH + 4 <= STORE_SECTOR_SIZE){
+        expected[2] = random_template();
+        template_store_save(2, expected[2].data(), expected[2].size());
+        template_store_flush();
+    }
+    return power_cuts(1, Template(MAX_LENGTH, 0xA5), true, "on a save that compacts");
+}
+
+/*******************************************************************************
+ * @brief saves queued while the writes step along, as the worker thread
+ *        runs them: every slot reads back its newest template throughout
+ * ****************************************************************************/
+static bool background(uint32_t saves){
+    blank_flash();
+    if (template_store_init() != STORE_OK){
+        return false;
+    }
+
+    uint64_t longest_step_us = 0;
+    uint32_t steps = 0, erases = 0;
+    for (uint32_t i = 0; i < saves; i++){
+        uint8_t slot = random_below(2);
+        Template data = random_template();
+        while (template_store_save(slot, data.data(), data.size()) == STORE_BUSY){
+            uint8_t sector;
+            if (template_store_step(&sector) == STORE_STEP_ERASE){
+                template_store_erased(sector, store_flash_erase(sector) == STORE_FLASH_OK);
+                erases++;
+            }
+        }
+        expected[slot] = data;
+
+        // Saved again before it was written: only the newer one is
+        if (i % 8 == 0){
+            expected[slot] = random_template();
+            if (template_store_save(slot, expected[slot].data(), expected[slot].size()) != STORE_OK){
+                printf("FAIL save not coalesced\n");
+                return false;
+            }
+        }
+
+        // A few steps before the next save comes in, sometimes none
+        for (uint32_t n = random_below(40); n > 0; n--){
+            uint8_t sector;
+            uint64_t busy_us = flash_sim_counters.busy_us;
+            int step = template_store_step(&sector);
+            if (step == STORE_STEP_IDLE){
+                break;
+            }
+            steps++;
+            if (step == STORE_STEP_ERASE){
+                template_store_erased(sector, store_flash_erase(sector) == STORE_FLASH_OK);
+                erases++;
+            }
+            else if (flash_sim_counters.busy_us - busy_us > longest_step_us){
+                longest_step_us = flash_sim_counters.busy_us - busy_us;
+            }
+            if (!check_slots("while writing")){
+                return false;
+            }
+        }
+    }
+    if (template_store_flush() != STORE_OK){
+        return false;
+    }
+    TemplateStoreStats stats = template_store_stats();
+    if (template_store_init() != STORE_OK || !check_slots("after a remount")){
+        return false;
+    }
+
+    printf("ok   background: %lu saves in %lu steps, %lu coalesced, %lu erases\n", (unsigned long)saves,
+           (unsigned long)steps, (unsigned long)stats.coalesced, (unsigned long)erases);
+    printf("     longest step %.1f ms of flash time, erases apart\n", longest_step_us / 1000.0);
+    return true;
+}
+
+/*******************************************************************************
+ * @brief templates read in place: aligned, current, and kept readable
+ *        through a compaction until released
+ * ****************************************************************************/
+static bool in_place(){
+    blank_flash();
+    template_store_init();
+    for (uint8_t slot = 0; slot < STORE_SLOTS; slot++){
+        expected[slot] = random_template();
+        template_store_save(slot, expected[slot].data(), expected[slot].size());
+        template_store_flush();
+    }
+
+    StoreSpan span;
+    if (template_store_map(0, &span) != STORE_OK || (uintptr_t)span.data % STORE_ALIGN != 0 ||
+        span.length != expected[0].size() || memcmp(span.data, expected[0].data(), span.length) != 0){
+        printf("FAIL template not mapped in place\n");
+        return false;
+    }
+
+    // A queued save makes a span stale
+    StoreSpan stale;
+    expected[1] = random_template();
+    template_store_save(1, expected[1].data(), expected[1].size());
+    if (template_store_map(1, &stale) != STORE_BUSY){
+        printf("FAIL span of a slot with a save queued\n");
+        return false;
+    }
+
+    // Compact under the span: the old sector must wait for it
+    uint32_t erases = flash_sim_counters.erases[0] + flash_sim_counters.erases[1];
+    uint32_t compactions = template_store_stats().compactions;
+    while (template_store_stats().compactions == compactions){
+        expected[1] = random_template();
+        template_store_save(1, expected[1].data(), expected[1].size());
+        template_store_flush();
+    }
+    bool kept = memcmp(span.data, expected[0].data(), span.length) == 0 &&
+                flash_sim_counters.erases[0] + flash_sim_counters.erases[1] == erases;
+    template_store_unmap(&span);
+    template_store_flush();
+    bool erased = flash_sim_counters.erases[0] + flash_sim_counters.erases[1] == erases + 1;
+    if (!kept || !erased || !check_slots("after reading in place")){
+        printf("FAIL span %s through a compaction, old sector %s after release\n", kept ? "kept" : "lost",
+               erased ? "erased" : "not erased");
+        return false;
+    }
+
+    TemplateStoreStats stats = template_store_stats();
+    printf("ok   in place: %lu maps, %lu bytes read without a RAM copy, aligned to %u\n", (unsigned long)stats.maps,
+           (unsigned long)stats.bytes_mapped, STORE_ALIGN);
+    return true;
+}
+
+int main(int argc, char **argv){
+    uint32_t saves = argc > 1 ? strtoul(argv[1], NULL, 0) : 2000;
+    int failed = 0;
+    failed += !wear(saves);
+    failed += !background(saves / 4);
+    failed += !in_place();
+    failed += !mount_times();
+    failed += !power_loss();
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""Pack a BSP bitmap font into the proportional run-length format of packed_font.h.
+
+Usage: tools/font_pack.py src/drivers/font16.c Font16P src/font16_packed.c
+
+The BSP fonts store every glyph as a full Width x Height cell of 1-bpp rows
+padded to whole bytes. This tool trims each glyph to its ink box, gives it a
+proportional advance and encodes the box as runs: one byte per run pair, high
+nibble = transparent pixels, low nibble = ink pixels, scanned row by row.
+Sizes before and after are printed so the flash saving can be tracked.
+"""
+
+import re
+import sys
+
+FIRST_CHAR = 0x20
+CHAR_COUNT = 95
+GLYPH_STRUCT_SIZE = 6  # sizeof(PackedGlyph) on the target
+
+
+def parse_bsp_font(source):
+    """Return (table bytes, width, height) of the sFONT defined in a fontXX.c file."""
+    table = re.search(r"const uint8_t\s+\w+_Table\s*\[\]\s*=\s*\{(.*?)\};", source, re.S)
+    if table is None:
+        raise ValueError("no font table found")
+    body = re.sub(r"//[^\n]*", "", table.group(1))
+    data = [int(v, 16) for v in re.findall(r"0x[0-9A-Fa-f]{2}", body)]
+
+    font = re.search(r"sFONT\s+\w+\s*=\s*\{\s*\w+\s*,\s*(\d+)\s*,[^,]*?(\d+)\s*,?[^}]*\}", source, re.S)
+    if font is None:
+        raise ValueError("no sFONT definition found")
+    return data, int(font.group(1)), int(font.group(2))
+
+
+def glyph_bits(data, index, width, height):
+    """Return the glyph as a list of rows, each a list of 0/1 pixels."""
+    row_bytes = (width + 7) // 8
+    start = index * height * row_bytes
+    rows = []
+    for y in range(height):
+        line = 0
+        for b in range(row_bytes):
+            line = (line << 8) | data[start + y * row_bytes + b]
+        shift = row_bytes * 8 - 1
+        rows.append([(line >> (shift - x)) & 1 for x in range(width)])
+    return rows
+
+
+def encode_runs(pixels):
+    """Encode a flat 0/1 pixel list as (transparent, ink) nibble pairs."""
+    out = []
+    i = 0
+    while i < len(pixels):
+        clear = 0
+        while i < len(pixels) and pixels[i] == 0 and clear < 15:
+            clear += 1
+            i += 1
+        ink = 0
+        # a run of 15 clear pixels may be followed by more, ink waits for the next byte
+        if clear < 15:
+            while i < len(pixels) and pixels[i] == 1 and ink < 15:
+                ink += 1
+                i += 1
+        out.append((clear << 4) | ink)
+    return out
+
+
+def pack(data, width, height):
+    spacing = 1 + width // 8
+    glyphs = []
+    runs = []
+    for index in range(CHAR_COUNT):
+        rows = glyph_bits(data, index, width, height)
+        cols = [x for x in range(width) if any(r[x] for r in rows)]
+        lines = [y for y in range(height) if any(rows[y])]
+        if not cols:
+            glyphs.append((max(width // 2, 1), 0, 0, 0, len(runs)))
+            continue
+        x0, x1 = cols[0], cols[-1]
+        y0, y1 = lines[0], lines[-1]
+        pixels = [rows[y][x] for y in range(y0, y1 + 1) for x in range(x0, x1 + 1)]
+        offset = len(runs)
+        runs.extend(encode_runs(pixels))
+        ink_width = x1 - x0 + 1
+        glyphs.append((ink_width + spacing, y0, ink_width, y1 - y0 + 1, offset))
+    return glyphs, runs, spacing // 2
+
+
+def emit(name, source_name, height, glyphs, runs, bearing):
+    max_width = max(g[2] for g in glyphs)
+    out = []
+    out.append("/* Generated by tools/font_pack.py from %s, do not edit */" % source_name)
+    out.append('#include "packed_font.h"')
+    out.append("")
+    out.append("static const uint8_t %s_Runs[] = {" % name)
+    for i in range(0, len(runs), 16):
+        out.append("    " + ", ".join("0x%02X" % b for b in runs[i:i + 16]) + ",")
+    out.append("};")
+    out.append("")
+    out.append("static const PackedGlyph %s_Glyphs[] = {" % name)
+    for index, (advance, y, w, h, offset) in enumerate(glyphs):
+        char = chr(FIRST_CHAR + index)
+        comment = "\\\\" if char == "\\" else char
+        out.append("    {%d, %d, %d, %d, %d}, // '%s'" % (advance, y, w, h, offset, comment))
+    out.append("};")
+    out.append("")
+    out.append("const PackedFont %s = {" % name)
+    out.append("    %s_Glyphs," % name)
+    out.append("    %s_Runs," % name)
+    out.append("    0x%02X, // first character" % FIRST_CHAR)
+    out.append("    %d, // glyphs" % CHAR_COUNT)
+    out.append("    %d, // line height" % height)
+    out.append("    %d, // widest ink box" % max_width)
+    out.append("    %d, // ink box offset from the pen" % bearing)
+    out.append("};")
+    return "\n".join(out) + "\n"
+
+
+def main(argv):
+    if len(argv) != 4:
+        sys.stderr.write(__doc__)
+        return 2
+    source_path, name, out_path = argv[1:]
+    with open(source_path) as f:
+        data, width, height = parse_bsp_font(f.read())
+
+    glyphs, runs, bearing = pack(data, width, height)
+    with open(out_path, "w") as f:
+        f.write(emit(name, source_path.split("/")[-1], height, glyphs, runs, bearing))
+
+    bsp_size = CHAR_COUNT * height * ((width + 7) // 8)
+    packed_size = len(runs) + CHAR_COUNT * GLYPH_STRUCT_SIZE
+    advances = [g[0] for g in glyphs]
+    print("%s: %dx%d cells, %d bytes -> %d bytes (%d run bytes + %d glyph table), %.1f%%"
+          % (name, width, height, bsp_size, packed_size, len(runs), CHAR_COUNT * GLYPH_STRUCT_SIZE,
+             100.0 * packed_size / bsp_size))
+    print("%s: advance %d..%d px, mean %.1f px (monospace %d px)"
+          % (name, min(advances), max(advances), sum(advances) / len(advances), width))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
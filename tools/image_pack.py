@@ -0,0 +1,247 @@
+#!/usr/bin/env python3
+"""Pack a PNG or PPM image into the compressed RGB565 format of packed_image.h.
+
+Usage: tools/image_pack.py splash.png Splash src/splash_image.c [--background RRGGBB]
+
+PNGs must be 8-bit, non-interlaced, grey, RGB or RGBA; alpha is blended over
+the background color (default black) since the frame buffer has no use for
+it. Binary PPMs (P6, as written by tools/lcd_emu) are read as they are.
+The packed stream is decoded again and compared with the input before the C
+file is written, and the sizes of the raw alternatives are printed.
+"""
+
+import struct
+import sys
+import zlib
+
+OP_INDEX = 0x00
+OP_DIFF = 0x40
+OP_LUMA = 0x80
+OP_RUN = 0xC0
+OP_RGB = 0xFE
+MAX_RUN = 62
+
+
+def read_png(data, background):
+    """Return (width, height, [(r, g, b), ...]) of an 8-bit PNG."""
+    if data[:8] != b"\x89PNG\r\n\x1a\n":
+        raise ValueError("not a PNG")
+    pos = 8
+    idat = b""
+    while pos < len(data):
+        length, kind = struct.unpack(">I4s", data[pos:pos + 8])
+        body = data[pos + 8:pos + 8 + length]
+        if kind == b"IHDR":
+            width, height, depth, color, _, _, interlace = struct.unpack(">IIBBBBB", body)
+        elif kind == b"IDAT":
+            idat += body
+        pos += 12 + length
+    channels = {0: 1, 2: 3, 4: 2, 6: 4}.get(color)
+    if depth != 8 or interlace != 0 or channels is None:
+        raise ValueError("only 8-bit non-interlaced grey, RGB or RGBA PNGs are supported")
+
+    raw = zlib.decompress(idat)
+    stride = width * channels
+    rows = []
+    prior = bytearray(stride)
+    pos = 0
+    for _ in range(height):
+        kind = raw[pos]
+        line = bytearray(raw[pos + 1:pos + 1 + stride])
+        pos += 1 + stride
+        for i in range(stride):
+            a = line[i - channels] if i >= channels else 0
+            b = prior[i]
+            c = prior[i - channels] if i >= channels else 0
+            if kind == 1:
+                line[i] = (line[i] + a) & 255
+            elif kind == 2:
+                line[i] = (line[i] + b) & 255
+            elif kind == 3:
+                line[i] = (line[i] + (a + b) // 2) & 255
+            elif kind == 4:
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                line[i] = (line[i] + (a if pa <= pb and pa <= pc else b if pb <= pc else c)) & 255
+        rows.append(line)
+        prior = line
+
+    pixels = []
+    for line in rows:
+        for x in range(width):
+            px = line[x * channels:(x + 1) * channels]
+            if channels <= 2:
+                rgb, alpha = (px[0], px[0], px[0]), px[1] if channels == 2 else 255
+            else:
+                rgb, alpha = tuple(px[:3]), px[3] if channels == 4 else 255
+            pixels.append(tuple((c * alpha + k * (255 - alpha)) // 255 for c, k in zip(rgb, background)))
+    return width, height, pixels
+
+
+def read_ppm(data):
+    """Return (width, height, [(r, g, b), ...]) of a binary PPM."""
+    fields = []
+    pos = 0
+    while len(fields) < 4:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b"#":
+            pos = data.index(b"\n", pos)
+            continue
+        end = pos
+        while not data[end:end + 1].isspace():
+            end += 1
+        fields.append(data[pos:end])
+        pos = end
+    if fields[0] != b"P6" or fields[3] != b"255":
+        raise ValueError("only binary 8-bit PPMs are supported")
+    width, height = int(fields[1]), int(fields[2])
+    body = data[pos + 1:pos + 1 + width * height * 3]
+    return width, height, [tuple(body[i:i + 3]) for i in range(0, len(body), 3)]
+
+
+def rgb565(rgb):
+    r, g, b = rgb
+    return ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3)
+
+
+def color_hash(c):
+    return ((c >> 11) * 3 + ((c >> 5) & 0x3F) * 5 + (c & 0x1F) * 7) % 64
+
+
+def wrap(value, bits):
+    half = 1 << (bits - 1)
+    return ((value + half) & ((1 << bits) - 1)) - half
+
+
+def encode(pixels):
+    out = bytearray()
+    index = [0] * 64
+    prev = 0
+    run = 0
+    for c in pixels:
+        if c == prev:
+            run += 1
+            if run == MAX_RUN:
+                out.append(OP_RUN | (run - 1))
+                run = 0
+            continue
+        if run:
+            out.append(OP_RUN | (run - 1))
+            run = 0
+
+        h = color_hash(c)
+        if index[h] == c:
+            out.append(OP_INDEX | h)
+        else:
+            dr = wrap((c >> 11) - (prev >> 11), 5)
+            dg = wrap(((c >> 5) & 0x3F) - ((prev >> 5) & 0x3F), 6)
+            db = wrap((c & 0x1F) - (prev & 0x1F), 5)
+            if -2 <= dr <= 1 and -2 <= dg <= 1 and -2 <= db <= 1:
+                out.append(OP_DIFF | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2))
+            elif -8 <= dr - dg <= 7 and -8 <= db - dg <= 7:
+                out.append(OP_LUMA | (dg + 32))
+                out.append(((dr - dg + 8) << 4) | (db - dg + 8))
+            else:
+                out.append(OP_RGB)
+                out.append(c & 0xFF)
+                out.append(c >> 8)
+        index[h] = c
+        prev = c
+    if run:
+        out.append(OP_RUN | (run - 1))
+    return out
+
+
+def decode(data, count):
+    """Reference decoder, mirrors image_stream_read()."""
+    out = []
+    index = [0] * 64
+    prev = 0
+    pos = 0
+    while len(out) < count and pos < len(data):
+        op = data[pos]
+        pos += 1
+        if op == OP_RGB:
+            prev = data[pos] | (data[pos + 1] << 8)
+            pos += 2
+        elif op & 0xC0 == OP_INDEX:
+            prev = index[op]
+        elif op & 0xC0 == OP_DIFF:
+            r = ((prev >> 11) + ((op >> 4) & 3) - 2) & 0x1F
+            g = (((prev >> 5) & 0x3F) + ((op >> 2) & 3) - 2) & 0x3F
+            b = ((prev & 0x1F) + (op & 3) - 2) & 0x1F
+            prev = (r << 11) | (g << 5) | b
+        elif op & 0xC0 == OP_LUMA:
+            dg = (op & 0x3F) - 32
+            rb = data[pos]
+            pos += 1
+            r = ((prev >> 11) + dg + (rb >> 4) - 8) & 0x1F
+            g = (((prev >> 5) & 0x3F) + dg) & 0x3F
+            b = ((prev & 0x1F) + dg + (rb & 0x0F) - 8) & 0x1F
+            prev = (r << 11) | (g << 5) | b
+        else:
+            out.extend([prev] * ((op & 0x3F) + 1))
+            continue
+        index[color_hash(prev)] = prev
+        out.append(prev)
+    return out
+
+
+def emit(name, source_name, width, height, data):
+    out = []
+    out.append("/* Generated by tools/image_pack.py from %s, do not edit */" % source_name)
+    out.append('#include "packed_image.h"')
+    out.append("")
+    out.append("static const uint8_t %s_Data[] = {" % name)
+    for i in range(0, len(data), 16):
+        out.append("    " + ", ".join("0x%02X" % b for b in data[i:i + 16]) + ",")
+    out.append("};")
+    out.append("")
+    out.append("const PackedImage %s = {" % name)
+    out.append("    %d, // width" % width)
+    out.append("    %d, // height" % height)
+    out.append("    %d, // bytes" % len(data))
+    out.append("    %s_Data," % name)
+    out.append("};")
+    return "\n".join(out) + "\n"
+
+
+def main(argv):
+    args = [a for a in argv[1:] if not a.startswith("--")]
+    background = (0, 0, 0)
+    for a in argv[1:]:
+        if a.startswith("--background="):
+            value = int(a.split("=", 1)[1], 16)
+            background = ((value >> 16) & 255, (value >> 8) & 255, value & 255)
+    if len(args) != 3:
+        sys.stderr.write(__doc__)
+        return 2
+    source_path, name, out_path = args
+
+    with open(source_path, "rb") as f:
+        data = f.read()
+    if data[:2] == b"P6":
+        width, height, rgb = read_ppm(data)
+    else:
+        width, height, rgb = read_png(data, background)
+
+    pixels = [rgb565(p) for p in rgb]
+    packed = encode(pixels)
+    if decode(packed, len(pixels)) != pixels:
+        raise SystemExit("%s: decoded image differs from the input" % source_path)
+
+    with open(out_path, "w") as f:
+        f.write(emit(name, source_path.split("/")[-1], width, height, packed))
+
+    raw565 = width * height * 2
+    bmp = 54 + ((width * 3 + 3) & ~3) * height
+    print("%s: %dx%d, %d bytes packed; RGB565 %d bytes (%.1f%%), 24-bit BMP %d bytes (%.1f%%), "
+          "ARGB8888 %d bytes (%.1f%%)"
+          % (name, width, height, len(packed), raw565, 100.0 * len(packed) / raw565, bmp,
+             100.0 * len(packed) / bmp, width * height * 4, 100.0 * len(packed) / (width * height * 4)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
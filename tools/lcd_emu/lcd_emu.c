@@ -0,0 +1,399 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <time.h>
+#include "stm32f4xx_hal.h"
+#include "lcd.h"
+#include "lcd_emu.h"
+
+DMA2D_TypeDef emu_dma2d;
+LTDC_TypeDef emu_ltdc;
+GPIO_TypeDef *GPIOA, *GPIOB, *GPIOC, *GPIOD, *GPIOE, *GPIOF, *GPIOG;
+
+// LTDC state the HAL keeps in registers rather than in the handle
+typedef struct
+{
+    int enabled;
+    int keyed;
+    uint32_t key;
+} EmuLayer;
+
+static LTDC_HandleTypeDef *ltdc;
+static EmuLayer layers[2];
+static EmuStats stats;
+
+#define PTR(address) ((void *)(uintptr_t)(address))
+
+/*******************************************************************************
+ * @brief ILI9341 stand-in: the panel is driven by the LTDC, only the size is
+ *        ever asked for
+ * ****************************************************************************/
+static void panel_nop(void){
+}
+
+static uint16_t panel_width(void){
+    return EMU_WIDTH;
+}
+
+static uint16_t panel_height(void){
+    return EMU_HEIGHT;
+}
+
+LCD_DrvTypeDef ili9341_drv = {
+    panel_nop, NULL, panel_nop, panel_nop, NULL, NULL, NULL, NULL, NULL, NULL, panel_width, panel_height, NULL, NULL,
+};
+
+void ili9341_PowerOn(void){
+}
+
+uint8_t BSP_SDRAM_Init(void){
+    return 0;
+}
+
+uint32_t us_ticker_read(void){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000000 + t.tv_nsec / 1000;
+}
+
+/*******************************************************************************
+ * @brief map the emulated SDRAM at the board address
+ * ****************************************************************************/
+void emu_init(void){
+    void *sdram = mmap(PTR(EMU_SDRAM_ADDR), EMU_SDRAM_SIZE, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (sdram != PTR(EMU_SDRAM_ADDR)){
+        fprintf(stderr, "lcd_emu: cannot map SDRAM at 0x%08X\n", EMU_SDRAM_ADDR);
+        exit(1);
+    }
+    emu_reset_stats();
+}
+
+/*******************************************************************************
+ * LTDC
+ * ****************************************************************************/
+HAL_StatusTypeDef HAL_LTDC_ConfigLayer(LTDC_HandleTypeDef *hltdc, LTDC_LayerCfgTypeDef *pLayerCfg, uint32_t LayerIdx){
+    ltdc = hltdc;
+    hltdc->LayerCfg[LayerIdx] = *pLayerCfg;
+    layers[LayerIdx].enabled = 1; // the HAL sets LEN when it configures a layer
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_LTDC_SetWindowSize(LTDC_HandleTypeDef *hltdc, uint32_t XSize, uint32_t YSize, uint32_t LayerIdx){
+    LTDC_LayerCfgTypeDef *cfg = &hltdc->LayerCfg[LayerIdx];
+    // the line length follows the window, so the frame buffer is repacked
+    cfg->ImageWidth = XSize;
+    cfg->ImageHeight = YSize;
+    cfg->WindowX1 = cfg->WindowX0 + XSize;
+    cfg->WindowY1 = cfg->WindowY0 + YSize;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_LTDC_SetWindowPosition(LTDC_HandleTypeDef *hltdc, uint32_t X0, uint32_t Y0, uint32_t LayerIdx){
+    LTDC_LayerCfgTypeDef *cfg = &hltdc->LayerCfg[LayerIdx];
+    cfg->WindowX0 = X0;
+    cfg->WindowX1 = X0 + cfg->ImageWidth;
+    cfg->WindowY0 = Y0;
+    cfg->WindowY1 = Y0 + cfg->ImageHeight;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_LTDC_SetAlpha(LTDC_HandleTypeDef *hltdc, uint32_t Alpha, uint32_t LayerIdx){
+    hltdc->LayerCfg[LayerIdx].Alpha = Alpha;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_LTDC_SetAddress(LTDC_HandleTypeDef *hltdc, uint32_t Address, uint32_t LayerIdx){
+    hltdc->LayerCfg[LayerIdx].FBStartAdress = Address;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_LTDC_ConfigColorKeying(LTDC_HandleTypeDef *hltdc, uint32_t RGBValue, uint32_t LayerIdx){
+    (void)hltdc;
+    layers[LayerIdx].key = RGBValue & 0x00FFFFFF;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_LTDC_EnableColorKeying(LTDC_HandleTypeDef *hltdc, uint32_t LayerIdx){
+    (void)hltdc;
+    layers[LayerIdx].keyed = 1;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_LTDC_DisableColorKeying(LTDC_HandleTypeDef *hltdc, uint32_t LayerIdx){
+    (void)hltdc;
+    layers[LayerIdx].keyed = 0;
+    return HAL_OK;
+}
+
+void emu_ltdc_layer_enable(uint32_t LayerIdx, FunctionalState State){
+    layers[LayerIdx].enabled = (State == ENABLE);
+}
+
+/*******************************************************************************
+ * @brief read one pixel and expand it to ARGB8888
+ * @param address: first byte of the pixel
+ * @param mode: CM_* input color mode, the LTDC formats use the same values
+ * @param color: A8 color, from the DMA2D foreground color register
+ * @return the ARGB8888 pixel
+ * ****************************************************************************/
+static uint32_t read_pixel(const uint8_t *address, uint32_t mode, uint32_t color){
+    uint32_t p, r, g, b, a;
+    switch (mode){
+    case CM_ARGB8888:
+        return *(const uint32_t *)address;
+    case CM_RGB888:
+        return 0xFF000000 | (address[2] << 16) | (address[1] << 8) | address[0];
+    case CM_RGB565:
+        p = *(const uint16_t *)address;
+        r = (p >> 11) & 0x1F;
+        g = (p >> 5) & 0x3F;
+        b = p & 0x1F;
+        return 0xFF000000 | (((r << 3) | (r >> 2)) << 16) | (((g << 2) | (g >> 4)) << 8) | ((b << 3) | (b >> 2));
+    case CM_ARGB1555:
+        p = *(const uint16_t *)address;
+        r = (p >> 10) & 0x1F;
+        g = (p >> 5) & 0x1F;
+        b = p & 0x1F;
+        a = (p & 0x8000) ? 0xFF : 0;
+        return (a << 24) | (((r << 3) | (r >> 2)) << 16) | (((g << 3) | (g >> 2)) << 8) | ((b << 3) | (b >> 2));
+    case CM_ARGB4444:
+        p = *(const uint16_t *)address;
+        return ((((p >> 12) & 0xF) * 0x11) << 24) | ((((p >> 8) & 0xF) * 0x11) << 16) | ((((p >> 4) & 0xF) * 0x11) << 8) |
+               ((p & 0xF) * 0x11);
+    case CM_A8:
+        return ((uint32_t)address[0] << 24) | (color & 0x00FFFFFF);
+    default:
+        fprintf(stderr, "lcd_emu: color mode %u not emulated\n", (unsigned)mode);
+        exit(1);
+    }
+}
+
+static uint32_t pixel_size(uint32_t mode){
+    switch (mode){
+    case CM_ARGB8888:
+        return 4;
+    case CM_RGB888:
+        return 3;
+    case CM_A8:
+        return 1;
+    default:
+        return 2;
+    }
+}
+
+/*******************************************************************************
+ * @brief apply the alpha mode of a DMA2D layer
+ * ****************************************************************************/
+static uint32_t apply_alpha(uint32_t pixel, const DMA2D_LayerCfgTypeDef *cfg){
+    uint32_t a = pixel >> 24;
+    uint32_t layer_alpha = cfg->InputAlpha >> 24;
+    if (cfg->InputColorMode == CM_A8 || cfg->InputColorMode == CM_A4){
+        // the HAL puts the color in InputAlpha for alpha-only formats
+        layer_alpha = 0xFF;
+    }
+    if (cfg->AlphaMode == DMA2D_REPLACE_ALPHA){
+        a = layer_alpha;
+    }
+    else if (cfg->AlphaMode == DMA2D_COMBINE_ALPHA){
+        a = a * layer_alpha / 255;
+    }
+    return (a << 24) | (pixel & 0x00FFFFFF);
+}
+
+/*******************************************************************************
+ * @brief store one ARGB8888 pixel in the output color mode
+ * ****************************************************************************/
+static void write_pixel(uint8_t *address, uint32_t mode, uint32_t pixel){
+    if (mode == DMA2D_ARGB8888){
+        *(uint32_t *)address = pixel;
+    }
+    else if (mode == DMA2D_RGB888){
+        address[0] = pixel;
+        address[1] = pixel >> 8;
+        address[2] = pixel >> 16;
+    }
+    else{
+        *(uint16_t *)address = ((pixel >> 8) & 0xF800) | ((pixel >> 5) & 0x07E0) | ((pixel >> 3) & 0x001F);
+    }
+}
+
+/*******************************************************************************
+ * @brief DMA2D blender, RM0090 formulas in 8-bit integer math
+ * ****************************************************************************/
+static uint32_t blend(uint32_t fg, uint32_t bg){
+    uint32_t fa = fg >> 24, ba = bg >> 24;
+    uint32_t mult = fa * ba / 255;
+    uint32_t out_a = fa + ba - mult;
+    if (out_a == 0){
+        return 0;
+    }
+    uint32_t out = out_a << 24;
+    for (int shift = 0; shift < 24; shift += 8){
+        uint32_t f = (fg >> shift) & 0xFF, b = (bg >> shift) & 0xFF;
+        out |= ((f * fa + b * ba - b * mult) / out_a) << shift;
+    }
+    return out;
+}
+
+/*******************************************************************************
+ * DMA2D: the transfer runs to completion inside Start, Poll only returns
+ * ****************************************************************************/
+HAL_StatusTypeDef HAL_DMA2D_Init(DMA2D_HandleTypeDef *hdma2d){
+    hdma2d->Instance->CR = hdma2d->Init.Mode;
+    hdma2d->Instance->OPFCCR = hdma2d->Init.ColorMode;
+    hdma2d->Instance->OOR = hdma2d->Init.OutputOffset;
+    stats.inits++;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA2D_ConfigLayer(DMA2D_HandleTypeDef *hdma2d, uint32_t LayerIdx){
+    DMA2D_LayerCfgTypeDef *cfg = &hdma2d->LayerCfg[LayerIdx];
+    if (LayerIdx == 1){
+        hdma2d->Instance->FGOR = cfg->InputOffset;
+        hdma2d->Instance->FGPFCCR = cfg->InputColorMode;
+        hdma2d->Instance->FGCOLR = cfg->InputAlpha & 0x00FFFFFF;
+    }
+    else{
+        hdma2d->Instance->BGOR = cfg->InputOffset;
+        hdma2d->Instance->BGPFCCR = cfg->InputColorMode;
+        hdma2d->Instance->BGCOLR = cfg->InputAlpha & 0x00FFFFFF;
+    }
+    return HAL_OK;
+}
+
+/*******************************************************************************
+ * @brief run one transfer
+ * @param fg: foreground source, or the color for R2M
+ * @param bg: background source, blend only
+ * ****************************************************************************/
+static void dma2d_run(DMA2D_HandleTypeDef *hdma2d, uint32_t fg, uint32_t bg, uint32_t dst, uint32_t width, uint32_t height){
+    DMA2D_TypeDef *regs = hdma2d->Instance;
+    uint32_t mode = regs->CR;
+    uint32_t out_mode = regs->OPFCCR;
+    uint32_t out_size = pixel_size(out_mode);
+    uint32_t fg_mode = (mode == DMA2D_M2M) ? out_mode : regs->FGPFCCR;
+    uint32_t fg_size = pixel_size(fg_mode), bg_size = pixel_size(regs->BGPFCCR);
+
+    for (uint32_t y = 0; y < height; y++){
+        uint8_t *out = (uint8_t *)PTR(dst) + y * (width + regs->OOR) * out_size;
+        const uint8_t *in_fg = (const uint8_t *)PTR(fg) + y * (width + regs->FGOR) * fg_size;
+        const uint8_t *in_bg = (const uint8_t *)PTR(bg) + y * (width + regs->BGOR) * bg_size;
+
+        for (uint32_t x = 0; x < width; x++){
+            if (mode == DMA2D_R2M){
+                write_pixel(out, out_mode, fg);
+            }
+            else if (mode == DMA2D_M2M){
+                memcpy(out, in_fg, out_size);
+            }
+            else{
+                uint32_t pixel = apply_alpha(read_pixel(in_fg, fg_mode, regs->FGCOLR), &hdma2d->LayerCfg[1]);
+                if (mode == DMA2D_M2M_BLEND){
+                    uint32_t back = apply_alpha(read_pixel(in_bg, regs->BGPFCCR, regs->BGCOLR), &hdma2d->LayerCfg[0]);
+                    pixel = blend(pixel, back);
+                }
+                write_pixel(out, out_mode, pixel);
+            }
+            out += out_size;
+            in_fg += fg_size;
+            in_bg += bg_size;
+        }
+    }
+
+    stats.jobs++;
+    stats.pixels += (uint64_t)width * height;
+    stats.r2m += (mode == DMA2D_R2M);
+    stats.m2m += (mode == DMA2D_M2M);
+    stats.pfc += (mode == DMA2D_M2M_PFC);
+    stats.blend += (mode == DMA2D_M2M_BLEND);
+}
+
+HAL_StatusTypeDef HAL_DMA2D_Start(DMA2D_HandleTypeDef *hdma2d, uint32_t pdata, uint32_t DstAddress, uint32_t Width, uint32_t Height){
+    dma2d_run(hdma2d, pdata, 0, DstAddress, Width, Height);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA2D_BlendingStart(DMA2D_HandleTypeDef *hdma2d, uint32_t SrcAddress1, uint32_t SrcAddress2,
+                                          uint32_t DstAddress, uint32_t Width, uint32_t Height){
+    dma2d_run(hdma2d, SrcAddress1, SrcAddress2, DstAddress, Width, Height);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DMA2D_PollForTransfer(DMA2D_HandleTypeDef *hdma2d, uint32_t Timeout){
+    (void)hdma2d;
+    (void)Timeout;
+    return HAL_OK;
+}
+
+/*******************************************************************************
+ * @brief scan out both layers over the LTDC background color
+ * @param rgb: EMU_WIDTH * EMU_HEIGHT * 3 bytes
+ * ****************************************************************************/
+void emu_compose(uint8_t *rgb){
+    for (int y = 0; y < EMU_HEIGHT; y++){
+        for (int x = 0; x < EMU_WIDTH; x++){
+            uint32_t out = 0;
+            if (ltdc != NULL){
+                out = (ltdc->Init.Backcolor.Red << 16) | (ltdc->Init.Backcolor.Green << 8) | ltdc->Init.Backcolor.Blue;
+            }
+
+            for (int l = 0; ltdc != NULL && l < 2; l++){
+                const LTDC_LayerCfgTypeDef *cfg = &ltdc->LayerCfg[l];
+                if (!layers[l].enabled || x < (int)cfg->WindowX0 || x >= (int)cfg->WindowX1 ||
+                    y < (int)cfg->WindowY0 || y >= (int)cfg->WindowY1){
+                    continue;
+                }
+                uint32_t size = pixel_size(cfg->PixelFormat);
+                uint32_t index = (y - cfg->WindowY0) * cfg->ImageWidth + (x - cfg->WindowX0);
+                uint32_t pixel = read_pixel((const uint8_t *)PTR(cfg->FBStartAdress) + index * size, cfg->PixelFormat, 0);
+                if (layers[l].keyed && (pixel & 0x00FFFFFF) == layers[l].key){
+                    continue;
+                }
+
+                uint32_t a = cfg->Alpha;
+                if (cfg->BlendingFactor1 == LTDC_BLENDING_FACTOR1_PAxCA){
+                    a = a * (pixel >> 24) / 255;
+                }
+                uint32_t mixed = 0;
+                for (int shift = 0; shift < 24; shift += 8){
+                    uint32_t c = (((pixel >> shift) & 0xFF) * a + ((out >> shift) & 0xFF) * (255 - a)) / 255;
+                    mixed |= c << shift;
+                }
+                out = mixed;
+            }
+
+            rgb[0] = out >> 16;
+            rgb[1] = out >> 8;
+            rgb[2] = out;
+            rgb += 3;
+        }
+    }
+}
+
+int emu_write_ppm(const char *path, const uint8_t *rgb){
+    FILE *f = fopen(path, "wb");
+    if (f == NULL){
+        return -1;
+    }
+    fprintf(f, "P6\n%d %d\n255\n", EMU_WIDTH, EMU_HEIGHT);
+    size_t written = fwrite(rgb, 3, EMU_WIDTH * EMU_HEIGHT, f);
+    fclose(f);
+    return written == EMU_WIDTH * EMU_HEIGHT ? 0 : -1;
+}
+
+uint64_t emu_hash(const uint8_t *rgb){
+    uint64_t hash = 14695981039346656037ULL;
+    for (int i = 0; i < EMU_WIDTH * EMU_HEIGHT * 3; i++){
+        hash = (hash ^ rgb[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+EmuStats emu_stats(void){
+    return stats;
+}
+
+void emu_reset_stats(void){
+    memset(&stats, 0, sizeof(stats));
+}
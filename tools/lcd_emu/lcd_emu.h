@@ -0,0 +1,50 @@
+#ifndef LCD_EMU_H
+#define LCD_EMU_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Emulated SDRAM, mapped at the board address so the frame buffer addresses
+// the BSP keeps in uint32_t stay valid pointers on a 64-bit host
+#define EMU_SDRAM_ADDR 0xD0000000
+#define EMU_SDRAM_SIZE 0x800000
+
+#define EMU_WIDTH 240
+#define EMU_HEIGHT 320
+
+// DMA2D work done since emu_reset_stats()
+typedef struct
+{
+    uint32_t jobs;        // transfers started
+    uint32_t inits;       // HAL_DMA2D_Init calls
+    uint32_t r2m;         // register to memory fills
+    uint32_t m2m;         // plain copies
+    uint32_t pfc;         // copies with pixel format conversion
+    uint32_t blend;       // two-source blends
+    uint64_t pixels;      // output pixels written
+} EmuStats;
+
+// Map the emulated SDRAM and hook up the LCD driver; call before BSP_LCD_Init()
+void emu_init(void);
+
+// Compose the enabled LTDC layers into a 24-bit RGB image the way the
+// LTDC scans them out: windows, constant alpha, pixel alpha and color keys
+void emu_compose(uint8_t *rgb);
+
+// Write a composed image as a binary PPM
+int emu_write_ppm(const char *path, const uint8_t *rgb);
+
+// 64-bit FNV-1a hash of a composed image
+uint64_t emu_hash(const uint8_t *rgb);
+
+EmuStats emu_stats(void);
+void emu_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,419 @@
+/*
+ * Host runner for the LCD driver on the emulated LTDC and DMA2D.
+ *
+ * Usage: lcd_emu check golden.txt    compare every scene with its golden hash
+ *        lcd_emu record golden.txt   rewrite the golden hashes
+ *        lcd_emu snap DIR            write every scene as DIR/<scene>.ppm
+ *        lcd_emu bench [RUNS]        time every scene and count DMA2D work
+ *
+ * Each scene exercises one BSP_LCD_* primitive from the same start screen.
+ * The composed LTDC output is hashed, so a rendering change shows up as a
+ * hash mismatch; check writes <scene>.fail.ppm next to the golden file for
+ * every scene that differs. Host times only rank primitives against each
+ * other, the DMA2D job and pixel counts are what carries over to the board.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "stm32f429i_discovery_lcd.h"
+#include "lcd_emu.h"
+
+#define FB_LAYER0 (LCD_FRAME_BUFFER + 0x130000)
+#define FB_LAYER1 LCD_FRAME_BUFFER
+#define SCRATCH   (LCD_FRAME_BUFFER + 0x390000) // images and masks, in SDRAM like on the board
+
+typedef struct
+{
+    const char *name;
+    void (*draw)(void);
+    int calls; // BSP_LCD_* calls per run, for the per-call cost
+} Scene;
+
+static uint32_t seed;
+
+static uint32_t next_random(uint32_t range){
+    seed = seed * 1664525 + 1013904223;
+    return (seed >> 8) % range;
+}
+
+/*******************************************************************************
+ * @brief put the driver in the state the app constructor leaves it in
+ * ****************************************************************************/
+static void reset_screen(void){
+    BSP_LCD_LayerDefaultInit(1, FB_LAYER1);
+    BSP_LCD_SelectLayer(1);
+    BSP_LCD_Clear(LCD_COLOR_WHITE);
+    BSP_LCD_SetColorKeying(1, LCD_COLOR_WHITE);
+    BSP_LCD_SetLayerVisible(1, DISABLE);
+    BSP_LCD_LayerDefaultInit(0, FB_LAYER0);
+    BSP_LCD_SelectLayer(0);
+    BSP_LCD_Clear(LCD_COLOR_WHITE);
+    BSP_LCD_SetFont(&Font16);
+    BSP_LCD_SetTextColor(LCD_COLOR_BLACK);
+    BSP_LCD_SetBackColor(LCD_COLOR_WHITE);
+    seed = 1;
+}
+
+/*******************************************************************************
+ * @brief build a bottom-up BMP with a color gradient in SDRAM
+ * @param bits: 16 (RGB565) or 24 (RGB888)
+ * @return the file image
+ * ****************************************************************************/
+static uint8_t *make_bitmap(uint32_t width, uint32_t height, uint32_t bits){
+    uint8_t *bmp = (uint8_t *)(uintptr_t)SCRATCH;
+    uint32_t offset = 54, size = offset + width * height * bits / 8;
+    memset(bmp, 0, offset);
+    bmp[0] = 'B';
+    bmp[1] = 'M';
+    memcpy(bmp + 2, &size, 4);
+    memcpy(bmp + 10, &offset, 4);
+    memcpy(bmp + 18, &width, 4);
+    memcpy(bmp + 22, &height, 4);
+    bmp[28] = bits;
+
+    uint8_t *p = bmp + offset;
+    for (uint32_t y = 0; y < height; y++){
+        for (uint32_t x = 0; x < width; x++){
+            uint32_t r = x * 255 / width, g = y * 255 / height, b = 255 - r;
+            if (bits == 16){
+                uint16_t c = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+                memcpy(p, &c, 2);
+                p += 2;
+            }
+            else{
+                *p++ = b;
+                *p++ = g;
+                *p++ = r;
+            }
+        }
+    }
+    return bmp;
+}
+
+static void scene_clear(void){
+    BSP_LCD_Clear(LCD_COLOR_DARKCYAN);
+}
+
+static void scene_pixel(void){
+    for (int i = 0; i < 500; i++){
+        BSP_LCD_DrawPixel(next_random(240), next_random(320), 0xFF000000 | next_random(0x1000000));
+    }
+}
+
+static void scene_hvline(void){
+    for (int i = 0; i < 20; i++){
+        BSP_LCD_SetTextColor(0xFF000000 | next_random(0x1000000));
+        BSP_LCD_DrawHLine(next_random(120), next_random(320), 1 + next_random(120));
+        BSP_LCD_DrawVLine(next_random(240), next_random(160), 1 + next_random(160));
+    }
+}
+
+static void scene_line(void){
+    for (int i = 0; i < 40; i++){
+        BSP_LCD_SetTextColor(0xFF000000 | next_random(0x1000000));
+        BSP_LCD_DrawLine(120, 160, next_random(240), next_random(320));
+    }
+}
+
+static void scene_rect(void){
+    for (int i = 0; i < 20; i++){
+        BSP_LCD_SetTextColor(0xFF000000 | next_random(0x1000000));
+        BSP_LCD_DrawRect(next_random(120), next_random(160), 1 + next_random(110), 1 + next_random(150));
+    }
+}
+
+static void scene_circle(void){
+    for (int i = 0; i < 20; i++){
+        BSP_LCD_SetTextColor(0xFF000000 | next_random(0x1000000));
+        BSP_LCD_DrawCircle(60 + next_random(120), 60 + next_random(200), 1 + next_random(55));
+    }
+}
+
+static void scene_ellipse(void){
+    for (int i = 0; i < 20; i++){
+        BSP_LCD_SetTextColor(0xFF000000 | next_random(0x1000000));
+        BSP_LCD_DrawEllipse(60 + next_random(120), 60 + next_random(200), 1 + next_random(55), 1 + next_random(55));
+    }
+}
+
+static void scene_polygon(void){
+    Point points[] = {{20, 40}, {200, 20}, {220, 150}, {120, 300}, {30, 220}};
+    BSP_LCD_SetTextColor(LCD_COLOR_BLUE);
+    BSP_LCD_DrawPolygon(points, 5);
+}
+
+static void scene_text(void){
+    BSP_LCD_SetBackColor(LCD_COLOR_BLUE);
+    BSP_LCD_SetTextColor(LCD_COLOR_WHITE);
+    BSP_LCD_DisplayStringAt(0, 30, (uint8_t *)"PASSWORD UNLOCKER", CENTER_MODE);
+    BSP_LCD_SetFont(&Font24);
+    BSP_LCD_DisplayStringAt(0, 100, (uint8_t *)"RECORD", CENTER_MODE);
+    BSP_LCD_SetFont(&Font12);
+    BSP_LCD_DisplayStringAtLine(20, (uint8_t *)"Recording in 3...");
+    BSP_LCD_SetFont(&Font8);
+    BSP_LCD_DisplayStringAt(5, 300, (uint8_t *)"UNLOCK: FAILED", RIGHT_MODE);
+}
+
+static void scene_bitmap565(void){
+    BSP_LCD_DrawBitmap(20, 40, make_bitmap(200, 120, 16));
+}
+
+static void scene_bitmap888(void){
+    BSP_LCD_DrawBitmap(20, 180, make_bitmap(200, 120, 24));
+}
+
+static void scene_image(void){
+    uint32_t *image = (uint32_t *)(uintptr_t)SCRATCH;
+    for (int i = 0; i < 100 * 60; i++){
+        image[i] = 0xFF000000 | (i * 0x010203);
+    }
+    BSP_LCD_DrawImage(70, 130, 100, 60, image);
+}
+
+static void scene_rgb565(void){
+    uint16_t *block = (uint16_t *)(uintptr_t)SCRATCH;
+    for (int y = 0; y < 60; y++){
+        for (int x = 0; x < 200; x++){
+            uint32_t r = x * 31 / 199, g = y * 63 / 59;
+            block[y * 200 + x] = (r << 11) | (g << 5) | (31 - r);
+        }
+    }
+    BSP_LCD_DrawRGB565(20, 60, 200, 30, block);
+    BSP_LCD_DrawRGB565(20, 200, 200, 30, block + 200 * 30);
+    BSP_LCD_WaitDMA2D();
+}
+
+static void scene_scroll(void){
+    BSP_LCD_SetTextColor(LCD_COLOR_RED);
+    BSP_LCD_FillRect(10, 100, 200, 100);
+    BSP_LCD_SetTextColor(LCD_COLOR_BLUE);
+    BSP_LCD_FillCircle(110, 150, 40);
+    BSP_LCD_ScrollLeft(0, 10, 100, 200, 100, 37);
+}
+
+static void scene_alpha_mask(void){
+    uint8_t *mask = (uint8_t *)(uintptr_t)SCRATCH;
+    for (int y = 0; y < 80; y++){
+        for (int x = 0; x < 160; x++){
+            mask[y * 160 + x] = (x * 255 / 159) ^ ((y & 8) ? 0xFF : 0);
+        }
+    }
+    BSP_LCD_SetTextColor(LCD_COLOR_YELLOW);
+    BSP_LCD_FillRect(0, 120, 240, 80);
+    BSP_LCD_DrawAlphaMask(40, 120, 160, 80, mask, LCD_COLOR_BLUE);
+}
+
+static void scene_fill_rect(void){
+    for (int i = 0; i < 20; i++){
+        BSP_LCD_SetTextColor(0xFF000000 | next_random(0x1000000));
+        BSP_LCD_FillRect(next_random(120), next_random(160), 1 + next_random(110), 1 + next_random(150));
+    }
+}
+
+static void scene_fill_circle(void){
+    for (int i = 0; i < 20; i++){
+        BSP_LCD_SetTextColor(0xFF000000 | next_random(0x1000000));
+        BSP_LCD_FillCircle(60 + next_random(120), 60 + next_random(200), 1 + next_random(55));
+    }
+}
+
+static void scene_fill_ellipse(void){
+    for (int i = 0; i < 20; i++){
+        BSP_LCD_SetTextColor(0xFF000000 | next_random(0x1000000));
+        BSP_LCD_FillEllipse(60 + next_random(120), 60 + next_random(200), 1 + next_random(55), 1 + next_random(55));
+    }
+}
+
+static void scene_fill_triangle(void){
+    for (int i = 0; i < 20; i++){
+        BSP_LCD_SetTextColor(0xFF000000 | next_random(0x1000000));
+        BSP_LCD_FillTriangle(next_random(240), next_random(240), next_random(240),
+                             next_random(320), next_random(320), next_random(320));
+    }
+}
+
+static void scene_fill_polygon(void){
+    Point points[] = {{20, 40}, {200, 20}, {220, 150}, {120, 300}, {30, 220}};
+    BSP_LCD_SetTextColor(LCD_COLOR_GREEN);
+    BSP_LCD_FillPolygon(points, 5);
+}
+
+/*******************************************************************************
+ * @brief the app screen: background layer plus a windowed, color-keyed,
+ *        half transparent status layer on top
+ * ****************************************************************************/
+static void scene_layers(void){
+    BSP_LCD_SetTextColor(LCD_COLOR_BLUE);
+    BSP_LCD_FillRect(0, 0, 240, 320);
+    BSP_LCD_SetTextColor(LCD_COLOR_LIGHTBLUE);
+    BSP_LCD_FillCircle(120, 280, 60);
+
+    BSP_LCD_SetLayerWindow(1, 0, 270, 240, 16);
+    BSP_LCD_SetColorKeying(1, LCD_COLOR_BLACK);
+    BSP_LCD_SelectLayer(1);
+    BSP_LCD_SetTextColor(LCD_COLOR_BLACK);
+    BSP_LCD_FillRect(0, 0, 240, 16);
+    BSP_LCD_SetTextColor(LCD_COLOR_RED);
+    BSP_LCD_FillRect(20, 2, 200, 12);
+    BSP_LCD_SetLayerVisible(1, ENABLE);
+    BSP_LCD_SetTransparency(1, 160);
+    BSP_LCD_SelectLayer(0);
+}
+
+static const Scene scenes[] = {
+    {"clear", scene_clear, 1},
+    {"pixel", scene_pixel, 500},
+    {"hvline", scene_hvline, 40},
+    {"line", scene_line, 40},
+    {"rect", scene_rect, 20},
+    {"circle", scene_circle, 20},
+    {"ellipse", scene_ellipse, 20},
+    {"polygon", scene_polygon, 1},
+    {"text", scene_text, 4},
+    {"bitmap565", scene_bitmap565, 1},
+    {"bitmap888", scene_bitmap888, 1},
+    {"image", scene_image, 1},
+    {"rgb565", scene_rgb565, 2},
+    {"scroll", scene_scroll, 3},
+    {"alpha_mask", scene_alpha_mask, 2},
+    {"fill_rect", scene_fill_rect, 20},
+    {"fill_circle", scene_fill_circle, 20},
+    {"fill_ellipse", scene_fill_ellipse, 20},
+    {"fill_triangle", scene_fill_triangle, 20},
+    {"fill_polygon", scene_fill_polygon, 1},
+    {"layers", scene_layers, 9},
+};
+#define SCENE_COUNT (sizeof(scenes) / sizeof(scenes[0]))
+
+static uint8_t frame[EMU_WIDTH * EMU_HEIGHT * 3];
+
+static uint64_t render(const Scene *scene){
+    reset_screen();
+    scene->draw();
+    emu_compose(frame);
+    return emu_hash(frame);
+}
+
+static double now_us(void){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e6 + t.tv_nsec / 1e3;
+}
+
+/*******************************************************************************
+ * @brief compare every scene with golden.txt, or rewrite it
+ * @return the number of scenes that differ or have no golden hash
+ * ****************************************************************************/
+static int check(const char *path, int record){
+    char names[SCENE_COUNT][32];
+    unsigned long long hashes[SCENE_COUNT];
+    int golden = 0, failed = 0;
+
+    FILE *f = fopen(path, record ? "w" : "r");
+    if (f == NULL){
+        perror(path);
+        return 1;
+    }
+    if (record){
+        fprintf(f, "# scene, FNV-1a 64 of the composed RGB frame; written by lcd_emu record\n");
+    }
+    else{
+        char line[128];
+        while (golden < (int)SCENE_COUNT && fgets(line, sizeof(line), f) != NULL){
+            if (line[0] != '#' && sscanf(line, "%31s %llx", names[golden], &hashes[golden]) == 2){
+                golden++;
+            }
+        }
+    }
+
+    for (unsigned i = 0; i < SCENE_COUNT; i++){
+        uint64_t hash = render(&scenes[i]);
+        if (record){
+            fprintf(f, "%s %016llx\n", scenes[i].name, (unsigned long long)hash);
+            continue;
+        }
+
+        int found = -1;
+        for (int g = 0; g < golden; g++){
+            if (strcmp(names[g], scenes[i].name) == 0){
+                found = g;
+            }
+        }
+        if (found >= 0 && hashes[found] == hash){
+            printf("ok   %s\n", scenes[i].name);
+            continue;
+        }
+
+        char ppm[512];
+        const char *slash = strrchr(path, '/');
+        snprintf(ppm, sizeof(ppm), "%.*s%s.fail.ppm", slash ? (int)(slash - path + 1) : 0, path, scenes[i].name);
+        emu_write_ppm(ppm, frame);
+        printf("FAIL %s: %016llx, golden %s, see %s\n", scenes[i].name, (unsigned long long)hash,
+               found >= 0 ? "differs" : "missing", ppm);
+        failed++;
+    }
+
+    fclose(f);
+    if (record){
+        printf("%u scenes recorded in %s\n", (unsigned)SCENE_COUNT, path);
+    }
+    else{
+        printf("%u scenes, %d failed\n", (unsigned)SCENE_COUNT, failed);
+    }
+    return failed;
+}
+
+static int snap(const char *dir){
+    for (unsigned i = 0; i < SCENE_COUNT; i++){
+        char path[512];
+        render(&scenes[i]);
+        snprintf(path, sizeof(path), "%s/%s.ppm", dir, scenes[i].name);
+        if (emu_write_ppm(path, frame) != 0){
+            perror(path);
+            return 1;
+        }
+        printf("%s\n", path);
+    }
+    return 0;
+}
+
+static int bench(int runs){
+    printf("%-14s %10s %10s %8s %12s\n", "scene", "us/run", "us/call", "dma2d", "dma2d px");
+    for (unsigned i = 0; i < SCENE_COUNT; i++){
+        reset_screen();
+        emu_reset_stats();
+        double start = now_us();
+        for (int r = 0; r < runs; r++){
+            seed = 1;
+            scenes[i].draw();
+        }
+        double elapsed = (now_us() - start) / runs;
+        EmuStats s = emu_stats();
+        printf("%-14s %10.1f %10.2f %8.1f %12.0f\n", scenes[i].name, elapsed, elapsed / scenes[i].calls,
+               (double)s.jobs / runs, (double)s.pixels / runs);
+    }
+    return 0;
+}
+
+int main(int argc, char **argv){
+    if (argc < 2){
+        fprintf(stderr, "usage: lcd_emu check|record GOLDEN | snap DIR | bench [RUNS]\n");
+        return 2;
+    }
+
+    emu_init();
+    BSP_LCD_Init();
+
+    if ((strcmp(argv[1], "check") == 0 || strcmp(argv[1], "record") == 0) && argc == 3){
+        return check(argv[2], argv[1][0] == 'r') ? 1 : 0;
+    }
+    if (strcmp(argv[1], "snap") == 0 && argc == 3){
+        return snap(argv[2]);
+    }
+    if (strcmp(argv[1], "bench") == 0){
+        return bench(argc > 2 ? atoi(argv[2]) : 100);
+    }
+    fprintf(stderr, "usage: lcd_emu check|record GOLDEN | snap DIR | bench [RUNS]\n");
+    return 2;
+}
@@ -0,0 +1,42 @@
+// Host stand-in for the few mbed OS APIs the UI drawing code uses, so
+// ui_emu.cpp can build src/ui.cpp and its helpers against the emulator.
+#ifndef MBED_H
+#define MBED_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+
+using namespace std;
+
+extern "C" uint32_t us_ticker_read(void);
+
+namespace mbed {
+
+class Timer {
+public:
+    void start(){
+        if (!running){
+            running = true;
+            started = chrono::steady_clock::now();
+        }
+    }
+    void stop(){
+        running = false;
+    }
+    chrono::microseconds elapsed_time() const{
+        return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - started);
+    }
+
+private:
+    bool running = false;
+    chrono::steady_clock::time_point started;
+};
+
+}
+
+using namespace mbed;
+
+#endif
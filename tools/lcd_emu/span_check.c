@@ -0,0 +1,308 @@
+/*
+ * Compares the filled shapes of the span rasteriser (LCD_SPAN_FILL=1) with
+ * the line based code it replaced (LCD_SPAN_FILL=0), pixel for pixel.
+ *
+ * Usage: span_check write FILE              draw every shape, save the masks
+ *        span_check check OLD NEW DIFFS     compare, and the differences
+ *                                           with the list in DIFFS
+ *        span_check record OLD NEW DIFFS    rewrite the list
+ *
+ * The Makefile builds this once against each driver. Each draws the same
+ * seeded shapes, one at a time on a white layer, and saves which pixels
+ * each one touched. Circles and ellipses drawn on screen must come out
+ * identical. Triangles, polygons and shapes crossing the screen edge
+ * differ by design:
+ *   - the old code swept lines from one vertex to the points of the
+ *     opposite edge, which left pinholes between them and put single
+ *     pixels just outside the edges; the spans fill between the edges;
+ *   - the old code let a shape past the right edge wrap into the next row,
+ *     the spans clip it. Flat ellipses go past it too: the BSP steps their
+ *     rows out to several times XRadius.
+ * Every shape that differs is listed in DIFFS with the pixels only the old
+ * code drew and the pixels only the new one drew. check fails if a circle
+ * or ellipse differs, or the differences are not exactly the listed ones.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stm32f429i_discovery_lcd.h"
+#include "lcd_emu.h"
+
+#define FB_LAYER0 (LCD_FRAME_BUFFER + 0x130000)
+#define MASK_SIZE (EMU_WIDTH * EMU_HEIGHT / 8)
+#define MAX_POINTS 8
+
+// Shapes
+#define SHAPE_CIRCLE 0
+#define SHAPE_ELLIPSE 1
+#define SHAPE_TRIANGLE 2
+#define SHAPE_POLYGON 3
+#define SHAPE_EDGE_CIRCLE 4  // crossing the right or bottom edge
+#define SHAPE_EDGE_ELLIPSE 5 // flat enough for the BSP's rows to leave the screen
+
+typedef struct
+{
+    int kind;
+    int index;      // within its kind
+    int count;      // points
+    Point points[MAX_POINTS];
+    int radius[2];  // circles and ellipses, centred on points[0]
+} Shape;
+
+static const struct
+{
+    const char *name;
+    int count;
+} kinds[] = {
+    {"circle", 200},
+    {"ellipse", 200},
+    {"triangle", 100},
+    {"polygon", 50},
+    {"edge_circle", 20},
+    {"edge_ellipse", 20},
+};
+#define KIND_COUNT (sizeof(kinds) / sizeof(kinds[0]))
+
+static uint32_t seed;
+
+static uint32_t next_random(uint32_t range){
+    seed = seed * 1664525 + 1013904223;
+    return (seed >> 8) % range;
+}
+
+/*******************************************************************************
+ * @brief half the widest row of BSP_LCD_FillEllipse(), stepped as it does.
+ *        Flat ellipses step past XRadius: with a YRadius of 1 or 2 the rows
+ *        grow to several times as wide.
+ * ****************************************************************************/
+static int ellipse_reach(int XRadius, int YRadius){
+    int x = 0, y = -YRadius, err = 2 - 2 * XRadius, e2, reach = 0;
+    float K = (float)YRadius / (float)XRadius;
+    do {
+        if ((uint16_t)(x / K) > reach){
+            reach = (uint16_t)(x / K);
+        }
+        e2 = err;
+        if (e2 <= x){
+            err += ++x * 2 + 1;
+            if (-y == x && e2 <= y) e2 = 0;
+        }
+        if (e2 > y) err += ++y * 2 + 1;
+    } while (y <= 0);
+    return reach;
+}
+
+/*******************************************************************************
+ * @brief make up the next shape; the same list on every run
+ * ****************************************************************************/
+static void next_shape(Shape *shape, int kind, int index){
+    memset(shape, 0, sizeof(*shape));
+    shape->kind = kind;
+    shape->index = index;
+    switch (kind){
+    case SHAPE_CIRCLE:
+    case SHAPE_ELLIPSE:
+    case SHAPE_EDGE_ELLIPSE:
+        // Inside the screen, the old code has no clipping; or for the edge
+        // ellipses, past it sideways only
+        shape->count = 1;
+        while (1){
+            int x = 60 + next_random(120), reach;
+            shape->points[0].X = x;
+            shape->points[0].Y = 60 + next_random(200);
+            shape->radius[0] = 1 + next_random(55);
+            shape->radius[1] = kind == SHAPE_CIRCLE ? shape->radius[0] : 1 + next_random(55);
+            reach = kind == SHAPE_CIRCLE ? shape->radius[0] : ellipse_reach(shape->radius[0], shape->radius[1]);
+            if ((x - reach >= 0 && x + reach < EMU_WIDTH) == (kind != SHAPE_EDGE_ELLIPSE)){
+                break;
+            }
+        }
+        break;
+    case SHAPE_EDGE_CIRCLE:
+        // Past the right or the bottom edge only: the old code would write
+        // outside the emulated SDRAM past the others
+        shape->count = 1;
+        if (index % 2){
+            shape->points[0].X = 200 + next_random(40);
+            shape->points[0].Y = 60 + next_random(200);
+        }
+        else{
+            shape->points[0].X = 60 + next_random(120);
+            shape->points[0].Y = 280 + next_random(40);
+        }
+        shape->radius[0] = shape->radius[1] = 45 + next_random(15);
+        break;
+    default:
+        shape->count = kind == SHAPE_TRIANGLE ? 3 : 3 + next_random(MAX_POINTS - 2);
+        for (int i = 0; i < shape->count; i++){
+            shape->points[i].X = next_random(EMU_WIDTH);
+            shape->points[i].Y = next_random(EMU_HEIGHT);
+        }
+        break;
+    }
+}
+
+static void draw(Shape *shape){
+    Point *p = shape->points;
+    switch (shape->kind){
+    case SHAPE_CIRCLE:
+    case SHAPE_EDGE_CIRCLE:
+        BSP_LCD_FillCircle(p[0].X, p[0].Y, shape->radius[0]);
+        break;
+    case SHAPE_ELLIPSE:
+    case SHAPE_EDGE_ELLIPSE:
+        BSP_LCD_FillEllipse(p[0].X, p[0].Y, shape->radius[0], shape->radius[1]);
+        break;
+    case SHAPE_TRIANGLE:
+        BSP_LCD_FillTriangle(p[0].X, p[1].X, p[2].X, p[0].Y, p[1].Y, p[2].Y);
+        break;
+    default:
+        BSP_LCD_FillPolygon(p, shape->count);
+        break;
+    }
+    BSP_LCD_WaitDMA2D();
+}
+
+static void describe(const Shape *shape, char *text, size_t size){
+    int n = snprintf(text, size, "%s %d", kinds[shape->kind].name, shape->index);
+    for (int i = 0; i < shape->count; i++){
+        n += snprintf(text + n, size - n, " %d,%d", shape->points[i].X, shape->points[i].Y);
+    }
+    if (shape->kind != SHAPE_TRIANGLE && shape->kind != SHAPE_POLYGON){
+        snprintf(text + n, size - n, " r%d,%d", shape->radius[0], shape->radius[1]);
+    }
+}
+
+/*******************************************************************************
+ * @brief draw every shape and save a bit per pixel of each
+ * ****************************************************************************/
+static int write_masks(const char *path){
+    FILE *f = fopen(path, "wb");
+    if (f == NULL){
+        perror(path);
+        return 1;
+    }
+    const uint32_t *fb = (const uint32_t *)(uintptr_t)FB_LAYER0;
+    static uint8_t mask[MASK_SIZE];
+    Shape shape;
+
+    BSP_LCD_LayerDefaultInit(0, FB_LAYER0);
+    BSP_LCD_SelectLayer(0);
+    seed = 1;
+    for (unsigned kind = 0; kind < KIND_COUNT; kind++){
+        for (int i = 0; i < kinds[kind].count; i++){
+            next_shape(&shape, kind, i);
+            BSP_LCD_Clear(LCD_COLOR_WHITE);
+            BSP_LCD_SetTextColor(LCD_COLOR_BLACK);
+            draw(&shape);
+            memset(mask, 0, sizeof(mask));
+            for (int p = 0; p < EMU_WIDTH * EMU_HEIGHT; p++){
+                if (fb[p] != LCD_COLOR_WHITE){
+                    mask[p / 8] |= 1 << (p % 8);
+                }
+            }
+            fwrite(mask, 1, sizeof(mask), f);
+        }
+    }
+    return fclose(f) == 0 ? 0 : 1;
+}
+
+/*******************************************************************************
+ * @brief compare the masks of both drivers, and the differences with the
+ *        list, or write the list
+ * @return the number of failures
+ * ****************************************************************************/
+static int compare(const char *old_path, const char *new_path, const char *diffs_path, int record){
+    FILE *old_file = fopen(old_path, "rb"), *new_file = fopen(new_path, "rb");
+    FILE *diffs = fopen(diffs_path, record ? "w" : "r");
+    if (old_file == NULL || new_file == NULL || diffs == NULL){
+        perror("span_check");
+        return 1;
+    }
+    if (record){
+        fprintf(diffs, "# shape, points, radii: pixels only LCD_SPAN_FILL=0 drew, only =1 drew;"
+                       " written by span_check record\n");
+    }
+
+    static uint8_t old_mask[MASK_SIZE], new_mask[MASK_SIZE];
+    int failed = 0, differing = 0, identical[KIND_COUNT] = {0};
+    char line[256], expected[256];
+    Shape shape;
+    seed = 1;
+    for (unsigned kind = 0; kind < KIND_COUNT; kind++){
+        for (int i = 0; i < kinds[kind].count; i++){
+            next_shape(&shape, kind, i);
+            if (fread(old_mask, 1, MASK_SIZE, old_file) != MASK_SIZE ||
+                fread(new_mask, 1, MASK_SIZE, new_file) != MASK_SIZE){
+                printf("FAIL masks end early\n");
+                return 1;
+            }
+            int old_only = 0, new_only = 0;
+            for (int b = 0; b < MASK_SIZE; b++){
+                old_only += __builtin_popcount(old_mask[b] & ~new_mask[b]);
+                new_only += __builtin_popcount(new_mask[b] & ~old_mask[b]);
+            }
+            if (!old_only && !new_only){
+                identical[kind]++;
+                continue;
+            }
+
+            describe(&shape, line, sizeof(line));
+            size_t n = strlen(line);
+            snprintf(line + n, sizeof(line) - n, ": %d old only, %d new only", old_only, new_only);
+            differing++;
+            if (kind == SHAPE_CIRCLE || kind == SHAPE_ELLIPSE){
+                printf("FAIL %s\n", line);
+                failed++;
+                continue;
+            }
+            if (record){
+                fprintf(diffs, "%s\n", line);
+                continue;
+            }
+            do {
+                if (fgets(expected, sizeof(expected), diffs) == NULL){
+                    expected[0] = 0;
+                    break;
+                }
+            } while (expected[0] == '#');
+            expected[strcspn(expected, "\n")] = 0;
+            if (strcmp(expected, line) != 0){
+                printf("FAIL %s, listed %s\n", line, expected[0] ? expected : "nothing");
+                failed++;
+            }
+        }
+    }
+    if (!record && fgets(expected, sizeof(expected), diffs) != NULL){
+        printf("FAIL listed but identical: %s", expected);
+        failed++;
+    }
+    fclose(old_file);
+    fclose(new_file);
+    fclose(diffs);
+
+    for (unsigned kind = 0; kind < KIND_COUNT; kind++){
+        printf("%-12s %3d of %3d identical\n", kinds[kind].name, identical[kind], kinds[kind].count);
+    }
+    if (record){
+        printf("%d differences recorded in %s\n", differing, diffs_path);
+    }
+    else{
+        printf("%d differences, %d failed\n", differing, failed);
+    }
+    return failed;
+}
+
+int main(int argc, char **argv){
+    emu_init();
+    BSP_LCD_Init();
+
+    if (argc == 3 && strcmp(argv[1], "write") == 0){
+        return write_masks(argv[2]);
+    }
+    if (argc == 5 && (strcmp(argv[1], "check") == 0 || strcmp(argv[1], "record") == 0)){
+        return compare(argv[2], argv[3], argv[4], argv[1][0] == 'r') ? 1 : 0;
+    }
+    fprintf(stderr, "usage: span_check write FILE | check|record OLD NEW DIFFS\n");
+    return 2;
+}
@@ -0,0 +1,234 @@
+/**
+  ******************************************************************************
+  * @file    stm32f4xx_hal.h
+  * @brief   Host stand-in for the parts of the STM32F4 HAL that the LCD BSP
+  *          driver uses. Types keep the HAL field names; the LTDC and DMA2D
+  *          calls are implemented by lcd_emu.c, everything else is a no-op.
+  ******************************************************************************
+  */
+
+#ifndef __STM32F4xx_HAL_H
+#define __STM32F4xx_HAL_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define __IO volatile
+#define __weak __attribute__((weak))
+
+typedef enum {DISABLE = 0, ENABLE = 1} FunctionalState;
+typedef enum {RESET = 0, SET = 1} FlagStatus, ITStatus;
+typedef enum {HAL_OK = 0, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT} HAL_StatusTypeDef;
+typedef enum {GPIO_PIN_RESET = 0, GPIO_PIN_SET} GPIO_PinState;
+
+/* Peripherals ---------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t MODER, OTYPER, OSPEEDR, PUPDR, IDR, ODR, BSRR, LCKR, AFR[2];
+} GPIO_TypeDef;
+
+typedef struct
+{
+  uint32_t Pin, Mode, Pull, Speed, Alternate;
+} GPIO_InitTypeDef;
+
+typedef struct
+{
+  uint32_t CR, ISR, IFCR, FGMAR, FGOR, BGMAR, BGOR, FGPFCCR, FGCOLR, BGPFCCR, BGCOLR,
+           FGCMAR, BGCMAR, OPFCCR, OCOLR, OMAR, OOR, NLR, LWR, AMTCR;
+} DMA2D_TypeDef;
+
+typedef struct
+{
+  uint32_t SSCR, BPCR, AWCR, TWCR, GCR, SRCR, BCCR, IER, ISR, ICR, LIPCR, CPSR, CDSR;
+} LTDC_TypeDef;
+
+extern GPIO_TypeDef *GPIOA, *GPIOB, *GPIOC, *GPIOD, *GPIOE, *GPIOF, *GPIOG;
+extern DMA2D_TypeDef emu_dma2d;
+extern LTDC_TypeDef emu_ltdc;
+#define DMA2D (&emu_dma2d)
+#define LTDC  (&emu_ltdc)
+
+/* LTDC ----------------------------------------------------------------------*/
+typedef struct
+{
+  uint8_t Blue, Green, Red, Reserved;
+} LTDC_ColorTypeDef;
+
+typedef struct
+{
+  uint32_t HSPolarity, VSPolarity, DEPolarity, PCPolarity;
+  uint32_t HorizontalSync, VerticalSync, AccumulatedHBP, AccumulatedVBP;
+  uint32_t AccumulatedActiveW, AccumulatedActiveH, TotalWidth, TotalHeigh;
+  LTDC_ColorTypeDef Backcolor;
+} LTDC_InitTypeDef;
+
+typedef struct
+{
+  uint32_t WindowX0, WindowX1, WindowY0, WindowY1;
+  uint32_t PixelFormat, Alpha, Alpha0, BlendingFactor1, BlendingFactor2;
+  uint32_t FBStartAdress, ImageWidth, ImageHeight;
+  LTDC_ColorTypeDef Backcolor;
+} LTDC_LayerCfgTypeDef;
+
+typedef struct
+{
+  LTDC_TypeDef *Instance;
+  LTDC_InitTypeDef Init;
+  LTDC_LayerCfgTypeDef LayerCfg[2];
+  uint32_t State, ErrorCode;
+} LTDC_HandleTypeDef;
+
+#define LTDC_HSPOLARITY_AL            0
+#define LTDC_VSPOLARITY_AL            0
+#define LTDC_DEPOLARITY_AL            0
+#define LTDC_PCPOLARITY_IPC           0
+#define LTDC_PIXEL_FORMAT_ARGB8888    0
+#define LTDC_PIXEL_FORMAT_RGB888      1
+#define LTDC_PIXEL_FORMAT_RGB565      2
+#define LTDC_PIXEL_FORMAT_ARGB1555    3
+#define LTDC_PIXEL_FORMAT_ARGB4444    4
+#define LTDC_PIXEL_FORMAT_L8          5
+#define LTDC_PIXEL_FORMAT_AL44        6
+#define LTDC_PIXEL_FORMAT_AL88        7
+#define LTDC_BLENDING_FACTOR1_CA      0x400
+#define LTDC_BLENDING_FACTOR1_PAxCA   0x600
+#define LTDC_BLENDING_FACTOR2_CA      0x5
+#define LTDC_BLENDING_FACTOR2_PAxCA   0x7
+
+HAL_StatusTypeDef HAL_LTDC_ConfigLayer(LTDC_HandleTypeDef *hltdc, LTDC_LayerCfgTypeDef *pLayerCfg, uint32_t LayerIdx);
+HAL_StatusTypeDef HAL_LTDC_SetWindowSize(LTDC_HandleTypeDef *hltdc, uint32_t XSize, uint32_t YSize, uint32_t LayerIdx);
+HAL_StatusTypeDef HAL_LTDC_SetWindowPosition(LTDC_HandleTypeDef *hltdc, uint32_t X0, uint32_t Y0, uint32_t LayerIdx);
+HAL_StatusTypeDef HAL_LTDC_SetAlpha(LTDC_HandleTypeDef *hltdc, uint32_t Alpha, uint32_t LayerIdx);
+HAL_StatusTypeDef HAL_LTDC_SetAddress(LTDC_HandleTypeDef *hltdc, uint32_t Address, uint32_t LayerIdx);
+HAL_StatusTypeDef HAL_LTDC_ConfigColorKeying(LTDC_HandleTypeDef *hltdc, uint32_t RGBValue, uint32_t LayerIdx);
+HAL_StatusTypeDef HAL_LTDC_EnableColorKeying(LTDC_HandleTypeDef *hltdc, uint32_t LayerIdx);
+HAL_StatusTypeDef HAL_LTDC_DisableColorKeying(LTDC_HandleTypeDef *hltdc, uint32_t LayerIdx);
+void emu_ltdc_layer_enable(uint32_t LayerIdx, FunctionalState State);
+
+/* The emulated LTDC has no shadow registers, so every update is immediate */
+#define HAL_LTDC_SetWindowSize_NoReload        HAL_LTDC_SetWindowSize
+#define HAL_LTDC_SetWindowPosition_NoReload    HAL_LTDC_SetWindowPosition
+#define HAL_LTDC_SetAlpha_NoReload             HAL_LTDC_SetAlpha
+#define HAL_LTDC_SetAddress_NoReload           HAL_LTDC_SetAddress
+#define HAL_LTDC_ConfigColorKeying_NoReload    HAL_LTDC_ConfigColorKeying
+#define HAL_LTDC_EnableColorKeying_NoReload    HAL_LTDC_EnableColorKeying
+#define HAL_LTDC_DisableColorKeying_NoReload   HAL_LTDC_DisableColorKeying
+#define HAL_LTDC_Relaod(h, t)                  ((void)(h), (void)(t))
+#define HAL_LTDC_Init(h)                       ((void)(h))
+#define HAL_LTDC_EnableDither(h)               ((void)(h))
+#define __HAL_LTDC_LAYER_ENABLE(h, l)          emu_ltdc_layer_enable((l), ENABLE)
+#define __HAL_LTDC_LAYER_DISABLE(h, l)         emu_ltdc_layer_enable((l), DISABLE)
+#define __HAL_LTDC_RELOAD_CONFIG(h)            ((void)(h))
+#define __HAL_LTDC_ENABLE(h)                   ((void)(h))
+#define __HAL_LTDC_DISABLE(h)                  ((void)(h))
+
+/* DMA2D ---------------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t Mode, ColorMode, OutputOffset;
+} DMA2D_InitTypeDef;
+
+typedef struct
+{
+  uint32_t InputOffset, InputColorMode, AlphaMode, InputAlpha;
+} DMA2D_LayerCfgTypeDef;
+
+typedef struct __DMA2D_HandleTypeDef
+{
+  DMA2D_TypeDef *Instance;
+  DMA2D_InitTypeDef Init;
+  void (*XferCpltCallback)(struct __DMA2D_HandleTypeDef *hdma2d);
+  void (*XferErrorCallback)(struct __DMA2D_HandleTypeDef *hdma2d);
+  DMA2D_LayerCfgTypeDef LayerCfg[2];
+  uint32_t State, ErrorCode;
+} DMA2D_HandleTypeDef;
+
+#define DMA2D_M2M                     0x00000
+#define DMA2D_M2M_PFC                 0x10000
+#define DMA2D_M2M_BLEND               0x20000
+#define DMA2D_R2M                     0x30000
+#define DMA2D_ARGB8888                0
+#define DMA2D_RGB888                  1
+#define DMA2D_RGB565                  2
+#define DMA2D_NO_MODIF_ALPHA          0
+#define DMA2D_REPLACE_ALPHA           1
+#define DMA2D_COMBINE_ALPHA           2
+#define CM_ARGB8888                   0
+#define CM_RGB888                     1
+#define CM_RGB565                     2
+#define CM_ARGB1555                   3
+#define CM_ARGB4444                   4
+#define CM_L8                         5
+#define CM_AL44                       6
+#define CM_AL88                       7
+#define CM_L4                         8
+#define CM_A8                         9
+#define CM_A4                         10
+
+HAL_StatusTypeDef HAL_DMA2D_Init(DMA2D_HandleTypeDef *hdma2d);
+HAL_StatusTypeDef HAL_DMA2D_ConfigLayer(DMA2D_HandleTypeDef *hdma2d, uint32_t LayerIdx);
+HAL_StatusTypeDef HAL_DMA2D_Start(DMA2D_HandleTypeDef *hdma2d, uint32_t pdata, uint32_t DstAddress, uint32_t Width, uint32_t Height);
+HAL_StatusTypeDef HAL_DMA2D_BlendingStart(DMA2D_HandleTypeDef *hdma2d, uint32_t SrcAddress1, uint32_t SrcAddress2, uint32_t DstAddress, uint32_t Width, uint32_t Height);
+HAL_StatusTypeDef HAL_DMA2D_PollForTransfer(DMA2D_HandleTypeDef *hdma2d, uint32_t Timeout);
+
+/* SDRAM, only named by the BSP prototypes -----------------------------------*/
+typedef struct
+{
+  uint32_t CommandMode, CommandTarget, AutoRefreshNumber, ModeRegisterDefinition;
+} FMC_SDRAM_CommandTypeDef;
+
+typedef struct
+{
+  void *Instance;
+  uint32_t State;
+} SDRAM_HandleTypeDef;
+
+/* Clocks and pins, nothing to do on the host --------------------------------*/
+typedef struct
+{
+  uint32_t PeriphClockSelection;
+  struct {uint32_t PLLSAIN, PLLSAIQ, PLLSAIR;} PLLSAI;
+  uint32_t PLLSAIDivR;
+} RCC_PeriphCLKInitTypeDef;
+
+#define RCC_PERIPHCLK_LTDC            0x8
+#define RCC_PLLSAIDIVR_8              0x20000
+#define GPIO_MODE_AF_PP               0x2
+#define GPIO_NOPULL                   0
+#define GPIO_SPEED_FAST               0x2
+#define GPIO_AF9_LTDC                 9
+#define GPIO_AF14_LTDC                14
+#define GPIO_PIN_0                    0x0001
+#define GPIO_PIN_1                    0x0002
+#define GPIO_PIN_3                    0x0008
+#define GPIO_PIN_4                    0x0010
+#define GPIO_PIN_6                    0x0040
+#define GPIO_PIN_7                    0x0080
+#define GPIO_PIN_8                    0x0100
+#define GPIO_PIN_9                    0x0200
+#define GPIO_PIN_10                   0x0400
+#define GPIO_PIN_11                   0x0800
+#define GPIO_PIN_12                   0x1000
+
+#define HAL_RCCEx_PeriphCLKConfig(c)  ((void)(c))
+#define HAL_GPIO_Init(p, i)           ((void)(p), (void)(i))
+#define __HAL_RCC_LTDC_CLK_ENABLE()   ((void)0)
+#define __HAL_RCC_DMA2D_CLK_ENABLE()  ((void)0)
+#define __HAL_RCC_GPIOA_CLK_ENABLE()  ((void)0)
+#define __HAL_RCC_GPIOB_CLK_ENABLE()  ((void)0)
+#define __HAL_RCC_GPIOC_CLK_ENABLE()  ((void)0)
+#define __HAL_RCC_GPIOD_CLK_ENABLE()  ((void)0)
+#define __HAL_RCC_GPIOF_CLK_ENABLE()  ((void)0)
+#define __HAL_RCC_GPIOG_CLK_ENABLE()  ((void)0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STM32F4xx_HAL_H */
@@ -0,0 +1,58 @@
+/*
+ * Renders the app's static screen with the real UI code on the emulator.
+ *
+ * Usage: ui_emu OUT.ppm
+ *
+ * Runs ui_draw_background() exactly as the firmware would without the boot
+ * image and writes the background layer; `make boot` packs the result into
+ * src/boot_screen.c.
+ */
+#include "mbed.h"
+#include "ui.h"
+#include "sprite_cache.h"
+#include "font_atlas.h"
+#include "render.h"
+#include "lcd_emu.h"
+
+// The SDRAM has to be mapped before the LCD constructor clears the layers
+static int sdram_mapped = (emu_init(), 1);
+LCD_DISCO_F429ZI lcd;
+
+// No render thread on the host, nothing here posts status lines or targets
+bool render_post_status(const char *text, uint32_t color){
+    (void)text;
+    (void)color;
+    return true;
+}
+
+bool render_post_target(int x, int y){
+    (void)x;
+    (void)y;
+    return true;
+}
+
+// ui_init() is never run here, so there is no boot profile either
+void boot_stage(const char *name){
+    (void)name;
+}
+
+int main(int argc, char **argv){
+    if (argc != 2){
+        fprintf(stderr, "usage: ui_emu OUT.ppm\n");
+        return 2;
+    }
+
+    sprite_cache_init(SDRAM_SPRITE_CACHE_SIZE);
+    font_cache_init();
+    lcd.SelectLayer(UI_BACKGROUND_LAYER);
+    ui_draw_background();
+
+    // the status layer is still disabled, so this is the background alone
+    static uint8_t frame[EMU_WIDTH * EMU_HEIGHT * 3];
+    emu_compose(frame);
+    if (emu_write_ppm(argv[1], frame) != 0){
+        perror(argv[1]);
+        return 1;
+    }
+    return sdram_mapped ? 0 : 1;
+}
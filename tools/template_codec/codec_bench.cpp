@@ -0,0 +1,258 @@
+/*
+ * Runs src/template_codec.cpp over gesture recordings: the size of each
+ * format, whether it decodes back, and how fast.
+ *
+ * Usage: codec_bench [-s COUNT] [FILE...]
+ *
+ *   FILE      recordings as the firmware prints them with
+ *             APP_DUMP_RECORDING=1,
+ *
+ *                 g <x> <y> <z>      one sample, in dps
+ *
+ *             any other line, such as the "# key, 87 samples" the firmware
+ *             prints first, ends the recording before it
+ *   -s COUNT  add COUNT generated recordings, sines of 20 to 300 dps under
+ *             a swell, on the gyroscope's steps and dead zone
+ *
+ * For every format it reports the bytes against the 12 of a float sample,
+ * the header included, the largest error after decoding, and the decode
+ * speed in blocks of APP_DECODE_BLOCK samples, as the matcher takes them.
+ * Exits non-zero if a format does not decode, or TEMPLATE_INT16 is not
+ * exact.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+#include "template_codec.h"
+
+// src/gyro.h SENSITIVITY_500, the range the app runs the gyroscope at
+#define GYRO_SCALE 0.0175f
+
+// src/main.cpp
+#define APP_DECODE_BLOCK 32
+#define SAMPLE_HZ 20
+
+// Generated recordings: 2 to 6 s, readings below the dead zone read 0 as
+// after GetCalibratedRawData()
+#define SYNTH_MIN_SAMPLES (2 * SAMPLE_HZ)
+#define SYNTH_MAX_SAMPLES (6 * SAMPLE_HZ)
+#define SYNTH_DEAD_ZONE 40
+
+// Decode each format for at least this long
+#define BENCH_SECONDS 0.2
+
+typedef std::vector<std::vector<float>> Recording; // samples of 3 floats
+
+static const struct
+{
+    uint8_t format;
+    const char *name;
+} formats[] = {
+    {TEMPLATE_F32, "f32"},
+    {TEMPLATE_INT16, "int16 varint"},
+    {TEMPLATE_INT16 | TEMPLATE_PACKED, "int16 packed"},
+    {TEMPLATE_INT8, "int8 varint"},
+    {TEMPLATE_INT8 | TEMPLATE_PACKED, "int8 packed"},
+};
+
+static std::vector<Recording> recordings;
+static uint32_t rng = 1;
+
+static double now_seconds(){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static double random_unit(){
+    rng = rng * 1664525 + 1013904223;
+    return (rng >> 8) / (double)(1 << 24);
+}
+
+/*******************************************************************************
+ * @brief a reading as the firmware holds it: ConvertDPS() of a raw value
+ * ****************************************************************************/
+static float gyro_value(double dps){
+    long raw = lrint(dps / GYRO_SCALE);
+    raw = raw > 32767 ? 32767 : raw < -32768 ? -32768 : raw;
+    if (labs(raw) < SYNTH_DEAD_ZONE){
+        raw = 0;
+    }
+    return (int16_t)raw * GYRO_SCALE;
+}
+
+static void add_recording(Recording &recording){
+    if (!recording.empty()){
+        recordings.push_back(recording);
+        recording.clear();
+    }
+}
+
+/*******************************************************************************
+ * @brief read the recordings of a dump
+ * ****************************************************************************/
+static bool load(const char *path){
+    FILE *file = fopen(path, "r");
+    if (!file){
+        perror(path);
+        return false;
+    }
+    char line[256];
+    Recording recording;
+    while (fgets(line, sizeof(line), file)){
+        float x, y, z;
+        if (sscanf(line, "g %f %f %f", &x, &y, &z) == 3){
+            // Printed to 4 decimals: back onto the gyroscope's steps
+            recording.push_back({gyro_value(x), gyro_value(y), gyro_value(z)});
+        }
+        else{
+            add_recording(recording);
+        }
+    }
+    add_recording(recording);
+    fclose(file);
+    return true;
+}
+
+/*******************************************************************************
+ * @brief make up a gesture: per axis a few sines under a swell, plus a
+ *        step or two of noise
+ * ****************************************************************************/
+static void synthesize(){
+    uint32_t n = SYNTH_MIN_SAMPLES + random_unit() * (SYNTH_MAX_SAMPLES - SYNTH_MIN_SAMPLES + 1);
+    double amplitude[3][3], hz[3][3], phase[3][3];
+    for (int axis = 0; axis < 3; axis++){
+        for (int k = 0; k < 3; k++){
+            amplitude[axis][k] = k == 0 || random_unit() < 0.5 ? 20 + random_unit() * 280 : 0;
+            hz[axis][k] = 0.3 + random_unit() * 1.7;
+            phase[axis][k] = random_unit() * 2 * M_PI;
+        }
+    }
+    Recording recording;
+    for (uint32_t i = 0; i < n; i++){
+        double t = (double)i / SAMPLE_HZ;
+        double swell = sin(M_PI * i / (n - 1));
+        std::vector<float> sample(3);
+        for (int axis = 0; axis < 3; axis++){
+            double dps = (random_unit() - 0.5) * 4 * GYRO_SCALE;
+            for (int k = 0; k < 3; k++){
+                dps += amplitude[axis][k] * sin(2 * M_PI * hz[axis][k] * t + phase[axis][k]);
+            }
+            sample[axis] = gyro_value(dps * swell);
+        }
+        recording.push_back(sample);
+    }
+    recordings.push_back(recording);
+}
+
+/*******************************************************************************
+ * @brief encode every recording in one format, decode them back and time it
+ * @return false if a recording does not come back
+ * ****************************************************************************/
+static bool run(uint8_t format, const char *name, uint32_t samples){
+    std::vector<std::vector<uint8_t>> encoded;
+    uint64_t bytes = 0;
+    for (const auto &recording : recordings){
+        std::vector<float> flat;
+        for (const auto &sample : recording){
+            flat.insert(flat.end(), sample.begin(), sample.end());
+        }
+        std::vector<uint8_t> out(template_encoded_max(recording.size()));
+        uint32_t length = template_encode((const float (*)[3])flat.data(), recording.size(), format, GYRO_SCALE,
+                                          out.data(), out.size());
+        if (length == 0){
+            printf("FAIL %s: encode\n", name);
+            return false;
+        }
+        out.resize(length);
+        bytes += length;
+        encoded.push_back(out);
+    }
+
+    // Back again, in the matcher's blocks
+    float block[APP_DECODE_BLOCK][3];
+    double max_error = 0;
+    for (size_t r = 0; r < recordings.size(); r++){
+        TemplateDecoder decoder;
+        if (!template_decode_init(&decoder, encoded[r].data(), encoded[r].size())){
+            printf("FAIL %s: recording %zu not a template\n", name, r);
+            return false;
+        }
+        size_t done = 0;
+        uint32_t n;
+        while ((n = template_decode(&decoder, block, APP_DECODE_BLOCK)) > 0){
+            for (uint32_t i = 0; i < n && done + i < recordings[r].size(); i++){
+                for (int axis = 0; axis < 3; axis++){
+                    max_error = fmax(max_error, fabs(block[i][axis] - recordings[r][done + i][axis]));
+                }
+            }
+            done += n;
+        }
+        if (done != recordings[r].size()){
+            printf("FAIL %s: recording %zu decoded %zu of %zu samples\n", name, r, done, recordings[r].size());
+            return false;
+        }
+    }
+    if ((format & ~TEMPLATE_PACKED) != TEMPLATE_INT8 && max_error != 0){
+        printf("FAIL %s: decodes %g dps off\n", name, max_error);
+        return false;
+    }
+
+    uint64_t decoded = 0;
+    volatile float sink; // keeps the decoding from being optimised out
+    double start = now_seconds();
+    double elapsed;
+    do {
+        for (const auto &data : encoded){
+            TemplateDecoder decoder;
+            template_decode_init(&decoder, data.data(), data.size());
+            uint32_t n;
+            while ((n = template_decode(&decoder, block, APP_DECODE_BLOCK)) > 0){
+                sink = block[n - 1][0];
+                decoded += n;
+            }
+        }
+        elapsed = now_seconds() - start;
+    } while (elapsed < BENCH_SECONDS);
+    (void)sink;
+
+    printf("%-13s %8llu bytes %5.2f B/sample  ratio %5.2f  error %7.4f dps  decode %7.1f Msamples/s %7.1f MB/s\n",
+           name, (unsigned long long)bytes, (double)bytes / samples, samples * 12.0 / bytes, max_error,
+           decoded / elapsed / 1e6, decoded * 12.0 / elapsed / 1e6);
+    return true;
+}
+
+int main(int argc, char **argv){
+    uint32_t synthetic = 0;
+    for (int i = 1; i < argc; i++){
+        if (!strcmp(argv[i], "-s") && i + 1 < argc){
+            synthetic = atoi(argv[++i]);
+        }
+        else if (!load(argv[i])){
+            return 1;
+        }
+    }
+    for (uint32_t i = 0; i < synthetic; i++){
+        synthesize();
+    }
+    if (recordings.empty()){
+        fprintf(stderr, "usage: codec_bench [-s COUNT] [FILE...]\n");
+        return 1;
+    }
+
+    uint32_t samples = 0;
+    for (const auto &recording : recordings){
+        samples += recording.size();
+    }
+    printf("%zu recordings, %u samples, %u bytes as floats\n", recordings.size(), samples, samples * 12);
+
+    bool ok = true;
+    for (const auto &format : formats){
+        ok = run(format.format, format.name, samples) && ok;
+    }
+    printf(ok ? "PASS\n" : "FAIL\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,213 @@
+/*
+ * Runs raw touch samples through src/touch_cal.cpp, the jitter filter,
+ * touch average and affine matrix the touch thread applies.
+ *
+ * Usage: touch_cal TRACE...   replay and compare every mapped sample
+ *        touch_cal -l         check the default matrix against the old
+ *                             fixed correction of the BSP
+ *
+ * A trace holds the lines the touch thread prints with TOUCH_TRACE=1,
+ *
+ *     m <a> <b> <c> <d> <e> <f>    matrix in use, Q16
+ *     f <shift>                    filter strength
+ *     t                            a new touch, the filter starts over
+ *     r <raw x> <raw y> <x> <y>    raw sample and the pixel it was mapped to
+ *
+ * and, once the touch on a calibration target is over,
+ *
+ *     c <x> <y> <raw x> <raw y>    target and where it was touched; the
+ *                                  third one solves the matrix
+ *
+ * The raw values of a c line must be the average of the r lines of the touch
+ * before it, if it has any; without, the line only tests the solver.
+ *
+ * Lines of tools/touch_replay, # comments and blank lines are skipped, so
+ * one capture feeds both tools. Without an m or c line the default matrix
+ * is used.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "touch_cal.h"
+#include "widgets.h"
+
+#define SHOW_MISMATCHES 5
+
+/*******************************************************************************
+ * @brief the BSP's correction before the calibration, kept as the reference
+ *        for the default matrix
+ * @param x, y: raw on entry, pixels on return
+ * ****************************************************************************/
+static void legacy_correct(uint16_t *x, uint16_t *y){
+    uint16_t yr, xr;
+    *y -= 360;
+    yr = *y / 11;
+    if (yr > WIDGET_SCREEN_HEIGHT){
+        yr = WIDGET_SCREEN_HEIGHT - 1;
+    }
+    *y = yr;
+    if (*x <= 3000){
+        *x = 3870 - *x;
+    }
+    else{
+        *x = 3800 - *x;
+    }
+    xr = *x / 15;
+    if (xr > WIDGET_SCREEN_WIDTH){
+        xr = WIDGET_SCREEN_WIDTH - 1;
+    }
+    *x = xr;
+}
+
+/*******************************************************************************
+ * @brief compare the default matrix with the old correction over the panel
+ * @return true if they agree wherever the old code did not wrap around
+ * ****************************************************************************/
+static bool check_legacy(){
+    TouchCal cal;
+    touch_cal_default(&cal);
+
+    uint32_t same = 0, differ = 0, skipped = 0;
+    for (uint32_t raw_y = 0; raw_y < 4096; raw_y++){
+        for (uint32_t raw_x = 0; raw_x < 4096; raw_x++){
+            uint16_t old_x = raw_x, old_y = raw_y, x, y;
+            // Past raw 3000 the old X offset jumps, below raw Y 360 its
+            // unsigned arithmetic wraps
+            if (raw_x > 3000 || raw_y < 360){
+                skipped++;
+                continue;
+            }
+            legacy_correct(&old_x, &old_y);
+            // Its clamps let one row and column past the screen through
+            if (old_x >= WIDGET_SCREEN_WIDTH || old_y >= WIDGET_SCREEN_HEIGHT){
+                skipped++;
+                continue;
+            }
+            touch_cal_apply(&cal, raw_x, raw_y, WIDGET_SCREEN_WIDTH, WIDGET_SCREEN_HEIGHT, &x, &y);
+            if (x == old_x && y == old_y){
+                same++;
+            }
+            else if (differ++ < SHOW_MISMATCHES){
+                printf("  raw %u %u: old %u %u, matrix %u %u\n", raw_x, raw_y, old_x, old_y, x, y);
+            }
+        }
+    }
+    printf("%s default matrix: %lu samples as before, %lu differ, %lu outside the old range\n",
+           differ ? "FAIL" : "ok  ", (unsigned long)same, (unsigned long)differ, (unsigned long)skipped);
+
+    // Three points on a line must be refused
+    TouchCalPoint line[3] = {{30, 30, 1000, 1000}, {120, 160, 2000, 2000}, {210, 290, 3000, 3000}};
+    bool refused = !touch_cal_solve(line, &cal);
+    printf("%s collinear calibration %s\n", refused ? "ok  " : "FAIL", refused ? "refused" : "accepted");
+    return differ == 0 && refused;
+}
+
+/*******************************************************************************
+ * @brief replay one trace
+ * @param path: trace file
+ * @return true if every sample maps to its recorded pixel
+ * ****************************************************************************/
+static bool replay(const char *path){
+    FILE *f = fopen(path, "r");
+    if (!f){
+        perror(path);
+        return false;
+    }
+
+    TouchCal cal;
+    TouchFilter filter;
+    TouchAverage average;
+    TouchCalPoint points[3];
+    int point_count = 0;
+    touch_cal_default(&cal);
+    touch_filter_init(&filter, TOUCH_FILTER_SHIFT);
+    touch_average_reset(&average);
+
+    uint32_t samples = 0, mismatches = 0;
+    bool ok = true;
+    char line[128];
+    int line_no = 0;
+    while (ok && fgets(line, sizeof(line), f)){
+        long m[6];
+        unsigned a, b, c, d;
+        line_no++;
+
+        // Blank, comment and touch_replay lines
+        if (!isalpha((unsigned char)line[0])){
+            continue;
+        }
+        switch (line[0]){
+        case 'm':
+            ok = sscanf(line, "m %ld %ld %ld %ld %ld %ld", &m[0], &m[1], &m[2], &m[3], &m[4], &m[5]) == 6;
+            cal = {(int32_t)m[0], (int32_t)m[1], (int32_t)m[2], (int32_t)m[3], (int32_t)m[4], (int32_t)m[5]};
+            break;
+        case 'f':
+            ok = sscanf(line, "f %u", &a) == 1;
+            touch_filter_init(&filter, a);
+            break;
+        case 't':
+            touch_filter_reset(&filter);
+            touch_average_reset(&average);
+            break;
+        case 'c':{
+            ok = sscanf(line, "c %u %u %u %u", &a, &b, &c, &d) == 4;
+            uint16_t mean_x, mean_y;
+            if (ok && touch_average_get(&average, &mean_x, &mean_y) && (mean_x != c || mean_y != d)){
+                printf("  line %d: target %u %u measured at %u %u, the samples average %u %u\n", line_no, a, b, c, d,
+                       mean_x, mean_y);
+                mismatches++;
+            }
+            touch_average_reset(&average);
+            points[point_count++] = {(int16_t)a, (int16_t)b, (uint16_t)c, (uint16_t)d};
+            if (ok && point_count == 3){
+                point_count = 0;
+                if (!touch_cal_solve(points, &cal)){
+                    fprintf(stderr, "%s:%d: calibration points too close to a line\n", path, line_no);
+                    ok = false;
+                }
+            }
+            break;
+        }
+        case 'r':{
+            ok = sscanf(line, "r %u %u %u %u", &a, &b, &c, &d) == 4;
+            uint16_t raw_x = a, raw_y = b, x, y;
+            touch_average_add(&average, raw_x, raw_y);
+            touch_filter_apply(&filter, &raw_x, &raw_y);
+            touch_cal_apply(&cal, raw_x, raw_y, WIDGET_SCREEN_WIDTH, WIDGET_SCREEN_HEIGHT, &x, &y);
+            samples++;
+            if (x != c || y != d){
+                if (mismatches++ < SHOW_MISMATCHES){
+                    printf("  line %d: raw %u %u recorded at %u %u, maps to %u %u\n", line_no, a, b, c, d, x, y);
+                }
+            }
+            break;
+        }
+        default:
+            ok = false;
+            break;
+        }
+        if (!ok){
+            fprintf(stderr, "%s:%d: cannot parse: %s", path, line_no, line);
+        }
+    }
+    fclose(f);
+
+    ok = ok && mismatches == 0;
+    printf("%s %s: %lu samples, %lu mismatched\n", ok ? "ok  " : "FAIL", path,
+           (unsigned long)samples, (unsigned long)mismatches);
+    return ok;
+}
+
+int main(int argc, char **argv){
+    if (argc < 2){
+        fprintf(stderr, "usage: touch_cal -l | TRACE...\n");
+        return 2;
+    }
+
+    int failed = 0;
+    for (int i = 1; i < argc; i++){
+        failed += strcmp(argv[i], "-l") == 0 ? !check_legacy() : !replay(argv[i]);
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,180 @@
+/*
+ * Replays touch traces through the widget state machine.
+ *
+ * Usage: touch_replay TRACE...      replay and compare with the expected actions
+ *        touch_replay -v TRACE...   also print every action
+ *
+ * A trace holds the lines the firmware prints with TOUCH_TRACE=1,
+ *
+ *     <ms> d|m|u <x> <y>           press, move or release
+ *
+ * plus the actions the app's widgets must see, in order,
+ *
+ *     = <ms> <widget> <action>     widget record|unlock, action down|move|up|long|cancel
+ *
+ * and # comments. The raw sample lines of tools/touch_replay/touch_cal,
+ * which start with a letter, are skipped. Time only advances with the trace: between two events
+ * widget_tick() is called at every deadline widget_timeout() reports, as
+ * the touch thread's timed wait would.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+#include "widgets.h"
+#include "ui_layout.h"
+
+#define MAX_ACTIONS 256
+
+static const char *const widget_names[] = {"record", "unlock"};
+static const char *const action_names[] = {"?", "down", "move", "up", "long", "cancel"};
+
+typedef struct
+{
+    uint32_t ms;
+    char text[32];
+} Action;
+
+static Action actual[MAX_ACTIONS];
+static int actual_count;
+static uint32_t now_ms;
+static bool verbose = false;
+
+/*******************************************************************************
+ * @brief widget handler: log the action at the current trace time
+ * ****************************************************************************/
+static void log_action(uint8_t widget, uint8_t action, void *context){
+    (void)context;
+    if (actual_count < MAX_ACTIONS){
+        Action *a = &actual[actual_count++];
+        a->ms = now_ms;
+        snprintf(a->text, sizeof(a->text), "%s %s", widget_names[widget], action_names[action]);
+        if (verbose){
+            printf("  %6lu %s\n", (unsigned long)a->ms, a->text);
+        }
+    }
+}
+
+/*******************************************************************************
+ * @brief run the deadlines that fall due before a time
+ * @param until: trace time to advance to
+ * ****************************************************************************/
+static void advance(uint32_t until){
+    uint32_t timeout;
+    while ((timeout = widget_timeout(now_ms)) != WIDGET_NO_TIMEOUT && now_ms + timeout <= until){
+        now_ms += timeout;
+        widget_tick(now_ms);
+    }
+    now_ms = until;
+}
+
+/*******************************************************************************
+ * @brief replay one trace
+ * @param path: trace file
+ * @return true if the actions match the expected ones
+ * ****************************************************************************/
+static bool replay(const char *path){
+    FILE *f = fopen(path, "r");
+    if (!f){
+        perror(path);
+        return false;
+    }
+
+    widget_clear();
+    widget_add(button_x_1, button_y_1, button1_width, button1_height, log_action, NULL);
+    widget_add(button_x_2, button_y_2, button2_width, button2_height, log_action, NULL);
+    actual_count = 0;
+    now_ms = 0;
+
+    Action expected[MAX_ACTIONS];
+    int expected_count = 0;
+    bool started = false;
+    char line[128];
+    int line_no = 0;
+    while (fgets(line, sizeof(line), f)){
+        unsigned long ms;
+        char kind;
+        int x, y;
+        char widget[16], action[16];
+        line_no++;
+
+        if (line[0] == '#' || line[0] == '\n' || isalpha((unsigned char)line[0])){
+            continue;
+        }
+        if (sscanf(line, "= %lu %15s %15s", &ms, widget, action) == 3){
+            if (expected_count < MAX_ACTIONS){
+                expected[expected_count].ms = ms;
+                snprintf(expected[expected_count].text, sizeof(expected[0].text), "%s %s", widget, action);
+                expected_count++;
+            }
+            continue;
+        }
+        if (sscanf(line, "%lu %c %d %d", &ms, &kind, &x, &y) != 4){
+            fprintf(stderr, "%s:%d: cannot parse: %s", path, line_no, line);
+            fclose(f);
+            return false;
+        }
+
+        if (!started){
+            now_ms = ms;
+            started = true;
+        }
+        advance(ms);
+        switch (kind){
+        case 'd':
+            widget_down(x, y, now_ms);
+            break;
+        case 'm':
+            widget_move(x, y, now_ms);
+            break;
+        case 'u':
+            widget_up(x, y, now_ms);
+            break;
+        default:
+            fprintf(stderr, "%s:%d: unknown event '%c'\n", path, line_no, kind);
+            fclose(f);
+            return false;
+        }
+    }
+    fclose(f);
+
+    // Let the last release and any long press run out
+    advance(now_ms + WIDGET_LONG_PRESS_MS + WIDGET_DEBOUNCE_MS);
+
+    bool ok = actual_count == expected_count;
+    for (int i = 0; ok && i < actual_count; i++){
+        ok = actual[i].ms == expected[i].ms && strcmp(actual[i].text, expected[i].text) == 0;
+    }
+    printf("%s %s\n", ok ? "ok  " : "FAIL", path);
+    if (!ok){
+        for (int i = 0; i < actual_count || i < expected_count; i++){
+            printf("  %-22s %s\n",
+                   i < expected_count ? expected[i].text : "-",
+                   i < actual_count ? actual[i].text : "-");
+            if (i < expected_count && i < actual_count){
+                printf("  %-22lu %lu\n", (unsigned long)expected[i].ms, (unsigned long)actual[i].ms);
+            }
+        }
+    }
+    return ok;
+}
+
+int main(int argc, char **argv){
+    int first = 1;
+    if (argc > 1 && strcmp(argv[1], "-v") == 0){
+        verbose = true;
+        first = 2;
+    }
+    if (first >= argc){
+        fprintf(stderr, "usage: touch_replay [-v] TRACE...\n");
+        return 2;
+    }
+
+    int failed = 0;
+    for (int i = first; i < argc; i++){
+        failed += !replay(argv[i]);
+    }
+    printf("%d traces, %d failed\n", argc - first, failed);
+    return failed ? 1 : 0;
+}